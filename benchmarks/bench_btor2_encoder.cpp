@@ -0,0 +1,135 @@
+/*********************                                                        */
+/*! \file bench_btor2_encoder.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Parse throughput benchmark for the BTOR2 frontend.
+**
+**        Usage: bench_btor2_encoder [<btor2 file>] [<repetitions>]
+**        e.g. bench_btor2_encoder samples/ridecore.btor 10
+**        Without a file, a large synthetic file is generated in the
+**        temporary directory and parsed.
+**
+**/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "core/fts.h"
+#include "frontends/btor2_encoder.h"
+#include "smt/available_solvers.h"
+#include "utils/timestamp.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+/** Writes a BTOR2 file with a ring of registers, each updated from its
+ *  predecessor, an input and a mix of operators, plus unnamed states
+ *  that are named by outputs
+ *  @return the number of lines written
+ */
+size_t synthetic_file(const string & filename, size_t num_regs)
+{
+  ofstream f(filename);
+  size_t id = 0;
+  f << ++id << " sort bitvec 1\n";
+  const size_t bv1 = id;
+  f << ++id << " sort bitvec 32\n";
+  const size_t bv32 = id;
+  f << ++id << " zero " << bv32 << "\n";
+  const size_t zero = id;
+  f << ++id << " input " << bv32 << " in\n";
+  const size_t in = id;
+
+  const size_t first_state = id + 1;
+  for (size_t i = 0; i < num_regs; ++i) {
+    const size_t state = ++id;
+    f << state << " state " << bv32;
+    // every other state is named by an output
+    if (i % 2) {
+      f << " r" << i;
+    }
+    f << "\n";
+    f << ++id << " init " << bv32 << " " << state << " " << zero << "\n";
+  }
+
+  for (size_t i = 0; i < num_regs; ++i) {
+    const size_t state = first_state + 2 * i;
+    const size_t prev = first_state + 2 * ((i + num_regs - 1) % num_regs);
+    const size_t sum = ++id;
+    f << sum << " add " << bv32 << " " << prev << " " << in << "\n";
+    const size_t mix = ++id;
+    f << mix << " xor " << bv32 << " " << sum << " " << state << "\n";
+    const size_t cond = ++id;
+    f << cond << " ult " << bv1 << " " << prev << " " << state << "\n";
+    const size_t upd = ++id;
+    f << upd << " ite " << bv32 << " " << cond << " " << mix << " " << prev
+      << "\n";
+    f << ++id << " next " << bv32 << " " << state << " " << upd << "\n";
+    if (!(i % 2)) {
+      f << ++id << " output " << state << " out" << i << "\n";
+    }
+  }
+
+  const size_t eq = ++id;
+  f << eq << " eq " << bv1 << " " << first_state << " " << in << "\n";
+  f << ++id << " bad " << eq << "\n";
+  return id;
+}
+
+int main(int argc, char ** argv)
+{
+  size_t repetitions = 5;
+  string filename;
+  bool synthetic = true;
+  if (argc > 1) {
+    filename = argv[1];
+    synthetic = false;
+  }
+  if (argc > 2) {
+    repetitions = stoul(argv[2]);
+  }
+
+  if (synthetic) {
+    filename = string(P_tmpdir) + "/pono_bench_btor2_encoder.btor2";
+    size_t num_lines = synthetic_file(filename, 200000);
+    cout << "synthetic file: " << filename << " (" << num_lines << " lines)"
+         << endl;
+  }
+
+  ifstream f(filename, ifstream::ate | ifstream::binary);
+  double size_mb = f.tellg() / (1024.0 * 1024.0);
+
+  double total_time = 0;
+  size_t num_states = 0;
+  for (size_t i = 0; i < repetitions; ++i) {
+    // fresh solver, otherwise later repetitions reuse hash-consed terms
+    SmtSolver s = create_solver(BTOR);
+    FunctionalTransitionSystem fts(s);
+    auto begin = timestamp();
+    BTOR2Encoder btor_enc(filename, fts);
+    total_time += time_duration_to_sec(timestamp_diff(begin, timestamp()));
+    num_states = fts.statevars().size();
+  }
+
+  if (synthetic) {
+    remove(filename.c_str());
+  }
+
+  double avg_time = total_time / repetitions;
+  cout << "state variables: " << num_states << endl;
+  cout << "file size: " << size_mb << " MB" << endl;
+  cout << "average parse time: " << avg_time << " s over " << repetitions
+       << " repetitions" << endl;
+  cout << "MB/s: " << size_mb / avg_time << endl;
+  return 0;
+}
@@ -0,0 +1,94 @@
+/*********************                                                        */
+/*! \file bench_coi.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Benchmark for cone-of-influence queries on the dependency graph.
+**
+**        Usage: bench_coi [<btor2 file>]
+**        Computes the cone-of-influence of every property (or, without
+**        a file, of every cluster of a synthetic design with many
+**        independent register clusters), as multi-property checking
+**        does.
+**
+**/
+
+#include <iostream>
+#include <string>
+
+#include "core/fts.h"
+#include "frontends/btor2_encoder.h"
+#include "smt/available_solvers.h"
+#include "utils/dependency_graph.h"
+#include "utils/timestamp.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+/** Populates fts with independent clusters of registers, each a shift
+ *  chain mixing in an input
+ *  @return a property over the last register of each cluster
+ */
+TermVec synthetic_design(FunctionalTransitionSystem & fts,
+                         size_t num_clusters,
+                         size_t cluster_size)
+{
+  Sort sort = fts.make_sort(BV, 16);
+  Term zero = fts.make_term(0, sort);
+  TermVec props;
+  for (size_t c = 0; c < num_clusters; ++c) {
+    string prefix = "c" + to_string(c) + "_";
+    Term in = fts.make_inputvar(prefix + "in", sort);
+    Term prev = in;
+    for (size_t i = 0; i < cluster_size; ++i) {
+      Term r = fts.make_statevar(prefix + "r" + to_string(i), sort);
+      fts.constrain_init(fts.make_term(Equal, r, zero));
+      fts.assign_next(r, fts.make_term(BVAdd, prev, fts.make_term(BVNot, r)));
+      prev = r;
+    }
+    props.push_back(fts.make_term(Distinct, prev, fts.make_term(7, sort)));
+  }
+  return props;
+}
+
+int main(int argc, char ** argv)
+{
+  SmtSolver s = create_solver(BTOR);
+  FunctionalTransitionSystem fts(s);
+  TermVec props;
+  if (argc > 1) {
+    BTOR2Encoder btor_enc(argv[1], fts);
+    props = btor_enc.propvec();
+  } else {
+    props = synthetic_design(fts, 2000, 64);
+  }
+
+  auto begin = timestamp();
+  DependencyGraph graph(fts);
+  double build_time = time_duration_to_sec(timestamp_diff(begin, timestamp()));
+
+  size_t total_cone = 0;
+  begin = timestamp();
+  for (const auto & p : props) {
+    UnorderedTermSet statevars, inputvars;
+    graph.cone({ p }, statevars, inputvars);
+    total_cone += statevars.size() + inputvars.size();
+  }
+  double query_time = time_duration_to_sec(timestamp_diff(begin, timestamp()));
+
+  cout << "state variables: " << fts.statevars().size() << endl;
+  cout << "input variables: " << fts.inputvars().size() << endl;
+  cout << "properties: " << props.size() << endl;
+  cout << "graph build time: " << build_time << " s" << endl;
+  cout << "cone queries: " << query_time << " s" << endl;
+  cout << "average cone size: "
+       << (props.empty() ? 0 : total_cone / props.size()) << endl;
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*********************                                                        */
+/*! \file bench_simulator.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Throughput benchmark for the compiled simulator.
+**
+**        Usage: bench_simulator [<btor2 file>] [<cycles>]
+**        Without a file, a synthetic design mixing narrow and wide
+**        bit-vector arithmetic is simulated.
+**
+**/
+
+#include <iostream>
+#include <string>
+
+#include "core/fts.h"
+#include "frontends/btor2_encoder.h"
+#include "smt/available_solvers.h"
+#include "utils/simulator.h"
+#include "utils/timestamp.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+/** Populates fts with a ring of registers of the given width,
+ *  each updated from its predecessor and an input
+ */
+void synthetic_design(FunctionalTransitionSystem & fts,
+                      size_t num_regs,
+                      size_t width)
+{
+  Sort sort = fts.make_sort(BV, width);
+  Term in = fts.make_inputvar("in_" + to_string(width), sort);
+  Term k = fts.make_term(0x9e3779b9, sort);
+  TermVec regs;
+  for (size_t i = 0; i < num_regs; ++i) {
+    regs.push_back(
+        fts.make_statevar("r_" + to_string(width) + "_" + to_string(i), sort));
+    fts.constrain_init(
+        fts.make_term(Equal, regs.back(), fts.make_term((int64_t)i, sort)));
+  }
+  for (size_t i = 0; i < num_regs; ++i) {
+    const Term & prev = regs[(i + num_regs - 1) % num_regs];
+    Term upd = fts.make_term(
+        BVXor, fts.make_term(BVMul, prev, k), fts.make_term(BVAdd, regs[i], in));
+    upd = fts.make_term(Ite,
+                        fts.make_term(BVUlt, prev, regs[i]),
+                        upd,
+                        fts.make_term(BVLshr, upd, in));
+    fts.assign_next(regs[i], upd);
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  size_t cycles = 100000;
+  string filename;
+  if (argc > 1) {
+    filename = argv[1];
+  }
+  if (argc > 2) {
+    cycles = stoul(argv[2]);
+  }
+
+  SmtSolver s = create_solver(BTOR);
+  FunctionalTransitionSystem fts(s);
+  if (!filename.empty()) {
+    BTOR2Encoder btor_enc(filename, fts);
+  } else {
+    synthetic_design(fts, 256, 32);
+    synthetic_design(fts, 16, 128);
+  }
+
+  auto begin = timestamp();
+  Simulator sim(fts);
+  double compile_time = time_duration_to_sec(timestamp_diff(begin, timestamp()));
+
+  begin = timestamp();
+  sim.reset();
+  for (size_t i = 0; i < cycles; ++i) {
+    sim.step();
+  }
+  double sim_time = time_duration_to_sec(timestamp_diff(begin, timestamp()));
+
+  cout << "state variables: " << fts.statevars().size() << endl;
+  cout << "input variables: " << fts.inputvars().size() << endl;
+  cout << "compile time: " << compile_time << " s" << endl;
+  cout << "simulated cycles: " << cycles << " x " << Simulator::NUM_LANES
+       << " lanes in " << sim_time << " s" << endl;
+  cout << "cycles/s: " << cycles / sim_time << endl;
+  cout << "lane-cycles/s: " << cycles * Simulator::NUM_LANES / sim_time
+       << endl;
+  return 0;
+}
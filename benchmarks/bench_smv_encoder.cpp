@@ -0,0 +1,105 @@
+/*********************                                                        */
+/*! \file bench_smv_encoder.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Load time benchmark for the SMV frontend.
+**
+**        Usage: bench_smv_encoder [<smv file>] [<repetitions>]
+**        Without a file, a large generated model with many module
+**        instances and case expressions is written to the temporary
+**        directory and loaded.
+**
+**/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "core/rts.h"
+#include "frontends/smv_encoder.h"
+#include "smt/available_solvers.h"
+#include "utils/timestamp.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+/** Writes an SMV model with a ring of cell instances, each with a
+ *  case expression that takes the value of its predecessor
+ */
+void generated_model(const string & filename, size_t num_cells)
+{
+  ofstream f(filename);
+  f << "MODULE cell(in, en)\n"
+    << "VAR\n"
+    << "  v : unsigned word[8];\n"
+    << "ASSIGN\n"
+    << "  init(v) := 0ud8_0;\n"
+    << "  next(v) := case\n"
+    << "    en & v < 0ud8_200 : in + 0ud8_1;\n"
+    << "    !en : v;\n"
+    << "    TRUE : 0ud8_0;\n"
+    << "  esac;\n\n";
+
+  f << "MODULE main\n"
+    << "IVAR\n"
+    << "  en : boolean;\n"
+    << "VAR\n";
+  for (size_t i = 0; i < num_cells; ++i) {
+    size_t prev = (i + num_cells - 1) % num_cells;
+    f << "  c" << i << " : cell(c" << prev << ".v, en);\n";
+  }
+  f << "INVARSPEC c0.v <= 0ud8_200;\n";
+}
+
+int main(int argc, char ** argv)
+{
+  size_t repetitions = 5;
+  string filename;
+  bool generated = true;
+  if (argc > 1) {
+    filename = argv[1];
+    generated = false;
+  }
+  if (argc > 2) {
+    repetitions = stoul(argv[2]);
+  }
+
+  if (generated) {
+    filename = string(P_tmpdir) + "/pono_bench_smv_encoder.smv";
+    const size_t num_cells = 5000;
+    generated_model(filename, num_cells);
+    cout << "generated model: " << filename << " (" << num_cells << " cells)"
+         << endl;
+  }
+
+  double total_time = 0;
+  size_t num_states = 0;
+  for (size_t i = 0; i < repetitions; ++i) {
+    // fresh solver, otherwise later repetitions reuse hash-consed terms
+    SmtSolver s = create_solver(BTOR);
+    s->set_opt("incremental", "true");
+    RelationalTransitionSystem rts(s);
+    auto begin = timestamp();
+    SMVEncoder smv_enc(filename, rts);
+    total_time += time_duration_to_sec(timestamp_diff(begin, timestamp()));
+    num_states = rts.statevars().size();
+  }
+
+  if (generated) {
+    remove(filename.c_str());
+  }
+
+  cout << "state variables: " << num_states << endl;
+  cout << "average load time: " << total_time / repetitions << " s over "
+       << repetitions << " repetitions" << endl;
+  return 0;
+}
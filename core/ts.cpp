@@ -485,6 +485,17 @@ void TransitionSystem::rebuild_trans_based_on_coi(
     const UnorderedTermSet & state_vars_in_coi,
     const UnorderedTermSet & input_vars_in_coi)
 {
+  // checked first so that the system is unchanged if it throws
+  UnorderedTermSet init_vars;
+  get_free_symbolic_consts(init_, init_vars);
+  for (const auto & v : init_vars) {
+    if (state_vars_in_coi.find(v) == state_vars_in_coi.end()) {
+      throw PonoException(
+          "Initial state constraints should only use state variables in the "
+          "cone-of-influence");
+    }
+  }
+
   /* Clear current transition relation 'trans_'. */
   trans_ = solver_->make_term(true);
 
@@ -509,18 +520,15 @@ void TransitionSystem::rebuild_trans_based_on_coi(
     add_constraint(e.first, e.second);
   }
 
-  statevars_.clear();
-  // Have to add any state variables in init back in
-  // this is because COI doesn't consider init and if
-  // we remove those state variables then the TS is
-  // ill-formed (e.g. init will contain unknown symbols)
-  // this shouldn't affect performance much, because
-  // variables in init that are not in the COI *only*
-  // appear in init
-  get_free_symbolic_consts(init_, statevars_);
-  for (const auto & var : state_vars_in_coi) {
-    statevars_.insert(var);
+  // remove the state variables outside of the COI
+  for (const auto & var : statevars_) {
+    if (state_vars_in_coi.find(var) == state_vars_in_coi.end()) {
+      next_statevars_.erase(next_map_.at(var));
+      curr_map_.erase(next_map_.at(var));
+      next_map_.erase(var);
+    }
   }
+  statevars_ = state_vars_in_coi;
 
   inputvars_.clear();
   for (const auto & var : input_vars_in_coi) {
@@ -747,6 +755,88 @@ void TransitionSystem::replace_terms(const UnorderedTermMap & to_replace)
   constraints_ = new_constraints;
 }
 
+void TransitionSystem::substitute_and_remove_statevars(
+    const UnorderedTermMap & subst)
+{
+  // the replacements may only use the remaining state variables
+  // otherwise the substitution could chain or cycle
+  for (const auto & elem : subst) {
+    if (!is_curr_var(elem.first)) {
+      throw PonoException(
+          "Expecting only state variables to be removed in "
+          "substitute_and_remove_statevars");
+    }
+    UnorderedTermSet free_vars;
+    get_free_symbolic_consts(elem.second, free_vars);
+    for (const auto & v : free_vars) {
+      if (!is_curr_var(v) || subst.find(v) != subst.end()) {
+        throw PonoException("Replacement of " + elem.first->to_string()
+                            + " must only use remaining state variables");
+      }
+    }
+  }
+
+  UnorderedTermMap to_replace;
+  for (const auto & elem : subst) {
+    to_replace[elem.first] = elem.second;
+    to_replace[next_map_.at(elem.first)] =
+        solver_->substitute(elem.second, next_map_);
+  }
+
+  // remove the state variables and their next-state functions
+  for (const auto & elem : subst) {
+    const Term & sv = elem.first;
+    Term nv = next_map_.at(sv);
+    statevars_.erase(sv);
+    next_statevars_.erase(nv);
+    state_updates_.erase(sv);
+    next_map_.erase(sv);
+    curr_map_.erase(nv);
+  }
+
+  SubstitutionWalker sw(solver_, to_replace);
+
+  init_ = sw.visit(init_);
+  trans_ = sw.visit(trans_);
+
+  unordered_map<string, Term> new_named_terms;
+  unordered_map<Term, string> new_term_to_name;
+  for (auto elem : named_terms_) {
+    new_named_terms[elem.first] = sw.visit(elem.second);
+    new_term_to_name[sw.visit(elem.second)] = term_to_name_.at(elem.second);
+  }
+  named_terms_ = new_named_terms;
+  term_to_name_ = new_term_to_name;
+
+  for (auto & elem : state_updates_) {
+    Term update = elem.second;
+    elem.second = sw.visit(update);
+  }
+
+  for (auto & e : constraints_) {
+    Term c = e.first;
+    e.first = sw.visit(c);
+  }
+
+  if (functional_) {
+    // drop the next-state functions of the removed state variables
+    trans_ = solver_->make_term(true);
+    for (const auto & elem : state_updates_) {
+      trans_ = solver_->make_term(
+          And,
+          trans_,
+          solver_->make_term(Equal, next_map_.at(elem.first), elem.second));
+    }
+    for (const auto & e : constraints_) {
+      trans_ = solver_->make_term(And, trans_, e.first);
+      if (e.second) {
+        trans_ = solver_->make_term(
+            And, trans_, solver_->substitute(e.first, next_map_));
+      }
+    }
+  }
+}
+
 bool TransitionSystem::known_symbols(const Term & term) const
 {
   return contains(
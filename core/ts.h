@@ -52,6 +52,9 @@ class TransitionSystem
 
   friend void swap(TransitionSystem & ts1, TransitionSystem & ts2);
 
+  // reads and writes all members (see utils/ts_snapshot.h)
+  friend class TSSnapshot;
+
   /** Copy assignment using
    *  copy-and-swap idiom
    */
@@ -335,6 +338,17 @@ class TransitionSystem
    */
   void replace_terms(const smt::UnorderedTermMap & to_replace);
 
+  /** EXPERTS ONLY
+   * Replace state variables (e.g. by a constant or an equivalent state
+   *  variable) and remove them from the system together with their
+   *  next-state function
+   *  The next state versions are replaced accordingly
+   *  Throws a PonoException if a replacement uses anything other than the
+   *    remaining state variables, i.e. the map must not chain or cycle
+   *  @param subst a mapping from state variables to their replacement
+   */
+  void substitute_and_remove_statevars(const smt::UnorderedTermMap & subst);
+
   // term building functionality -- forwards to the underlying SmtSolver
   // assumes all Terms/Sorts belong to solver_
   // e.g. should only use it on terms created by this TransitionSystem
@@ -472,7 +486,11 @@ class TransitionSystem
      set 'state_vars_in_coi' is computed in the 'Prover' class that
      checks a property related to this transition system. Also, update
      the set of state/input variables to the passed sets
-     'state_vars_in_coi' and 'input_vars_in_coi'. */
+     'state_vars_in_coi' and 'input_vars_in_coi'. The other state
+     variables are removed from the system.
+     Throws a PonoException, without modifying the system, if init
+     mentions a variable outside of 'state_vars_in_coi': init must be
+     reduced to the COI first (see StaticConeOfInfluence). */
   void rebuild_trans_based_on_coi(
       const smt::UnorderedTermSet & state_vars_in_coi,
       const smt::UnorderedTermSet & input_vars_in_coi);
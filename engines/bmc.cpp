@@ -15,7 +15,9 @@
  **/
 
 #include "bmc.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
+#include "utils/timestamp.h"
 
 using namespace smt;
 
@@ -29,6 +31,7 @@ Bmc::Bmc(const Property & p, const TransitionSystem & ts,
   bin_search_frames_ = 0;
   bound_step_ = opt.bmc_bound_step_;
   bound_start_ = opt.bmc_bound_start_;
+  max_adaptive_step_ = 1024;
 }
 
 Bmc::~Bmc() {}
@@ -65,19 +68,52 @@ ProverResult Bmc::check_until(int k)
 
   // Options 'bmc_exponential_step_' results in doubling the bound in every step
   const bool exp_step = options_.bmc_exponential_step_;
+  // Option 'bmc_adaptive_step_' results in adapting the step to the time
+  // spent in the previous step
+  const bool adaptive_step = options_.bmc_adaptive_step_;
+  unsigned int cur_step = bound_step_;
 
-  for (int i = bound_start_; i <= k;
-       i = exp_step ? (i == 0 ? 1 : i << 1) : (i + bound_step_)) {
+  for (int i = bound_start_; i <= k;) {
+    pono_time_stamp step_begin = timestamp();
     if (!step(i)) {
       compute_witness();
       return ProverResult::FALSE;
     }
+
+    if (exp_step) {
+      i = (i == 0 ? 1 : i << 1);
+    } else if (adaptive_step) {
+      double step_time =
+          time_duration_to_sec(timestamp_diff(step_begin, timestamp()));
+      cur_step = adapt_bound_step(cur_step, step_time);
+      logger.log(1, "BMC adaptive step: {} (last step took {} s)",
+                 cur_step, step_time);
+      // don't skip checking the final bound 'k'
+      i = (i < k && i + (int)cur_step > k) ? k : i + cur_step;
+    } else {
+      i += bound_step_;
+    }
   }
   return ProverResult::UNKNOWN;
 }
 
+unsigned int Bmc::adapt_bound_step(const unsigned int cur_step,
+                                   const double step_time) const
+{
+  const double target_time = options_.bmc_adaptive_target_time_;
+  if (step_time < target_time / 2 && cur_step < max_adaptive_step_) {
+    // fast step: cover a larger interval in the next step
+    return cur_step << 1;
+  } else if (step_time > target_time && cur_step > 1) {
+    // slow step: the disjunctive bad state clause is getting too large
+    return cur_step >> 1;
+  }
+  return cur_step;
+}
+
 bool Bmc::step(int i)
 {
+  ProfilePhase phase("bmc_step");
   logger.log(1, "\nBMC checking at bound: {}", i);
   
   if (i <= reached_k_) {
@@ -45,6 +45,12 @@ public:
   unsigned int bound_step_;
   // Used in binary search for cex: number of times we called 'solver->push()'
   unsigned int bin_search_frames_;
+  // Upper limit for the bound step when using adaptive bound steps
+  unsigned int max_adaptive_step_;
+  // Compute the next bound step for adaptive bound stepping based on the
+  // current step 'cur_step' and the time in seconds spent in the last step
+  unsigned int adapt_bound_step(const unsigned int cur_step,
+                                const double step_time) const;
   // Get an upper bound on the cex, which is located in interval '[lb,ub]'
   int bmc_interval_get_cex_ub(const int lb, const int ub);
   // Add negated bad state predicate for all bounds in interval '[start,end]'.
@@ -30,6 +30,7 @@
 #include "engines/kinduction.h"
 #include "engines/mbic3.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
 #include "utils/make_provers.h"
 #include "utils/term_analysis.h"
@@ -62,7 +63,9 @@ CegProphecyArrays<Prover_T>::CegProphecyArrays(const Property & p,
            super::options_.cegp_timed_axiom_red_),
       pm_(abs_ts_),
       reached_k_(-1),
-      num_added_axioms_(0)
+      num_added_axioms_(0),
+      num_axioms_(0),
+      num_refinements_(0)
 {
   // point orig_ts_ to the correct one
   super::orig_ts_ = ts;
@@ -127,6 +130,15 @@ ProverResult CegProphecyArrays<MsatIC3IA>::prove()
 }
 #endif
 
+template <class Prover_T>
+ProverStatistics CegProphecyArrays<Prover_T>::statistics() const
+{
+  ProverStatistics stats = super::statistics();
+  stats.counters["refinements"] = num_refinements_;
+  stats.counters["axioms"] = num_axioms_;
+  return stats;
+}
+
 template <class Prover_T>
 ProverResult CegProphecyArrays<Prover_T>::check_until(int k)
 {
@@ -280,6 +292,7 @@ void CegProphecyArrays<Prover_T>::cegar_abstract()
 template <class Prover_T>
 bool CegProphecyArrays<Prover_T>::cegar_refine()
 {
+  ProfilePhase phase("refine");
   num_added_axioms_ = 0;
   // TODO use ArrayAxiomEnumerator and modifiers to refine the system
   // create BMC formula
@@ -389,6 +402,8 @@ bool CegProphecyArrays<Prover_T>::cegar_refine()
   if (consecutive_axioms.size() > 0) {
     refine_ts(consecutive_axioms);
     num_added_axioms_ += consecutive_axioms.size();
+    num_axioms_ += consecutive_axioms.size();
+    num_refinements_++;
     logger.log(1, "CEGP: refine added {} axiom(s)", num_added_axioms_);
   }
 
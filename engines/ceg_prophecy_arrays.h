@@ -55,6 +55,9 @@ class CegProphecyArrays : public CEGAR<Prover_T>
     return reached_k_+1;
   }
 
+  /** Adds the number of refinements and added axioms */
+  ProverStatistics statistics() const override;
+
  protected:
   TransitionSystem conc_ts_;
   TransitionSystem & abs_ts_;
@@ -66,6 +69,8 @@ class CegProphecyArrays : public CEGAR<Prover_T>
   int reached_k_; ///< local variable to check the length of BMC refinement run
 
   size_t num_added_axioms_;  ///< set by refine to the number of added axioms
+  size_t num_axioms_;        ///< total number of added axioms
+  size_t num_refinements_;   ///< refinements that added axioms
 
   smt::UnorderedTermMap labels_;  ///< labels for unsat core minimization
 
@@ -0,0 +1,362 @@
+/*********************                                                        */
+/*! \file cegar_localization.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A CEGAR loop for localization abstraction: state variables
+**        outside the abstraction are treated as inputs and refinement
+**        makes more state variables visible
+**
+**/
+
+#include "engines/cegar_localization.h"
+
+#include "assert.h"
+#include "engines/bmc.h"
+#include "engines/ic3bits.h"
+#include "engines/ic3ia.h"
+#include "engines/ic3sa.h"
+#include "engines/kinduction.h"
+#include "engines/mbic3.h"
+#include "smt-switch/utils.h"
+#include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/make_provers.h"
+#include "utils/term_evaluator.h"
+#include "utils/ts_manipulation.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+template <class Prover_T>
+CegarLocalization<Prover_T>::CegarLocalization(const Property & p,
+                                               const TransitionSystem & ts,
+                                               const SmtSolver & solver,
+                                               PonoOptions opt)
+    : super(p, create_fresh_ts(true, solver), solver, opt),
+      conc_ts_(ts, super::to_prover_solver_),
+      abs_ts_(super::prover_interface_ts()),
+      cegloc_solver_(create_solver(solver->get_solver_enum())),
+      to_cegloc_solver_(cegloc_solver_),
+      from_cegloc_solver_(solver),
+      cegloc_ts_(conc_ts_, to_cegloc_solver_),
+      cegloc_un_(cegloc_ts_),
+      num_refinements_(0),
+      abs_cex_length_(0)
+{
+  if (!ts.is_functional()) {
+    throw PonoException(
+        "CegarLocalization requires a functional transition system");
+  }
+  // point orig_ts_ to the concrete system for witnesses
+  super::orig_ts_ = ts;
+  cegloc_solver_->set_opt("produce-unsat-assumptions", "true");
+}
+
+template <class Prover_T>
+ProverResult CegarLocalization<Prover_T>::check_until(int k)
+{
+  initialize();
+
+  while (true) {
+    logger.log(1,
+               "CegarLocalization: {} of {} state variables visible",
+               visible_.size(),
+               conc_ts_.statevars().size());
+
+    // the abstraction changes in every refinement, restart the engine
+    Property abs_prop(super::solver_,
+                      super::solver_->make_term(Not, super::bad_));
+    SmtSolver s = create_solver_for(super::solver_->get_solver_enum(),
+                                    super::engine_,
+                                    super::options_.logging_smt_solver_);
+    shared_ptr<Prover> prover =
+        make_prover(super::engine_, abs_prop, abs_ts_, s, super::options_);
+    ProverResult res = prover->check_until(k);
+    abs_stats_ = prover->statistics();
+
+    if (res == ProverResult::TRUE) {
+      // an invariant of the abstraction is one of the concrete system
+      try {
+        super::invar_ = prover->invar();
+      }
+      catch (std::exception & e) {
+        logger.log(1, "Failed to set invariant because {}", e.what());
+      }
+      return res;
+    } else if (res != ProverResult::FALSE) {
+      return res;
+    }
+
+    abs_cex_length_ = prover->witness_length();
+    abs_witness_.clear();
+    try {
+      if (!prover->witness(abs_witness_)
+          || abs_witness_.size() != abs_cex_length_ + 1) {
+        abs_witness_.clear();
+      }
+    }
+    catch (std::exception & e) {
+      // e.g. IC3 variants that do not produce witnesses
+      abs_witness_.clear();
+    }
+
+    if (!cegar_refine()) {
+      return super::witness_.empty() ? ProverResult::UNKNOWN
+                                     : ProverResult::FALSE;
+    }
+  }
+}
+
+template <class Prover_T>
+ProverStatistics CegarLocalization<Prover_T>::statistics() const
+{
+  ProverStatistics stats = abs_stats_;
+  stats.counters["refinements"] = num_refinements_;
+  stats.counters["visible_statevars"] = visible_.size();
+  return stats;
+}
+
+template <class Prover_T>
+void CegarLocalization<Prover_T>::initialize()
+{
+  if (super::initialized_) {
+    return;
+  }
+
+  // start with the state variables in the support of the property
+  UnorderedTermSet free_vars;
+  get_free_symbolic_consts(super::bad_, free_vars);
+  for (const auto & v : free_vars) {
+    if (conc_ts_.is_curr_var(v)) {
+      visible_.insert(v);
+    }
+  }
+
+  TermVec conjuncts;
+  conjunctive_partition(conc_ts_.init(), conjuncts, true);
+  for (const auto & c : conjuncts) {
+    UnorderedTermSet vars;
+    get_free_symbolic_consts(c, vars);
+    init_conjuncts_.push_back({ c, vars });
+  }
+
+  Sort boolsort = cegloc_solver_->make_sort(BOOL);
+  for (const auto & sv : conc_ts_.statevars()) {
+    cegloc_labels_[sv] = cegloc_solver_->make_symbol(
+        "__cegloc_assump_" + sv->to_string(), boolsort);
+  }
+  cegloc_bad_ = to_cegloc_solver_.transfer_term(super::bad_, BOOL);
+
+  // specify which cegar_abstract in case
+  // we're inheriting from another cegar algorithm
+  CegarLocalization::cegar_abstract();
+  super::initialize();
+}
+
+template <class Prover_T>
+void CegarLocalization<Prover_T>::cegar_abstract()
+{
+  const SmtSolver & solver = super::solver_;
+  TransitionSystem abs = create_fresh_ts(true, solver);
+  for (const auto & sv : conc_ts_.statevars()) {
+    if (visible_.find(sv) != visible_.end()) {
+      abs.add_statevar(sv, conc_ts_.next(sv));
+    } else {
+      abs.add_inputvar(sv);
+    }
+  }
+  for (const auto & iv : conc_ts_.inputvars()) {
+    abs.add_inputvar(iv);
+  }
+  for (const auto & elem : conc_ts_.state_updates()) {
+    if (visible_.find(elem.first) != visible_.end()) {
+      abs.assign_next(elem.first, elem.second);
+    }
+  }
+
+  // only the init conjuncts over visible state variables
+  Term init = solver->make_term(true);
+  for (const auto & elem : init_conjuncts_) {
+    bool all_visible = true;
+    for (const auto & v : elem.second) {
+      all_visible &= visible_.find(v) != visible_.end();
+    }
+    if (all_visible) {
+      init = solver->make_term(And, init, elem.first);
+    }
+  }
+  abs.set_init(init);
+
+  for (const auto & e : conc_ts_.constraints()) {
+    abs.add_constraint(e.first, e.second);
+  }
+
+  abs_ts_ = abs;
+}
+
+template <class Prover_T>
+bool CegarLocalization<Prover_T>::cegar_refine()
+{
+  ProfilePhase phase("refine");
+  const size_t len = abs_cex_length_;
+  auto label = [this](const Term & sv) {
+    return cegloc_labels_.at(sv);
+  };
+  auto is_visible = [this](const Term & sv) {
+    return visible_.find(sv) != visible_.end();
+  };
+
+  cegloc_solver_->push();
+
+  // init, invisible state variables are guarded by their labels
+  for (const auto & elem : init_conjuncts_) {
+    Term guard = cegloc_solver_->make_term(true);
+    for (const auto & v : elem.second) {
+      if (conc_ts_.is_curr_var(v) && !is_visible(v)) {
+        guard = cegloc_solver_->make_term(And, guard, label(v));
+      }
+    }
+    Term c = cegloc_un_.at_time(
+        to_cegloc_solver_.transfer_term(elem.first, BOOL), 0);
+    cegloc_solver_->assert_formula(
+        cegloc_solver_->make_term(Implies, guard, c));
+  }
+
+  // transitions, the same for the updates
+  for (size_t t = 0; t < len; ++t) {
+    for (const auto & elem : conc_ts_.state_updates()) {
+      Term sv = to_cegloc_solver_.transfer_term(elem.first);
+      Term upd = to_cegloc_solver_.transfer_term(elem.second);
+      Term eq = cegloc_solver_->make_term(Equal,
+                                          cegloc_un_.at_time(sv, t + 1),
+                                          cegloc_un_.at_time(upd, t));
+      if (!is_visible(elem.first)) {
+        eq = cegloc_solver_->make_term(Implies, label(elem.first), eq);
+      }
+      cegloc_solver_->assert_formula(eq);
+    }
+  }
+  for (const auto & e : cegloc_ts_.constraints()) {
+    for (size_t t = 0; t < len + (e.second ? 1 : 0); ++t) {
+      cegloc_solver_->assert_formula(cegloc_un_.at_time(e.first, t));
+    }
+  }
+  cegloc_solver_->assert_formula(cegloc_un_.at_time(cegloc_bad_, len));
+
+  TermVec assumps;
+  for (const auto & sv : conc_ts_.statevars()) {
+    if (!is_visible(sv)) {
+      assumps.push_back(label(sv));
+    }
+  }
+
+  Result r = cegloc_solver_->check_sat_assuming(assumps);
+  if (r.is_sat()) {
+    logger.log(1, "CegarLocalization: real counterexample of length {}", len);
+    compute_concrete_witness(len);
+    cegloc_solver_->pop();
+    return false;
+  }
+
+  UnorderedTermSet core;
+  if (!super::options_.ceg_loc_pba_ && !abs_witness_.empty()) {
+    // spurious trace analysis: restrict to the abstract trace
+    cegloc_solver_->push();
+    for (size_t t = 0; t <= len; ++t) {
+      for (const auto & elem : abs_witness_[t]) {
+        const Term & v = elem.first;
+        if (!conc_ts_.is_input_var(v) && !is_visible(v)) {
+          continue;
+        }
+        Term eq = cegloc_solver_->make_term(
+            Equal,
+            cegloc_un_.at_time(to_cegloc_solver_.transfer_term(v), t),
+            to_cegloc_solver_.transfer_term(elem.second));
+        cegloc_solver_->assert_formula(eq);
+      }
+    }
+    r = cegloc_solver_->check_sat_assuming(assumps);
+    assert(r.is_unsat());
+    cegloc_solver_->get_unsat_assumptions(core);
+    cegloc_solver_->pop();
+  } else {
+    cegloc_solver_->get_unsat_assumptions(core);
+  }
+  cegloc_solver_->pop();
+
+  size_t num_visible = visible_.size();
+  for (const auto & sv : conc_ts_.statevars()) {
+    if (!is_visible(sv) && core.find(label(sv)) != core.end()) {
+      logger.log(2, "CegarLocalization: making {} visible", sv);
+      visible_.insert(sv);
+    }
+  }
+
+  if (visible_.size() == num_visible) {
+    if (assumps.empty()) {
+      // only possible if the engine reported a different length
+      logger.log(1, "CegarLocalization: could not refine");
+      return false;
+    }
+    // empty core, fall back to the concrete system
+    for (const auto & sv : conc_ts_.statevars()) {
+      visible_.insert(sv);
+    }
+  }
+
+  cegar_abstract();
+  num_refinements_++;
+  return true;
+}
+
+template <class Prover_T>
+void CegarLocalization<Prover_T>::compute_concrete_witness(size_t len)
+{
+  super::witness_.clear();
+  for (size_t t = 0; t <= len; ++t) {
+    super::witness_.push_back(UnorderedTermMap());
+    UnorderedTermMap & map = super::witness_.back();
+    for (const auto & sv : conc_ts_.statevars()) {
+      Term v = cegloc_un_.at_time(to_cegloc_solver_.transfer_term(sv), t);
+      map[sv] = from_cegloc_solver_.transfer_term(cegloc_solver_->get_value(v));
+    }
+    for (const auto & iv : conc_ts_.inputvars()) {
+      Term v = cegloc_un_.at_time(to_cegloc_solver_.transfer_term(iv), t);
+      map[iv] = from_cegloc_solver_.transfer_term(cegloc_solver_->get_value(v));
+    }
+  }
+  // named terms that cannot be evaluated are taken from the model
+  for (const auto & elem : conc_ts_.named_terms()) {
+    const Term & nt = elem.second;
+    if (TermEvaluator::is_supported(nt) || !conc_ts_.no_next(nt)) {
+      continue;
+    }
+    Term cegloc_nt = to_cegloc_solver_.transfer_term(nt);
+    for (size_t t = 0; t <= len; ++t) {
+      Term val = cegloc_solver_->get_value(cegloc_un_.at_time(cegloc_nt, t));
+      super::witness_[t][nt] = from_cegloc_solver_.transfer_term(val);
+    }
+  }
+  evaluate_named_terms(conc_ts_, super::witness_);
+  super::reached_k_ = static_cast<int>(len) - 1;
+}
+
+template class CegarLocalization<Bmc>;
+template class CegarLocalization<KInduction>;
+template class CegarLocalization<ModelBasedIC3>;
+template class CegarLocalization<IC3Bits>;
+template class CegarLocalization<IC3IA>;
+template class CegarLocalization<IC3SA>;
+
+}  // namespace pono
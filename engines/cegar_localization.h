@@ -0,0 +1,106 @@
+/*********************                                                        */
+/*! \file cegar_localization.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A CEGAR loop for localization abstraction: state variables
+**        outside the abstraction are treated as inputs and refinement
+**        makes more state variables visible
+**
+**        The abstraction starts with the state variables in the support
+**        of the property. A counterexample of the abstract system is
+**        checked with BMC on the concrete system, where the update and
+**        initial state of each invisible state variable is guarded by a
+**        label. If it is spurious, the state variables with a label in
+**        the unsat core are made visible. By default the BMC query is
+**        restricted to the inputs and visible state variables of the
+**        abstract trace (when the engine provides one), with
+**        --ceg-loc-pba the core of the unrestricted query is used
+**        (proof-based abstraction).
+**
+**/
+
+#pragma once
+
+#include "core/unroller.h"
+#include "engines/cegar.h"
+
+namespace pono {
+
+template <class Prover_T>
+class CegarLocalization : public CEGAR<Prover_T>
+{
+  typedef CEGAR<Prover_T> super;
+
+ public:
+  CegarLocalization(const Property & p,
+                    const TransitionSystem & ts,
+                    const smt::SmtSolver & solver,
+                    PonoOptions opt = PonoOptions());
+
+  ProverResult check_until(int k) override;
+
+  void initialize() override;
+
+  /** The witness of the concrete system, regardless of the engine */
+  bool witness(std::vector<smt::UnorderedTermMap> & out) override
+  {
+    return Prover::witness(out);
+  }
+
+  size_t witness_length() const override { return super::reached_k_ + 1; }
+
+  /** The statistics of the last run on the abstraction with the number
+   *  of refinements and visible state variables
+   */
+  ProverStatistics statistics() const override;
+
+  /** @return the visible state variables of the concrete system */
+  const smt::UnorderedTermSet & visible() const { return visible_; }
+
+ protected:
+  TransitionSystem conc_ts_;
+  TransitionSystem & abs_ts_;
+
+  smt::UnorderedTermSet visible_;
+  ///< conjuncts of init with their state variables
+  std::vector<std::pair<smt::Term, smt::UnorderedTermSet>> init_conjuncts_;
+
+  // solver and associated infrastructure for
+  // unrolling based refinement
+  smt::SmtSolver cegloc_solver_;
+  smt::TermTranslator to_cegloc_solver_;
+  smt::TermTranslator from_cegloc_solver_;
+  TransitionSystem cegloc_ts_;
+  Unroller cegloc_un_;
+  smt::Term cegloc_bad_;
+
+  ///< labels for each state variable of the concrete system
+  smt::UnorderedTermMap cegloc_labels_;
+
+  size_t num_refinements_;
+  ProverStatistics abs_stats_;  ///< statistics of the last abstract run
+
+  size_t abs_cex_length_;  ///< the step of bad in the abstract witness
+  std::vector<smt::UnorderedTermMap> abs_witness_;  ///< empty if unknown
+
+  /** Rebuilds abs_ts_ from the visible state variables */
+  void cegar_abstract() override;
+
+  /** Checks the abstract counterexample on the concrete system
+   *  @return true iff it was spurious and state variables became visible
+   *  if it is real, populates witness_
+   */
+  bool cegar_refine() override;
+
+  /** Populates witness_ from the model of the refinement solver */
+  void compute_concrete_witness(size_t len);
+};
+
+}  // namespace pono
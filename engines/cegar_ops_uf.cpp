@@ -22,6 +22,7 @@
 #include "engines/ic3sa.h"
 #include "engines/ceg_prophecy_arrays.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/exceptions.h"
 #include "utils/logger.h"
 #include "utils/make_provers.h"
@@ -142,6 +143,7 @@ void CegarOpsUf<Prover_T>::cegar_abstract()
 template <class Prover_T>
 bool CegarOpsUf<Prover_T>::cegar_refine()
 {
+  ProfilePhase phase("refine");
   const UnorderedTermMap & abs_terms = oa_.abstract_terms();
   if (abs_terms.size() == 0) {
     return false;
@@ -280,9 +282,7 @@ void CegarOpsUf<IC3SA>::refine_subprover_ts(const UnorderedTermSet & axioms,
     RelationalTransitionSystem & ts =
         static_cast<RelationalTransitionSystem &>(super::ts_);
     if (ts.only_curr(ta) && !skip_init) {
-      ts.constrain_init(ta);
-      super::solver_->assert_formula(
-          solver_->make_term(Implies, super::init_label_, ta));
+      super::constrain_init(ta);
     }
 
     ts.constrain_trans(ta);
@@ -25,6 +25,7 @@
 #include "math.h"
 #include "smt-switch/identity_walker.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/exceptions.h"
 #include "utils/logger.h"
 #include "utils/make_provers.h"
@@ -311,6 +312,7 @@ void CegarValues<Prover_T>::cegar_abstract()
 template <class Prover_T>
 bool CegarValues<Prover_T>::cegar_refine()
 {
+  ProfilePhase phase("refine");
   size_t cex_length = super::witness_length();
 
   // create bmc formula for abstract system
@@ -19,6 +19,7 @@
 
 #include "assert.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
 #include "utils/term_analysis.h"
 
@@ -87,6 +88,99 @@ void ProofGoalQueue::pop() { queue_.pop(); }
 
 bool ProofGoalQueue::empty() const { return queue_.empty(); }
 
+/** InitIntersectionCache */
+
+void InitIntersectionCache::CubeStore::add(const TermVec & cube)
+{
+  size_t id = cubes.size();
+  cubes.push_back(UnorderedTermSet(cube.begin(), cube.end()));
+  for (const auto & l : cubes.back()) {
+    occurrences[l].push_back(id);
+  }
+}
+
+bool InitIntersectionCache::CubeStore::has_subset(const TermVec & cube) const
+{
+  // count the literals of each stored cube that occur in cube
+  unordered_map<size_t, size_t> counts;
+  UnorderedTermSet seen;
+  for (const auto & l : cube) {
+    auto it = occurrences.find(l);
+    if (it == occurrences.end() || !seen.insert(l).second) {
+      continue;
+    }
+    for (auto id : it->second) {
+      if (++counts[id] == cubes[id].size()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool InitIntersectionCache::CubeStore::has_superset(const TermVec & cube) const
+{
+  if (cube.empty()) {
+    return !cubes.empty();
+  }
+
+  // only the stored cubes containing the rarest literal are candidates
+  const vector<size_t> * candidates = nullptr;
+  for (const auto & l : cube) {
+    auto it = occurrences.find(l);
+    if (it == occurrences.end()) {
+      return false;
+    }
+    if (!candidates || it->second.size() < candidates->size()) {
+      candidates = &it->second;
+    }
+  }
+
+  for (auto id : *candidates) {
+    const UnorderedTermSet & stored = cubes[id];
+    bool contains_all = true;
+    for (const auto & l : cube) {
+      if (stored.find(l) == stored.end()) {
+        contains_all = false;
+        break;
+      }
+    }
+    if (contains_all) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool InitIntersectionCache::lookup(const TermVec & cube, bool & intersects)
+{
+  num_queries_++;
+  if (non_intersecting_.has_subset(cube)) {
+    intersects = false;
+  } else if (intersecting_.has_superset(cube)) {
+    intersects = true;
+  } else {
+    return false;
+  }
+  num_hits_++;
+  return true;
+}
+
+void InitIntersectionCache::add(const TermVec & cube, bool intersects)
+{
+  if (intersects) {
+    intersecting_.add(cube);
+  } else {
+    non_intersecting_.add(cube);
+  }
+}
+
+void InitIntersectionCache::clear()
+{
+  intersecting_ = CubeStore();
+  non_intersecting_ = CubeStore();
+}
+
 /** IC3Base */
 
 IC3Base::IC3Base(const Property & p,
@@ -98,6 +192,12 @@ IC3Base::IC3Base(const Property & p,
           s->get_solver_enum(), Engine::IC3IA_ENGINE, opt.logging_smt_solver_)),
       solver_context_(0),
       num_check_sat_since_reset_(0),
+      num_check_sat_(0),
+      num_proof_goals_(0),
+      num_refinements_(0),
+      init_is_cube_(false),
+      init_evaluator_(s),
+      num_init_syntactic_(0),
       failed_to_reset_solver_(false),
       approx_pregen_(false)
 {
@@ -123,8 +223,18 @@ void IC3Base::initialize()
   // check whether this flavor of IC3 can be applied to this transition system
   check_ts();
 
+  detect_init_cube();
+
   assert(solver_context_ == 0);  // expecting to be at base context level
 
+  // must be mined before anything is asserted at the base level
+  TermVec invs = mine_invariants();
+  for (const auto & inv : given_invariants_) {
+    invs.push_back(orig_ts_.solver() == solver_
+                       ? inv
+                       : to_prover_solver_.transfer_term(inv, BOOL));
+  }
+
   frames_.clear();
   frame_labels_.clear();
   // first frame is always the initial states
@@ -148,6 +258,24 @@ void IC3Base::initialize()
 
   bad_label_ = solver_->make_symbol("__bad_label", boolsort_);
   solver_->assert_formula(solver_->make_term(Implies, bad_label_, bad_));
+
+  // seed the first frame with the invariants that are valid
+  // lemmas for this flavor of IC3, they are inductive and propagate
+  size_t num_lemmas = 0;
+  TermVec disjuncts;
+  for (const auto & inv : invs) {
+    disjuncts.clear();
+    disjunctive_partition(inv, disjuncts);
+    IC3Formula lemma = ic3formula_disjunction(disjuncts);
+    if (ic3formula_check_valid(lemma)) {
+      constrain_frame(1, lemma);
+      ++num_lemmas;
+    }
+  }
+  if (!invs.empty()) {
+    logger.log(1, "Added {} of {} invariants to F[1]", num_lemmas,
+               invs.size());
+  }
 }
 
 ProverResult IC3Base::check_until(int k)
@@ -170,6 +298,7 @@ ProverResult IC3Base::check_until(int k)
       assert(cex_.size());
       RefineResult s = refine();
       if (s == REFINE_SUCCESS) {
+        num_refinements_++;
         continue;
       } else if (s == REFINE_NONE) {
         // this is a real counterexample
@@ -192,6 +321,23 @@ ProverResult IC3Base::check_until(int k)
   return ProverResult::UNKNOWN;
 }
 
+void IC3Base::add_invariants(const TermVec & invs)
+{
+  assert(!initialized_);
+  given_invariants_.insert(given_invariants_.end(), invs.begin(), invs.end());
+}
+
+TermVec IC3Base::lemmas()
+{
+  TermVec res;
+  for (size_t i = 1; i < frames_.size(); ++i) {
+    for (const auto & lemma : frames_[i]) {
+      res.push_back(to_orig_ts(lemma.term, BOOL));
+    }
+  }
+  return res;
+}
+
 bool IC3Base::witness(std::vector<smt::UnorderedTermMap> & out)
 {
   throw PonoException("IC3 witness NYI");
@@ -204,6 +350,25 @@ size_t IC3Base::witness_length() const
   return cex_.size() - 1;
 }
 
+ProverStatistics IC3Base::statistics() const
+{
+  ProverStatistics stats = super::statistics();
+  stats.counters["frames"] = frames_.size();
+  size_t num_lemmas = 0;
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    stats.counters["lemmas_frame_" + std::to_string(i)] = frames_[i].size();
+    num_lemmas += frames_[i].size();
+  }
+  stats.counters["lemmas"] = num_lemmas;
+  stats.counters["proof_goals"] = num_proof_goals_;
+  stats.counters["sat_checks"] = num_check_sat_;
+  stats.counters["refinements"] = num_refinements_;
+  stats.counters["init_cache_queries"] = init_cache_.num_queries();
+  stats.counters["init_cache_hits"] = init_cache_.num_hits();
+  stats.counters["init_syntactic_checks"] = num_init_syntactic_;
+  return stats;
+}
+
 // Protected Methods
 
 IC3Formula IC3Base::ic3formula_disjunction(const TermVec & c) const
@@ -255,6 +420,7 @@ IC3Formula IC3Base::ic3formula_negate(const IC3Formula & u) const
 
 IC3Formula IC3Base::inductive_generalization(size_t i, const IC3Formula & c)
 {
+  ProfilePhase phase("inductive_generalization");
   assert(!solver_context_);
   assert(i <= frontier_idx());
   assert(!c.disjunction);  // expecting a cube
@@ -296,7 +462,7 @@ IC3Formula IC3Base::inductive_generalization(size_t i, const IC3Formula & c)
     //       and instead only doing it for subsumption checks
     gen = ic3formula_conjunction(gen.children);
 
-    if (!check_intersects_initial(gen.term)
+    if (!check_intersects_initial(gen)
         && rel_ind_check(i, gen, out, false)) {
       // we can drop this literal
 
@@ -324,7 +490,7 @@ IC3Formula IC3Base::inductive_generalization(size_t i, const IC3Formula & c)
   // reconstruct the IC3Formula -- need to make sure term is valid
   // since we've been modifying gen.children
   gen = ic3formula_conjunction(gen.children);
-  assert(!check_intersects_initial(gen.term));
+  assert(!check_intersects_initial(gen));
   IC3Formula block = ic3formula_negate(gen);
   assert(block.disjunction);
   return block;
@@ -340,6 +506,7 @@ void IC3Base::predecessor_generalization(size_t i,
 
 bool IC3Base::reaches_bad(IC3Formula & out)
 {
+  ProfilePhase phase("reaches_bad");
   push_solver_context();
   // assert the last frame (conjunction over clauses)
   assert_frame_labels(frontier_idx());
@@ -463,6 +630,7 @@ bool IC3Base::rel_ind_check(size_t i,
                             IC3Formula & out,
                             bool get_pred)
 {
+  ProfilePhase phase("rel_ind_check");
   assert(i > 0);
   assert(i < frames_.size());
   // expecting to be the polarity for proof goals, not frames
@@ -554,7 +722,7 @@ bool IC3Base::rel_ind_check(size_t i,
 
     // this check needs to be here after the solver context has been popped
     // if i == 1 and there's a predecessor, then it should be an initial state
-    assert(i != 1 || check_intersects_initial(out.term));
+    assert(i != 1 || check_intersects_initial(out));
 
     // should never intersect with a frame before F[i-1]
     // otherwise, this predecessor should have been found
@@ -580,6 +748,7 @@ bool IC3Base::block_all()
 
     while (!proof_goals.empty()) {
       const ProofGoal * pg = proof_goals.top();
+      num_proof_goals_++;
 
       if (!pg->idx) {
         // went all the way back to initial
@@ -680,6 +849,7 @@ bool IC3Base::is_blocked(const ProofGoal * pg)
 
 bool IC3Base::propagate(size_t i)
 {
+  ProfilePhase phase("propagate");
   assert(!solver_context_);
   assert(i < frontier_idx());
 
@@ -872,12 +1042,67 @@ bool IC3Base::check_intersects_initial(const Term & t)
   return check_intersects(init_label_, t);
 }
 
+bool IC3Base::check_intersects_initial(const IC3Formula & c)
+{
+  assert(!c.disjunction);
+
+  // with a cube init only the literals that cannot be evaluated
+  // syntactically need the solver
+  TermVec rest;
+  if (init_is_cube_) {
+    if (!check_init_cube_literals(c.children, rest)) {
+      num_init_syntactic_++;
+      return false;
+    } else if (rest.empty()) {
+      num_init_syntactic_++;
+      return true;
+    }
+  }
+  const TermVec & lits = init_is_cube_ ? rest : c.children;
+
+  if (!options_.ic3_init_cache_) {
+    return check_intersects_initial(init_is_cube_ ? make_and(rest) : c.term);
+  }
+
+  bool intersects;
+  if (!init_cache_.lookup(lits, intersects)) {
+    intersects =
+        check_intersects_initial(init_is_cube_ ? make_and(rest) : c.term);
+    init_cache_.add(lits, intersects);
+  }
+  return intersects;
+}
+
 void IC3Base::fix_if_intersects_initial(TermVec & to_keep, const TermVec & rem)
 {
   // TODO: there's a tricky issue here. The reducer doesn't have the label
   // assumptions so we can't use init_label_ here. need to come up with a
   // better interface. Should we add label assumptions to reducer?
   if (rem.size() != 0) {
+    TermVec rest;
+    if (init_is_cube_) {
+      // pick one literal that conflicts with init, if there is one
+      if (!check_init_cube_literals(to_keep, rest)) {
+        num_init_syntactic_++;
+        return;
+      }
+      for (const auto & l : rem) {
+        rest.clear();
+        if (!check_init_cube_literals({ l }, rest)) {
+          num_init_syntactic_++;
+          to_keep.push_back(l);
+          return;
+        }
+      }
+    }
+
+    bool intersects;
+    if (options_.ic3_init_cache_ && init_cache_.lookup(to_keep, intersects)
+        && !intersects) {
+      // nothing needs to be added back
+      return;
+    }
+
     Term formula = solver_->make_term(And, ts_.init(), make_and(to_keep));
 
     bool success = reducer_.reduce_assump_unsatcore(formula,
@@ -887,7 +1112,87 @@ void IC3Base::fix_if_intersects_initial(TermVec & to_keep, const TermVec & rem)
                                                     options_.ic3_gen_max_iter_,
                                                     options_.random_seed_);
     assert(success);
+    if (options_.ic3_init_cache_) {
+      init_cache_.add(to_keep, false);
+    }
+  }
+}
+
+void IC3Base::constrain_init(const Term & constraint)
+{
+  assert(init_label_);
+  ts_.constrain_init(constraint);
+  solver_->assert_formula(
+      solver_->make_term(Implies, init_label_, constraint));
+  init_cache_.clear();
+  detect_init_cube();
+}
+
+void IC3Base::detect_init_cube()
+{
+  init_is_cube_ = false;
+
+  Term solver_false = solver_->make_term(false);
+  UnorderedTermMap values;
+  TermVec conjuncts;
+  conjunctive_partition(ts_.init(), conjuncts, true);
+  for (const auto & c : conjuncts) {
+    Term var, val;
+    PrimOp po = c->get_op().prim_op;
+    if (ts_.is_curr_var(c)) {
+      var = c;
+      val = solver_true_;
+    } else if (po == Not && ts_.is_curr_var(*c->begin())) {
+      var = *c->begin();
+      val = solver_false;
+    } else if (po == Equal) {
+      TermVec children(c->begin(), c->end());
+      assert(children.size() == 2);
+      if (children[1]->is_value()) {
+        std::swap(children[0], children[1]);
+      }
+      if (children[0]->is_value() && ts_.is_curr_var(children[1])) {
+        var = children[1];
+        val = children[0];
+      }
+    }
+
+    if (!var) {
+      logger.log(2, "IC3Base: initial states are not a cube");
+      return;
+    }
+    auto it = values.find(var);
+    if (it != values.end() && it->second != val) {
+      // conflicting values are left to the solver
+      return;
+    }
+    values[var] = val;
+  }
+
+  if (values.empty()) {
+    return;
   }
+  init_is_cube_ = true;
+  init_evaluator_.set_assignment(values);
+  logger.log(2,
+             "IC3Base: initial states are a cube over {} of {} state "
+             "variables",
+             values.size(),
+             ts_.statevars().size());
+}
+
+bool IC3Base::check_init_cube_literals(const TermVec & cube, TermVec & rest)
+{
+  assert(init_is_cube_);
+  mpz_class val;
+  for (const auto & l : cube) {
+    if (!init_evaluator_.evaluate(l, val)) {
+      rest.push_back(l);
+    } else if (val == 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 size_t IC3Base::find_highest_frame(size_t i, IC3Formula & u)
@@ -946,7 +1251,7 @@ void IC3Base::reconstruct_trace(const ProofGoal * pg, TermVec & out)
   assert(!solver_context_);
   assert(pg);
   assert(pg->target.term);
-  assert(check_intersects_initial(pg->target.term));
+  assert(check_intersects_initial(pg->target));
 
   out.clear();
   while (pg) {
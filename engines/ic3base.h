@@ -65,9 +65,11 @@
 
 #include <algorithm>
 #include <queue>
+#include <unordered_map>
 
 #include "engines/prover.h"
 #include "smt-switch/utils.h"
+#include "utils/term_evaluator.h"
 
 namespace pono {
 
@@ -153,6 +155,56 @@ class ProofGoalQueue
   std::vector<ProofGoal *> store_;
 };
 
+/**
+ * Cache for checks of whether a cube intersects the initial states
+ * Intersection with init is monotone in the literals of a cube: if a cube
+ * does not intersect init, neither does any cube with more literals, and
+ * if it does, so does any cube with fewer literals. Queries are answered
+ * by subsumption against the cubes that were checked before.
+ * Only valid as long as the initial states do not change, it is cleared
+ * by IC3Base::constrain_init.
+ */
+class InitIntersectionCache
+{
+ public:
+  InitIntersectionCache() : num_queries_(0), num_hits_(0) {}
+
+  /** Looks up whether a cube intersects the initial states
+   *  @param cube the literals of the cube
+   *  @param intersects set to the answer if it is known
+   *  @return true iff the answer is known by subsumption
+   */
+  bool lookup(const smt::TermVec & cube, bool & intersects);
+
+  /** Records whether a cube intersects the initial states */
+  void add(const smt::TermVec & cube, bool intersects);
+
+  /** Forgets all cubes, e.g. after the initial states changed */
+  void clear();
+
+  size_t num_queries() const { return num_queries_; }
+  size_t num_hits() const { return num_hits_; }
+
+ private:
+  /** Cubes indexed by their literals */
+  struct CubeStore
+  {
+    std::vector<smt::UnorderedTermSet> cubes;
+    std::unordered_map<smt::Term, std::vector<size_t>> occurrences;
+
+    void add(const smt::TermVec & cube);
+    /** @return true iff a stored cube is a subset of cube */
+    bool has_subset(const smt::TermVec & cube) const;
+    /** @return true iff a stored cube is a superset of cube */
+    bool has_superset(const smt::TermVec & cube) const;
+  };
+
+  CubeStore intersecting_;
+  CubeStore non_intersecting_;
+  size_t num_queries_;
+  size_t num_hits_;
+};
+
 class IC3Base : public Prover
 {
  public:
@@ -177,10 +229,39 @@ class IC3Base : public Prover
 
   size_t witness_length() const override;
 
+  /** Adds frames, lemmas per frame, proof goals, satisfiability checks
+   *  and refinements
+   */
+  ProverStatistics statistics() const override;
+
+  /** Adds invariants of the transition system, e.g. learned by a
+   *  previous run on the same system, which are used to seed the first
+   *  frame like mined invariants
+   *  must be called before initialize
+   *  @param invs inductive invariants over current state variables
+   *         using the solver of the original transition system
+   */
+  void add_invariants(const smt::TermVec & invs);
+
+  /** Returns the lemmas of all frames except the initial states
+   *  these are only guaranteed to hold in the states reachable
+   *  without violating the property within the frame index
+   *  @return the lemmas using the solver of the original transition system
+   */
+  smt::TermVec lemmas();
+
  protected:
 
   smt::UnsatCoreReducer reducer_;
 
+  InitIntersectionCache init_cache_;  ///< see check_intersects_initial
+
+  ///< true iff the initial states are a cube of state variable values
+  ///< then init_evaluator_ is assigned these values
+  bool init_is_cube_;
+  TermEvaluator init_evaluator_;
+  size_t num_init_syntactic_;  ///< init checks answered syntactically
+
   ///< keeps track of the current context-level of the solver
   // NOTE: if solver is passed in, it could be off
   //       currently no way to check
@@ -189,12 +270,20 @@ class IC3Base : public Prover
 
   size_t num_check_sat_since_reset_;
 
+  // statistics
+  size_t num_check_sat_;
+  size_t num_proof_goals_;
+  size_t num_refinements_;
+
   bool failed_to_reset_solver_;  ///< some solvers don't support reset
                                  ///< assertions. Stop trying for those solvers.
 
   smt::TermVec cex_;  ///< a vector of terms over state variables describing
                       ///< a (possibly abstract) counterexample trace
 
+  smt::TermVec given_invariants_;  ///< see add_invariants, in the solver of
+                                   ///< the original transition system
+
   bool approx_pregen_;  ///< if set to true then predecessor generalization
                         ///< might over-generalize leading to intersection
                         ///< with F[i-2]
@@ -494,9 +583,44 @@ class IC3Base : public Prover
    */
   bool check_intersects_initial(const smt::Term & t);
 
+  /** Check if a cube intersects with the initial states
+   *  answered by init_cache_ if possible (see --no-ic3-init-cache)
+   *  @param c the cube to check
+   *  @return true iff c intersects with the initial states
+   */
+  bool check_intersects_initial(const IC3Formula & c);
+
   void fix_if_intersects_initial(smt::TermVec & to_keep,
                                  const smt::TermVec & rem);
 
+  /** Adds a constraint to the initial states of ts_ and to the solver
+   *  (under init_label_), e.g. for a CEGAR refinement
+   *  Clears init_cache_ and detects the init cube again, both assume
+   *  fixed initial states
+   *  @param constraint a constraint over current state variables
+   *  @requires the prover is initialized
+   */
+  void constrain_init(const smt::Term & constraint);
+
+  /** Sets init_is_cube_ if the initial states are a conjunction of
+   *  literals v, (not v) or (= v value) over state variables and
+   *  assigns these values in init_evaluator_
+   *  called again by constrain_init when the initial states change
+   */
+  void detect_init_cube();
+
+  /** Syntactic check of a cube against initial states that are a cube
+   *  the literals that evaluate to true under the initial values are
+   *  implied by init, the others cannot be evaluated, e.g. because they
+   *  contain uninitialized state variables
+   *  @param cube the literals of the cube
+   *  @param rest populated with the literals that cannot be evaluated
+   *  @return false iff a literal evaluates to false, i.e. the cube
+   *          does not intersect the initial states
+   */
+  bool check_init_cube_literals(const smt::TermVec & cube,
+                                smt::TermVec & rest);
+
   /** Returns the highest frame this unit can be pushed to
    *  @param i the starting frame index
    *  @param u the IC3Formula to check how far it can be pushed
@@ -561,12 +685,14 @@ class IC3Base : public Prover
   inline smt::Result check_sat()
   {
     num_check_sat_since_reset_++;
+    num_check_sat_++;
     return solver_->check_sat();
   }
 
   inline smt::Result check_sat_assuming(const smt::TermVec & assumps)
   {
     num_check_sat_since_reset_++;
+    num_check_sat_++;
     return solver_->check_sat_assuming(assumps);
   }
 
@@ -32,6 +32,7 @@
 #include <random>
 
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
 #include "utils/term_analysis.h"
 
@@ -132,6 +133,13 @@ void IC3IA::check_ts() const
   // exception better than maintaining in two places
 }
 
+ProverStatistics IC3IA::statistics() const
+{
+  ProverStatistics stats = super::statistics();
+  stats.counters["predicates"] = predset_.size();
+  return stats;
+}
+
 void IC3IA::initialize()
 {
   if (initialized_) {
@@ -229,6 +237,7 @@ void IC3IA::abstract()
 
 RefineResult IC3IA::refine()
 {
+  ProfilePhase phase("refine");
   // counterexample trace should have been populated
   assert(cex_.size());
   if (cex_.size() == 1) {
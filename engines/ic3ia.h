@@ -51,6 +51,9 @@ class IC3IA : public IC3
 
   void add_important_var(smt::Term v);
 
+  /** Adds the number of predicates */
+  ProverStatistics statistics() const override;
+
  protected:
   // Note: important that conc_ts_ and abs_ts_ are before ia_
   //       because we will pass them to ia_ and they must be
@@ -28,6 +28,7 @@
 #include "core/rts.h"
 #include "smt-switch/utils.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
 #include "utils/term_analysis.h"
 #include "utils/term_walkers.h"
@@ -233,6 +234,7 @@ void IC3SA::abstract()
 
 RefineResult IC3SA::refine()
 {
+  ProfilePhase phase("refine");
   assert(!solver_context_);
   logger.log(1, "IC3SA: refining a counterexample of length {}", cex_.size());
 
@@ -589,6 +591,13 @@ void IC3SA::conjunctive_assumptions(const Term & term,
   }
 }
 
+ProverStatistics IC3SA::statistics() const
+{
+  ProverStatistics stats = super::statistics();
+  stats.counters["predicates"] = predset_.size();
+  return stats;
+}
+
 void IC3SA::initialize()
 {
   super::initialize();
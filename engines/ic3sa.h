@@ -47,6 +47,9 @@ class IC3SA : public IC3
 
   typedef IC3 super;
 
+  /** Adds the number of predicates */
+  ProverStatistics statistics() const override;
+
  protected:
   TransitionSystem conc_ts_;
 
@@ -15,6 +15,7 @@
  **/
 
 #include "kinduction.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
 
 using namespace smt;
@@ -48,6 +49,18 @@ void KInduction::initialize()
   init0_ = unroller_.at_time(ts_.init(), 0);
   false_ = solver_->make_term(false);
 
+  // invariants hold in all reachable states and strengthen both the
+  // base and the inductive case
+  mined_invar_ = nullptr;
+  TermVec invs = mine_invariants();
+  if (!invs.empty()) {
+    mined_invar_ = invs[0];
+    for (size_t i = 1; i < invs.size(); ++i) {
+      mined_invar_ = solver_->make_term(And, mined_invar_, invs[i]);
+    }
+    solver_->assert_formula(unroller_.at_time(mined_invar_, 0));
+  }
+
   // selector literal to toggle initial state predicate
   Sort boolsort = solver_->make_sort(smt::BOOL);
   sel_init_ = solver_->make_symbol("sel_init", boolsort);
@@ -114,6 +127,7 @@ ProverResult KInduction::check_until(int k)
   
   Result res;
   for (int i = reached_k_ + 1; i <= k; i += bound_step_) {
+    ProfilePhase phase("kind_step");
 
     logger.log(1, "");
     kind_log_msg(1, "", "current unrolling depth/bound: {}", i);
@@ -247,6 +261,9 @@ ProverResult KInduction::check_until(int k)
       // states) because we proved in base check that it is implied when
       // assuming initial state predicate
       solver_->assert_formula(unroller_.at_time(ts_.trans(), j));
+      if (mined_invar_) {
+        solver_->assert_formula(unroller_.at_time(mined_invar_, j + 1));
+      }
       // add negated bad state term using selector term as part of disjunction
       Term disj = solver_->make_term(PrimOp::Or, sel_neg_bad_state_terms_,
 				     unroller_.at_time(solver_->make_term(Not, bad_), j));
@@ -42,6 +42,9 @@ class KInduction : public Prover
 
   smt::Term init0_;
   smt::Term false_;
+  // conjunction of the mined invariants (see Prover::mine_invariants),
+  // asserted at every unrolled time step, or nullptr if there are none
+  smt::Term mined_invar_;
 
   // selector term used to toggle addition of
   // initial state predicate 'init0_'. We add a term '(sel_init_ OR init0_)'
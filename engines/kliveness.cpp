@@ -0,0 +1,129 @@
+/*********************                                                        */
+/*! \file kliveness.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief K-liveness (Claessen, Sorensson) for proving that a property
+**        eventually holds forever (FG p).
+**
+**/
+
+#include "engines/kliveness.h"
+
+#include "engines/ic3base.h"
+#include "smt/available_solvers.h"
+#include "utils/invariant_miner.h"
+#include "utils/logger.h"
+#include "utils/make_provers.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+// width of the counter, the bound is never close to overflowing it
+static const size_t COUNTER_WIDTH = 32;
+
+KLiveness::KLiveness(const Property & p,
+                     const TransitionSystem & ts,
+                     const SmtSolver & solver,
+                     PonoOptions opt)
+    : super(p, ts, solver, opt), counter_ts_(ts_), count_bound_(0)
+{
+  engine_ = Engine::KLIVE;
+}
+
+KLiveness::~KLiveness() {}
+
+void KLiveness::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  // bad_ is true at the steps where the property does not hold
+  Sort sort = counter_ts_.make_sort(BV, COUNTER_WIDTH);
+  count_ = counter_ts_.make_statevar("_klive_count", sort);
+  counter_ts_.constrain_init(
+      counter_ts_.make_term(Equal, count_, counter_ts_.make_term(0, sort)));
+  counter_ts_.assign_next(
+      count_,
+      counter_ts_.make_term(
+          Ite,
+          bad_,
+          counter_ts_.make_term(BVAdd, count_, counter_ts_.make_term(1, sort)),
+          count_));
+
+  count_bound_ = 0;
+  invariants_.clear();
+}
+
+ProverResult KLiveness::check_until(int k)
+{
+  initialize();
+
+  while (count_bound_ <= k) {
+    logger.log(1,
+               "KLiveness: checking that the property is violated at most {} "
+               "times",
+               count_bound_);
+    Term bounded = counter_ts_.make_term(
+        BVUle, count_, counter_ts_.make_term(count_bound_, count_->get_sort()));
+    Property p(solver_, bounded);
+
+    // the IC3 variants assert at the base level of their solver
+    Engine e = options_.klive_engine_;
+    SmtSolver s = create_solver_for(
+        solver_->get_solver_enum(), e, options_.logging_smt_solver_);
+    shared_ptr<Prover> prover = make_prover(e, p, counter_ts_, s, options_);
+    shared_ptr<IC3Base> ic3 = dynamic_pointer_cast<IC3Base>(prover);
+    if (ic3) {
+      ic3->add_invariants(invariants_);
+    }
+
+    ProverResult r = prover->check_until(k);
+    if (r == ProverResult::TRUE) {
+      logger.log(1,
+                 "KLiveness: the property is violated at most {} times",
+                 count_bound_);
+      return ProverResult::TRUE;
+    } else if (r != ProverResult::FALSE) {
+      return r;
+    }
+
+    if (ic3) {
+      reuse_lemmas(*ic3);
+    }
+    ++count_bound_;
+  }
+
+  return ProverResult::UNKNOWN;
+}
+
+void KLiveness::reuse_lemmas(IC3Base & ic3)
+{
+  // the lemmas are only known to hold on paths satisfying the
+  // previous bound, keep those that are invariants of the system
+  TermVec candidates = invariants_;
+  UnorderedTermSet known(invariants_.begin(), invariants_.end());
+  for (const auto & lemma : ic3.lemmas()) {
+    if (known.insert(lemma).second) {
+      candidates.push_back(lemma);
+    }
+  }
+  invariants_ = inductive_subset(counter_ts_, candidates);
+  logger.log(1,
+             "KLiveness: reusing {} of {} lemmas as invariants",
+             invariants_.size(),
+             candidates.size());
+}
+
+}  // namespace pono
@@ -0,0 +1,68 @@
+/*********************                                                        */
+/*! \file kliveness.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief K-liveness (Claessen, Sorensson) for proving that a property
+**        eventually holds forever (FG p), e.g. p is the negation of a
+**        justice signal (see modifiers/liveness_to_safety.h).
+**
+**        A counter of the steps where p does not hold is added to the
+**        system and an IC3 variant checks that the counter never
+**        exceeds k for increasing k. If this holds for some k, the
+**        property holds. The lemmas of a failed run that are invariants
+**        of the system with the counter seed the run for the next k.
+**
+**        This engine is incomplete: it can only prove a property, it
+**        never finds a counterexample.
+**
+**/
+
+#pragma once
+
+#include "engines/prover.h"
+
+namespace pono {
+
+class IC3Base;
+
+class KLiveness : public Prover
+{
+ public:
+  KLiveness(const Property & p,
+            const TransitionSystem & ts,
+            const smt::SmtSolver & solver,
+            PonoOptions opt = PonoOptions());
+
+  ~KLiveness();
+
+  typedef Prover super;
+
+  void initialize() override;
+
+  /** Checks the counter bounds up to k, each with an IC3 run bounded
+   *  by k frames
+   *  @return TRUE if the property holds, otherwise UNKNOWN
+   */
+  ProverResult check_until(int k) override;
+
+ protected:
+  /** Keeps the lemmas of a failed run that are invariants of
+   *  counter_ts_ for the next runs
+   */
+  void reuse_lemmas(IC3Base & ic3);
+
+  TransitionSystem counter_ts_;  ///< ts_ with the counter
+  smt::Term count_;  ///< the number of steps where the property was false
+  int count_bound_;  ///< the bound on count_ to check next
+  smt::TermVec invariants_;  ///< invariants of counter_ts_
+
+};  // class KLiveness
+
+}  // namespace pono
@@ -0,0 +1,476 @@
+/*********************                                                        */
+/*! \file pdkind.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann, Ahmed Irfan
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Property-directed k-induction (PD-KIND).
+**        See Property-Directed k-Induction by Jovanovic and Dutertre
+**        (FMCAD 2016)
+**
+**/
+
+#include "engines/pdkind.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+#include "smt-switch/exceptions.h"
+#include "smt-switch/utils.h"
+#include "smt/available_solvers.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+// helper for negating a literal without introducing double negations
+static Term negate_literal(const SmtSolver & s, const Term & t)
+{
+  if (t->get_op() == Not) {
+    return *(t->begin());
+  }
+  return s->make_term(Not, t);
+}
+
+PdKind::PdKind(const Property & p,
+               const TransitionSystem & ts,
+               const SmtSolver & slv,
+               PonoOptions opt)
+    : super(p, ts, slv, opt),
+      // only mathsat interpolator supported
+      interpolator_(create_interpolating_solver_for(
+          SolverEnum::MSAT_INTERPOLATOR, Engine::PDKIND)),
+      to_interpolator_(interpolator_),
+      to_solver_(solver_)
+{
+  engine_ = Engine::PDKIND;
+}
+
+PdKind::~PdKind() {}
+
+void PdKind::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  init0_ = unroller_.at_time(ts_.init(), 0);
+  true_ = solver_->make_term(true);
+  false_ = solver_->make_term(false);
+
+  // need to copy over UF as well
+  UnorderedTermMap & cache = to_solver_.get_cache();
+  UnorderedTermSet free_symbols;
+  get_free_symbols(bad_, free_symbols);
+  get_free_symbols(ts_.init(), free_symbols);
+  get_free_symbols(ts_.trans(), free_symbols);
+  for (const auto & s : free_symbols) {
+    if (s->get_sort()->get_sort_kind() == FUNCTION) {
+      cache[to_interpolator_.transfer_term(s)] = s;
+    }
+  }
+  cached_time_ = -1;
+
+  // the frame initially only contains the property
+  // which is valid up to depth 0 after step_0
+  Term prop = negate_literal(solver_, bad_);
+  frame_.clear();
+  frame_.push_back(FrameElement(IC3Formula(prop, { prop }, true),
+                                IC3Formula(bad_, { bad_ }, false),
+                                true));
+  n_ = 0;
+}
+
+ProverResult PdKind::check_until(int k)
+{
+  initialize();
+
+  try {
+    if (reached_k_ < 0) {
+      ProverResult r = step_0();
+      if (r != ProverResult::UNKNOWN) {
+        return r;
+      }
+    }
+
+    while (reached_k_ < k) {
+      // PD-KIND uses induction depth n + 1
+      // every lemma is valid up to n, so this is enough for the base case
+      ProverResult r = push(n_ + 1);
+      if (r != ProverResult::UNKNOWN) {
+        return r;
+      }
+    }
+  }
+  catch (InternalSolverException & e) {
+    logger.log(1, "Failed when computing interpolant.");
+  }
+
+  return ProverResult::UNKNOWN;
+}
+
+ProverResult PdKind::step_0()
+{
+  logger.log(1, "PD-KIND: checking bound 0");
+  solver_->push();
+  solver_->assert_formula(init0_);
+  solver_->assert_formula(unroller_.at_time(bad_, 0));
+  Result r = solver_->check_sat();
+  if (r.is_sat()) {
+    compute_witness();
+    solver_->pop();
+    return ProverResult::FALSE;
+  }
+  solver_->pop();
+  reached_k_ = 0;
+  return ProverResult::UNKNOWN;
+}
+
+ProverResult PdKind::push(size_t k)
+{
+  logger.log(1,
+             "PD-KIND: pushing frame with {} lemmas from depth {} to depth "
+             "{} (k = {})",
+             frame_.size(),
+             n_,
+             n_ + k,
+             k);
+
+  deque<FrameElement> obligations(frame_.begin(), frame_.end());
+  InductionFrame next_frame;
+  // the depth the next frame is valid up to
+  // lowered to just before a lemma is violated
+  size_t n_p = n_ + k;
+  // stays true iff every lemma in frame_ is k-inductive
+  // relative to frame_
+  bool frame_inductive = true;
+
+  while (!obligations.empty()) {
+    FrameElement elem = obligations.front();
+    obligations.pop_front();
+
+    IC3Formula lemma_cti;
+    Term neg_lemma = solver_->make_term(Not, elem.lemma.term);
+    if (!k_step_reachable(k, neg_lemma, lemma_cti)) {
+      // lemma is k-inductive relative to the frame
+      next_frame.push_back(elem);
+      continue;
+    }
+
+    IC3Formula cti_pred;
+    if (k_step_reachable(k, elem.cti.term, cti_pred)) {
+      // the cti can be reached in k steps from the frame
+      IC3Formula blocker;
+      size_t depth;
+      if (reachable(cti_pred, blocker, depth)) {
+        if (elem.is_prop) {
+          // bad is reachable within n_ + k steps
+          concretize_cex(n_ + k);
+          return ProverResult::FALSE;
+        }
+        // the cti is reachable in depth + k steps, where the lemma is
+        // violated, so it can't be kept in the next frame
+        logger.log(2, "PD-KIND: dropping lemma {}", elem.lemma.term);
+        frame_inductive = false;
+        n_p = min(n_p, depth + k - 1);
+        continue;
+      }
+
+      // learn a lemma blocking the predecessor of the cti
+      logger.log(3, "PD-KIND: learned lemma {}", blocker.term);
+      FrameElement learned(blocker, cti_pred, false);
+      frame_.push_back(learned);
+      obligations.push_back(learned);
+      obligations.push_back(elem);
+    } else {
+      // the cti is not reachable in k steps from the frame
+      // but the lemma is not k-inductive
+      IC3Formula blocker;
+      size_t depth;
+      if (reachable(lemma_cti, blocker, depth)) {
+        // the lemma is violated in depth + k steps
+        // weaken it to the negation of the cti, which holds
+        // as long as the frame does because of the check above
+        assert(!elem.is_prop);
+        logger.log(2, "PD-KIND: weakening lemma {}", elem.lemma.term);
+        frame_inductive = false;
+        n_p = min(n_p, depth + k - 1);
+        next_frame.push_back(
+            FrameElement(negate_cube(elem.cti), elem.cti, false));
+        continue;
+      }
+
+      // learn a lemma blocking the counterexample to induction
+      logger.log(3, "PD-KIND: learned lemma {}", blocker.term);
+      FrameElement learned(blocker, lemma_cti, false);
+      frame_.push_back(learned);
+      obligations.push_back(learned);
+      obligations.push_back(elem);
+    }
+  }
+
+  if (frame_inductive) {
+    logger.log(1, "PD-KIND: found a {}-inductive invariant", k);
+    // invar() is expected to be 1-inductive (see check_invar)
+    // a k-inductive frame is only returned if it also is 1-inductive
+    Term inv = frame_term();
+    if (k == 1 || is_one_inductive(inv)) {
+      invar_ = inv;
+    } else {
+      logger.log(1, "PD-KIND: the invariant is not 1-inductive");
+    }
+    return ProverResult::TRUE;
+  }
+
+  // every lemma is valid up to n_, so depth + k - 1 >= n_ for k = n_ + 1
+  assert(n_p >= n_);
+  frame_ = next_frame;
+  n_ = n_p;
+  // the property is always kept in the frame
+  reached_k_ = n_;
+  return ProverResult::UNKNOWN;
+}
+
+bool PdKind::k_step_reachable(size_t k,
+                              const Term & target,
+                              IC3Formula & out)
+{
+  solver_->push();
+  solver_->assert_formula(unroll_frame(frame_term(), k));
+  solver_->assert_formula(unroller_.at_time(target, k));
+  Result r = solver_->check_sat();
+  if (r.is_sat()) {
+    out = get_model_cube(0);
+  }
+  solver_->pop();
+  assert(r.is_sat() || r.is_unsat());
+  return r.is_sat();
+}
+
+bool PdKind::is_one_inductive(const Term & inv)
+{
+  solver_->push();
+  solver_->assert_formula(unroll_frame(inv, 1));
+  solver_->assert_formula(
+      unroller_.at_time(solver_->make_term(Not, inv), 1));
+  Result r = solver_->check_sat();
+  solver_->pop();
+  assert(r.is_sat() || r.is_unsat());
+  return r.is_unsat();
+}
+
+bool PdKind::reachable(const IC3Formula & s,
+                       IC3Formula & blocker,
+                       size_t & depth)
+{
+  assert(!s.disjunction);
+
+  Term s_at_some_time = false_;
+  for (size_t j = 0; j <= n_; ++j) {
+    s_at_some_time =
+        solver_->make_term(Or, s_at_some_time, unroller_.at_time(s.term, j));
+  }
+
+  solver_->push();
+  solver_->assert_formula(unroll_from_init(n_));
+  solver_->assert_formula(s_at_some_time);
+  Result r = solver_->check_sat();
+  assert(r.is_sat() || r.is_unsat());
+
+  if (r.is_sat()) {
+    // the first time s holds in the model
+    depth = 0;
+    while (depth < n_
+           && solver_->get_value(unroller_.at_time(s.term, depth))
+                  != true_) {
+      ++depth;
+    }
+    solver_->pop();
+    return true;
+  }
+  solver_->pop();
+
+  blocker = generalize_blocker(s);
+  return false;
+}
+
+IC3Formula PdKind::generalize_blocker(const IC3Formula & s)
+{
+  // blocking the cube itself is always valid
+  IC3Formula neg_s = negate_cube(s);
+
+  // an interpolant at each depth overapproximates the states reachable
+  // in exactly that many steps, while excluding s
+  // their disjunction holds in all states reachable within n_ steps
+  TermVec interpolants;
+  interpolants.reserve(n_ + 1);
+  Term int_A = to_interpolator_.transfer_term(init0_);
+  for (size_t j = 0; j <= n_; ++j) {
+    if (j > 0) {
+      int_A = interpolator_->make_term(
+          And,
+          int_A,
+          to_interpolator_.transfer_term(
+              unroller_.at_time(ts_.trans(), j - 1)));
+    }
+    Term int_B = to_interpolator_.transfer_term(unroller_.at_time(s.term, j));
+
+    cache_time_symbols(j);
+    Term int_I;
+    bool got_interpolant = false;
+    try {
+      Result r = interpolator_->get_interpolant(int_A, int_B, int_I);
+      // should always be unsat, s was checked to be unreachable
+      got_interpolant = r.is_unsat();
+    }
+    catch (InternalSolverException & e) {
+      got_interpolant = false;
+    }
+
+    if (!got_interpolant) {
+      logger.log(2, "PD-KIND: interpolation failed, falling back to cube");
+      return neg_s;
+    }
+
+    Term I = unroller_.untime(to_solver_.transfer_term(int_I, BOOL));
+    interpolants.push_back(I);
+  }
+
+  Term lemma = interpolants.at(0);
+  for (size_t i = 1; i < interpolants.size(); ++i) {
+    lemma = solver_->make_term(Or, lemma, interpolants[i]);
+  }
+
+  // interpolants can contain non-state symbols for some theories
+  // only keep the lemma if it's over current state variables
+  if (!ts_.only_curr(lemma)) {
+    return neg_s;
+  }
+
+  return IC3Formula(lemma, { lemma }, true);
+}
+
+void PdKind::concretize_cex(size_t bound)
+{
+  logger.log(1, "PD-KIND: searching for counterexample up to {}", bound);
+
+  Term unrolling = init0_;
+  for (size_t i = 0; i <= bound; ++i) {
+    if (i > 0) {
+      unrolling = solver_->make_term(
+          And, unrolling, unroller_.at_time(ts_.trans(), i - 1));
+    }
+
+    if ((int)i <= reached_k_) {
+      // already known to be safe at this depth
+      continue;
+    }
+
+    solver_->push();
+    solver_->assert_formula(unrolling);
+    solver_->assert_formula(unroller_.at_time(bad_, i));
+    Result r = solver_->check_sat();
+    if (r.is_sat()) {
+      reached_k_ = i - 1;
+      compute_witness();
+      solver_->pop();
+      return;
+    }
+    solver_->pop();
+  }
+
+  throw PonoException(
+      "Internal error: PD-KIND expected a counterexample within bound "
+      + std::to_string(bound));
+}
+
+IC3Formula PdKind::get_model_cube(size_t t)
+{
+  TermVec children;
+  children.reserve(ts_.statevars().size());
+  for (const auto & sv : ts_.statevars()) {
+    Term val = solver_->get_value(unroller_.at_time(sv, t));
+    children.push_back(solver_->make_term(Equal, sv, val));
+  }
+
+  if (children.empty()) {
+    return IC3Formula(true_, { true_ }, false);
+  }
+
+  Term term = children.at(0);
+  for (size_t i = 1; i < children.size(); ++i) {
+    term = solver_->make_term(And, term, children[i]);
+  }
+  return IC3Formula(term, children, false);
+}
+
+IC3Formula PdKind::negate_cube(const IC3Formula & c) const
+{
+  assert(!c.disjunction);
+  assert(c.children.size());
+
+  TermVec neg_children;
+  neg_children.reserve(c.children.size());
+  for (const auto & child : c.children) {
+    neg_children.push_back(negate_literal(solver_, child));
+  }
+
+  Term term = neg_children.at(0);
+  for (size_t i = 1; i < neg_children.size(); ++i) {
+    term = solver_->make_term(Or, term, neg_children[i]);
+  }
+  return IC3Formula(term, neg_children, true);
+}
+
+Term PdKind::frame_term() const
+{
+  Term res = true_;
+  for (const auto & elem : frame_) {
+    res = solver_->make_term(And, res, elem.lemma.term);
+  }
+  return res;
+}
+
+Term PdKind::unroll_frame(const Term & frame, size_t k)
+{
+  Term res = true_;
+  for (size_t i = 0; i < k; ++i) {
+    res = solver_->make_term(And, res, unroller_.at_time(frame, i));
+    res = solver_->make_term(And, res, unroller_.at_time(ts_.trans(), i));
+  }
+  return res;
+}
+
+Term PdKind::unroll_from_init(size_t k)
+{
+  Term res = init0_;
+  for (size_t i = 0; i < k; ++i) {
+    res = solver_->make_term(And, res, unroller_.at_time(ts_.trans(), i));
+  }
+  return res;
+}
+
+void PdKind::cache_time_symbols(size_t t)
+{
+  UnorderedTermMap & cache = to_solver_.get_cache();
+  while (cached_time_ < (int)t) {
+    ++cached_time_;
+    Term tmp;
+    for (const auto & s : ts_.statevars()) {
+      tmp = unroller_.at_time(s, cached_time_);
+      cache[to_interpolator_.transfer_term(tmp)] = tmp;
+    }
+  }
+}
+
+}  // namespace pono
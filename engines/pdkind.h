@@ -0,0 +1,172 @@
+/*********************                                                        */
+/*! \file pdkind.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann, Ahmed Irfan
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Property-directed k-induction (PD-KIND).
+**        See Property-Directed k-Induction by Jovanovic and Dutertre
+**        (FMCAD 2016)
+**
+**        Maintains an induction frame: a set of lemmas, each paired with
+**        the counterexample to induction (CTI) it was learned to block.
+**        Every lemma in the frame is valid up to n steps from init.
+**        A push at depth k checks that each lemma is k-inductive relative
+**        to the frame. Failing lemmas are repaired by learning new lemmas
+**        that block the CTI (generalized with interpolants), or weakened
+**        to the negation of their CTI. If every lemma survives a push,
+**        the frame is a k-inductive invariant. It is only returned by
+**        invar() if it is also 1-inductive.
+**
+**/
+
+#pragma once
+
+#include "engines/ic3base.h"
+#include "engines/prover.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class PdKind : public Prover
+{
+ public:
+  PdKind(const Property & p,
+         const TransitionSystem & ts,
+         const smt::SmtSolver & slv,
+         PonoOptions opt = PonoOptions());
+
+  ~PdKind();
+
+  typedef Prover super;
+
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+ protected:
+  /** An element of the induction frame
+   *  lemma is a formula that is valid up to the frame's depth
+   *  cti is the (conjunctive) set of states the lemma was learned to block
+   *  e.g. for the property itself, lemma = P and cti = !P
+   */
+  struct FrameElement
+  {
+    FrameElement(const IC3Formula & l, const IC3Formula & c, bool p)
+        : lemma(l), cti(c), is_prop(p)
+    {
+    }
+
+    IC3Formula lemma;
+    IC3Formula cti;
+    bool is_prop;  ///< true iff this element corresponds to the property
+  };
+
+  typedef std::vector<FrameElement> InductionFrame;
+
+  /** Checks for a counterexample at bound 0
+   *  @return FALSE if init intersects bad, otherwise UNKNOWN
+   */
+  ProverResult step_0();
+
+  /** Push the induction frame from depth n_ to depth n_ + k
+   *  or to just before the earliest depth a dropped or weakened lemma
+   *  is violated at
+   *  @param k the induction depth
+   *  @return TRUE if the frame is a k-inductive invariant
+   *          FALSE if a counterexample was found
+   *          UNKNOWN otherwise (n_ and frame_ are updated)
+   */
+  ProverResult push(size_t k);
+
+  /** Checks whether target is reachable in exactly k steps from
+   *  a path of states that all satisfy the current frame
+   *  i.e. checks F@0 /\ T@0 /\ ... /\ F@k-1 /\ T@k-1 /\ target@k
+   *  @param k the number of steps
+   *  @param target the formula to check (over current state variables)
+   *  @param out set to the full state at time 0 if the query is sat
+   *  @return true iff the query is sat
+   */
+  bool k_step_reachable(size_t k, const smt::Term & target, IC3Formula & out);
+
+  /** Checks whether inv /\ T /\ !inv' is unsat
+   *  every lemma holds in the initial states, so together with this
+   *  check the frame is a 1-inductive invariant
+   *  @param inv the conjunction of the frame
+   *  @return true iff inv is inductive relative to itself
+   */
+  bool is_one_inductive(const smt::Term & inv);
+
+  /** Checks whether any state in the cube s is reachable from init
+   *  in at most n_ steps
+   *  @param s the cube to check
+   *  @param blocker set to a lemma that blocks s and is valid up to n_
+   *         steps if s is unreachable
+   *  @param depth set to a number of steps s is reached in if reachable
+   *  @return true iff s is reachable within n_ steps
+   */
+  bool reachable(const IC3Formula & s,
+                 IC3Formula & blocker,
+                 size_t & depth);
+
+  /** Computes a generalization of !s that still holds in all states
+   *  reachable in at most n_ steps
+   *  @requires s is not reachable within n_ steps
+   *  @param s the cube to block
+   *  @return a lemma (disjunction) over current state variables
+   */
+  IC3Formula generalize_blocker(const IC3Formula & s);
+
+  /** Once a property violation is known to occur within bound steps,
+   *  find the shortest counterexample with BMC and populate the witness
+   *  @param bound an upper bound on the counterexample length
+   */
+  void concretize_cex(size_t bound);
+
+  /** Get the full state at time t from the current model
+   *  @requires the last call to solver_->check_sat was sat
+   *  @param t the time step of the state to extract
+   *  @return a cube over current state variables
+   */
+  IC3Formula get_model_cube(size_t t);
+
+  /** Creates an IC3Formula representing the negation of a cube */
+  IC3Formula negate_cube(const IC3Formula & c) const;
+
+  /** Returns the conjunction of all lemmas in the frame */
+  smt::Term frame_term() const;
+
+  /** Returns F@0 /\ T@0 /\ ... /\ F@k-1 /\ T@k-1 */
+  smt::Term unroll_frame(const smt::Term & frame, size_t k);
+
+  /** Returns Init@0 /\ T@0 /\ ... /\ T@k-1 */
+  smt::Term unroll_from_init(size_t k);
+
+  /** Add symbols at time t to the to_solver_ cache so that
+   *  interpolants over them can be translated back
+   */
+  void cache_time_symbols(size_t t);
+
+  InductionFrame frame_;  ///< current induction frame
+  size_t n_;              ///< every lemma in frame_ is valid up to n_ steps
+
+  smt::Term init0_;
+  smt::Term true_;
+  smt::Term false_;
+
+  smt::SmtSolver interpolator_;
+  // for translating terms to interpolator_
+  smt::TermTranslator to_interpolator_;
+  // for translating terms to solver_
+  smt::TermTranslator to_solver_;
+  // symbols up to this time are in the to_solver_ cache
+  int cached_time_;
+
+};  // class PdKind
+
+}  // namespace pono
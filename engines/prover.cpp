@@ -23,13 +23,40 @@
 #include "core/rts.h"
 #include "modifiers/static_coi.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
+#include "utils/exceptions.h"
+#include "utils/invariant_miner.h"
 #include "utils/logger.h"
+#include "utils/term_analysis.h"
+#include "utils/term_evaluator.h"
 
 using namespace smt;
 using namespace std;
 
 namespace pono {
 
+void ProverStatistics::write_json(ostream & out) const
+{
+  out << "{" << endl;
+  out << "  \"counters\": {";
+  bool first = true;
+  for (const auto & elem : counters) {
+    out << (first ? "" : ",") << endl;
+    first = false;
+    out << "    \"" << elem.first << "\": " << elem.second;
+  }
+  out << endl << "  }," << endl;
+  out << "  \"timers\": {";
+  first = true;
+  for (const auto & elem : timers) {
+    out << (first ? "" : ",") << endl;
+    first = false;
+    out << "    \"" << elem.first << "\": " << elem.second;
+  }
+  out << endl << "  }" << endl;
+  out << "}" << endl;
+}
+
 Prover::Prover(const Property & p,
                const TransitionSystem & ts,
                const smt::SmtSolver & s,
@@ -47,7 +74,8 @@ Prover::Prover(const Property & p,
               ? orig_property_.prop()
               : to_prover_solver_.transfer_term(orig_property_.prop(), BOOL))),
       options_(opt),
-      engine_(Engine::NONE)
+      engine_(Engine::NONE),
+      named_terms_for_solver_computed_(false)
 {
 }
 
@@ -81,6 +109,9 @@ bool Prover::witness(std::vector<UnorderedTermMap> & out)
         "a counterexample and that the engine supports witness generation.");
   }
 
+  // named terms are only evaluated on demand
+  compute_witness_named_terms();
+
   function<Term(const Term &, SortKind)> transfer_to_prover_as;
   function<Term(const Term &, SortKind)> transfer_to_orig_ts_as;
   TermTranslator to_orig_ts_solver(orig_ts_.solver());
@@ -163,6 +194,23 @@ Term Prover::invar()
   return to_orig_ts(invar_, BOOL);
 }
 
+ProverStatistics Prover::statistics() const
+{
+  ProverStatistics stats;
+  stats.counters["reached_k"] = initialized_ ? reached_k_ : -1;
+  stats.counters["statevars"] = ts_.statevars().size();
+  stats.counters["inputvars"] = ts_.inputvars().size();
+  stats.counters["trans_size"] = dag_size(ts_.trans());
+
+  shared_ptr<ProfilingSolver> ps =
+      dynamic_pointer_cast<ProfilingSolver>(solver_);
+  if (ps) {
+    stats.counters["solver_calls"] = ps->num_calls();
+    stats.timers["solver_time"] = ps->time();
+  }
+  return stats;
+}
+
 Term Prover::to_orig_ts(Term t, SortKind sk)
 {
   if (solver_ == orig_ts_.solver()) {
@@ -194,29 +242,79 @@ bool Prover::compute_witness()
 {
   // TODO: make sure the solver state is SAT
 
-  for (int i = 0; i <= reached_k_ + 1; ++i) {
+  // smt-switch has no interface for querying several values at once
+  // collect all the queried terms up front, so that the unrolling is
+  // done before any value is requested from the solver
+  TermVec vars;
+  vars.reserve(ts_.statevars().size() + ts_.inputvars().size());
+  vars.insert(vars.end(), ts_.statevars().begin(), ts_.statevars().end());
+  vars.insert(vars.end(), ts_.inputvars().begin(), ts_.inputvars().end());
+  const TermVec & named = named_terms_for_solver();
+  vars.insert(vars.end(), named.begin(), named.end());
+
+  const size_t num_steps = reached_k_ + 2;
+  vector<TermVec> timed_vars(num_steps);
+  for (size_t i = 0; i < num_steps; ++i) {
+    TermVec & tv = timed_vars[i];
+    tv.reserve(vars.size());
+    for (const auto & v : vars) {
+      tv.push_back(unroller_.at_time(v, i));
+    }
+  }
+
+  witness_.reserve(witness_.size() + num_steps);
+  for (size_t i = 0; i < num_steps; ++i) {
     witness_.push_back(UnorderedTermMap());
     UnorderedTermMap & map = witness_.back();
+    map.reserve(vars.size());
 
-    for (const auto &v : ts_.statevars()) {
-      const Term &vi = unroller_.at_time(v, i);
-      const Term &r = solver_->get_value(vi);
-      map[v] = r;
+    const TermVec & tv = timed_vars[i];
+    for (size_t j = 0; j < vars.size(); ++j) {
+      map[vars[j]] = solver_->get_value(tv[j]);
     }
+  }
 
-    for (const auto &v : ts_.inputvars()) {
-      const Term &vi = unroller_.at_time(v, i);
-      const Term &r = solver_->get_value(vi);
-      map[v] = r;
-    }
+  return true;
+}
 
-    for (const auto &elem : ts_.named_terms()) {
-      const Term &ti = unroller_.at_time(elem.second, i);
-      map[elem.second] = solver_->get_value(ti);
+const TermVec & Prover::named_terms_for_solver()
+{
+  if (!named_terms_for_solver_computed_) {
+    for (const auto & elem : ts_.named_terms()) {
+      const Term & t = elem.second;
+      if (ts_.is_curr_var(t) || ts_.is_input_var(t)) {
+        // already part of the witness
+        continue;
+      }
+      if (!TermEvaluator::is_supported(t)) {
+        named_terms_for_solver_.push_back(t);
+      }
     }
+    named_terms_for_solver_computed_ = true;
   }
+  return named_terms_for_solver_;
+}
 
-  return true;
+void Prover::compute_witness_named_terms()
+{
+  evaluate_named_terms(ts_, witness_);
+}
+
+TermVec Prover::mine_invariants()
+{
+  if (!options_.mine_invariants_ || !ts_.is_functional()) {
+    return {};
+  }
+
+  try {
+    InvariantMiner miner(ts_, options_.random_seed_);
+    miner.mine(options_.mine_invariants_);
+    return miner.validate();
+  }
+  catch (PonoException & e) {
+    logger.log(1, "Skipping invariant mining: {}", e.what());
+    return {};
+  }
 }
 
 }  // namespace pono
@@ -16,6 +16,11 @@
 
 #pragma once
 
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+
 #include "core/prop.h"
 #include "core/proverresult.h"
 #include "core/ts.h"
@@ -35,6 +40,18 @@ enum RefineResult
   REFINE_FAIL       // failed to refine
 };
 
+/** Statistics of an engine, populated by Prover::statistics
+ *  counters are e.g. numbers of frames, lemmas or refinements
+ *  timers are in seconds
+ */
+struct ProverStatistics
+{
+  std::map<std::string, int64_t> counters;
+  std::map<std::string, double> timers;
+
+  void write_json(std::ostream & out) const;
+};
+
 class Prover
 {
  public:
@@ -66,6 +83,13 @@ class Prover
    */
   smt::Term invar();
 
+  /** Returns the statistics of the engine
+   *  the base version reports the reached bound, the size of the
+   *  transition system and, if the solver is a ProfilingSolver,
+   *  the number and time of its calls. Engines add their own.
+   */
+  virtual ProverStatistics statistics() const;
+
  protected:
   /** Take a term from the Prover's solver
    *  to the original transition system's solver
@@ -88,11 +112,37 @@ class Prover
   /** Default implementation for computing a witness
    *  Assumes that this engine is unrolling-based and that the solver
    *   state is currently satisfiable with a counterexample trace
-   *  populates witness_
+   *  populates witness_ with the values of state and input variables
+   *  named terms are only queried from the solver if they cannot be
+   *  evaluated natively (see named_terms_for_solver), the others are
+   *  evaluated lazily by compute_witness_named_terms
    *  @return true on success
    */
   bool compute_witness();
 
+  /** Returns the named terms which cannot be evaluated from the values
+   *  of the variables with a TermEvaluator, e.g. because they contain
+   *  arrays or uninterpreted functions. Engines populating witness_
+   *  directly should query the values of these terms from the solver.
+   */
+  const smt::TermVec & named_terms_for_solver();
+
+  /** Adds the values of the named terms that are missing in witness_
+   *  by evaluating them over the values of the variables of each step
+   *  next state variables are evaluated with the values of the next step
+   *  named terms that cannot be evaluated are left out
+   */
+  void compute_witness_named_terms();
+
+  /** Mines candidate invariants of ts_ with random simulation and
+   *  returns those that are validated as an inductive invariant
+   *  returns an empty vector if --mine-invariants is not set or
+   *  ts_ cannot be simulated, e.g. because it is not functional
+   *  uses push/pop on solver_ and should be called before the engine
+   *  asserts anything at the base level
+   */
+  smt::TermVec mine_invariants();
+
   /** Returns the reference of the interface ts, which is a copy of orig_ts but
    *  built using solver_. By default, the method returns a reference to ts_.
    *  The derived classes may be based on abstraction-refinement methods (e.g.
@@ -126,5 +176,9 @@ class Prover
 
   smt::Term invar_; ///< populated with an invariant if the engine supports it
 
+ private:
+  bool named_terms_for_solver_computed_;
+  smt::TermVec named_terms_for_solver_;
+
 };
 }  // namespace pono
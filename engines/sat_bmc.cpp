@@ -0,0 +1,154 @@
+/*********************                                                        */
+/*! \file sat_bmc.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bounded model checking on a native SAT solver.
+**
+**/
+
+#include "engines/sat_bmc.h"
+
+#include <cassert>
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+SatBmc::SatBmc(const Property & p,
+               const TransitionSystem & ts,
+               const SmtSolver & solver,
+               PonoOptions opt)
+    : super(p, ts, solver, opt), sat_(create_sat_solver()), true_var_(0)
+{
+  engine_ = Engine::SAT_BMC;
+}
+
+SatBmc::~SatBmc() {}
+
+void SatBmc::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  bbts_.reset(new BitBlastedTs(ts_, bad_));
+  const Aig & aig = bbts_->aig();
+  logger.log(1,
+             "SatBmc: bit-blasted into {} AIG nodes ({} ands)",
+             aig.num_nodes(),
+             aig.num_ands());
+
+  true_var_ = sat_->new_var();
+  sat_->add_clause({ true_var_ });
+  add_frame();
+}
+
+ProverResult SatBmc::check_until(int k)
+{
+  initialize();
+
+  for (int i = reached_k_ + 1; i <= k; ++i) {
+    logger.log(1, "\nSatBmc checking at bound: {}", i);
+    while (frames_.size() <= static_cast<size_t>(i)) {
+      add_frame();
+    }
+
+    int bad = sat_lit(i, bbts_->bad());
+    if (sat_->solve({ bad })) {
+      logger.log(1, "  SatBmc found a counterexample at bound {}", i);
+      reached_k_ = i - 1;
+      model_to_witness(i);
+      return ProverResult::FALSE;
+    }
+    reached_k_ = i;
+
+    if (!sat_->failed(bad)) {
+      // the unrolling is unsat without the bad state assumption,
+      // there are no traces of this length or longer
+      logger.log(1, "  SatBmc: no traces of length {}", i);
+      return ProverResult::TRUE;
+    }
+  }
+
+  return ProverResult::UNKNOWN;
+}
+
+ProverStatistics SatBmc::statistics() const
+{
+  ProverStatistics stats = super::statistics();
+  if (bbts_) {
+    stats.counters["aig_nodes"] = bbts_->aig().num_nodes();
+    stats.counters["aig_ands"] = bbts_->aig().num_ands();
+  }
+  stats.counters["sat_vars"] = sat_->num_vars();
+  stats.counters["sat_clauses"] = sat_->num_clauses();
+  return stats;
+}
+
+void SatBmc::add_frame()
+{
+  size_t k = frames_.size();
+  frames_.push_back(unordered_map<uint32_t, int>());
+  frames_[k][Aig::node(Aig::FALSE_LIT)] = -true_var_;
+
+  if (k > 0) {
+    const AigBits & state_bits = bbts_->state_bits();
+    const AigBits & next_bits = bbts_->next_bits();
+    for (size_t j = 0; j < state_bits.size(); ++j) {
+      int l = sat_lit(k - 1, next_bits[j]);
+      assert(!Aig::is_negated(state_bits[j]));
+      frames_[k][Aig::node(state_bits[j])] = l;
+    }
+  }
+
+  // materialize all variable bits so that the witness is complete
+  for (size_t j = 0; j < bbts_->vars().size(); ++j) {
+    for (const auto & b : bbts_->var_bits(j)) {
+      sat_lit(k, b);
+    }
+  }
+
+  if (bbts_->constraints() != Aig::TRUE_LIT) {
+    sat_->add_clause({ sat_lit(k, bbts_->constraints()) });
+  }
+
+  if (k == 0) {
+    sat_->add_clause({ sat_lit(0, bbts_->init()) });
+  }
+}
+
+int SatBmc::sat_lit(size_t k, AigLit l)
+{
+  return encode_cnf(bbts_->aig(), *sat_, frames_[k], l);
+}
+
+void SatBmc::model_to_witness(int k)
+{
+  const TermVec & vars = bbts_->vars();
+  for (int i = 0; i <= k; ++i) {
+    witness_.push_back(UnorderedTermMap());
+    UnorderedTermMap & map = witness_.back();
+    for (size_t j = 0; j < vars.size(); ++j) {
+      vector<bool> bit_values;
+      for (const auto & b : bbts_->var_bits(j)) {
+        bit_values.push_back(sat_->value(sat_lit(i, b)));
+      }
+      map[vars[j]] = bbts_->value(solver_, j, bit_values);
+    }
+  }
+}
+
+}  // namespace pono
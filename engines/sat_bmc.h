@@ -0,0 +1,79 @@
+/*********************                                                        */
+/*! \file sat_bmc.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bounded model checking on a native SAT solver.
+**
+**        The functional transition system is bit-blasted into an AIG
+**        once, then every BMC frame is a fresh copy of its CNF encoding
+**        in a single incremental SAT solver. The bad state of the
+**        current bound is passed as an assumption. Models are only
+**        translated back to terms to build the witness.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "engines/prover.h"
+#include "smt/sat_solver.h"
+#include "utils/bit_blaster.h"
+
+namespace pono {
+
+class SatBmc : public Prover
+{
+ public:
+  SatBmc(const Property & p,
+         const TransitionSystem & ts,
+         const smt::SmtSolver & solver,
+         PonoOptions opt = PonoOptions());
+
+  ~SatBmc();
+
+  typedef Prover super;
+
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+  ProverStatistics statistics() const override;
+
+ protected:
+  /** Add the CNF frame for the next time step
+   *  state bits are connected to the next state functions of the
+   *  previous frame, init is asserted in frame 0 and the constraints
+   *  in every frame
+   */
+  void add_frame();
+
+  /** @return the SAT literal of an AIG literal at time k
+   *  encodes the cone of the literal in frame k as needed
+   */
+  int sat_lit(size_t k, AigLit l);
+
+  /** Populate witness_ from the model of the last SAT call
+   *  @param k the bound of the counterexample
+   */
+  void model_to_witness(int k);
+
+  std::unique_ptr<BitBlastedTs> bbts_;
+  SatSolverPtr sat_;
+
+  int true_var_;  ///< SAT variable that is always true
+
+  /** for every frame, the SAT literals of the encoded AIG nodes */
+  std::vector<std::unordered_map<uint32_t, int>> frames_;
+
+};  // class SatBmc
+
+}  // namespace pono
@@ -0,0 +1,502 @@
+/*********************                                                        */
+/*! \file sat_ic3.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bit-level IC3 / PDR on a native SAT solver.
+**
+**/
+
+#include "engines/sat_ic3.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <queue>
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+SatIC3::SatIC3(const Property & p,
+               const TransitionSystem & ts,
+               const SmtSolver & solver,
+               PonoOptions opt)
+    : super(p, ts, solver, opt),
+      sat_(create_sat_solver()),
+      bad_lit_(0),
+      next_constraints_lit_(0),
+      init_sat_(create_sat_solver()),
+      init_bad_lit_(0),
+      num_sat_calls_(0)
+{
+  engine_ = (opt.engine_ == IC3_BOOL) ? IC3_BOOL : IC3_BITS;
+}
+
+SatIC3::~SatIC3() {}
+
+void SatIC3::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  if (engine_ == IC3_BOOL) {
+    // same restriction as the SMT-based bit-level IC3
+    for (const auto & v : ts_.statevars()) {
+      if (v->get_sort()->get_sort_kind() != BOOL) {
+        throw PonoException(
+            "Got non-boolean state variable in bit-level IC3: "
+            + v->to_string());
+      }
+    }
+    for (const auto & v : ts_.inputvars()) {
+      if (v->get_sort()->get_sort_kind() != BOOL) {
+        throw PonoException(
+            "Got non-boolean input variable in bit-level IC3: "
+            + v->to_string());
+      }
+    }
+  }
+
+  bbts_.reset(new BitBlastedTs(ts_, bad_));
+  for (size_t i = 0; i < bbts_->num_statevars(); ++i) {
+    for (size_t j = 0; j < bbts_->var_bits(i).size(); ++j) {
+      bit_vars_.push_back({ i, j });
+    }
+  }
+  logger.log(1,
+             "SatIC3: bit-blasted into {} AIG nodes ({} ands), {} state bits",
+             bbts_->aig().num_nodes(),
+             bbts_->aig().num_ands(),
+             bit_vars_.size());
+
+  encode();
+}
+
+ProverResult SatIC3::check_until(int k)
+{
+  initialize();
+
+  if (reached_k_ < 0) {
+    ++num_sat_calls_;
+    if (init_sat_->solve({ init_bad_lit_ })) {
+      logger.log(1, "SatIC3: an initial state is bad");
+      add_witness_step(model_cube(*init_sat_, init_cur_),
+                       model_values(*init_sat_, init_inputs_));
+      return ProverResult::FALSE;
+    }
+    reached_k_ = 0;
+    new_frame();
+  }
+
+  while (reached_k_ < k) {
+    size_t top = lemmas_.size() - 1;
+    logger.log(1, "SatIC3: blocking bad states at frame {}", top);
+
+    vector<int> assumptions = frame_assumptions(top);
+    assumptions.push_back(bad_lit_);
+    ++num_sat_calls_;
+    while (sat_->solve(assumptions)) {
+      ProofObligation ob;
+      ob.cube = model_cube(*sat_, cur_);
+      ob.inputs = model_values(*sat_, inputs_);
+      ob.level = top;
+      ob.next = -1;
+      if (!block(ob)) {
+        // the witness has one more state than transitions
+        reached_k_ = witness_.size() - 2;
+        return ProverResult::FALSE;
+      }
+      ++num_sat_calls_;
+    }
+
+    reached_k_ = top;
+    new_frame();
+    if (propagate()) {
+      logger.log(1, "SatIC3: found an inductive invariant");
+      return ProverResult::TRUE;
+    }
+  }
+
+  return ProverResult::UNKNOWN;
+}
+
+ProverStatistics SatIC3::statistics() const
+{
+  ProverStatistics stats = super::statistics();
+  if (bbts_) {
+    stats.counters["aig_nodes"] = bbts_->aig().num_nodes();
+    stats.counters["aig_ands"] = bbts_->aig().num_ands();
+  }
+  stats.counters["sat_vars"] = sat_->num_vars();
+  stats.counters["sat_clauses"] = sat_->num_clauses();
+  stats.counters["sat_calls"] = num_sat_calls_;
+  stats.counters["frames"] = lemmas_.size();
+  size_t num_lemmas = 0;
+  for (const auto & l : lemmas_) {
+    num_lemmas += l.size();
+  }
+  stats.counters["lemmas"] = num_lemmas;
+  return stats;
+}
+
+void SatIC3::encode()
+{
+  const Aig & aig = bbts_->aig();
+  const AigBits & state_bits = bbts_->state_bits();
+  const AigBits & next_bits = bbts_->next_bits();
+  const AigBits & input_bits = bbts_->input_bits();
+
+  int true_var = sat_->new_var();
+  sat_->add_clause({ true_var });
+
+  // the transition relation over the current state and inputs
+  unordered_map<uint32_t, int> cur_nodes;
+  cur_nodes[Aig::node(Aig::FALSE_LIT)] = -true_var;
+  for (const auto & b : state_bits) {
+    cur_.push_back(encode_cnf(aig, *sat_, cur_nodes, b));
+  }
+  for (const auto & b : input_bits) {
+    inputs_.push_back(encode_cnf(aig, *sat_, cur_nodes, b));
+  }
+  // fresh next state variables so that cores map to state bits
+  unordered_map<uint32_t, int> next_nodes;
+  next_nodes[Aig::node(Aig::FALSE_LIT)] = -true_var;
+  for (size_t j = 0; j < state_bits.size(); ++j) {
+    int f = encode_cnf(aig, *sat_, cur_nodes, next_bits[j]);
+    int n = sat_->new_var();
+    sat_->add_clause({ -n, f });
+    sat_->add_clause({ n, -f });
+    next_.push_back(n);
+    assert(!Aig::is_negated(state_bits[j]));
+    next_nodes[Aig::node(state_bits[j])] = n;
+  }
+  sat_->add_clause({ encode_cnf(aig, *sat_, cur_nodes, bbts_->constraints()) });
+  // inputs of the next state get fresh variables
+  next_constraints_lit_ =
+      encode_cnf(aig, *sat_, next_nodes, bbts_->constraints());
+  bad_lit_ = encode_cnf(aig, *sat_, cur_nodes, bbts_->bad());
+
+  // frame 0 are the initial states
+  frame_acts_.push_back(sat_->new_var());
+  sat_->add_clause(
+      { -frame_acts_[0], encode_cnf(aig, *sat_, cur_nodes, bbts_->init()) });
+  lemmas_.push_back(vector<Cube>());
+
+  // the initial states on their own, for initiation checks
+  int init_true_var = init_sat_->new_var();
+  init_sat_->add_clause({ init_true_var });
+  unordered_map<uint32_t, int> init_nodes;
+  init_nodes[Aig::node(Aig::FALSE_LIT)] = -init_true_var;
+  for (const auto & b : state_bits) {
+    init_cur_.push_back(encode_cnf(aig, *init_sat_, init_nodes, b));
+  }
+  for (const auto & b : input_bits) {
+    init_inputs_.push_back(encode_cnf(aig, *init_sat_, init_nodes, b));
+  }
+  init_sat_->add_clause(
+      { encode_cnf(aig, *init_sat_, init_nodes, bbts_->init()) });
+  init_sat_->add_clause(
+      { encode_cnf(aig, *init_sat_, init_nodes, bbts_->constraints()) });
+  init_bad_lit_ = encode_cnf(aig, *init_sat_, init_nodes, bbts_->bad());
+}
+
+void SatIC3::new_frame()
+{
+  frame_acts_.push_back(sat_->new_var());
+  lemmas_.push_back(vector<Cube>());
+}
+
+vector<int> SatIC3::frame_assumptions(size_t level) const
+{
+  if (level == 0) {
+    return { frame_acts_[0] };
+  }
+  return vector<int>(frame_acts_.begin() + level, frame_acts_.end());
+}
+
+bool SatIC3::block(const ProofObligation & bad)
+{
+  // lowest frame first, then the most recent obligation
+  auto cmp = [this](size_t a, size_t b) {
+    const ProofObligation & oa = obligations_[a];
+    const ProofObligation & ob = obligations_[b];
+    return oa.level > ob.level || (oa.level == ob.level && a < b);
+  };
+  priority_queue<size_t, vector<size_t>, decltype(cmp)> queue(cmp);
+
+  obligations_.clear();
+  obligations_.push_back(bad);
+  queue.push(0);
+  size_t top = lemmas_.size() - 1;
+
+  while (!queue.empty()) {
+    size_t idx = queue.top();
+    queue.pop();
+    // copy, obligations_ grows below
+    ProofObligation ob = obligations_[idx];
+
+    if (intersects_init(ob.cube)) {
+      // the cubes are full states, this is a counterexample trace
+      for (int i = idx; i >= 0; i = obligations_[i].next) {
+        add_witness_step(obligations_[i].cube, obligations_[i].inputs);
+      }
+      logger.log(1, "SatIC3: found a counterexample of length {}",
+                 witness_.size() - 1);
+      return false;
+    }
+    // predecessors from frame 0 are initial states
+    assert(ob.level > 0);
+
+    if (is_blocked(ob.cube, ob.level)) {
+      continue;
+    }
+
+    ProofObligation pred;
+    Cube core;
+    if (!relative_inductive(ob.cube, ob.level - 1, &core, &pred)) {
+      pred.level = ob.level - 1;
+      pred.next = idx;
+      obligations_.push_back(pred);
+      queue.push(obligations_.size() - 1);
+      queue.push(idx);
+      continue;
+    }
+
+    Cube g = generalize(repair_initiation(core, ob.cube), ob.level - 1);
+    // push the lemma as far as it is inductive
+    size_t level = ob.level;
+    while (level < top && relative_inductive(g, level, nullptr, nullptr)) {
+      ++level;
+    }
+    add_lemma(g, level);
+    logger.log(3, "SatIC3: blocked a cube of {} literals at frame {}",
+               g.size(), level);
+
+    if (level < top) {
+      // block it at the next frame too
+      obligations_[idx].level = level + 1;
+      queue.push(idx);
+    }
+  }
+  return true;
+}
+
+bool SatIC3::intersects_init(const Cube & c)
+{
+  vector<int> assumptions;
+  assumptions.reserve(c.size());
+  for (const auto & l : c) {
+    int v = init_cur_[abs(l) - 1];
+    assumptions.push_back(l > 0 ? v : -v);
+  }
+  ++num_sat_calls_;
+  return init_sat_->solve(assumptions);
+}
+
+bool SatIC3::is_blocked(const Cube & c, size_t level)
+{
+  vector<int> assumptions = frame_assumptions(level);
+  for (const auto & l : c) {
+    assumptions.push_back(cur_lit(l));
+  }
+  ++num_sat_calls_;
+  return !sat_->solve(assumptions);
+}
+
+bool SatIC3::relative_inductive(const Cube & c,
+                                size_t level,
+                                Cube * core,
+                                ProofObligation * pred)
+{
+  // !c only holds for this query
+  int act = sat_->new_var();
+  vector<int> clause({ -act });
+  for (const auto & l : c) {
+    clause.push_back(-cur_lit(l));
+  }
+  sat_->add_clause(clause);
+
+  vector<int> assumptions = frame_assumptions(level);
+  assumptions.push_back(act);
+  assumptions.push_back(next_constraints_lit_);
+  for (const auto & l : c) {
+    assumptions.push_back(next_lit(l));
+  }
+  ++num_sat_calls_;
+  bool sat = sat_->solve(assumptions);
+
+  if (sat && pred) {
+    pred->cube = model_cube(*sat_, cur_);
+    pred->inputs = model_values(*sat_, inputs_);
+  } else if (!sat && core) {
+    core->clear();
+    for (const auto & l : c) {
+      if (sat_->failed(next_lit(l))) {
+        core->push_back(l);
+      }
+    }
+  }
+
+  // retire the activation literal
+  sat_->add_clause({ -act });
+  return !sat;
+}
+
+SatIC3::Cube SatIC3::repair_initiation(const Cube & reduced, const Cube & c)
+{
+  Cube res = reduced;
+  for (const auto & l : c) {
+    if (!intersects_init(res)) {
+      break;
+    }
+    if (find(res.begin(), res.end(), l) == res.end()) {
+      res.push_back(l);
+    }
+  }
+  auto by_bit = [](int a, int b) { return abs(a) < abs(b); };
+  sort(res.begin(), res.end(), by_bit);
+  assert(!intersects_init(res));
+  return res;
+}
+
+SatIC3::Cube SatIC3::generalize(const Cube & c, size_t level)
+{
+  Cube res = c;
+  Cube to_try = c;
+  for (const auto & l : to_try) {
+    if (res.size() <= 1) {
+      break;
+    }
+    auto it = find(res.begin(), res.end(), l);
+    if (it == res.end()) {
+      // already dropped with a core
+      continue;
+    }
+    Cube candidate = res;
+    candidate.erase(candidate.begin() + (it - res.begin()));
+    if (intersects_init(candidate)) {
+      continue;
+    }
+    Cube core;
+    if (relative_inductive(candidate, level, &core, nullptr)) {
+      res = repair_initiation(core, candidate);
+    }
+  }
+  return res;
+}
+
+void SatIC3::add_lemma(const Cube & c, size_t level)
+{
+  assert(level > 0);
+  assert(level < lemmas_.size());
+  vector<int> clause({ -frame_acts_[level] });
+  for (const auto & l : c) {
+    clause.push_back(-cur_lit(l));
+  }
+  sat_->add_clause(clause);
+  lemmas_[level].push_back(c);
+}
+
+bool SatIC3::propagate()
+{
+  size_t top = lemmas_.size() - 1;
+  for (size_t i = 1; i < top; ++i) {
+    vector<Cube> keep;
+    vector<Cube> to_push = lemmas_[i];
+    for (const auto & c : to_push) {
+      // !c is already in frame i
+      vector<int> assumptions = frame_assumptions(i);
+      assumptions.push_back(next_constraints_lit_);
+      for (const auto & l : c) {
+        assumptions.push_back(next_lit(l));
+      }
+      ++num_sat_calls_;
+      if (sat_->solve(assumptions)) {
+        keep.push_back(c);
+      } else {
+        add_lemma(c, i + 1);
+      }
+    }
+    lemmas_[i] = keep;
+
+    if (keep.empty()) {
+      // frame i equals frame i + 1, which is an inductive invariant
+      Term inv = solver_->make_term(true);
+      for (size_t j = i + 1; j <= top; ++j) {
+        for (const auto & c : lemmas_[j]) {
+          Term clause = solver_->make_term(false);
+          for (const auto & l : c) {
+            const pair<size_t, size_t> & vb = bit_vars_[abs(l) - 1];
+            Term bit = bbts_->bit_term(solver_, vb.first, vb.second, l < 0);
+            clause = solver_->make_term(Or, clause, bit);
+          }
+          inv = solver_->make_term(And, inv, clause);
+        }
+      }
+      invar_ = inv;
+      return true;
+    }
+  }
+  return false;
+}
+
+SatIC3::Cube SatIC3::model_cube(const SatSolver & sat,
+                                const vector<int> & state_lits) const
+{
+  Cube res;
+  res.reserve(state_lits.size());
+  for (size_t j = 0; j < state_lits.size(); ++j) {
+    int l = j + 1;
+    res.push_back(sat.value(state_lits[j]) ? l : -l);
+  }
+  return res;
+}
+
+vector<bool> SatIC3::model_values(const SatSolver & sat,
+                                  const vector<int> & lits) const
+{
+  vector<bool> res;
+  res.reserve(lits.size());
+  for (const auto & l : lits) {
+    res.push_back(sat.value(l));
+  }
+  return res;
+}
+
+void SatIC3::add_witness_step(const Cube & state, const vector<bool> & inputs)
+{
+  witness_.push_back(UnorderedTermMap());
+  UnorderedTermMap & map = witness_.back();
+
+  const TermVec & vars = bbts_->vars();
+  size_t state_pos = 0;
+  size_t input_pos = 0;
+  for (size_t i = 0; i < vars.size(); ++i) {
+    size_t width = bbts_->var_bits(i).size();
+    vector<bool> bit_values;
+    for (size_t j = 0; j < width; ++j) {
+      if (i < bbts_->num_statevars()) {
+        bit_values.push_back(state[state_pos++] > 0);
+      } else {
+        bit_values.push_back(inputs[input_pos++]);
+      }
+    }
+    map[vars[i]] = bbts_->value(solver_, i, bit_values);
+  }
+}
+
+}  // namespace pono
@@ -0,0 +1,183 @@
+/*********************                                                        */
+/*! \file sat_ic3.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bit-level IC3 / PDR on a native SAT solver.
+**
+**        The functional transition system is bit-blasted into an AIG
+**        once and the transition relation is encoded into CNF once in
+**        a single incremental SAT solver. Frames are activation
+**        literals: a lemma learned at frame i is guarded by the literal
+**        of frame i, and a query relative to frame i assumes the
+**        literals of all frames >= i. Cubes are over state bits and are
+**        reduced with the failed assumptions of the SAT solver. Models
+**        are only translated back to terms for the witness, and the
+**        lemmas for the invariant.
+**
+**        Serves as the native backend of ic3bool and ic3bits.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "engines/prover.h"
+#include "smt/sat_solver.h"
+#include "utils/bit_blaster.h"
+
+namespace pono {
+
+class SatIC3 : public Prover
+{
+ public:
+  SatIC3(const Property & p,
+         const TransitionSystem & ts,
+         const smt::SmtSolver & solver,
+         PonoOptions opt = PonoOptions());
+
+  ~SatIC3();
+
+  typedef Prover super;
+
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+  ProverStatistics statistics() const override;
+
+ protected:
+  /** A cube over the state bits: a literal is +(j + 1) if state bit j
+   *  is true and -(j + 1) if it is false, sorted by bit index
+   */
+  typedef std::vector<int> Cube;
+
+  /** A state to block at a frame, with the inputs that lead from it to
+   *  the state of the next proof obligation (or to a bad state)
+   */
+  struct ProofObligation
+  {
+    Cube cube;                ///< a full state
+    std::vector<bool> inputs;  ///< the values of the input bits
+    size_t level;
+    int next;  ///< index of the successor obligation, -1 for a bad state
+  };
+
+  /** Encode the transition relation, the frames and the initial states
+   *  into the SAT solvers
+   */
+  void encode();
+
+  /** Add a new frame, with no lemmas, on top */
+  void new_frame();
+
+  /** @return the activation literals of the frames >= level
+   *  or only the initial states for level 0
+   */
+  std::vector<int> frame_assumptions(size_t level) const;
+
+  /** Block a bad state and all of its predecessors
+   *  @param bad the bad state at the top frame
+   *  @return false iff a counterexample was found, then witness_ is set
+   */
+  bool block(const ProofObligation & bad);
+
+  /** @return true iff the cube intersects the initial states */
+  bool intersects_init(const Cube & c);
+
+  /** @return true iff the cube does not intersect frame level */
+  bool is_blocked(const Cube & c, size_t level);
+
+  /** Check whether frame level /\ !c /\ T /\ c' is unsat
+   *  @param c the cube
+   *  @param level the frame
+   *  @param core if unsat and not null, set to the literals of c in the
+   *         final conflict
+   *  @param pred if sat and not null, set to the predecessor state and
+   *         the inputs leading to c
+   *  @return true iff unsat, i.e. !c is inductive relative to the frame
+   */
+  bool relative_inductive(const Cube & c,
+                          size_t level,
+                          Cube * core,
+                          ProofObligation * pred);
+
+  /** Extend a reduced cube with literals of the original cube until it
+   *  no longer intersects the initial states
+   *  @requires c does not intersect the initial states
+   */
+  Cube repair_initiation(const Cube & reduced, const Cube & c);
+
+  /** Drop literals of a cube whose negation is inductive relative to
+   *  frame level, keeping it disjoint from the initial states
+   */
+  Cube generalize(const Cube & c, size_t level);
+
+  /** Add !c to frame level */
+  void add_lemma(const Cube & c, size_t level);
+
+  /** Push lemmas to the next frame where they are inductive
+   *  @return true iff two frames became equal, then invar_ is set
+   */
+  bool propagate();
+
+  /** @return the full state cube of the model of a SAT solver
+   *  @param sat the solver
+   *  @param state_lits the SAT literals of the state bits
+   */
+  Cube model_cube(const SatSolver & sat,
+                  const std::vector<int> & state_lits) const;
+
+  /** @return the values of the literals in the model of a SAT solver */
+  std::vector<bool> model_values(const SatSolver & sat,
+                                 const std::vector<int> & lits) const;
+
+  /** Append a step to witness_ */
+  void add_witness_step(const Cube & state, const std::vector<bool> & inputs);
+
+  /** @return the SAT literal of a cube literal over the current state */
+  int cur_lit(int l) const { return l > 0 ? cur_[l - 1] : -cur_[-l - 1]; }
+
+  /** @return the SAT literal of a cube literal over the next state */
+  int next_lit(int l) const { return l > 0 ? next_[l - 1] : -next_[-l - 1]; }
+
+  std::unique_ptr<BitBlastedTs> bbts_;
+
+  SatSolverPtr sat_;  ///< frames and transition relation
+  std::vector<int> cur_;     ///< current state bits in sat_
+  std::vector<int> next_;    ///< next state bits in sat_
+  std::vector<int> inputs_;  ///< input bits in sat_
+  int bad_lit_;
+  /** the constraints over the next state, assumed in transition queries */
+  int next_constraints_lit_;
+  std::vector<int> frame_acts_;  ///< activation literal of each frame
+
+  SatSolverPtr init_sat_;  ///< initial states only
+  std::vector<int> init_cur_;
+  std::vector<int> init_inputs_;
+  int init_bad_lit_;
+
+  /** lemmas_[i] are the cubes blocked at frame i but not at i + 1
+   *  lemmas_[0] stays empty, frame 0 are the initial states
+   */
+  std::vector<std::vector<Cube>> lemmas_;
+
+  std::vector<ProofObligation> obligations_;
+
+  /** for every state bit, the index of its variable and bit */
+  std::vector<std::pair<size_t, size_t>> bit_vars_;
+
+  size_t num_sat_calls_;
+
+};  // class SatIC3
+
+}  // namespace pono
@@ -0,0 +1,339 @@
+/*********************                                                        */
+/*! \file sim_bmc.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann, Florian Lonsing
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Simulation-guided bug hunting (state-jump BMC).
+**
+**/
+
+#include "engines/sim_bmc.h"
+
+#include <cassert>
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+SimBmc::SimBmc(const Property & p,
+               const TransitionSystem & ts,
+               const SmtSolver & solver,
+               PonoOptions opt)
+    : super(p, ts, solver, opt),
+      window_(opt.sim_bmc_window_),
+      sim_steps_(opt.sim_bmc_sim_steps_),
+      rng_(opt.random_seed_)
+{
+  engine_ = Engine::SIM_BMC;
+}
+
+SimBmc::~SimBmc() {}
+
+void SimBmc::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  init0_ = unroller_.at_time(ts_.init(), 0);
+  sim_trace_.clear();
+
+  // the random phase runs on the native simulator if possible
+  // the solver is then only used for the BMC windows
+  sim_.reset();
+  if (ts_.is_functional()) {
+    try {
+      sim_.reset(new Simulator(ts_, options_.random_seed_));
+      sim_->set_bad(bad_);
+      sim_->set_record(true);
+    }
+    catch (PonoException & e) {
+      logger.log(1, "SimBmc: falling back to SMT simulation: {}", e.what());
+      sim_.reset();
+    }
+  }
+}
+
+ProverResult SimBmc::check_until(int k)
+{
+  initialize();
+
+  // the first window starts from the initial states
+  // it is an exhaustive search up to its length
+  int len = min(window_, k);
+  logger.log(1, "SimBmc: checking window [0, {}] from initial states", len);
+  int bad_idx = bmc_window(init0_, len);
+  if (bad_idx >= 0) {
+    reached_k_ = bad_idx - 1;
+    return ProverResult::FALSE;
+  }
+  reached_k_ = len;
+
+  // the current state is not part of sim_trace_
+  // because its inputs are not known until the next step
+  sim_trace_.clear();
+  Term start = init0_;
+  int depth = 0;
+
+  bool native = false;
+  if (sim_) {
+    sim_->reset();
+    native = sim_->valid_lanes() != 0;
+    if (!native) {
+      logger.log(1, "SimBmc: no random initial state satisfies init");
+    }
+  }
+
+  while (depth + 1 <= k) {
+    // simulation phase: jump to a deeper concrete state
+    logger.log(1, "SimBmc: simulating from depth {}", depth);
+    int steps = min(sim_steps_, k - depth);
+    bool found_bad = false;
+    bool progress = native ? simulate_native(steps, depth, start, found_bad)
+                           : simulate_smt(steps, depth, start, found_bad);
+    if (found_bad) {
+      return ProverResult::FALSE;
+    } else if (!progress) {
+      logger.log(1, "SimBmc: simulation stuck at depth {}", depth);
+      return ProverResult::UNKNOWN;
+    }
+
+    // BMC phase: short window pinned to the simulated state
+    len = min(window_, k - depth);
+    logger.log(1,
+               "SimBmc: checking window [{}, {}] from simulated state",
+               depth,
+               depth + len);
+    bad_idx = bmc_window(start, len);
+    if (bad_idx >= 0) {
+      // stitch the simulated prefix and the window trace
+      witness_.insert(witness_.begin(), sim_trace_.begin(), sim_trace_.end());
+      reached_k_ = depth + bad_idx - 1;
+      logger.log(1, "SimBmc: found counterexample at {}", depth + bad_idx);
+      return ProverResult::FALSE;
+    }
+  }
+
+  return ProverResult::UNKNOWN;
+}
+
+bool SimBmc::simulate_native(int steps,
+                             int & depth,
+                             Term & start,
+                             bool & found_bad)
+{
+  found_bad = sim_->run(steps);
+  if (found_bad) {
+    // the simulator records the whole trace from an initial state
+    size_t lane = first_lane(sim_->bad_lanes());
+    witness_.clear();
+    sim_->witness(lane, witness_);
+    depth = sim_->cycle();
+    reached_k_ = depth - 1;
+    logger.log(1, "SimBmc: simulation reached bad state at {}", depth);
+    return true;
+  }
+
+  Simulator::LaneMask valid = sim_->valid_lanes();
+  if (!valid) {
+    // every lane violated a constraint
+    return false;
+  }
+
+  // continue with the first lane that is still valid
+  size_t lane = first_lane(valid);
+  depth = sim_->cycle();
+  sim_trace_.clear();
+  sim_->witness(lane, sim_trace_);
+
+  // state variables without an update are free in the window
+  UnorderedTermMap cur_state;
+  for (const auto & elem : ts_.state_updates()) {
+    cur_state[elem.first] = sim_->get_value(elem.first, lane);
+  }
+  start = state_at_time_0(cur_state);
+  return true;
+}
+
+bool SimBmc::simulate_smt(int steps,
+                          int & depth,
+                          Term & start,
+                          bool & found_bad)
+{
+  found_bad = false;
+  for (int i = 0; i < steps; ++i) {
+    UnorderedTermMap step;
+    UnorderedTermMap next;
+    bool next_bad = false;
+    if (!simulate_step(start, step, next, next_bad)) {
+      return false;
+    }
+    sim_trace_.push_back(step);
+    ++depth;
+    start = state_at_time_0(next);
+
+    // simulation can also hit a bad state directly
+    // use a window of length 0 to get the inputs of the last state
+    if (next_bad && bmc_window(start, 0) == 0) {
+      logger.log(1, "SimBmc: simulation reached bad state at {}", depth);
+      witness_.insert(witness_.begin(), sim_trace_.begin(), sim_trace_.end());
+      reached_k_ = depth - 1;
+      found_bad = true;
+      return true;
+    }
+  }
+  return true;
+}
+
+size_t SimBmc::first_lane(Simulator::LaneMask lanes)
+{
+  assert(lanes);
+  size_t lane = 0;
+  while (!((lanes >> lane) & 1)) {
+    ++lane;
+  }
+  return lane;
+}
+
+int SimBmc::bmc_window(const Term & start, int len)
+{
+  int bad_idx = -1;
+
+  solver_->push();
+  solver_->assert_formula(start);
+  for (int j = 0; j <= len; ++j) {
+    if (j > 0) {
+      solver_->assert_formula(unroller_.at_time(ts_.trans(), j - 1));
+    }
+
+    solver_->push();
+    solver_->assert_formula(unroller_.at_time(bad_, j));
+    Result r = solver_->check_sat();
+    assert(r.is_sat() || r.is_unsat());
+    if (r.is_sat()) {
+      bad_idx = j;
+      witness_.clear();
+      for (int t = 0; t <= j; ++t) {
+        witness_.push_back(UnorderedTermMap());
+        model_to_map(t, witness_.back());
+      }
+      solver_->pop();
+      break;
+    }
+    solver_->pop();
+  }
+  solver_->pop();
+
+  return bad_idx;
+}
+
+bool SimBmc::simulate_step(const Term & start,
+                           UnorderedTermMap & step,
+                           UnorderedTermMap & next,
+                           bool & next_bad)
+{
+  solver_->push();
+  solver_->assert_formula(start);
+  solver_->assert_formula(unroller_.at_time(ts_.trans(), 0));
+
+  // try random inputs first
+  // if constraints rule them out, let the solver pick the inputs
+  solver_->push();
+  for (const auto & iv : ts_.inputvars()) {
+    Term val = random_value(iv->get_sort());
+    if (val) {
+      solver_->assert_formula(
+          solver_->make_term(Equal, unroller_.at_time(iv, 0), val));
+    }
+  }
+  Result r = solver_->check_sat();
+  if (!r.is_sat()) {
+    solver_->pop();
+    solver_->push();
+    r = solver_->check_sat();
+  }
+
+  if (r.is_sat()) {
+    model_to_map(0, step);
+    for (const auto & sv : ts_.statevars()) {
+      next[sv] = solver_->get_value(unroller_.at_time(sv, 1));
+    }
+    next_bad = (solver_->get_value(unroller_.at_time(bad_, 1))
+                == solver_->make_term(true));
+  }
+
+  solver_->pop();
+  solver_->pop();
+  return r.is_sat();
+}
+
+Term SimBmc::state_at_time_0(const UnorderedTermMap & state)
+{
+  Term res = solver_->make_term(true);
+  for (const auto & elem : state) {
+    res = solver_->make_term(
+        And,
+        res,
+        solver_->make_term(
+            Equal, unroller_.at_time(elem.first, 0), elem.second));
+  }
+  return res;
+}
+
+void SimBmc::model_to_map(int t, UnorderedTermMap & map)
+{
+  for (const auto & v : ts_.statevars()) {
+    map[v] = solver_->get_value(unroller_.at_time(v, t));
+  }
+
+  for (const auto & v : ts_.inputvars()) {
+    map[v] = solver_->get_value(unroller_.at_time(v, t));
+  }
+
+  // the other named terms are evaluated lazily from the variables
+  for (const auto & nt : named_terms_for_solver()) {
+    map[nt] = solver_->get_value(unroller_.at_time(nt, t));
+  }
+}
+
+Term SimBmc::random_value(const Sort & sort)
+{
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    return solver_->make_term((bool)(rng_() & 1));
+  } else if (sk == BV) {
+    uint64_t width = sort->get_width();
+    if (width <= 64) {
+      uint64_t val = rng_();
+      if (width < 64) {
+        val &= (((uint64_t)1) << width) - 1;
+      }
+      return solver_->make_term(std::to_string(val), sort, 10);
+    }
+    string bits;
+    bits.reserve(width);
+    while (bits.size() < width) {
+      uint64_t val = rng_();
+      for (size_t i = 0; i < 64 && bits.size() < width; ++i) {
+        bits.push_back((val >> i) & 1 ? '1' : '0');
+      }
+    }
+    return solver_->make_term(bits, sort, 2);
+  }
+  // other sorts are left to the solver
+  return nullptr;
+}
+
+}  // namespace pono
@@ -0,0 +1,134 @@
+/*********************                                                        */
+/*! \file sim_bmc.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann, Florian Lonsing
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Simulation-guided bug hunting (state-jump BMC).
+**
+**        Alternates between random simulation, which reaches deep
+**        concrete states, and short BMC windows starting from the
+**        state reached by simulation. A counterexample found in a
+**        window is stitched together with the simulated prefix into a
+**        full witness starting in an initial state.
+**
+**        Functional systems are simulated with the native Simulator,
+**        the solver is then only used for the windows. Other systems
+**        are simulated with solver calls.
+**
+**        This engine is incomplete: it can only find bugs, it never
+**        proves a property. Only the first window, which starts from
+**        the initial states, is an exhaustive search.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <random>
+
+#include "engines/prover.h"
+#include "utils/simulator.h"
+
+namespace pono {
+
+class SimBmc : public Prover
+{
+ public:
+  SimBmc(const Property & p,
+         const TransitionSystem & ts,
+         const smt::SmtSolver & solver,
+         PonoOptions opt = PonoOptions());
+
+  ~SimBmc();
+
+  typedef Prover super;
+
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+ protected:
+  /** Run a BMC window of length up to len from time 0, where the
+   *  state at time 0 satisfies the given constraint
+   *  @param start the constraint at time 0 (e.g. init or a concrete state)
+   *  @param len the maximum length of the window
+   *  @return the bound of the first bad state in the window or -1 if none
+   *  @ensures if a bad state was found, the witness of the window
+   *           is appended to witness_
+   */
+  int bmc_window(const smt::Term & start, int len);
+
+  /** Run the random phase on the native simulator
+   *  continues the simulation where the last call stopped
+   *  @param steps the number of cycles to simulate
+   *  @param depth set to the cycle of the simulator
+   *  @param start set to the constraint pinning a simulated state
+   *  @param found_bad set to true iff a bad state was reached, then
+   *         witness_ and reached_k_ are populated
+   *  @return false if no lane satisfies the constraints anymore
+   */
+  bool simulate_native(int steps,
+                       int & depth,
+                       smt::Term & start,
+                       bool & found_bad);
+
+  /** Run the random phase with solver calls (see simulate_native)
+   *  used if the native simulator does not support the system
+   *  @param start the constraint pinning the current state, updated
+   */
+  bool simulate_smt(int steps,
+                    int & depth,
+                    smt::Term & start,
+                    bool & found_bad);
+
+  /** @return the index of the first lane in a non-empty mask */
+  static size_t first_lane(Simulator::LaneMask lanes);
+
+  /** Simulate one step with random inputs
+   *  @param start the constraint at time 0 (init or the current state)
+   *  @param step populated with the state and inputs at time 0
+   *  @param next populated with the next state values
+   *  @param next_bad set to true iff the next state is a bad state
+   *  @return false if there is no successor (e.g. constraints are violated)
+   */
+  bool simulate_step(const smt::Term & start,
+                     smt::UnorderedTermMap & step,
+                     smt::UnorderedTermMap & next,
+                     bool & next_bad);
+
+  /** Returns a term constraining the state variables at time 0
+   *  to the given concrete values
+   */
+  smt::Term state_at_time_0(const smt::UnorderedTermMap & state);
+
+  /** Populates map with the model values of state variables, inputs and
+   *  the named terms that cannot be evaluated natively at time t
+   *  @requires the last call to solver_->check_sat was sat
+   */
+  void model_to_map(int t, smt::UnorderedTermMap & map);
+
+  /** Returns a random value of the given sort or nullptr if values of
+   *  this sort are not sampled
+   */
+  smt::Term random_value(const smt::Sort & sort);
+
+  int window_;     ///< the length of the BMC windows
+  int sim_steps_;  ///< the number of simulation steps between windows
+
+  smt::Term init0_;
+
+  std::mt19937_64 rng_;
+
+  std::unique_ptr<Simulator> sim_;  ///< null if the system is unsupported
+
+  std::vector<smt::UnorderedTermMap> sim_trace_;  ///< the simulated prefix
+
+};  // class SimBmc
+
+}  // namespace pono
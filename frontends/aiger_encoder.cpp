@@ -0,0 +1,505 @@
+/*********************                                                        */
+/*! \file aiger_encoder.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Frontend for the AIGER format (ASCII .aag and binary .aig).
+**
+**
+**/
+
+#include "frontends/aiger_encoder.h"
+
+#include "smt-switch/utils.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+// marks variables that are not AND gates
+const unsigned UNDEFINED = static_cast<unsigned>(-1);
+
+}  // namespace
+
+AIGEREncoder::AIGEREncoder(string filename, FunctionalTransitionSystem & fts)
+    : fts_(fts),
+      solver_(fts.solver()),
+      filename_(filename),
+      file_(nullptr),
+      last_char_(EOF),
+      binary_(false)
+{
+  parse(filename);
+}
+
+void AIGEREncoder::parse(const string & filename)
+{
+  file_ = fopen(filename.c_str(), "rb");
+  if (!file_) {
+    throw PonoException("Could not open " + filename);
+  }
+
+  try {
+    read_header();
+
+    input_lits_.reserve(num_inputs_);
+    for (unsigned i = 0; i < num_inputs_; ++i) {
+      if (binary_) {
+        input_lits_.push_back(2 * (i + 1));
+      } else {
+        input_lits_.push_back(read_number());
+        expect('\n', "input");
+      }
+    }
+
+    latches_.reserve(num_latches_);
+    for (unsigned i = 0; i < num_latches_; ++i) {
+      unsigned lit = 2 * (num_inputs_ + i + 1);
+      if (!binary_) {
+        lit = read_number();
+        expect(' ', "latch");
+      }
+      unsigned next = read_number();
+      // reset is zero unless given (AIGER 1.9)
+      unsigned reset = 0;
+      if (last_char_ == ' ') {
+        reset = read_number();
+      }
+      expect('\n', "latch");
+      latches_.push_back(make_tuple(lit, next, reset));
+    }
+
+    read_sections();
+
+    ands_.assign(maxvar_ + 1, { UNDEFINED, UNDEFINED });
+    if (binary_) {
+      read_binary_ands();
+    } else {
+      read_ascii_ands();
+    }
+
+    read_symbols();
+  }
+  catch (...) {
+    fclose(file_);
+    file_ = nullptr;
+    throw;
+  }
+  fclose(file_);
+  file_ = nullptr;
+
+  encode();
+}
+
+void AIGEREncoder::read_header()
+{
+  string format;
+  for (int i = 0; i < 3; ++i) {
+    format += static_cast<char>(next_char());
+  }
+  if (format == "aig") {
+    binary_ = true;
+  } else if (format != "aag") {
+    throw PonoException(filename_ + " is not an AIGER file");
+  }
+  last_char_ = next_char();
+  expect(' ', "header");
+
+  maxvar_ = read_number();
+  expect(' ', "header");
+  num_inputs_ = read_number();
+  expect(' ', "header");
+  num_latches_ = read_number();
+  expect(' ', "header");
+  num_outputs_ = read_number();
+  expect(' ', "header");
+  num_ands_ = read_number();
+
+  // optional AIGER 1.9 counts
+  unsigned * optional[4] = {
+    &num_bad_, &num_constraints_, &num_justice_, &num_fairness_
+  };
+  for (auto n : optional) {
+    *n = 0;
+  }
+  for (auto n : optional) {
+    if (last_char_ != ' ') {
+      break;
+    }
+    *n = read_number();
+  }
+  expect('\n', "header");
+
+  if (binary_ && maxvar_ != num_inputs_ + num_latches_ + num_ands_) {
+    throw PonoException("Invalid header in " + filename_
+                        + ": M must be I + L + A in the binary format");
+  }
+  if (maxvar_ < num_inputs_ + num_latches_ + num_ands_) {
+    throw PonoException("Invalid header in " + filename_
+                        + ": M is smaller than I + L + A");
+  }
+}
+
+void AIGEREncoder::read_sections()
+{
+  auto read_lits = [this](unsigned num,
+                          vector<unsigned> & lits,
+                          const string & what) {
+    lits.reserve(num);
+    for (unsigned i = 0; i < num; ++i) {
+      lits.push_back(read_number());
+      expect('\n', what);
+    }
+  };
+
+  read_lits(num_outputs_, output_lits_, "output");
+  read_lits(num_bad_, bad_lits_, "bad state");
+  read_lits(num_constraints_, constraint_lits_, "constraint");
+
+  vector<unsigned> justice_sizes;
+  read_lits(num_justice_, justice_sizes, "justice size");
+  justice_lits_.resize(num_justice_);
+  for (unsigned i = 0; i < num_justice_; ++i) {
+    read_lits(justice_sizes[i], justice_lits_[i], "justice");
+  }
+
+  read_lits(num_fairness_, fairness_lits_, "fairness");
+}
+
+void AIGEREncoder::read_ascii_ands()
+{
+  for (unsigned i = 0; i < num_ands_; ++i) {
+    unsigned lhs = read_number();
+    expect(' ', "AND gate");
+    unsigned rhs0 = read_number();
+    expect(' ', "AND gate");
+    unsigned rhs1 = read_number();
+    expect('\n', "AND gate");
+    if ((lhs & 1) || lhs / 2 > maxvar_ || ands_[lhs / 2].first != UNDEFINED) {
+      throw PonoException("Invalid AND gate " + to_string(lhs) + " in "
+                          + filename_);
+    }
+    ands_[lhs / 2] = { rhs0, rhs1 };
+  }
+}
+
+void AIGEREncoder::read_binary_ands()
+{
+  // gates are in topological order, each given by two deltas:
+  // lhs - rhs0 and rhs0 - rhs1 with lhs > rhs0 >= rhs1
+  unsigned lhs = 2 * (num_inputs_ + num_latches_);
+  for (unsigned i = 0; i < num_ands_; ++i) {
+    lhs += 2;
+    unsigned delta0 = read_delta();
+    unsigned delta1 = read_delta();
+    if (!delta0 || delta0 > lhs || delta1 > lhs - delta0) {
+      throw PonoException("Invalid AND gate " + to_string(lhs) + " in "
+                          + filename_);
+    }
+    unsigned rhs0 = lhs - delta0;
+    ands_[lhs / 2] = { rhs0, rhs0 - delta1 };
+  }
+}
+
+void AIGEREncoder::read_symbols()
+{
+  input_names_.resize(num_inputs_);
+  latch_names_.resize(num_latches_);
+  output_names_.resize(num_outputs_);
+  bad_names_.resize(num_bad_);
+
+  int c;
+  while ((c = next_char()) != EOF) {
+    if (c == 'c') {
+      // either a constraint symbol or the start of the comment section
+      int d = next_char();
+      if (d == '\n' || d == EOF) {
+        break;
+      }
+      ungetc(d, file_);
+    }
+    unsigned idx = read_number();
+    expect(' ', "symbol");
+    string name = read_line();
+
+    vector<string> * names = nullptr;
+    switch (c) {
+      case 'i': names = &input_names_; break;
+      case 'l': names = &latch_names_; break;
+      case 'o': names = &output_names_; break;
+      case 'b': names = &bad_names_; break;
+      case 'c':
+      case 'j':
+      case 'f':
+        // not used
+        break;
+      default:
+        throw PonoException("Invalid symbol table entry in " + filename_);
+    }
+    if (names) {
+      if (idx >= names->size()) {
+        throw PonoException("Invalid symbol index " + to_string(idx) + " in "
+                            + filename_);
+      }
+      (*names)[idx] = name;
+    }
+  }
+}
+
+void AIGEREncoder::encode()
+{
+  Sort boolsort = solver_->make_sort(BOOL);
+  lit_terms_.resize(2 * (maxvar_ + 1));
+  lit_terms_[0] = solver_->make_term(false);
+  lit_terms_[1] = solver_->make_term(true);
+  expanded_.assign(maxvar_ + 1, false);
+
+  auto check_var = [this](unsigned lit, const string & what) {
+    if ((lit & 1) || lit < 2 || lit / 2 > maxvar_ || lit_terms_[lit]
+        || ands_[lit / 2].first != UNDEFINED) {
+      throw PonoException("Invalid " + what + " literal " + to_string(lit)
+                          + " in " + filename_);
+    }
+  };
+
+  inputsvec_.reserve(num_inputs_);
+  for (unsigned i = 0; i < num_inputs_; ++i) {
+    unsigned lit = input_lits_[i];
+    check_var(lit, "input");
+    string name = input_names_[i].empty() ? "i" + to_string(i) : input_names_[i];
+    Term input = fts_.make_inputvar(unique_name(name), boolsort);
+    lit_terms_[lit] = input;
+    inputsvec_.push_back(input);
+  }
+
+  statesvec_.reserve(num_latches_);
+  for (unsigned i = 0; i < num_latches_; ++i) {
+    unsigned lit = get<0>(latches_[i]);
+    check_var(lit, "latch");
+    string name = latch_names_[i].empty() ? "l" + to_string(i) : latch_names_[i];
+    Term state = fts_.make_statevar(unique_name(name), boolsort);
+    lit_terms_[lit] = state;
+    statesvec_.push_back(state);
+  }
+
+  for (unsigned i = 0; i < num_latches_; ++i) {
+    const Term & state = statesvec_[i];
+    unsigned lit, next, reset;
+    tie(lit, next, reset) = latches_[i];
+    if (reset == 0) {
+      fts_.constrain_init(solver_->make_term(Not, state));
+    } else if (reset == 1) {
+      fts_.constrain_init(state);
+    } else if (reset != lit) {
+      // the latch is uninitialized iff the reset is the latch itself
+      throw PonoException("Invalid reset " + to_string(reset) + " of latch "
+                          + to_string(lit) + " in " + filename_);
+    }
+    fts_.assign_next(state, lit_to_term(next));
+  }
+
+  for (auto lit : constraint_lits_) {
+    Term constraint = lit_to_term(lit);
+    // constraints over inputs need to be promoted to state variables
+    // (see also BTOR2Encoder)
+    UnorderedTermSet free_vars;
+    get_free_symbolic_consts(constraint, free_vars);
+    for (const auto & v : free_vars) {
+      if (fts_.is_input_var(v)) {
+        fts_.promote_inputvar(v);
+      }
+    }
+    fts_.add_constraint(constraint);
+  }
+
+  for (unsigned i = 0; i < num_outputs_; ++i) {
+    Term output = lit_to_term(output_lits_[i]);
+    if (!output_names_[i].empty()) {
+      try_name(output_names_[i], output);
+    }
+  }
+
+  // outputs are bad states if there are no bad state properties
+  const vector<unsigned> & bad_lits = num_bad_ ? bad_lits_ : output_lits_;
+  const vector<string> & bad_names = num_bad_ ? bad_names_ : output_names_;
+  propvec_.reserve(bad_lits.size());
+  for (size_t i = 0; i < bad_lits.size(); ++i) {
+    Term prop = lit_to_term(bad_lits[i] ^ 1);
+    if (num_bad_ && !bad_names[i].empty()) {
+      try_name(bad_names[i], prop);
+    }
+    propvec_.push_back(prop);
+  }
+
+  justicevec_.reserve(num_justice_);
+  for (const auto & lits : justice_lits_) {
+    TermVec justice;
+    justice.reserve(lits.size());
+    for (auto lit : lits) {
+      justice.push_back(lit_to_term(lit));
+    }
+    justicevec_.push_back(justice);
+  }
+
+  fairvec_.reserve(num_fairness_);
+  for (auto lit : fairness_lits_) {
+    fairvec_.push_back(lit_to_term(lit));
+  }
+
+  if (num_justice_ || num_fairness_) {
+    logger.log(1,
+               "AIGER file has {} justice and {} fairness properties",
+               num_justice_,
+               num_fairness_);
+  }
+}
+
+int AIGEREncoder::next_char()
+{
+  return getc(file_);
+}
+
+unsigned AIGEREncoder::read_number()
+{
+  int c = next_char();
+  if (c < '0' || c > '9') {
+    throw PonoException("Expected a number in " + filename_);
+  }
+  uint64_t res = 0;
+  do {
+    res = 10 * res + (c - '0');
+    if (res > UNDEFINED - 1) {
+      throw PonoException("Number out of range in " + filename_);
+    }
+    c = next_char();
+  } while (c >= '0' && c <= '9');
+  last_char_ = c;
+  return res;
+}
+
+void AIGEREncoder::expect(char c, const string & what)
+{
+  if (last_char_ != c) {
+    throw PonoException("Unexpected character while reading " + what + " in "
+                        + filename_);
+  }
+}
+
+unsigned AIGEREncoder::read_delta()
+{
+  uint64_t res = 0;
+  unsigned shift = 0;
+  int c;
+  do {
+    c = next_char();
+    if (c == EOF) {
+      throw PonoException("Unexpected end of file in " + filename_);
+    }
+    res |= static_cast<uint64_t>(c & 0x7f) << shift;
+    shift += 7;
+    if (res > UNDEFINED - 1) {
+      throw PonoException("Invalid delta in " + filename_);
+    }
+  } while (c & 0x80);
+  return res;
+}
+
+string AIGEREncoder::read_line()
+{
+  string line;
+  int c;
+  while ((c = next_char()) != '\n' && c != EOF) {
+    line += static_cast<char>(c);
+  }
+  return line;
+}
+
+Term AIGEREncoder::lit_to_term(unsigned lit)
+{
+  if (lit >= lit_terms_.size()) {
+    throw PonoException("Invalid literal " + to_string(lit) + " in "
+                        + filename_);
+  }
+
+  unsigned pos = lit & ~1u;
+  if (!lit_terms_[pos]) {
+    // build the AND gates in the fanin in post-order
+    // iteratively, the ASCII format allows arbitrarily deep gates
+    vector<unsigned> to_visit({ pos });
+    while (!to_visit.empty()) {
+      unsigned p = to_visit.back();
+      if (lit_terms_[p]) {
+        to_visit.pop_back();
+        continue;
+      }
+
+      const auto & gate = ands_[p / 2];
+      if (gate.first == UNDEFINED) {
+        throw PonoException("Undefined literal " + to_string(p) + " in "
+                            + filename_);
+      }
+      if (gate.first >= lit_terms_.size() || gate.second >= lit_terms_.size()) {
+        throw PonoException("Invalid literal in AND gate " + to_string(p)
+                            + " in " + filename_);
+      }
+
+      unsigned p0 = gate.first & ~1u;
+      unsigned p1 = gate.second & ~1u;
+      if (lit_terms_[p0] && lit_terms_[p1]) {
+        lit_terms_[p] = solver_->make_term(
+            And, lit_to_term(gate.first), lit_to_term(gate.second));
+        to_visit.pop_back();
+      } else if (expanded_[p / 2]) {
+        throw PonoException("Cyclic AND gate " + to_string(p) + " in "
+                            + filename_);
+      } else {
+        expanded_[p / 2] = true;
+        to_visit.push_back(p0);
+        to_visit.push_back(p1);
+      }
+    }
+  }
+
+  Term & res = lit_terms_[lit];
+  if (!res) {
+    res = solver_->make_term(Not, lit_terms_[pos]);
+  }
+  return res;
+}
+
+string AIGEREncoder::unique_name(const string & name)
+{
+  string res = name;
+  size_t i = 0;
+  // state variables also use the name with a .next suffix
+  while (used_names_.find(res) != used_names_.end()
+         || used_names_.find(res + ".next") != used_names_.end()) {
+    res = name + "_" + to_string(i++);
+  }
+  used_names_.insert(res);
+  used_names_.insert(res + ".next");
+  return res;
+}
+
+void AIGEREncoder::try_name(const string & name, const Term & t)
+{
+  const auto & named_terms = fts_.named_terms();
+  auto it = named_terms.find(name);
+  if (it == named_terms.end()) {
+    fts_.name_term(name, t);
+  } else if (it->second != t) {
+    logger.log(1, "Ignoring duplicate AIGER symbol {}", name);
+  }
+}
+
+}  // namespace pono
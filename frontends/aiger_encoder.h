@@ -0,0 +1,135 @@
+/*********************                                                        */
+/*! \file aiger_encoder.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Frontend for the AIGER format (ASCII .aag and binary .aig).
+**        See http://fmv.jku.at/aiger/ for more information.
+**
+**        Inputs and latches become boolean input and state variables,
+**        AND gates become boolean conjunctions (no bit-vectors of width
+**        one). Supports the AIGER 1.9 sections: bad states, invariant
+**        constraints, justice and fairness properties, and latch reset
+**        values. If there are no bad states, the outputs are the bad
+**        states (AIGER 1.0 convention).
+**
+**/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "core/fts.h"
+#include "smt-switch/smt.h"
+#include "utils/exceptions.h"
+
+namespace pono {
+
+class AIGEREncoder
+{
+ public:
+  /** Parses an AIGER file into a functional transition system
+   *  the format is determined by the header ("aag" or "aig")
+   *  throws a PonoException if the file is malformed
+   *  @param filename the file to read
+   *  @param fts the transition system to populate
+   */
+  AIGEREncoder(std::string filename, FunctionalTransitionSystem & fts);
+
+  /** the negated bad states (or outputs) in the order of the file */
+  const smt::TermVec & propvec() const { return propvec_; }
+  /** each justice property is a set of literals that must all be
+   *  infinitely often true */
+  const std::vector<smt::TermVec> & justicevec() const { return justicevec_; }
+  /** fairness constraints, must be infinitely often true */
+  const smt::TermVec & fairvec() const { return fairvec_; }
+  /** inputs and latches in the order of the file */
+  const smt::TermVec & inputsvec() const { return inputsvec_; }
+  const smt::TermVec & statesvec() const { return statesvec_; }
+
+ protected:
+  // reads the whole file, binary AND gates are decoded while streaming
+  void parse(const std::string & filename);
+  void read_header();
+  // reads the literal sections after the inputs and latches
+  void read_sections();
+  void read_ascii_ands();
+  void read_binary_ands();
+  // reads the symbol table, stops at the comment section
+  void read_symbols();
+  // creates the variables, gates and the transition system
+  void encode();
+
+  // low-level reading
+  int next_char();
+  // reads an unsigned decimal number, the following character is
+  // stored in last_char_
+  unsigned read_number();
+  // throws a PonoException if last_char_ is not c
+  void expect(char c, const std::string & what);
+  // reads a 7-bit encoded delta of the binary format
+  unsigned read_delta();
+  std::string read_line();
+
+  // @return the term for an AIGER literal, building AND gates on demand
+  smt::Term lit_to_term(unsigned lit);
+  // @return name if unused, otherwise a fresh variant of it
+  std::string unique_name(const std::string & name);
+  // names t if the name is not yet used in the transition system
+  void try_name(const std::string & name, const smt::Term & t);
+
+  FunctionalTransitionSystem & fts_;
+  const smt::SmtSolver & solver_;
+
+  std::string filename_;
+  FILE * file_;
+  int last_char_;
+  bool binary_;
+
+  // header
+  unsigned maxvar_, num_inputs_, num_latches_, num_outputs_, num_ands_;
+  unsigned num_bad_, num_constraints_, num_justice_, num_fairness_;
+
+  // sections as literals
+  std::vector<unsigned> input_lits_;
+  // latch literal, next literal, reset literal
+  std::vector<std::tuple<unsigned, unsigned, unsigned>> latches_;
+  std::vector<unsigned> output_lits_;
+  std::vector<unsigned> bad_lits_;
+  std::vector<unsigned> constraint_lits_;
+  std::vector<std::vector<unsigned>> justice_lits_;
+  std::vector<unsigned> fairness_lits_;
+  // AND gate inputs indexed by variable, UNDEFINED if not a gate
+  std::vector<std::pair<unsigned, unsigned>> ands_;
+
+  // names from the symbol table, empty if not named
+  std::vector<std::string> input_names_;
+  std::vector<std::string> latch_names_;
+  std::vector<std::string> output_names_;
+  std::vector<std::string> bad_names_;
+
+  // terms indexed by literal, null if not yet built
+  smt::TermVec lit_terms_;
+  // AND gates visited while building, to detect cycles
+  std::vector<bool> expanded_;
+  std::unordered_set<std::string> used_names_;
+
+  smt::TermVec propvec_;
+  std::vector<smt::TermVec> justicevec_;
+  smt::TermVec fairvec_;
+  smt::TermVec inputsvec_;
+  smt::TermVec statesvec_;
+};
+
+}  // namespace pono
@@ -19,7 +19,12 @@
 #include "btor2_encoder.h"
 #include "utils/logger.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <iostream>
+#include <unordered_set>
 #include "assert.h"
 
 using namespace smt;
@@ -124,9 +129,13 @@ const unordered_map<Btor2Tag, smt::PrimOp> boolopmap({
 Term BTOR2Encoder::bool_to_bv(const Term & t) const
 {
   if (t->get_sort()->get_sort_kind() == BOOL) {
-    Sort bv1sort = solver_->make_sort(BV, 1);
-    return solver_->make_term(
-        Ite, t, solver_->make_term(1, bv1sort), solver_->make_term(0, bv1sort));
+    auto it = bool_to_bv_cache_.find(t);
+    if (it != bool_to_bv_cache_.end()) {
+      return it->second;
+    }
+    Term res = solver_->make_term(Ite, t, bv1_one_, bv1_zero_);
+    bool_to_bv_cache_[t] = res;
+    return res;
   } else {
     return t;
   }
@@ -139,8 +148,13 @@ Term BTOR2Encoder::bv_to_bool(const Term & t) const
     if (sort->get_width() != 1) {
       throw PonoException("Can't convert non-width 1 bitvector to bool.");
     }
-    return solver_->make_term(
-        Equal, t, solver_->make_term(1, solver_->make_sort(BV, 1)));
+    auto it = bv_to_bool_cache_.find(t);
+    if (it != bv_to_bool_cache_.end()) {
+      return it->second;
+    }
+    Term res = solver_->make_term(Equal, t, bv1_one_);
+    bv_to_bool_cache_[t] = res;
+    return res;
   } else {
     return t;
   }
@@ -184,26 +198,66 @@ TermVec BTOR2Encoder::lazy_convert(const TermVec & tvec) const
 }
 
 
-// to handle the case where yosys generate sth. like this
-// state (with no name)
-// output (with name)
-// for Verilog :  output reg xxx;
+void BTOR2Encoder::read_lines(const std::string & filename)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw PonoException("Could not open " + filename);
+  }
 
-// this function go over the file and record this case
-// when we encounter it again we shall replace the state's name
-void BTOR2Encoder::preprocess(const std::string& filename) {
-  FILE * input_file = fopen(filename.c_str(), "r");
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    close(fd);
+    throw PonoException("Could not stat " + filename);
+  }
+  size_t size = st.st_size;
+
+  // map the file and let btor2parser read from memory
+  // falls back to regular reads if the file cannot be mapped (e.g. empty)
+  void * data = MAP_FAILED;
+  if (size) {
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  FILE * input_file;
+  if (data != MAP_FAILED) {
+    madvise(data, size, MADV_SEQUENTIAL);
+    input_file = fmemopen(data, size, "r");
+  } else {
+    input_file = fdopen(dup(fd), "r");
+  }
+  close(fd);
 
   if (!input_file) {
+    if (data != MAP_FAILED) {
+      munmap(data, size);
+    }
     throw PonoException("Could not open " + filename);
   }
 
   reader_ = btor2parser_new();
+  // the parser copies everything it keeps, the mapping can be released
+  bool success = btor2parser_read_lines(reader_, input_file);
+  fclose(input_file);
+  if (data != MAP_FAILED) {
+    munmap(data, size);
+  }
 
-  if (!btor2parser_read_lines(reader_, input_file)) {
-    throw PonoException(std::string(btor2parser_error(reader_)));
+  if (!success) {
+    std::string msg(btor2parser_error(reader_));
+    btor2parser_delete(reader_);
+    throw PonoException(msg);
   }
+}
 
+// to handle the case where yosys generate sth. like this
+// state (with no name)
+// output (with name)
+// for Verilog :  output reg xxx;
+
+// this function go over the parsed lines and record this case
+// when we encounter it again we shall replace the state's name
+void BTOR2Encoder::preprocess()
+{
   it_ = btor2parser_iter_init(reader_);
 
   std::unordered_set<uint64_t> unamed_state_ids;
@@ -228,24 +282,21 @@ void BTOR2Encoder::preprocess(const std::string& filename) {
       }
     } // end of if input
   } // end of while
-
-  fclose(input_file);
-  btor2parser_delete(reader_);
 } // end of preprocess
 
 void BTOR2Encoder::parse(const std::string filename)
 {
-  FILE * input_file = fopen(filename.c_str(), "r");
-
-  if (!input_file) {
-    throw PonoException("Could not open " + filename);
-  }
+  Sort bv1sort = solver_->make_sort(BV, 1);
+  bv1_one_ = solver_->make_term(1, bv1sort);
+  bv1_zero_ = solver_->make_term(0, bv1sort);
 
-  reader_ = btor2parser_new();
+  read_lines(filename);
+  preprocess();
 
-  if (!btor2parser_read_lines(reader_, input_file)) {
-    throw PonoException(std::string(btor2parser_error(reader_)));
-  }
+  // ids are bounded by the number of lines in practice, but don't rely on it
+  int64_t max_id = btor2parser_max_id(reader_);
+  sorts_.assign(max_id + 1, nullptr);
+  terms_.assign(max_id + 1, nullptr);
 
   uint64_t num_states = 0;
   std::unordered_map<int64_t, uint64_t> id2statenum;
@@ -255,7 +306,11 @@ void BTOR2Encoder::parse(const std::string filename)
     /******************************** Identify sort
      * ********************************/
     if (l_->tag != BTOR2_TAG_sort && l_->sort.id) {
-      linesort_ = sorts_.at(l_->sort.id);
+      if ((size_t)l_->sort.id >= sorts_.size() || !sorts_[l_->sort.id]) {
+        throw PonoException("Missing sort for id "
+                            + std::to_string(l_->sort.id));
+      }
+      linesort_ = sorts_[l_->sort.id];
     }
 
     /******************************** Gather term arguments
@@ -269,11 +324,11 @@ void BTOR2Encoder::parse(const std::string filename)
         negated_ = true;
         idx_ = -idx_;
       }
-      if (terms_.find(idx_) == terms_.end()) {
+      if ((size_t)idx_ >= terms_.size() || !terms_[idx_]) {
         throw PonoException("Missing term for id " + std::to_string(idx_));
       }
 
-      Term term_ = terms_.at(idx_);
+      Term term_ = terms_[idx_];
       if (negated_) {
         if (term_->get_sort()->get_sort_kind() == BV) {
           term_ = solver_->make_term(BVNot, term_);
@@ -334,9 +389,13 @@ void BTOR2Encoder::parse(const std::string filename)
           break;
         }
         case BTOR2_TAG_SORT_array: {
-          linesort_ = solver_->make_sort(ARRAY,
-                                         sorts_.at(l_->sort.array.index),
-                                         sorts_.at(l_->sort.array.element));
+          Sort idxsort = sorts_.at(l_->sort.array.index);
+          Sort elemsort = sorts_.at(l_->sort.array.element);
+          if (!idxsort || !elemsort) {
+            throw PonoException("Missing sort for array sort "
+                                + std::to_string(l_->id));
+          }
+          linesort_ = solver_->make_sort(ARRAY, idxsort, elemsort);
           sorts_[l_->id] = linesort_;
           break;
         }
@@ -417,13 +476,17 @@ void BTOR2Encoder::parse(const std::string filename)
       propvec_.push_back(prop);
       terms_[l_->id] = prop;
     } else if (l_->tag == BTOR2_TAG_justice) {
-      std::cout << "Warning: ignoring justice term" << std::endl;
-      justicevec_.push_back(termargs_[0]);
-      terms_[l_->id] = termargs_[0];
+      // all arguments must be infinitely often true
+      TermVec justice;
+      for (const auto & arg : termargs_) {
+        justice.push_back(bv_to_bool(arg));
+      }
+      justicevec_.push_back(justice);
+      terms_[l_->id] = justice[0];
     } else if (l_->tag == BTOR2_TAG_fair) {
-      std::cout << "Warning: ignoring fair term" << std::endl;
-      fairvec_.push_back(termargs_[0]);
-      terms_[l_->id] = termargs_[0];
+      Term fair = bv_to_bool(termargs_[0]);
+      fairvec_.push_back(fair);
+      terms_[l_->id] = fair;
     } else if (l_->constant) {
       terms_[l_->id] =
           solver_->make_term(l_->constant, linesort_, basemap.at(l_->tag));
@@ -742,9 +805,9 @@ void BTOR2Encoder::parse(const std::string filename)
     // use the symbol to name the term (if applicable)
     // input, output, and state already named
     if (l_->symbol && l_->tag != BTOR2_TAG_input && l_->tag != BTOR2_TAG_output
-        && l_->tag != BTOR2_TAG_state && terms_.find(l_->id) != terms_.end()) {
+        && l_->tag != BTOR2_TAG_state && terms_[l_->id]) {
       try {
-        ts_.name_term(l_->symbol, terms_.at(l_->id));
+        ts_.name_term(l_->symbol, terms_[l_->id]);
       }
       catch (PonoException & e) {
         logger.log(1, "BTOR2Encoder Warning: {}", e.what());
@@ -752,10 +815,9 @@ void BTOR2Encoder::parse(const std::string filename)
     }
 
     // sort tag should be the only one that doesn't populate terms_
-    assert(l_->tag == BTOR2_TAG_sort || terms_.find(l_->id) != terms_.end());
+    assert(l_->tag == BTOR2_TAG_sort || terms_[l_->id]);
   }
 
-  fclose(input_file);
   btor2parser_delete(reader_);
 }
 }  // namespace pono
@@ -26,6 +26,7 @@ extern "C" {
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "assert.h"
 
 #include "core/ts.h"
@@ -40,12 +41,11 @@ class BTOR2Encoder
   BTOR2Encoder(std::string filename, TransitionSystem & ts)
       : ts_(ts), solver_(ts.solver())
   {
-    preprocess(filename);
     parse(filename);
   };
 
   const smt::TermVec & propvec() const { return propvec_; };
-  const smt::TermVec & justicevec() const { return justicevec_; };
+  const std::vector<smt::TermVec> & justicevec() const { return justicevec_; };
   const smt::TermVec & fairvec() const { return fairvec_; };
   const smt::TermVec & inputsvec() const { return inputsvec_; }
   const smt::TermVec & statesvec() const { return statesvec_; }
@@ -56,6 +56,7 @@ class BTOR2Encoder
 
  protected:
   // converts booleans to bitvector of size one
+  // conversions are cached, the same terms are converted many times
   smt::Term bool_to_bv(const smt::Term & t) const;
   // converts bitvector of size one to boolean
   smt::Term bv_to_bool(const smt::Term & t) const;
@@ -64,8 +65,12 @@ class BTOR2Encoder
   // and lazily converts them to the majority
   smt::TermVec lazy_convert(const smt::TermVec &) const;
   
-  // preprocess a btor2 file
-  void preprocess(const std::string & filename);
+  // reads and parses all lines of a btor2 file into reader_
+  // the file is memory-mapped and read only once
+  void read_lines(const std::string & filename);
+  // collects names of unnamed states from named outputs
+  // walks the lines already parsed by read_lines
+  void preprocess();
   // parse a btor2 file
   void parse(const std::string filename);
 
@@ -83,12 +88,13 @@ class BTOR2Encoder
   // Useful variables
   smt::Sort linesort_;
   smt::TermVec termargs_;
-  std::unordered_map<int, smt::Sort> sorts_;
-  std::unordered_map<int, smt::Term> terms_;
+  // sorts and terms indexed by line id (ids are dense in practice)
+  std::vector<smt::Sort> sorts_;
+  smt::TermVec terms_;
   std::string symbol_;
 
   smt::TermVec propvec_;
-  smt::TermVec justicevec_;
+  std::vector<smt::TermVec> justicevec_;
   smt::TermVec fairvec_;
 
   Btor2Parser * reader_;
@@ -98,5 +104,10 @@ class BTOR2Encoder
   int64_t idx_;
   bool negated_;
   size_t witness_id_{ 0 };  ///< id of any introduced witnesses for properties
+
+  smt::Term bv1_one_;
+  smt::Term bv1_zero_;
+  mutable smt::UnorderedTermMap bool_to_bv_cache_;
+  mutable smt::UnorderedTermMap bv_to_bool_cache_;
 };
 }  // namespace pono
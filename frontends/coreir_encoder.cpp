@@ -1,5 +1,8 @@
 #include "frontends/coreir_encoder.h"
+#include "smt-switch/substitution_walker.h"
 #include "utils/logger.h"
+#include "utils/term_analysis.h"
+#include "utils/timestamp.h"
 
 #include <iostream>
 #include <set>
@@ -26,6 +29,16 @@ bool instance_of(CoreIR::Instance * inst, std::string ns, std::string name)
   return gen->getName() == name && gen->getNamespace()->getName() == ns;
 }
 
+// true iff inst is a register that prevents abstracting the clock
+bool has_async_behavior(CoreIR::Instance * inst)
+{
+  if (instance_of(inst, "coreir", "reg_arst")) {
+    return true;
+  }
+  return instance_of(inst, "coreir", "reg")
+         && !inst->getModArgs().at("clk_posedge")->get<bool>();
+}
+
 // operator map
 
 const unordered_map<string, PrimOp> boolopmap(
@@ -59,20 +72,85 @@ Module * CoreIREncoder::read_coreir_file(Context * c, std::string filename)
 
 // member functions
 
-void CoreIREncoder::encode()
+CoreIREncoder::CoreIREncoder(Module * m,
+                             CoreIRModuleTemplate & tmpl,
+                             const CoreIREncoder & parent)
+    : ts_(tmpl.ts),
+      solver_(parent.solver_),
+      c_(parent.c_),
+      top_(m),
+      num_clocks_(0),
+      can_abstract_clock_(parent.can_abstract_clock_),
+      force_abstract_clock_(parent.force_abstract_clock_),
+      nested_(true),
+      tmpl_(&tmpl),
+      prefix_(tmpl.prefix),
+      templates_(parent.templates_),
+      bvsort1_(parent.bvsort1_),
+      boolsort_(parent.boolsort_),
+      bv1_(parent.bv1_)
 {
-  // expecting top_ to be non-null
-  assert(top_);
+  encode();
+}
 
+void CoreIREncoder::run_passes(const vector<string> & passes)
+{
   /* running passes prints to stdout -- redirect output */
   // save old stdout
   streambuf * stdout = cout.rdbuf();
   stringstream ss;
   // redirect
   cout.rdbuf(ss.rdbuf());
-  c_->runPasses(passes_, { "global" });
+  c_->runPasses(passes, { "global" });
   // replace stdout
   cout.rdbuf(stdout);
+}
+
+void CoreIREncoder::collect_submodules(Module * m,
+                                       unordered_set<Module *> & submodules)
+{
+  for (auto ipair : m->getDef()->getInstances()) {
+    Module * sub = ipair.second->getModuleRef();
+    if (sub->hasDef() && !instance_of(ipair.second, "coreir", "reg")
+        && !instance_of(ipair.second, "coreir", "reg_arst")
+        && submodules.insert(sub).second) {
+      collect_submodules(sub, submodules);
+    }
+  }
+}
+
+void CoreIREncoder::encode()
+{
+  // expecting top_ to be non-null
+  assert(top_);
+
+  if (!nested_) {
+    run_passes(passes_);
+
+    unordered_set<Module *> submodules;
+    collect_submodules(top_, submodules);
+    for (auto m : submodules) {
+      if (!m->getModParams().empty()) {
+        // the encoding would depend on the arguments of each instance
+        logger.log(1,
+                   "INFO flattening CoreIR Module {} because {} has parameters",
+                   top_->getName(),
+                   m->getName());
+        run_passes(flatten_passes_);
+        submodules.clear();
+        break;
+      }
+    }
+
+    // the clock encoding is shared by all modules
+    for (auto m : submodules) {
+      for (auto ipair : m->getDef()->getInstances()) {
+        if (has_async_behavior(ipair.second)) {
+          can_abstract_clock_ = false;
+        }
+      }
+    }
+  }
 
   // start processing module
   def_ = top_->getDef();
@@ -132,20 +210,24 @@ void CoreIREncoder::encode()
     bool is_clk;
     if ((is_clk = elem.second->getType()->toString() == "coreir.clk")
         || elem.second->getType()->toString() == "coreir.arst") {
-      t_ = ts_.make_statevar(elem.first, boolsort_);
+      t_ = make_statevar(elem.first, boolsort_);
       w2term_[elem.second] = t_;
       if (is_clk) {
         num_clocks_++;
       }
     } else if (type_->isInput() || type_->isInOut()) {
       sort_ = compute_sort(elem.second);
-      t_ = ts_.make_inputvar(elem.first, sort_);
+      t_ = make_inputvar(elem.first, sort_);
       w2term_[elem.second] = t_;
     } else {
       // if not a clock or global input, don't need to connect it yet
       continue;
     }
 
+    if (nested_) {
+      tmpl_->inputs[elem.first] = t_;
+    }
+
     // assign all the connections to these global inputs
     Wireable * dst;
     Wireable * parent;
@@ -179,78 +261,139 @@ void CoreIREncoder::encode()
     }
   }
 
-  // can't abstract the clock if there's more than one
-  can_abstract_clock_ &= (num_clocks_ <= 1);
+  if (!nested_) {
+    // can't abstract the clock if there's more than one
+    can_abstract_clock_ &= (num_clocks_ <= 1);
 
-  logger.log(1,
-             "INFO {} abstract clock for CoreIR Module {}",
-             can_abstract_clock_ ? "can" : "cannot",
-             top_->getName());
+    logger.log(1,
+               "INFO {} abstract clock for CoreIR Module {}",
+               can_abstract_clock_ ? "can" : "cannot",
+               top_->getName());
 
-  if (!can_abstract_clock_ && force_abstract_clock_) {
-    logger.log(1, "INFO forcing clock abstraction based on user-provided flag");
+    if (!can_abstract_clock_ && force_abstract_clock_) {
+      logger.log(1,
+                 "INFO forcing clock abstraction based on user-provided flag");
+    }
   }
 
   // process the rest in topological order
   size_t processed_instances = 0;
   unordered_set<Instance *> visited_instances;
-  while (instances.size()) {
-    inst_ = instances.back();
-    instances.pop_back();
+  vector<Wireable *> inst_outs;
+  while (true) {
+    while (instances.size()) {
+      inst_ = instances.back();
+      instances.pop_back();
+
+      if (visited_instances.find(inst_) != visited_instances.end()) {
+        // this module has already been processed
+        continue;
+      } else {
+        // mark this instance as visited
+        visited_instances.insert(inst_);
+      }
 
-    if (visited_instances.find(inst_) != visited_instances.end()) {
-      // this module has already been processed
-      continue;
-    } else {
-      // mark this instance as visited
-      visited_instances.insert(inst_);
+      if (inst_->getModuleRef()->hasDef()
+          && state_elements.find(inst_) == state_elements.end()) {
+        inst_outs = instantiate_module(inst_);
+      } else {
+        inst_outs = { process_instance(inst_) };
+      }
+      processed_instances++;
+
+      // check everything connected to outputs
+      // append to list if all other inputs have been seen already
+
+      Wireable * dst;
+      Wireable * parent;
+      Instance * parent_inst;
+      for (auto inst_out : inst_outs) {
+        auto it = w2term_.find(inst_out);
+        if (it != w2term_.end()) {
+          t_ = it->second;
+        }
+        for (Connection conn : inst_out->getLocalConnections()) {
+          wire_connection(conn);
+          dst = conn.second;
+          type_ = dst->getType();
+
+          // expecting to have a destination with type input or InOut
+          assert(type_->isInput() || type_->isInOut());
+
+          // parent is either an instance or a top-level input
+          parent = dst->getTopParent();
+          if (Instance::classof(parent)) {
+            parent_inst = dyn_cast<Instance>(parent);
+
+            // state_elements have already been added to instances
+            // so ignore those
+            if (instance_of(parent_inst, "coreir", "reg")
+                || instance_of(parent_inst, "coreir", "reg_arst")) {
+              continue;
+            }
+
+            Wireable * dst_parent = dst;
+            if (isa<CoreIR::Select>(dst)
+                && isNumber(cast<CoreIR::Select>(dst)->getSelStr())) {
+              // shouldn't count bit-selects as individual inputs
+              // need to get parent
+              dst_parent = cast<CoreIR::Select>(dst)->getParent();
+            }
+            covered_inputs[parent_inst].insert(dst_parent);
+
+            // if all inputs are driven, then add onto stack to be processed
+            if (num_inputs[parent_inst]
+                    == covered_inputs.at(parent_inst).size()
+                // optimization -- don't even add to stack if already visited
+                && visited_instances.find(parent_inst)
+                       == visited_instances.end()) {
+              instances.push_back(parent_inst);
+            }
+          }
+        }
+      }
     }
 
-    Wireable * inst_out = process_instance(inst_);
-    processed_instances++;
-
-    // check everything connected to outputs
-    // append to list if all other inputs have been seen already
-
-    Wireable * dst;
-    Wireable * parent;
-    Instance * parent_inst;
-    for (Connection conn : inst_out->getLocalConnections()) {
-      wire_connection(conn);
-      dst = conn.second;
-      type_ = dst->getType();
-
-      // expecting to have a destination with type input or InOut
-      assert(type_->isInput() || type_->isInOut());
-
-      // parent is either an instance or a top-level input
-      parent = dst->getTopParent();
-      if (Instance::classof(parent)) {
-        parent_inst = dyn_cast<Instance>(parent);
+    if (processed_instances == def_->getInstances().size()) {
+      break;
+    }
 
-        // state_elements have already been added to instances so ignore those
-        if (instance_of(parent_inst, "coreir", "reg")
-            || instance_of(parent_inst, "coreir", "reg_arst")) {
-          continue;
-        }
+    // without flattening, connections between module instances can form a
+    // cycle even if there is no combinational loop
+    // break it with forward references for the inputs of a pending module
+    Instance * pending = nullptr;
+    size_t max_covered = 0;
+    for (auto ipair : def_->getInstances()) {
+      if (visited_instances.find(ipair.second) != visited_instances.end()
+          || !ipair.second->getModuleRef()->hasDef()
+          || state_elements.find(ipair.second) != state_elements.end()) {
+        continue;
+      }
+      size_t n = covered_inputs[ipair.second].size();
+      if (!pending || n > max_covered) {
+        pending = ipair.second;
+        max_covered = n;
+      }
+    }
 
-        Wireable * dst_parent = dst;
-        if (isa<CoreIR::Select>(dst)
-            && isNumber(cast<CoreIR::Select>(dst)->getSelStr())) {
-          // shouldn't count bit-selects as individual inputs
-          // need to get parent
-          dst_parent = cast<CoreIR::Select>(dst)->getParent();
-        }
-        covered_inputs[parent_inst].insert(dst_parent);
+    if (!pending) {
+      break;
+    }
 
-        // if all inputs are driven, then add onto stack to be processed
-        if (num_inputs[parent_inst] == covered_inputs.at(parent_inst).size()
-            // optimization -- don't even add to stack if already visited
-            && visited_instances.find(parent_inst) == visited_instances.end()) {
-          instances.push_back(parent_inst);
-        }
+    logger.log(1,
+               "INFO using forward references for the inputs of CoreIR "
+               "instance {}",
+               pending->toString());
+    for (auto elem : pending->getSelects()) {
+      type_ = elem.second->getType();
+      if ((type_->isInput() || type_->isInOut())
+          && w2term_.find(elem.second) == w2term_.end()) {
+        sort_ = compute_sort(elem.second);
+        w2term_[elem.second] = make_inputvar(elem.second->toString(), sort_);
+        forward_refs_.insert(elem.second);
       }
     }
+    instances.push_back(pending);
   }
 
   if (processed_instances != def_->getInstances().size()) {
@@ -261,6 +404,156 @@ void CoreIREncoder::encode()
   for (auto st : state_elements) {
     process_state_element(st);
   }
+
+  if (nested_) {
+    // collect the terms driving the outputs of the module
+    for (auto elem : def_->getInterface()->getSelects()) {
+      auto it = w2term_.find(elem.second);
+      if (elem.second->getType()->getFlipped()->isOutput()
+          && it != w2term_.end()) {
+        tmpl_->outputs[elem.first] = it->second;
+      }
+    }
+    tmpl_->num_terms = dag_size(TermVec{ ts_.init(), ts_.trans() });
+  } else {
+    log_templates();
+  }
+}
+
+vector<Wireable *> CoreIREncoder::instantiate_module(Instance * inst)
+{
+  CoreIRModuleTemplate & tmpl = get_template(inst->getModuleRef());
+  auto begin = timestamp();
+  string inst_prefix = inst->toString() + "$";
+  const RelationalTransitionSystem & tts = tmpl.ts;
+
+  UnorderedTermMap subst;
+  // interface inputs are replaced by their drivers
+  Term driver;
+  for (auto elem : tmpl.inputs) {
+    Wireable * port = inst->sel(elem.first);
+    auto it = w2term_.find(port);
+    bool is_state = tts.is_curr_var(elem.second);
+    if (it != w2term_.end()) {
+      driver = it->second;
+    } else {
+      logger.log(1, "Warning: no driver for {}", port->toString());
+      sort_ = elem.second->get_sort();
+      driver = is_state ? make_statevar(port->toString(), sort_)
+                        : make_inputvar(port->toString(), sort_);
+    }
+    subst[elem.second] = driver;
+
+    if (is_state) {
+      // clocks and asynchronous resets, need the next state for edges
+      if (ts_.only_curr(driver)) {
+        subst[tts.next(elem.second)] = ts_.next(driver);
+      } else if (!can_abstract_clock_ && !force_abstract_clock_) {
+        throw PonoException("Driver for " + port->toString()
+                            + " has non-state variables -- causes semantic "
+                              "issues with transition system.");
+      }
+    }
+  }
+
+  // every other symbol gets a fresh copy for this instance
+  Term fresh;
+  for (auto sv : tts.statevars()) {
+    if (subst.find(sv) == subst.end()) {
+      fresh = make_statevar(inst_prefix + tmpl.symbol_names.at(sv),
+                            sv->get_sort());
+      subst[sv] = fresh;
+      subst[tts.next(sv)] = ts_.next(fresh);
+    }
+  }
+  for (auto iv : tts.inputvars()) {
+    if (subst.find(iv) == subst.end()) {
+      subst[iv] = make_inputvar(inst_prefix + tmpl.symbol_names.at(iv),
+                                iv->get_sort());
+    }
+  }
+
+  // the cache is shared by all terms of this instance
+  SubstitutionWalker sw(solver_, subst);
+  for (auto elem : tts.state_updates()) {
+    ts_.assign_next(subst.at(elem.first), sw.visit(elem.second));
+  }
+  for (auto elem : tts.constraints()) {
+    ts_.add_constraint(sw.visit(elem.first), elem.second);
+  }
+  for (auto c : tmpl.init_constraints) {
+    constrain_init(sw.visit(c));
+  }
+  for (auto c : tmpl.trans_constraints) {
+    constrain_trans(sw.visit(c));
+  }
+
+  // names of wires inside the module, the symbols were named above
+  for (auto elem : tts.named_terms()) {
+    if (elem.first.compare(0, tmpl.prefix.size(), tmpl.prefix) == 0) {
+      continue;
+    }
+    string name = inst_prefix + elem.first;
+    if (ts_.named_terms().find(name) == ts_.named_terms().end()) {
+      ts_.name_term(name, sw.visit(elem.second));
+    }
+  }
+
+  vector<Wireable *> outs;
+  for (auto elem : inst->getSelects()) {
+    if (!elem.second->getType()->isOutput()) {
+      continue;
+    }
+    auto it = tmpl.outputs.find(elem.first);
+    if (it != tmpl.outputs.end()) {
+      t_ = sw.visit(it->second);
+    } else {
+      logger.log(1, "Warning: no driver for {}", elem.second->toString());
+      t_ = make_inputvar(elem.second->toString(), compute_sort(elem.second));
+    }
+    w2term_[elem.second] = t_;
+    ts_.name_term(elem.second->toString(), t_);
+    outs.push_back(elem.second);
+  }
+
+  tmpl.num_instances++;
+  tmpl.instantiate_time +=
+      time_duration_to_sec(timestamp_diff(begin, timestamp()));
+  return outs;
+}
+
+CoreIRModuleTemplate & CoreIREncoder::get_template(Module * m)
+{
+  auto it = templates_->find(m);
+  if (it != templates_->end()) {
+    return *it->second;
+  }
+
+  auto tmpl = make_shared<CoreIRModuleTemplate>(solver_);
+  // module names are only unique within a namespace
+  tmpl->prefix = "template" + std::to_string(templates_->size()) + "$"
+                 + m->getName() + "$";
+  (*templates_)[m] = tmpl;
+
+  auto begin = timestamp();
+  CoreIREncoder enc(m, *tmpl, *this);
+  tmpl->encode_time = time_duration_to_sec(timestamp_diff(begin, timestamp()));
+  return *tmpl;
+}
+
+void CoreIREncoder::log_templates() const
+{
+  for (auto elem : *templates_) {
+    const CoreIRModuleTemplate & tmpl = *elem.second;
+    logger.log(1,
+               "INFO CoreIR Module {}: {} instances, {} terms, encoded in {} "
+               "s, instantiated in {} s",
+               elem.first->getRefName(),
+               tmpl.num_instances,
+               tmpl.num_terms,
+               tmpl.encode_time,
+               tmpl.instantiate_time);
+  }
 }
 
 Wireable * CoreIREncoder::process_instance(CoreIR::Instance * inst)
@@ -291,7 +584,7 @@ Wireable * CoreIREncoder::process_instance(CoreIR::Instance * inst)
     // NOTE: inputs to state_elements are not wired up until later
     sort_ = solver_->make_sort(
         BV, inst->getModuleRef()->getGenArgs().at("width")->get<int>());
-    t_ = ts_.make_statevar(inst->toString(), sort_);
+    t_ = make_statevar(inst->toString(), sort_);
   } else if (nsname == "coreir" && name == "const") {
     size_t w = mod_->getGenArgs().at("width")->get<int>();
     sort_ = solver_->make_sort(BV, w);
@@ -319,9 +612,9 @@ Wireable * CoreIREncoder::process_instance(CoreIR::Instance * inst)
         Concat, w2term_.at(inst->sel("in0")), w2term_.at(inst->sel("in1")));
   } else if (nsname == "coreir" && name == "undriven") {
     sort_ = solver_->make_sort(BV, mod_->getGenArgs().at("width")->get<int>());
-    t_ = ts_.make_inputvar(inst->toString(), sort_);
+    t_ = make_inputvar(inst->toString(), sort_);
   } else if (nsname == "corebit" && name == "undriven") {
-    t_ = ts_.make_inputvar(inst->toString(), boolsort_);
+    t_ = make_inputvar(inst->toString(), boolsort_);
   } else if (name == "andr") {
     // reduce and over bits is only 1 if all bits are 1
     Term in = w2term_.at(inst->sel("in"));
@@ -388,7 +681,7 @@ void CoreIREncoder::process_state_element(Instance * st)
           solver_->make_term(vals.at("init")->get<BitVec>().binary_string(),
                              stterm->get_sort(),
                              2);
-      ts_.constrain_init(solver_->make_term(Equal, stterm, initval));
+      constrain_init(solver_->make_term(Equal, stterm, initval));
     }
 
   } else {
@@ -407,8 +700,8 @@ void CoreIREncoder::process_state_element(Instance * st)
       in = w2term_.at(st->sel("in"));
     } else {
       logger.log(1, "Warning: no driver for register {}", st->toString());
-      in = ts_.make_inputvar(st->sel("in")->toString(),
-                             compute_sort(st->sel("in")));
+      in = make_inputvar(st->sel("in")->toString(),
+                         compute_sort(st->sel("in")));
     }
 
     assert(w2term_.find(st) != w2term_.end());
@@ -449,7 +742,7 @@ void CoreIREncoder::process_state_element(Instance * st)
       } else {
         logger.log(
             1, "Warning: no driver for register arst: {}", st->toString());
-        arst_driver = ts_.make_statevar(st->sel("arst")->toString(), boolsort_);
+        arst_driver = make_statevar(st->sel("arst")->toString(), boolsort_);
       }
 
       Term active_arst;
@@ -464,11 +757,10 @@ void CoreIREncoder::process_state_element(Instance * st)
       next_st = solver_->make_term(Ite, active_arst, initval, next_st);
     }
 
-    ts_.constrain_trans(
-        solver_->make_term(Equal, ts_.next(cur_stterm), next_st));
+    constrain_trans(solver_->make_term(Equal, ts_.next(cur_stterm), next_st));
 
     if (initval) {
-      ts_.constrain_init(solver_->make_term(Equal, cur_stterm, initval));
+      constrain_init(solver_->make_term(Equal, cur_stterm, initval));
     }
   }
 }
@@ -506,7 +798,7 @@ void CoreIREncoder::wire_connection(Connection conn)
       // create new "input" (actually more of a definition) for dst parent
       // need a forward reference for it
       sort_ = compute_sort(parent);
-      tparent = ts_.make_inputvar(parent->toString(), sort_);
+      tparent = make_inputvar(parent->toString(), sort_);
       // cache this symbol
       w2term_[parent] = tparent;
     } else {
@@ -539,7 +831,7 @@ void CoreIREncoder::wire_connection(Connection conn)
       // create new "input" (actually more of a definition) for dst parent
       // need a forward reference for it
       sort_ = compute_sort(dst_parent);
-      term_dst_parent = ts_.make_inputvar(dst_parent->toString(), sort_);
+      term_dst_parent = make_inputvar(dst_parent->toString(), sort_);
       w2term_[dst_parent] = term_dst_parent;
     } else {
       term_dst_parent = w2term_.at(dst_parent);
@@ -560,9 +852,15 @@ void CoreIREncoder::wire_connection(Connection conn)
     tmpterm = t_;
   }
 
-  if (w2term_.find(dst) != w2term_.end()) {
-    throw PonoException("CoreIREncoder error. Multiple drivers for "
-                        + dst->toString());
+  auto it = w2term_.find(dst);
+  if (it != w2term_.end()) {
+    if (forward_refs_.find(dst) == forward_refs_.end()) {
+      throw PonoException("CoreIREncoder error. Multiple drivers for "
+                          + dst->toString());
+    }
+    // the destination was used before its driver was processed
+    ts_.add_constraint(solver_->make_term(Equal, it->second, tmpterm));
+    return;
   }
 
   // name and save the value for the dst
@@ -584,4 +882,38 @@ Sort CoreIREncoder::compute_sort(CoreIR::Wireable * w)
   return s;
 }
 
+Term CoreIREncoder::make_statevar(const string & name, const Sort & sort)
+{
+  Term sv = ts_.make_statevar(prefix_ + name, sort);
+  if (nested_) {
+    tmpl_->symbol_names[sv] = name;
+  }
+  return sv;
+}
+
+Term CoreIREncoder::make_inputvar(const string & name, const Sort & sort)
+{
+  Term iv = ts_.make_inputvar(prefix_ + name, sort);
+  if (nested_) {
+    tmpl_->symbol_names[iv] = name;
+  }
+  return iv;
+}
+
+void CoreIREncoder::constrain_init(const Term & constraint)
+{
+  ts_.constrain_init(constraint);
+  if (nested_) {
+    tmpl_->init_constraints.push_back(constraint);
+  }
+}
+
+void CoreIREncoder::constrain_trans(const Term & constraint)
+{
+  ts_.constrain_trans(constraint);
+  if (nested_) {
+    tmpl_->trans_constraints.push_back(constraint);
+  }
+}
+
 }  // namespace pono
@@ -1,4 +1,7 @@
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "coreir.h"
@@ -7,6 +10,32 @@
 #include "smt-switch/smt.h"
 
 namespace pono {
+
+/** A CoreIR module definition encoded once over template symbols
+ *  Instances of the module are stamped out by substituting the
+ *  interface inputs with their drivers and the other symbols with
+ *  fresh symbols named after the instance.
+ */
+struct CoreIRModuleTemplate
+{
+  CoreIRModuleTemplate(const smt::SmtSolver & s) : ts(s) {}
+
+  RelationalTransitionSystem ts;  ///< the encoding over template symbols
+  std::string prefix;  ///< prefix of the template symbol names
+  ///< maps template symbols to their names without the template prefix
+  std::unordered_map<smt::Term, std::string> symbol_names;
+  std::unordered_map<std::string, smt::Term> inputs;   ///< by port name
+  std::unordered_map<std::string, smt::Term> outputs;  ///< by port name
+  smt::TermVec init_constraints;   ///< e.g. register initial values
+  smt::TermVec trans_constraints;  ///< not covered by state updates
+
+  // statistics
+  size_t num_instances{ 0 };
+  size_t num_terms{ 0 };  ///< size of the term DAG of init and trans
+  double encode_time{ 0 };
+  double instantiate_time{ 0 };
+};
+
 class CoreIREncoder
 {
  public:
@@ -18,7 +47,10 @@ class CoreIREncoder
         c_(CoreIR::newContext()),
         num_clocks_(0),
         can_abstract_clock_(true),
-        force_abstract_clock_(force_abstract_clock)
+        force_abstract_clock_(force_abstract_clock),
+        nested_(false),
+        tmpl_(nullptr),
+        templates_(std::make_shared<TemplateMap>())
   {
     c_->getLibraryManager()->loadLib("commonlib");
     bvsort1_ = solver_->make_sort(smt::BV, 1);
@@ -37,7 +69,10 @@ class CoreIREncoder
         c_(m->getContext()),
         num_clocks_(0),
         can_abstract_clock_(true),
-        force_abstract_clock_(force_abstract_clock)
+        force_abstract_clock_(force_abstract_clock),
+        nested_(false),
+        tmpl_(nullptr),
+        templates_(std::make_shared<TemplateMap>())
   {
     c_->getLibraryManager()->loadLib("commonlib");
     bvsort1_ = solver_->make_sort(smt::BV, 1);
@@ -48,6 +83,20 @@ class CoreIREncoder
   }
 
  protected:
+  typedef std::unordered_map<CoreIR::Module *,
+                             std::shared_ptr<CoreIRModuleTemplate>>
+      TemplateMap;
+
+  /** Encodes the definition of a module into a template
+   *  shares the clock encoding and the templates with the parent
+   *  @param m the module, expected to have a definition
+   *  @param tmpl the template to populate
+   *  @param parent the encoder of the module instantiating m
+   */
+  CoreIREncoder(CoreIR::Module * m,
+                CoreIRModuleTemplate & tmpl,
+                const CoreIREncoder & parent);
+
   static CoreIR::Module * read_coreir_file(CoreIR::Context * c,
                                            std::string filename);
   // encodes the Module * stored in top_
@@ -65,6 +114,28 @@ class CoreIREncoder
    */
   CoreIR::Wireable * process_instance(CoreIR::Instance * inst);
 
+  /** stamps out an instance of a module with a definition
+   *  encodes the module into a template the first time it is seen
+   *  @param inst the instance to process, all inputs must be driven
+   *  @return the output ports of the instance
+   */
+  std::vector<CoreIR::Wireable *> instantiate_module(CoreIR::Instance * inst);
+
+  /** @return the template for a module, encoding it if necessary */
+  CoreIRModuleTemplate & get_template(CoreIR::Module * m);
+
+  /** collects the modules with a definition instantiated (recursively)
+   *  in the definition of m, registers are not included
+   */
+  void collect_submodules(CoreIR::Module * m,
+                          std::unordered_set<CoreIR::Module *> & submodules);
+
+  // runs CoreIR passes on the global namespace
+  void run_passes(const std::vector<std::string> & passes);
+
+  /** logs the encoding statistics of each module */
+  void log_templates() const;
+
   /** computes the next state updates for state elements
    *  this is done as a second pass after all other
    *  instances have been processed so that the drivers
@@ -93,6 +164,13 @@ class CoreIREncoder
    */
   smt::Sort compute_sort(CoreIR::Wireable * w);
 
+  // creates symbols in ts_, with the template prefix if nested
+  smt::Term make_statevar(const std::string & name, const smt::Sort & sort);
+  smt::Term make_inputvar(const std::string & name, const smt::Sort & sort);
+  // adds constraints to ts_ and records them for templates
+  void constrain_init(const smt::Term & constraint);
+  void constrain_trans(const smt::Term & constraint);
+
   RelationalTransitionSystem & ts_;
   smt::SmtSolver solver_;
   CoreIR::Context * c_;
@@ -102,6 +180,15 @@ class CoreIREncoder
   bool force_abstract_clock_;  ///< force the clock to be abstracted
                                ///< (synchronizes async behavior)
 
+  // module templates
+  bool nested_;  ///< true iff encoding a template for a submodule
+  CoreIRModuleTemplate * tmpl_;  ///< the template being encoded (if nested)
+  std::string prefix_;  ///< prefix for symbol names (empty at the top)
+  std::shared_ptr<TemplateMap> templates_;  ///< shared with nested encoders
+  ///< inputs created before their driver was processed (e.g. to break
+  ///< a cycle between instances), constrained to equal the driver later
+  std::unordered_set<CoreIR::Wireable *> forward_refs_;
+
   // conversion data structures
   std::unordered_map<CoreIR::Wireable *, smt::Term> w2term_;
 
@@ -127,11 +214,16 @@ class CoreIREncoder
     "cullgraph",
     "removebulkconnections",
     "removeunconnected",
-    "flatten",
-    // might not be necessary if it's already flat
+    // modules are not flattened, each module definition is encoded once
     "flattentypes",
     "packconnections",
     "cullzexts"
   };
+
+  // fallback for modules with parameters, which cannot be encoded
+  // independently of their instances
+  const std::vector<std::string> flatten_passes_ = {
+    "flatten", "flattentypes", "packconnections", "cullzexts"
+  };
 };
 }  // namespace pono
@@ -30,67 +30,556 @@ smt::Term pono::SMVEncoder::parseString(std::string newline)
   return parse_term;
 }
 // case condition check preprocess
+// checks that the conditions of each case expression cover all
+// possibilities, with a single query for all of them
 void pono::SMVEncoder::processCase()
 {
-  std::future_status status;
-  for (int i = 0; i < casecheck_.size(); i++) {
-    solver_->push();
-    Term bad_ = solver_->make_term(smt::PrimOp::Not, casecheck_[i]);
-    solver_->assert_formula(bad_);
-    auto fut = std::async(
-        launch::async,
-        [](smt::SmtSolver solver_) {
-          Result r = solver_->check_sat();
-          return r.is_unsat();
-        },
-        solver_);
-    std::future_status status;
-    status = fut.wait_for(std::chrono::seconds(5)); //check timeout
-    while (status != std::future_status::timeout) {
-      if (status == std::future_status::ready) {
-        if (fut.get()) {
-          break;
-        }
-        else {
-          // TODO would be nice if we could give a line number
-          throw PonoException("case error");
-        }
-      }
+  if (casecheck_.empty()) {
+    return;
+  }
+  Term all_cases = casecheck_[0];
+  for (size_t i = 1; i < casecheck_.size(); i++) {
+    all_cases = solver_->make_term(smt::PrimOp::And, all_cases, casecheck_[i]);
+  }
+
+  solver_->push();
+  Term bad_ = solver_->make_term(smt::PrimOp::Not, all_cases);
+  solver_->assert_formula(bad_);
+  auto fut = std::async(
+      launch::async,
+      [](smt::SmtSolver solver_) {
+        Result r = solver_->check_sat();
+        return r.is_unsat();
+      },
+      solver_);
+  // same time budget as checking each case separately
+  std::future_status status =
+      fut.wait_for(std::chrono::seconds(5 * casecheck_.size()));
+  if (status == std::future_status::timeout) {
+    throw PonoException("case timeout check error");
+  }
+  if (!fut.get()) {
+    // TODO would be nice if we could give a line number
+    throw PonoException("case error");
+  }
+  solver_->pop();
+}
+
+// modular SMV: all symbols of all instances are declared first, so
+// expressions can refer to symbols of instances that come later in the
+// flattened model
+void pono::SMVEncoder::build_main()
+{
+  auto it = module_list.find("main");
+  if (it == module_list.end()) {
+    throw PonoException("no main module found");
+  }
+  module_scope * main_scope = make_scope(it->second, "", nullptr);
+  it->second->declare(*this, *main_scope);
+  it->second->encode(*this, *main_scope);
+}
+
+module_scope * pono::SMVEncoder::make_scope(module_node * module,
+                                            const std::string & prefix,
+                                            const module_scope * parent)
+{
+  scopes_.push_back(module_scope());
+  module_scope & scope = scopes_.back();
+  scope.module = module;
+  scope.prefix = prefix;
+  scope.parent = parent;
+  return &scope;
+}
+
+static bool is_arith(SMVnode * a)
+{
+  SMVnode::Type t = a->getType();
+  SortKind sk = a->getTerm()->get_sort()->get_sort_kind();
+  return t == SMVnode::Integer || t == SMVnode::Real || sk == INT
+         || sk == REAL;
+}
+
+static bool is_bool_or_word(SMVnode::Type t)
+{
+  return t == SMVnode::Unsigned || t == SMVnode::Signed
+         || t == SMVnode::Boolean;
+}
+
+// the SMV type of an arithmetic result follows the sort
+static SMVnode * arith_node(const Term & res)
+{
+  if (res->get_sort()->get_sort_kind() == REAL) {
+    return new SMVnode(res, SMVnode::Real);
+  }
+  return new SMVnode(res, SMVnode::Integer);
+}
+
+SMVnode * pono::SMVEncoder::make_bool_constant(bool val)
+{
+  return new SMVnode(solver_->make_term(val), SMVnode::Boolean);
+}
+
+SMVnode * pono::SMVEncoder::make_int_constant(const std::string & val)
+{
+  Sort sort_ = solver_->make_sort(INT);
+  return new SMVnode(solver_->make_term(val, sort_), SMVnode::Integer);
+}
+
+SMVnode * pono::SMVEncoder::make_real_constant(const std::string & val)
+{
+  Sort sort_ = solver_->make_sort(REAL);
+  return new SMVnode(solver_->make_term(val, sort_), SMVnode::Real);
+}
+
+SMVnode * pono::SMVEncoder::make_word_constant(const std::string & prefix,
+                                               const std::string & width,
+                                               const std::string & val)
+{
+  // 0[u|s]<base>
+  SMVnode::Type bvt = SMVnode::Unsigned;
+  char base_char = prefix[1];
+  if (prefix.size() > 2) {
+    if (prefix[1] == 's') {
+      bvt = SMVnode::Signed;
     }
-    if (status == std::future_status::timeout) {
-      throw PonoException("case timeout check error");
+    base_char = prefix[2];
+  }
+  int base = 2;
+  switch (base_char) {
+    case 'b': base = 2; break;
+    case 'd': base = 10; break;
+    case 'h': base = 16; break;
+    default: base = 2;
+  }
+  Sort sort_ = solver_->make_sort(BV, stoi(width));
+  return new SMVnode(solver_->make_term(val, sort_, base), bvt);
+}
+
+SMVnode * pono::SMVEncoder::make_identifier(const std::string & name)
+{
+  if (terms_.find(name) == terms_.end()) {
+    build_define(name);
+  }
+  auto it = terms_.find(name);
+  if (it == terms_.end()) {
+    throw PonoException("Unknown identifier: " + name);
+  }
+  Term tok = it->second;
+  if (unsignedbv_.find(name) != unsignedbv_.end()) {
+    return new SMVnode(tok, SMVnode::Unsigned);
+  } else if (signedbv_.find(name) != signedbv_.end()) {
+    return new SMVnode(tok, SMVnode::Signed);
+  } else if (arrayty_.find(name) != arrayty_.end()) {
+    return new SMVnode(tok, SMVnode::WordArray, arrayty_.at(name));
+  } else if (arrayint_.find(name) != arrayint_.end()) {
+    return new SMVnode(tok, SMVnode::IntArray, arrayint_.at(name));
+  }
+  SortKind kind_ = tok->get_sort()->get_sort_kind();
+  if (kind_ == BV || kind_ == BOOL) {
+    return new SMVnode(tok, SMVnode::Boolean);
+  } else if (kind_ == INT) {
+    return new SMVnode(tok, SMVnode::Integer);
+  } else if (kind_ == REAL) {
+    return new SMVnode(tok, SMVnode::Real);
+  }
+  throw PonoException("The type of the identifier is wrong");
+}
+
+SMVnode * pono::SMVEncoder::make_not(SMVnode * a)
+{
+  SMVnode::Type bvs_a = a->getType();
+  SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
+  if (!is_bool_or_word(bvs_a)) {
+    throw PonoException("Type system violation");
+  } else if (ask != BOOL && ask != BV) {
+    throw PonoException(
+        "Expecting two booleans or two bit-vectors of the same width");
+  }
+  Term e = solver_->make_term(ask == BOOL ? Not : BVNot, a->getTerm());
+  return new SMVnode(e, bvs_a);
+}
+
+// the operands of &, |, xor and xnor
+static SortKind logic_operands(SMVnode * a, SMVnode * b)
+{
+  SMVnode::Type bvs_a = a->getType();
+  SMVnode::Type bvs_b = b->getType();
+  if (!is_bool_or_word(bvs_a) || !is_bool_or_word(bvs_b)) {
+    throw PonoException("Type system violation");
+  }
+  SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
+  if (bvs_a != bvs_b || (ask != BOOL && ask != BV)) {
+    throw PonoException(
+        "Expecting two booleans or two bit-vectors of the same width");
+  }
+  assert(ask == b->getTerm()->get_sort()->get_sort_kind());
+  return ask;
+}
+
+SMVnode * pono::SMVEncoder::make_logic(PrimOp bool_op,
+                                       PrimOp bv_op,
+                                       SMVnode * a,
+                                       SMVnode * b)
+{
+  SortKind ask = logic_operands(a, b);
+  Term e = solver_->make_term(
+      ask == BOOL ? bool_op : bv_op, a->getTerm(), b->getTerm());
+  return new SMVnode(e, a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_xnor(SMVnode * a, SMVnode * b)
+{
+  SortKind ask = logic_operands(a, b);
+  Term e;
+  if (ask == BOOL) {
+    e = solver_->make_term(
+        Not, solver_->make_term(Xor, a->getTerm(), b->getTerm()));
+  } else {
+    e = solver_->make_term(BVXnor, a->getTerm(), b->getTerm());
+  }
+  return new SMVnode(e, a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_bool_op(PrimOp op, SMVnode * a, SMVnode * b)
+{
+  SMVnode::Type bvs_a = a->getType();
+  SMVnode::Type bvs_b = b->getType();
+  if (!is_bool_or_word(bvs_a) || !is_bool_or_word(bvs_b)) {
+    throw PonoException("Type system violation");
+  } else if (bvs_a != bvs_b) {
+    throw PonoException(to_string(loc.end.line) + " Unsigned/Signed mismatch");
+  }
+  Term e = solver_->make_term(op, a->getTerm(), b->getTerm());
+  return new SMVnode(e, bvs_a);
+}
+
+SMVnode * pono::SMVEncoder::make_equal(PrimOp op, SMVnode * a, SMVnode * b)
+{
+  SMVnode::Type bvs_a = a->getType();
+  SMVnode::Type bvs_b = b->getType();
+  bool int_real = (bvs_a == SMVnode::Real && bvs_b == SMVnode::Integer)
+                  || (bvs_a == SMVnode::Integer && bvs_b == SMVnode::Real);
+  if (!int_real && bvs_a != bvs_b) {
+    throw PonoException(to_string(loc.end.line) + " Unsigned/Signed mismatch");
+  }
+  Term e = solver_->make_term(op, a->getTerm(), b->getTerm());
+  return new SMVnode(e, SMVnode::Boolean);
+}
+
+SMVnode * pono::SMVEncoder::make_compare(PrimOp arith_op,
+                                         PrimOp unsigned_op,
+                                         PrimOp signed_op,
+                                         SMVnode * a,
+                                         SMVnode * b)
+{
+  PrimOp op = arith_op;
+  if (!is_arith(a) && !is_arith(b)) {
+    if (a->getType() != b->getType()) {
+      throw PonoException(to_string(loc.end.line)
+                          + " Unsigned/Signed mismatch");
     }
-    solver_->pop();
+    op = (a->getType() == SMVnode::Signed) ? signed_op : unsigned_op;
   }
+  Term res = solver_->make_term(op, a->getTerm(), b->getTerm());
+  return new SMVnode(res, SMVnode::Boolean);
 }
-//change the input stream to output stringstream 
-int pono::SMVEncoder::parse_flat(std::istream & s)
+
+SMVnode * pono::SMVEncoder::make_uminus(SMVnode * a)
 {
-  pono::SMVscanner smvscanner(*this);
-  smvscanner.switch_streams(&s);
-  pono::smvparser parse(smvscanner, *this);
-  return parse();
+  if (is_arith(a)) {
+    return arith_node(solver_->make_term(Negate, a->getTerm()));
+  }
+  Term res = solver_->make_term(BVNeg, a->getTerm());
+  return new SMVnode(res, a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_arith(PrimOp arith_op,
+                                       PrimOp bv_op,
+                                       SMVnode * a,
+                                       SMVnode * b)
+{
+  if (is_arith(a) || is_arith(b)) {
+    return arith_node(solver_->make_term(arith_op, a->getTerm(), b->getTerm()));
+  } else if (a->getType() != b->getType()) {
+    throw PonoException(to_string(loc.end.line)
+                        + "Unsigned/Signed bitvector mismatch");
+  }
+  Term res = solver_->make_term(bv_op, a->getTerm(), b->getTerm());
+  return new SMVnode(res, a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_div(PrimOp arith_op,
+                                     PrimOp unsigned_op,
+                                     PrimOp signed_op,
+                                     SMVnode * a,
+                                     SMVnode * b)
+{
+  if (is_arith(a) || is_arith(b)) {
+    return arith_node(solver_->make_term(arith_op, a->getTerm(), b->getTerm()));
+  } else if (a->getType() != b->getType()) {
+    throw PonoException(to_string(loc.end.line)
+                        + "Unsigned/Signed bitvector mismatch");
+  }
+  if (a->getType() == SMVnode::Signed) {
+    Term res = solver_->make_term(signed_op, a->getTerm(), b->getTerm());
+    return new SMVnode(res, SMVnode::Signed);
+  }
+  Term res = solver_->make_term(unsigned_op, a->getTerm(), b->getTerm());
+  return new SMVnode(res, SMVnode::Unsigned);
+}
+
+SMVnode * pono::SMVEncoder::make_shift(PrimOp op, SMVnode * a, SMVnode * b)
+{
+  if (b->getType() != SMVnode::Unsigned) {
+    throw PonoException("Shift type mismatch");
+  }
+  Term res = solver_->make_term(op, a->getTerm(), b->getTerm());
+  return new SMVnode(res, a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_concat(SMVnode * a, SMVnode * b)
+{
+  if (a->getType() != b->getType()) {
+    throw PonoException(to_string(loc.end.line)
+                        + "Unsigned/Signed bitvector mismatch");
+  }
+  Term res = solver_->make_term(Concat, a->getTerm(), b->getTerm());
+  return new SMVnode(res, SMVnode::Unsigned);
+}
+
+SMVnode * pono::SMVEncoder::make_extract(SMVnode * a,
+                                         const std::string & high,
+                                         const std::string & low)
+{
+  SMVnode::Type bvs_a = a->getType();
+  if (bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed) {
+    throw PonoException("Bit selection type is uncompatible");
+  }
+  Term res =
+      solver_->make_term(Op(Extract, stoi(high), stoi(low)), a->getTerm());
+  return new SMVnode(res, SMVnode::Unsigned);
+}
+
+SMVnode * pono::SMVEncoder::make_floor(SMVnode * a)
+{
+  Term t = a->getTerm();
+  SortKind sk = t->get_sort()->get_sort_kind();
+  assert(sk == REAL || sk == INT);
+  return new SMVnode(solver_->make_term(To_Int, t), SMVnode::Integer);
+}
+
+SMVnode * pono::SMVEncoder::make_ite(SMVnode * a, SMVnode * b, SMVnode * c)
+{
+  Term e = solver_->make_term(Ite, a->getTerm(), b->getTerm(), c->getTerm());
+  return new SMVnode(e, b->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_read(SMVnode * a, SMVnode * b)
+{
+  Term read_r = solver_->make_term(Select, a->getTerm(), b->getTerm());
+  return new SMVnode(read_r, a->getElementType());
+}
+
+SMVnode * pono::SMVEncoder::make_write(SMVnode * a, SMVnode * b, SMVnode * c)
+{
+  Sort arrsort = a->getTerm()->get_sort();
+  Sort idxsort = b->getTerm()->get_sort();
+  Sort elemsort = c->getTerm()->get_sort();
+  if (arrsort->get_sort_kind() != ARRAY || arrsort->get_indexsort() != idxsort
+      || arrsort->get_elemsort() != elemsort) {
+    // TODO: would be good to print the SMV text and line number
+    throw PonoException("Type checking error in array write");
+  }
+  Term write_r =
+      solver_->make_term(Store, a->getTerm(), b->getTerm(), c->getTerm());
+  return new SMVnode(write_r, a->getType(), a->getElementType());
 }
 
-//modular SMV preprocess
-std::stringstream pono::SMVEncoder::preprocess()
+SMVnode * pono::SMVEncoder::make_const_array(const std::string & name,
+                                             SMVnode * a)
 {
-  module_node * main_n;
-  if (module_list.find("main") != module_list.end()) {
-    main_n = module_list.find("main")->second;
+  SMVnode * arr = make_identifier(name);
+  Sort sort_ = arr->getTerm()->get_sort();
+  if (arr->getType() == SMVnode::WordArray) {
+    Term const_arr = solver_->make_term(a->getTerm(), sort_);
+    return new SMVnode(const_arr, SMVnode::WordArray, a->getType());
+  } else if (arr->getType() == SMVnode::IntArray) {
+    Term const_arr = solver_->make_term(a->getTerm(), sort_);
+    return new SMVnode(const_arr, SMVnode::IntArray, SMVnode::Integer);
+  }
+  throw PonoException("The type of the const array is wrong");
+}
+
+SMVnode * pono::SMVEncoder::make_const_array(const Sort & index_sort,
+                                             SMVnode::Type array_type,
+                                             type_node * elem,
+                                             SMVnode * a)
+{
+  Sort sort_ = solver_->make_sort(ARRAY, index_sort, elem->getSort());
+  Term const_arr = solver_->make_term(a->getTerm(), sort_);
+  return new SMVnode(const_arr, array_type, a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_apply(const std::string & fun,
+                                       const std::vector<SMVnode *> & args)
+{
+  auto it = ufs_.find(fun);
+  if (it == ufs_.end()) {
+    throw PonoException("Function application with unknown function: "
+                        + fun);
+  }
+  TermVec terms({ it->second.first });
+  for (auto arg : args) {
+    terms.push_back(arg->getTerm());
+  }
+  return new SMVnode(solver_->make_term(Apply, terms), it->second.second);
+}
+
+SMVnode * pono::SMVEncoder::make_next(SMVnode * a)
+{
+  return new SMVnode(rts_.next(a->getTerm()), a->getType());
+}
+
+SMVnode * pono::SMVEncoder::make_case(
+    const std::vector<std::pair<SMVnode *, SMVnode *>> & body)
+{
+  assert(!body.empty());
+  // the last condition is only used for the coverage check
+  Term cond = body.back().first->getTerm();
+  Term final_term = body.back().second->getTerm();
+  SMVnode::Type t = body.back().second->getType();
+  for (auto it = body.rbegin() + 1; it != body.rend(); ++it) {
+    Term c = it->first->getTerm();
+    t = it->second->getType();
+    final_term = solver_->make_term(Ite, c, it->second->getTerm(), final_term);
+    if (cond->get_sort()->get_sort_kind() == BOOL) {
+      cond = solver_->make_term(Or, cond, c);
+    } else {
+      cond = solver_->make_term(BVOr, cond, c);
+    }
+  }
+  casecheck_.push_back(cond);
+  return new SMVnode(final_term, t);
+}
+
+void pono::SMVEncoder::record_type(const std::string & name,
+                                   const Term & t,
+                                   SMVnode::Type type,
+                                   SMVnode::Type element_type)
+{
+  terms_[name] = t;
+  if (type == SMVnode::Unsigned) {
+    unsignedbv_[name] = t;
+  } else if (type == SMVnode::Signed) {
+    signedbv_[name] = t;
+  } else if (type == SMVnode::WordArray) {
+    arrayty_[name] = element_type;
+  } else if (type == SMVnode::IntArray) {
+    arrayint_[name] = element_type;
+  }
+}
+
+Term pono::SMVEncoder::declare_state(const std::string & name,
+                                     type_node * type)
+{
+  Term state = rts_.make_statevar(name, type->getSort());
+  record_type(name, state, type->getType(), type->getElementType());
+  return state;
+}
+
+void pono::SMVEncoder::declare_input(const std::string & name,
+                                     type_node * type)
+{
+  Term input = rts_.make_inputvar(name, type->getSort());
+  record_type(name, input, type->getType(), type->getElementType());
+}
+
+void pono::SMVEncoder::declare_fun(const std::string & name, type_node * type)
+{
+  Term fun = solver_->make_symbol(name, type->getSort());
+  ufs_[name] = { fun, type->getType() };
+}
+
+void pono::SMVEncoder::freeze(const std::string & name)
+{
+  Term state = terms_.at(name);
+  Term e = solver_->make_term(Equal, rts_.next(state), state);
+  rts_.constrain_trans(e);
+  transterm_.push_back(make_pair(loc.end.line, e));
+}
+
+void pono::SMVEncoder::define(const std::string & name, SMVnode * a)
+{
+  record_type(name, a->getTerm(), a->getType(), a->getElementType());
+}
+
+void pono::SMVEncoder::declare_define(const std::string & name,
+                                      SMVnode * ex,
+                                      const module_scope & scope)
+{
+  pending_defines_[name] = { ex, &scope };
+}
+
+void pono::SMVEncoder::build_define(const std::string & name)
+{
+  auto it = pending_defines_.find(name);
+  if (it == pending_defines_.end()) {
+    if (building_defines_.find(name) != building_defines_.end()) {
+      throw PonoException("Cyclic DEFINE: " + name);
+    }
+    return;
+  }
+  SMVnode * ex = it->second.first;
+  const module_scope & scope = *it->second.second;
+  pending_defines_.erase(it);
+  building_defines_.insert(name);
+  define(name, ex->build(*this, scope));
+  building_defines_.erase(name);
+}
+
+void pono::SMVEncoder::assign(const std::string & name, SMVnode * a)
+{
+  Term e = solver_->make_term(Equal, terms_.at(name), a->getTerm());
+  rts_.add_constraint(e);
+}
+
+void pono::SMVEncoder::assign_init(const std::string & name, SMVnode * a)
+{
+  Term e = solver_->make_term(Equal, terms_.at(name), a->getTerm());
+  rts_.constrain_init(e);
+}
+
+void pono::SMVEncoder::assign_next(const std::string & name, SMVnode * a)
+{
+  Term state = terms_.at(name);
+  assert(rts_.is_curr_var(state));
+  if (rts_.only_curr(a->getTerm())) {
+    rts_.assign_next(state, a->getTerm());
   } else {
-    throw PonoException("no main module found");
+    rts_.constrain_trans(
+        rts_.make_term(Equal, rts_.next(state), a->getTerm()));
   }
-  std::stringstream str;
-  str << "MODULE main" << std::endl;
-  main_n->process_main(module_list, str);
-  // TODO add a command line flag to re-enable dumping the debug file
-  // generate text file
-  // if(module_flat){
-  //   std::string flatten =file.substr(0,file.find_last_of(".")) +
-  //   "_flatten.txt"; std::ofstream ofile(flatten); ofile << str.str()
-  //   <<std::endl; ofile.close();
-  // }
-  parse_flat(str);
-  return str;
+}
+
+void pono::SMVEncoder::add_init(SMVnode * a)
+{
+  rts_.constrain_init(a->getTerm());
+}
+
+void pono::SMVEncoder::add_trans(SMVnode * a)
+{
+  rts_.constrain_trans(a->getTerm());
+}
+
+void pono::SMVEncoder::add_invar(SMVnode * a)
+{
+  rts_.add_invar(a->getTerm());
+  // an invariant is added over current and next states
+  transterm_.push_back(make_pair(loc.end.line, a->getTerm()));
+  transterm_.push_back(make_pair(loc.end.line, rts_.next(a->getTerm())));
+}
+
+void pono::SMVEncoder::add_invarspec(SMVnode * a)
+{
+  propvec_.push_back(a->getTerm());
 }
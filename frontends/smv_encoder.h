@@ -11,6 +11,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "assert.h"
@@ -32,11 +33,12 @@ class SMVEncoder
   {
     module_flat = false;
     file = filename;
+    // collect the modules
     parse(filename);
-    preprocess();
+    // flatten the modules and build the terms
     module_flat = true;
     loc.end.line = 0;
-    std::string output= preprocess().str();
+    build_main();
     processCase();
   };
 
@@ -44,13 +46,101 @@ class SMVEncoder
   // Important members
   string file;
   int parse(std::string filename);
-  int parse_flat(std::istream& s);
   smt::Term parseString(std::string newline);
   location loc;
   void processCase();
-  std::stringstream preprocess();
+  /* flatten the modules starting from main and build the terms from the
+   * AST of the module instances */
+  void build_main();
   smt::TermVec propvec() { return propvec_; }
 
+  /* term construction, shared by the flat-mode grammar actions and the
+   * AST of the modules */
+  SMVnode * make_bool_constant(bool val);
+  SMVnode * make_int_constant(const std::string & val);
+  SMVnode * make_real_constant(const std::string & val);
+  /** @param prefix the width and base prefix, e.g. 0ud or 0b */
+  SMVnode * make_word_constant(const std::string & prefix,
+                               const std::string & width,
+                               const std::string & val);
+  /* a variable, function or DEFINE, which is built on first use */
+  SMVnode * make_identifier(const std::string & name);
+  SMVnode * make_not(SMVnode * a);
+  /* &, | and xor on booleans or words */
+  SMVnode * make_logic(smt::PrimOp bool_op,
+                       smt::PrimOp bv_op,
+                       SMVnode * a,
+                       SMVnode * b);
+  SMVnode * make_xnor(SMVnode * a, SMVnode * b);
+  /* -> and <-> */
+  SMVnode * make_bool_op(smt::PrimOp op, SMVnode * a, SMVnode * b);
+  /* = and != */
+  SMVnode * make_equal(smt::PrimOp op, SMVnode * a, SMVnode * b);
+  /* <, >, <= and >= */
+  SMVnode * make_compare(smt::PrimOp arith_op,
+                         smt::PrimOp unsigned_op,
+                         smt::PrimOp signed_op,
+                         SMVnode * a,
+                         SMVnode * b);
+  SMVnode * make_uminus(SMVnode * a);
+  /* +, - and * */
+  SMVnode * make_arith(smt::PrimOp arith_op,
+                       smt::PrimOp bv_op,
+                       SMVnode * a,
+                       SMVnode * b);
+  /* / and mod */
+  SMVnode * make_div(smt::PrimOp arith_op,
+                     smt::PrimOp unsigned_op,
+                     smt::PrimOp signed_op,
+                     SMVnode * a,
+                     SMVnode * b);
+  SMVnode * make_shift(smt::PrimOp op, SMVnode * a, SMVnode * b);
+  SMVnode * make_concat(SMVnode * a, SMVnode * b);
+  SMVnode * make_extract(SMVnode * a,
+                         const std::string & high,
+                         const std::string & low);
+  SMVnode * make_floor(SMVnode * a);
+  SMVnode * make_ite(SMVnode * a, SMVnode * b, SMVnode * c);
+  SMVnode * make_read(SMVnode * a, SMVnode * b);
+  SMVnode * make_write(SMVnode * a, SMVnode * b, SMVnode * c);
+  /* CONSTARRAY(typeof(name), a) */
+  SMVnode * make_const_array(const std::string & name, SMVnode * a);
+  SMVnode * make_const_array(const smt::Sort & index_sort,
+                             SMVnode::Type array_type,
+                             type_node * elem,
+                             SMVnode * a);
+  SMVnode * make_apply(const std::string & fun,
+                       const std::vector<SMVnode *> & args);
+  SMVnode * make_next(SMVnode * a);
+  /* the pairs of conditions and values of the case expression */
+  SMVnode * make_case(
+      const std::vector<std::pair<SMVnode *, SMVnode *>> & body);
+
+  /* declarations and constraints */
+  smt::Term declare_state(const std::string & name, type_node * type);
+  void declare_input(const std::string & name, type_node * type);
+  void declare_fun(const std::string & name, type_node * type);
+  /* the next state of a frozen variable is its current state */
+  void freeze(const std::string & name);
+  void define(const std::string & name, SMVnode * a);
+  /* a DEFINE of a module instance that is only built when it is used */
+  void declare_define(const std::string & name,
+                      SMVnode * ex,
+                      const module_scope & scope);
+  void build_define(const std::string & name);
+  void assign(const std::string & name, SMVnode * a);
+  void assign_init(const std::string & name, SMVnode * a);
+  void assign_next(const std::string & name, SMVnode * a);
+  void add_init(SMVnode * a);
+  void add_trans(SMVnode * a);
+  void add_invar(SMVnode * a);
+  void add_invarspec(SMVnode * a);
+
+  /* the scope of a new module instance, owned by the encoder */
+  module_scope * make_scope(module_node * module,
+                            const std::string & prefix,
+                            const module_scope * parent);
+
   smt::Term parse_term;
   const smt::SmtSolver & solver_;
   pono::RelationalTransitionSystem & rts_;
@@ -71,9 +161,7 @@ class SMVEncoder
              ///< and the SMV return type
 
   ///< casecheck_: vector of booleans, each element is an Or of all the conditions in a case statement.
-  ///< caseterm_: used to temporaily store each statement in case body before future process check that the conditions cover all possibilities (required by nuXmv manual)
   std::vector<smt::Term> casecheck_;
-  std::vector<std::pair<SMVnode*,SMVnode*>> caseterm_;
   ///< module_list: map from module name to module node
   std::unordered_map<std::string,module_node*> module_list;
   // indicate whether needs to flatten module first
@@ -89,5 +177,17 @@ class SMVEncoder
   std::vector<pono::SMVnode*> trans_list_;
   std::vector<pono::SMVnode*> invar_list_;
   std::vector<pono::SMVnode*> invarspec_list_;
+
+ protected:
+  void record_type(const std::string & name,
+                   const smt::Term & t,
+                   SMVnode::Type type,
+                   SMVnode::Type element_type);
+
+  std::deque<module_scope> scopes_;
+  ///< DEFINEs of module instances that are not built yet
+  std::unordered_map<std::string, std::pair<SMVnode *, const module_scope *>>
+      pending_defines_;
+  std::unordered_set<std::string> building_defines_;
 };  // class SMVEncoder
 }  // namespace pono
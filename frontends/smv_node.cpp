@@ -1,979 +1,548 @@
 #include "smv_node.h"
 
-void pono::module_node::process_main(
-    std::unordered_map<std::string, module_node *> module_list,
-    std::ostream & s)
-{
-  std::unordered_map<string, string> new_prefix;
-  new_prefix[module_name] = "";
-  std::string prefix = "";
-  var_li->preprocess(module_name, "", module_list, &new_prefix, s);
-  var_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  ivar_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  frozenvar_li->generate_ostream(
-      module_name, prefix, module_list, new_prefix, s);
-  fun_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  define_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  assign_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  init_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  trans_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  invar_li->generate_ostream(module_name, prefix, module_list, new_prefix, s);
-  invarspec_li->generate_ostream(
-      module_name, prefix, module_list, new_prefix, s);
-}
-
-void pono::module_node::preprocess(
-    std::string parent,
-    std::string prefix,
-    std::unordered_map<string, string> * new_prefix,
-    std::unordered_map<std::string, module_node *> module_list,
-    std::vector<SMVnode *> id_li,
-    std::ostream & s)
-{
-  if (par_li.size() != id_li.size()) {
+#include "frontends/smv_encoder.h"
+
+pono::SMVnode * pono::SMVnode::build(SMVEncoder & enc,
+                                     const module_scope & scope)
+{
+  throw PonoException("Unsupported expression in a module");
+}
+
+pono::module_scope * pono::module_node::instantiate(
+    SMVEncoder & enc,
+    const std::string & prefix,
+    module_scope & parent,
+    const std::vector<SMVnode *> & args)
+{
+  if (par_li.size() != args.size()) {
     throw PonoException("module declaration wrong");
   }
-  for (int i = 0; i < id_li.size(); i++) {
-    std::string s = par_li[i];
-    new_par[s] = id_li[i];
+  module_scope * scope = enc.make_scope(this, prefix, &parent);
+  for (size_t i = 0; i < args.size(); i++) {
+    scope->args[par_li[i]] = args[i];
   }
-  (*new_prefix)[module_name] = prefix;
-  par_name = parent;
-  std::unordered_map<string, string> prefix_li = *new_prefix;
-  var_li->preprocess(module_name, prefix, module_list, new_prefix, s);
-  var_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  ivar_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  frozenvar_li->generate_ostream(
-      module_name, prefix, module_list, prefix_li, s);
-  fun_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  define_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  assign_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  init_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  trans_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  invar_li->generate_ostream(module_name, prefix, module_list, prefix_li, s);
-  invarspec_li->generate_ostream(
-      module_name, prefix, module_list, prefix_li, s);
-}
-
-void pono::type_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << type_name;
-}
-
-void pono::var_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+  parent.children.push_back(scope);
+  return scope;
+}
+
+void pono::module_node::declare(SMVEncoder & enc, module_scope & scope)
 {
-  if (vt != ModuleT) {
-    unordered_map<string, SMVnode *> new_par =
-        module_list[name]->get_namelist();
-    if (new_par.find(id) != new_par.end())
-      throw PonoException("duplicately defined");
-    s << new_prefix[name] << id << ":" << type << ";" << endl;
+  var_li->instantiate(enc, scope);
+  for (auto child : scope.children) {
+    child->module->declare(enc, *child);
   }
+  var_li->declare(enc, scope);
+  ivar_li->declare(enc, scope);
+  frozenvar_li->declare(enc, scope);
+  fun_li->declare(enc, scope);
+  define_li->declare(enc, scope);
 }
 
-void pono::ivar_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::module_node::encode(SMVEncoder & enc, const module_scope & scope)
 {
-  unordered_map<string, SMVnode *> new_par = module_list[name]->get_namelist();
-  if (new_par.find(id) != new_par.end())
-    throw PonoException("duplicately defined");
-  s << new_prefix[name] << id << " : " << type << " ; " << endl;
+  for (auto child : scope.children) {
+    child->module->encode(enc, *child);
+  }
+  frozenvar_li->encode(enc, scope);
+  define_li->encode(enc, scope);
+  assign_li->encode(enc, scope);
+  init_li->encode(enc, scope);
+  trans_li->encode(enc, scope);
+  invar_li->encode(enc, scope);
+  invarspec_li->encode(enc, scope);
 }
 
-void pono::frozenvar_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+// a declared name must not shadow a parameter of the module
+static void check_not_parameter(const std::string & id,
+                                const pono::module_scope & scope)
 {
-  unordered_map<string, SMVnode *> new_par = module_list[name]->get_namelist();
-  if (new_par.find(id) != new_par.end())
+  if (scope.args.find(id) != scope.args.end()) {
     throw PonoException("duplicately defined");
-  s << new_prefix[name] << id << " : " << type << " ; " << endl;
+  }
 }
 
-void pono::fun_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::var_node::instantiate(SMVEncoder & enc, module_scope & scope)
 {
-  unordered_map<string, SMVnode *> new_par = module_list[name]->get_namelist();
-  if (new_par.find(id) != new_par.end())
-    throw PonoException("duplicately defined");
-  s << new_prefix[name] << id << " : " << type << " ; " << endl;
+  for (auto v : ex_li) {
+    if (v->getVarType() != ModuleT) {
+      continue;
+    }
+    type_node * ty = v->getmodtype();
+    auto it = enc.module_list.find(ty->getName());
+    if (it == enc.module_list.end()) {
+      throw PonoException("unknown module " + ty->getName());
+    }
+    it->second->instantiate(
+        enc, scope.prefix + v->getName() + ".", scope, ty->get_list());
+  }
 }
 
-void pono::define_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+// the elements are handled in the order of the flattened model, which
+// lists the declarations of a section last to first
+void pono::var_node::declare(SMVEncoder & enc, const module_scope & scope)
 {
-  unordered_map<string, SMVnode *> new_par = module_list[name]->get_namelist();
-  if (new_par.find(id) != new_par.end())
-    throw PonoException("duplicately defined");
-  s << prefix << id << " := ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ;" << endl;
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->declare(enc, scope);
+  }
 }
 
-void pono::assign_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::ivar_node::declare(SMVEncoder & enc, const module_scope & scope)
 {
-  unordered_map<string, SMVnode *> new_par = module_list[name]->get_namelist();
-  if (new_par.find(id) != new_par.end())
-    throw PonoException("duplicately defined");
-  if (pre == "")
-    s << prefix << id << " := ";
-  else
-    s << pre << " ( " <<  prefix << id << ") :=";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ;" << endl;
-}
-
-void pono::init_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ;" << endl;
-}
-
-void pono::trans_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ;" << endl;
-}
-
-void pono::invar_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ;" << endl;
-}
-
-void pono::invarspec_node_c::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ;" << endl;
-}
-
-void pono::var_node::preprocess(
-    std::string module,
-    std::string prefix,
-    std::unordered_map<std::string, module_node *> module_list,
-    std::unordered_map<string, string> * new_prefix,
-    ostream & s)
-{
-  for (int i = 0; i < ex_li.size(); i++) {
-    var_node_c * temp = ex_li[i];
-    if (temp->getVarType() == ModuleT) {
-      unordered_map<string, module_node *>::iterator it =
-          module_list.find(temp->getmodtype()->getName());
-      if (it != module_list.end()) {
-        std::string prefix = (*new_prefix)[module] + ex_li[i]->getName() + ".";
-        it->second->preprocess(module,
-                               prefix,
-                               new_prefix,
-                               module_list,
-                               temp->getmodtype()->get_list(),
-                               s);
-      }
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->declare(enc, scope);
   }
 }
 
-void pono::var_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::frozenvar_node::declare(SMVEncoder & enc,
+                                   const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    s << "VAR" << endl;
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->declare(enc, scope);
   }
 }
 
-void pono::ivar_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::frozenvar_node::encode(SMVEncoder & enc,
+                                  const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    s << "IVAR" << endl;
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::frozenvar_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::fun_node::declare(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    s << "FROZENVAR" << endl;
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->declare(enc, scope);
   }
 }
 
-void pono::fun_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::define_node::declare(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    s << "FUN" << endl;
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->declare(enc, scope);
   }
 }
 
-void pono::define_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::define_node::encode(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    s << "DEFINE" << endl;
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::assign_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::assign_node::encode(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    s << "ASSIGN" << endl;
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::init_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::init_node::encode(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      s << "INIT" << endl;
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::trans_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::trans_node::encode(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      s << "TRANS" << endl;
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::invar_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::invar_node::encode(SMVEncoder & enc, const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      s << "INVAR" << endl;
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::invarspec_node::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::invarspec_node::encode(SMVEncoder & enc,
+                                  const module_scope & scope)
 {
-  if (!ex_li.empty()) {
-    
-    for (int i = ex_li.size() - 1; i > -1; i--) {
-      s << "INVARSPEC" << endl;
-      ex_li[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    }
+  for (auto it = ex_li.rbegin(); it != ex_li.rend(); ++it) {
+    (*it)->encode(enc, scope);
   }
 }
 
-void pono::constant::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::var_node_c::declare(SMVEncoder & enc, const module_scope & scope)
 {
-  s << " ";
-  s << in;
-  s << " ";
+  if (vt != ModuleT) {
+    check_not_parameter(id, scope);
+    enc.declare_state(scope.prefix + id, ty);
+  }
 }
 
-void pono::identifier::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+void pono::ivar_node_c::declare(SMVEncoder & enc, const module_scope & scope)
 {
-  unordered_map<string, SMVnode *> name_list =
-      module_list[name]->get_namelist();
-  if (name_list.find(in) != name_list.end()) {
-    std::unordered_map<string, SMVnode *>::iterator it = name_list.find(in);
-    it->second->generate_ostream(
-        module_list[name]->get_par(), prefix, module_list, new_prefix, s);
+  check_not_parameter(id, scope);
+  enc.declare_input(scope.prefix + id, ty);
+}
+
+void pono::frozenvar_node_c::declare(SMVEncoder & enc,
+                                     const module_scope & scope)
+{
+  check_not_parameter(id, scope);
+  enc.declare_state(scope.prefix + id, ty);
+}
+
+void pono::frozenvar_node_c::encode(SMVEncoder & enc,
+                                    const module_scope & scope)
+{
+  enc.freeze(scope.prefix + id);
+}
+
+void pono::fun_node_c::declare(SMVEncoder & enc, const module_scope & scope)
+{
+  check_not_parameter(id, scope);
+  enc.declare_fun(scope.prefix + id, ty);
+}
+
+void pono::define_node_c::declare(SMVEncoder & enc,
+                                  const module_scope & scope)
+{
+  check_not_parameter(id, scope);
+  enc.declare_define(scope.prefix + id, ex, scope);
+}
+
+void pono::define_node_c::encode(SMVEncoder & enc, const module_scope & scope)
+{
+  // no-op if it was already used
+  enc.build_define(scope.prefix + id);
+}
+
+void pono::assign_node_c::encode(SMVEncoder & enc, const module_scope & scope)
+{
+  check_not_parameter(id, scope);
+  SMVnode * a = ex->build(enc, scope);
+  if (pre == "") {
+    enc.assign(scope.prefix + id, a);
+  } else if (pre == "init") {
+    enc.assign_init(scope.prefix + id, a);
   } else {
-    s << " " << new_prefix[name] << in << " ";
+    assert(pre == "next");
+    enc.assign_next(scope.prefix + id, a);
+  }
+}
+
+void pono::init_node_c::encode(SMVEncoder & enc, const module_scope & scope)
+{
+  enc.add_init(ex->build(enc, scope));
+}
+
+void pono::trans_node_c::encode(SMVEncoder & enc, const module_scope & scope)
+{
+  enc.add_trans(ex->build(enc, scope));
+}
+
+void pono::invar_node_c::encode(SMVEncoder & enc, const module_scope & scope)
+{
+  enc.add_invar(ex->build(enc, scope));
+}
+
+void pono::invarspec_node_c::encode(SMVEncoder & enc,
+                                    const module_scope & scope)
+{
+  enc.add_invarspec(ex->build(enc, scope));
+}
+
+pono::SMVnode * pono::constant::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  return val;
+}
+
+pono::SMVnode * pono::identifier::build(SMVEncoder & enc,
+                                        const module_scope & scope)
+{
+  // parameters are expressions of the parent instance
+  auto it = scope.args.find(in);
+  if (it != scope.args.end()) {
+    return it->second->build(enc, *scope.parent);
   }
+  return enc.make_identifier(scope.prefix + in);
+}
+
+pono::SMVnode * pono::par_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  return ex->build(enc, scope);
 }
 
-void pono::par_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::not_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  s << " ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  return enc.make_not(ex->build(enc, scope));
 }
 
-void pono::not_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::and_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  s << " !";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_logic(smt::And, smt::BVAnd, a, b);
 }
 
-void pono::and_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::or_expr::build(SMVEncoder & enc,
+                                     const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " & ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_logic(smt::Or, smt::BVOr, a, b);
 }
 
-void pono::or_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::xor_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " | ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_logic(smt::Xor, smt::BVXor, a, b);
 }
 
-void pono::xor_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::xnor_expr::build(SMVEncoder & enc,
+                                       const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " xor ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_xnor(a, b);
 }
 
-void pono::xnor_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::imp_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " xnor ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_bool_op(smt::Implies, a, b);
 }
 
-void pono::imp_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::iff_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " -> ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_bool_op(smt::Equal, a, b);
 }
 
-void pono::iff_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::eq_expr::build(SMVEncoder & enc,
+                                     const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " <-> ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_equal(smt::Equal, a, b);
 }
 
-void pono::eq_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::neq_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " = ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_equal(smt::Distinct, a, b);
 }
 
-void pono::neq_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::lt_expr::build(SMVEncoder & enc,
+                                     const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " != ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_compare(smt::Lt, smt::BVUlt, smt::BVSlt, a, b);
 }
 
-void pono::lt_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::gt_expr::build(SMVEncoder & enc,
+                                     const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " < ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_compare(smt::Gt, smt::BVUgt, smt::BVSgt, a, b);
 }
 
-void pono::gt_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::lte_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " > ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_compare(smt::Le, smt::BVUle, smt::BVSle, a, b);
 }
 
-void pono::lte_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::gte_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " <= ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_compare(smt::Ge, smt::BVUge, smt::BVSge, a, b);
 }
 
-void pono::gte_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::uminus_expr::build(SMVEncoder & enc,
+                                         const module_scope & scope)
 {
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " >= ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+  return enc.make_uminus(ex->build(enc, scope));
 }
 
-void pono::uminus_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::add_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  s << " - ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_arith(smt::Plus, smt::BVAdd, a, b);
 }
 
-void pono::add_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " + ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+pono::SMVnode * pono::sub_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_arith(smt::Minus, smt::BVSub, a, b);
 }
 
-void pono::sub_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " - ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+pono::SMVnode * pono::mul_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_arith(smt::Mult, smt::BVMul, a, b);
 }
 
-void pono::mul_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " * ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
+pono::SMVnode * pono::div_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_div(smt::Div, smt::BVUdiv, smt::BVSdiv, a, b);
 }
 
-void pono::div_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " / ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::mod_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " mod ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::sr_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " >>  ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::sl_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " << ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::subscript_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << " [ ";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ] ";
-}
-
-void pono::sel_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " [ " << start;
-  s << " : " << end;
-  s << " ] ";
-}
-
-void pono::con_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " :: ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::read_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "READ ( ";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
-}
-
-void pono::write_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "WRITE ( ";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex3->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
-}
-
-void pono::apply_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << fun << "(";
-  size_t argsize = args.size();
-  for (size_t i = 0; i + 1 < argsize; ++i) {
-    args[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    s << ", ";
-  }
-  args[argsize - 1]->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << ")";
+pono::SMVnode * pono::mod_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_div(smt::Mod, smt::BVUrem, smt::BVSmod, a, b);
 }
 
-void pono::word1_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::sr_expr::build(SMVEncoder & enc,
+                                     const module_scope & scope)
 {
-  s << "word1 ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_shift(smt::BVLshr, a, b);
 }
 
-void pono::bool_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::sl_expr::build(SMVEncoder & enc,
+                                     const module_scope & scope)
 {
-  s << "bool ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_shift(smt::BVShl, a, b);
 }
 
-void pono::toint_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::sel_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  s << "toint ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  return enc.make_extract(ex1->build(enc, scope), start, end);
 }
 
-void pono::signed_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::con_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
 {
-  s << " signed ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_concat(a, b);
 }
 
-void pono::unsigned_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::read_expr::build(SMVEncoder & enc,
+                                       const module_scope & scope)
 {
-  s << "unsigned ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  return enc.make_read(a, b);
 }
 
-void pono::extend_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::write_expr::build(SMVEncoder & enc,
+                                        const module_scope & scope)
 {
-  s << " extend ";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  SMVnode * c = ex3->build(enc, scope);
+  return enc.make_write(a, b, c);
+}
 
-void pono::resize_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << " resize ";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::union_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " union ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::set_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "!";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::in_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " in ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::ite_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ? ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " : ";
-  ex3->generate_ostream(name, prefix, module_list, new_prefix, s);
-}
-
-void pono::floor_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "floor ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
-}
-
-void pono::constarray_type_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "CONSTARRAY ( typeof ( " << prefix << id << " ) ,";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
-}
-
-void pono::constarray_word_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "CONSTARRAY ( array word " << size << " of";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
-}
-
-void pono::constarray_int_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << "CONSTARRAY ( array integer of " ;
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " , ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
-}
-
-void pono::case_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
-{
-  s << " case ";
-  for (int i = 0; i < ex_l.size(); i++) {
-    ex_l[i]->generate_ostream(name, prefix, module_list, new_prefix, s);
-    s << endl;
+pono::SMVnode * pono::apply_expr::build(SMVEncoder & enc,
+                                        const module_scope & scope)
+{
+  std::vector<SMVnode *> built_args;
+  for (auto arg : args) {
+    built_args.push_back(arg->build(enc, scope));
   }
-  s << " esac ";
+  return enc.make_apply(scope.prefix + fun, built_args);
 }
 
-void pono::case_body_ex::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::signed_expr::build(SMVEncoder & enc,
+                                         const module_scope & scope)
 {
-  s << " ";
-  ex1->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " : ";
-  ex2->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ; ";
+  return ex->build(enc, scope);
+}
+
+pono::SMVnode * pono::unsigned_expr::build(SMVEncoder & enc,
+                                           const module_scope & scope)
+{
+  return ex->build(enc, scope);
+}
+
+pono::SMVnode * pono::ite_expr::build(SMVEncoder & enc,
+                                      const module_scope & scope)
+{
+  SMVnode * a = ex1->build(enc, scope);
+  SMVnode * b = ex2->build(enc, scope);
+  SMVnode * c = ex3->build(enc, scope);
+  return enc.make_ite(a, b, c);
+}
+
+pono::SMVnode * pono::floor_expr::build(SMVEncoder & enc,
+                                        const module_scope & scope)
+{
+  return enc.make_floor(ex->build(enc, scope));
+}
+
+pono::SMVnode * pono::constarray_type_expr::build(SMVEncoder & enc,
+                                                  const module_scope & scope)
+{
+  return enc.make_const_array(scope.prefix + id, ex->build(enc, scope));
+}
+
+pono::SMVnode * pono::constarray_word_expr::build(SMVEncoder & enc,
+                                                  const module_scope & scope)
+{
+  smt::Sort index_sort = enc.solver_->make_sort(smt::BV, size);
+  return enc.make_const_array(index_sort,
+                              WordArray,
+                              static_cast<type_node *>(ex1),
+                              ex2->build(enc, scope));
+}
+
+pono::SMVnode * pono::constarray_int_expr::build(SMVEncoder & enc,
+                                                 const module_scope & scope)
+{
+  smt::Sort index_sort = enc.solver_->make_sort(smt::INT);
+  return enc.make_const_array(index_sort,
+                              IntArray,
+                              static_cast<type_node *>(ex1),
+                              ex2->build(enc, scope));
+}
+
+pono::SMVnode * pono::case_expr::build(SMVEncoder & enc,
+                                       const module_scope & scope)
+{
+  std::vector<std::pair<SMVnode *, SMVnode *>> body;
+  for (auto e : ex_l) {
+    case_body_ex * c = static_cast<case_body_ex *>(e);
+    SMVnode * cond = c->get_cond()->build(enc, scope);
+    SMVnode * val = c->get_value()->build(enc, scope);
+    body.push_back({ cond, val });
+  }
+  return enc.make_case(body);
 }
 
-void pono::next_expr::generate_ostream(
-    std::string name,
-    std::string prefix,
-    std::unordered_map<string, module_node *> module_list,
-    std::unordered_map<string, string> new_prefix,
-    ostream & s)
+pono::SMVnode * pono::next_expr::build(SMVEncoder & enc,
+                                       const module_scope & scope)
 {
-  s << "next ( ";
-  ex->generate_ostream(name, prefix, module_list, new_prefix, s);
-  s << " ) ";
+  return enc.make_next(ex->build(enc, scope));
 }
@@ -18,10 +18,26 @@ using namespace std;
  * assigned when element_node stores a vector of SMVNode * that contain the
  * corresponding type NodeMType NodeMType includes VAR, IVAR, FROZENVAR, FUN
  * DEFINE, INIT, INVAR, TRANS, ASSIGN
+ * The terms are built from the AST of the module instances (declare, encode
+ * and build).
  */
 
 namespace pono {
 class module_node;
+class SMVEncoder;
+struct SMVnode;
+
+/* a module instance while building the terms: the prefix of its names
+ * and the arguments of its parameters, which are expressions of the
+ * parent instance */
+struct module_scope
+{
+  module_node * module;
+  std::string prefix;
+  const module_scope * parent;
+  std::unordered_map<std::string, SMVnode *> args;
+  std::vector<module_scope *> children;
+};
 struct SMVnode
 {
  public:
@@ -120,12 +136,12 @@ struct SMVnode
   smt::Sort getSort() { return st; }
   smt::Term getTerm() { return tm; }
   virtual std::string getName() { return ""; }
-  virtual void generate_ostream(
-      std::string name,
-      std::string prefix,
-      std::unordered_map<string, module_node *> module_list,
-      std::unordered_map<string, string> new_prefix,
-      ostream & s){};
+  /* declare the variables, functions and defines of a declaration */
+  virtual void declare(SMVEncoder & enc, const module_scope & scope){};
+  /* add the constraints and properties of a module element */
+  virtual void encode(SMVEncoder & enc, const module_scope & scope){};
+  /* build the term of an expression in a module instance */
+  virtual SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };  // struct SMVNode
 
 class element_node : public SMVnode
@@ -134,12 +150,8 @@ class element_node : public SMVnode
 
  public:
   element_node() {}
-  virtual void preprocess(
-      std::string module,
-      std::string prefix,
-      std::unordered_map<std::string, module_node *> module_list,
-      std::unordered_map<string, string> * new_prefix,
-      ostream & s){};
+  /* create the scopes of the module instances declared in VAR */
+  virtual void instantiate(SMVEncoder & enc, module_scope & scope){};
   virtual std::vector<SMVnode *> get_list() { return pa_li; }
 };
 
@@ -161,11 +173,34 @@ class module_node
   element_node * invarspec_li;
 
  public:
-  module_node(std::string name) { module_name = name; }
+  module_node(std::string name)
+  {
+    module_name = name;
+    var_li = new element_node();
+    ivar_li = new element_node();
+    define_li = new element_node();
+    assign_li = new element_node();
+    frozenvar_li = new element_node();
+    fun_li = new element_node();
+    init_li = new element_node();
+    trans_li = new element_node();
+    invar_li = new element_node();
+    invarspec_li = new element_node();
+  }
   module_node(std::string name, std::vector<string> id_list)
   {
     module_name = name;
     par_li = id_list;
+    var_li = new element_node();
+    ivar_li = new element_node();
+    define_li = new element_node();
+    assign_li = new element_node();
+    frozenvar_li = new element_node();
+    fun_li = new element_node();
+    init_li = new element_node();
+    trans_li = new element_node();
+    invar_li = new element_node();
+    invarspec_li = new element_node();
   }
   module_node(std::string name,
               std::vector<string> id_list,
@@ -230,18 +265,18 @@ class module_node
       if (it->first == SMVnode::INVARSPEC) invarspec_li = it->second;
     }
   }
-  unordered_map<string, SMVnode *> get_namelist() { return new_par; }
+  const unordered_map<string, SMVnode *> & get_namelist() { return new_par; }
   std::string get_par() { return par_name; }
-  /* process modular smv starting from main module */
-  void process_main(std::unordered_map<std::string, module_node *> module_list,
-           std::ostream & s);
-  /* preprocess method: output to stringstream following falttened smv file format */ 
-  void preprocess(std::string parent,
-                  std::string prefix,
-                  std::unordered_map<string, string> * new_prefix,
-                  std::unordered_map<std::string, module_node *> module_list,
-                  std::vector<SMVnode *> id_li,
-                  std::ostream & s);
+  /* create the scope of an instance of this module in the parent scope */
+  module_scope * instantiate(SMVEncoder & enc,
+                             const std::string & prefix,
+                             module_scope & parent,
+                             const std::vector<SMVnode *> & args);
+  /* declare the symbols of an instance, submodule instances first */
+  void declare(SMVEncoder & enc, module_scope & scope);
+  /* add the constraints and properties of an instance, in the order of
+   * the flattened model */
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class type_node : public SMVnode
@@ -257,6 +292,14 @@ class type_node : public SMVnode
     type_name = n;
     ex_li = li;
   }
+  type_node(std::string n, smt::Sort s, Type type, Type element = Default)
+  {
+    type_name = n;
+    nt = SortNode;
+    st = s;
+    bvt = type;
+    ele_type = element;
+  }
   type_node(smt::Sort s, Type type)
   {
     nt = SortNode;
@@ -284,11 +327,6 @@ class type_node : public SMVnode
   Type getElementType() { return ele_type; }
   smt::Sort getSort() { return st; }
   smt::Term getTerm() { return tm; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 
 class var_node_c : public SMVnode
@@ -307,65 +345,56 @@ class var_node_c : public SMVnode
   }
   std::string getName() { return id; }
   pono::type_node * getmodtype() { return ty; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
 };
 
 class ivar_node_c : public SMVnode
 {
   std::string id;
   std::string type;
+  pono::type_node * ty;
 
  public:
-  ivar_node_c(std::string n, SMVnode * t)
+  ivar_node_c(std::string n, pono::type_node * t)
   {
+    ty = t;
     type = t->getName();
     id = n;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
 };
 
 class frozenvar_node_c : public SMVnode
 {
   std::string id;
   std::string type;
+  pono::type_node * ty;
 
  public:
-  frozenvar_node_c(std::string n, SMVnode * t)
+  frozenvar_node_c(std::string n, pono::type_node * t)
   {
+    ty = t;
     type = t->getName();
     id = n;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class fun_node_c : public SMVnode
 {
   std::string id;
   std::string type;
+  pono::type_node * ty;
 
  public:
-  fun_node_c(std::string n, SMVnode * t)
+  fun_node_c(std::string n, pono::type_node * t)
   {
+    ty = t;
     type = t->getName();
     id = n;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
 };
 
 class define_node_c : public SMVnode
@@ -379,11 +408,8 @@ class define_node_c : public SMVnode
     ex = t;
     id = n;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class assign_node_c : public SMVnode
@@ -399,11 +425,7 @@ class assign_node_c : public SMVnode
     id = n;
     pre = p;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class init_node_c : public SMVnode
@@ -412,11 +434,7 @@ class init_node_c : public SMVnode
 
  public:
   init_node_c(SMVnode * t) { ex = t; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class trans_node_c : public SMVnode
@@ -425,11 +443,7 @@ class trans_node_c : public SMVnode
 
  public:
   trans_node_c(SMVnode * t) { ex = t; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class invar_node_c : public SMVnode
@@ -438,11 +452,7 @@ class invar_node_c : public SMVnode
 
  public:
   invar_node_c(SMVnode * t) { ex = t; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 class invarspec_node_c : public SMVnode
 {
@@ -450,11 +460,7 @@ class invarspec_node_c : public SMVnode
 
  public:
   invarspec_node_c(SMVnode * t) { ex = t; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 };
 
 class var_node : public element_node
@@ -467,17 +473,9 @@ class var_node : public element_node
     mt = t;
     ex_li = li;
   }
-  void preprocess(std::string module,
-                  std::string prefix,
-                  std::unordered_map<std::string, module_node *> module_list,
-                  std::unordered_map<string, string> * new_prefix,
-                  ostream & s);
+  void instantiate(SMVEncoder & enc, module_scope & scope);
+  void declare(SMVEncoder & enc, const module_scope & scope);
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 
 class ivar_node : public element_node
@@ -486,11 +484,7 @@ class ivar_node : public element_node
 
  public:
   ivar_node(std::vector<SMVnode *> li, NodeMtype t) : ex_li(li) { mt = t; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -505,11 +499,8 @@ class frozenvar_node : public element_node
     mt = t;
     ex_li = li;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -524,11 +515,7 @@ class fun_node : public element_node
     mt = t;
     ex_li = li;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -544,11 +531,8 @@ class define_node : public element_node
     ex_li = li;
   }
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void declare(SMVEncoder & enc, const module_scope & scope);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -564,11 +548,7 @@ class assign_node : public element_node
     ex_li = li;
   }
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -584,11 +564,7 @@ class init_node : public element_node
     ex_li = li;
   }
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -604,11 +580,7 @@ class trans_node : public element_node
     ex_li = li;
   }
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -624,11 +596,7 @@ class invar_node : public element_node
     ex_li = li;
   }
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
 
@@ -643,11 +611,7 @@ class invarspec_node : public element_node
     ex_li = li;
   }
 
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  void encode(SMVEncoder & enc, const module_scope & scope);
 
   std::vector<SMVnode *> get_list() { return ex_li; }
 };
@@ -655,14 +619,15 @@ class invarspec_node : public element_node
 class constant : public SMVnode
 {
   string in;
+  SMVnode * val;
 
  public:
-  constant(std::string input) { in = input; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  constant(std::string input, SMVnode * v)
+  {
+    in = input;
+    val = v;
+  }
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class identifier : public SMVnode
@@ -671,11 +636,7 @@ class identifier : public SMVnode
 
  public:
   identifier(std::string input) { in = input; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class par_expr : public SMVnode
 {
@@ -683,11 +644,7 @@ class par_expr : public SMVnode
 
  public:
   par_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class not_expr : public SMVnode
 {
@@ -695,11 +652,7 @@ class not_expr : public SMVnode
 
  public:
   not_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class and_expr : public SMVnode
 {
@@ -712,11 +665,7 @@ class and_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class or_expr : public SMVnode
 {
@@ -729,11 +678,7 @@ class or_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class xor_expr : public SMVnode
 {
@@ -746,11 +691,7 @@ class xor_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class xnor_expr : public SMVnode
 {
@@ -763,11 +704,7 @@ class xnor_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class imp_expr : public SMVnode
 {
@@ -780,11 +717,7 @@ class imp_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class iff_expr : public SMVnode
 {
@@ -797,11 +730,7 @@ class iff_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class eq_expr : public SMVnode
 {
@@ -814,11 +743,7 @@ class eq_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class neq_expr : public SMVnode
 {
@@ -831,11 +756,7 @@ class neq_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class lt_expr : public SMVnode
 {
@@ -848,11 +769,7 @@ class lt_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class gt_expr : public SMVnode
 {
@@ -865,11 +782,7 @@ class gt_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class lte_expr : public SMVnode
@@ -883,11 +796,7 @@ class lte_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class gte_expr : public SMVnode
 {
@@ -900,11 +809,7 @@ class gte_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class uminus_expr : public SMVnode
 {
@@ -912,11 +817,7 @@ class uminus_expr : public SMVnode
 
  public:
   uminus_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class add_expr : public SMVnode
 {
@@ -929,11 +830,7 @@ class add_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class sub_expr : public SMVnode
 {
@@ -946,11 +843,7 @@ class sub_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class mul_expr : public SMVnode
 {
@@ -963,11 +856,7 @@ class mul_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class div_expr : public SMVnode
 {
@@ -980,11 +869,7 @@ class div_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class mod_expr : public SMVnode
 {
@@ -997,11 +882,7 @@ class mod_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class sr_expr : public SMVnode
 {
@@ -1014,11 +895,7 @@ class sr_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class sl_expr : public SMVnode
 {
@@ -1031,11 +908,7 @@ class sl_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class subscript_expr : public SMVnode
@@ -1049,11 +922,6 @@ class subscript_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class sel_expr : public SMVnode
 {
@@ -1068,11 +936,7 @@ class sel_expr : public SMVnode
     start = s1;
     end = s2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class con_expr : public SMVnode
 {
@@ -1085,11 +949,7 @@ class con_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class read_expr : public SMVnode
@@ -1103,11 +963,7 @@ class read_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class write_expr : public SMVnode
@@ -1123,11 +979,7 @@ class write_expr : public SMVnode
     ex2 = e2;
     ex3 = e3;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class apply_expr : public SMVnode
@@ -1141,11 +993,7 @@ class apply_expr : public SMVnode
     fun = f;
     args = a;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class word1_expr : public SMVnode
@@ -1154,11 +1002,6 @@ class word1_expr : public SMVnode
 
  public:
   word1_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class bool_expr : public SMVnode
 {
@@ -1166,11 +1009,6 @@ class bool_expr : public SMVnode
 
  public:
   bool_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class toint_expr : public SMVnode
 {
@@ -1178,11 +1016,6 @@ class toint_expr : public SMVnode
 
  public:
   toint_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class signed_expr : public SMVnode
 {
@@ -1190,11 +1023,7 @@ class signed_expr : public SMVnode
 
  public:
   signed_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class unsigned_expr : public SMVnode
 {
@@ -1202,11 +1031,7 @@ class unsigned_expr : public SMVnode
 
  public:
   unsigned_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class extend_expr : public SMVnode
 {
@@ -1219,11 +1044,6 @@ class extend_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class resize_expr : public SMVnode
 {
@@ -1236,11 +1056,6 @@ class resize_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class union_expr : public SMVnode
 {
@@ -1253,11 +1068,6 @@ class union_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class set_expr : public SMVnode
 {
@@ -1265,11 +1075,6 @@ class set_expr : public SMVnode
 
  public:
   set_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class in_expr : public SMVnode
 {
@@ -1282,11 +1087,6 @@ class in_expr : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
 };
 class ite_expr : public SMVnode
 {
@@ -1301,11 +1101,7 @@ class ite_expr : public SMVnode
     ex2 = e2;
     ex3 = e3;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 class floor_expr : public SMVnode
 {
@@ -1313,11 +1109,7 @@ class floor_expr : public SMVnode
 
  public:
   floor_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class constarray_type_expr : public SMVnode
@@ -1327,11 +1119,7 @@ class constarray_type_expr : public SMVnode
 
  public:
   constarray_type_expr( string input, pono::SMVnode * e){ id = input; ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class constarray_word_expr : public SMVnode
@@ -1342,11 +1130,7 @@ class constarray_word_expr : public SMVnode
 
  public:
   constarray_word_expr(int sizet, pono::type_node * e1, pono::SMVnode * e2) { size = sizet; ex1 = e1; ex2 = e2; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class constarray_int_expr : public SMVnode
@@ -1356,11 +1140,7 @@ class constarray_int_expr : public SMVnode
 
  public:
   constarray_int_expr(pono::type_node * e1, pono::SMVnode * e2) { ex1 = e1; ex2 = e2; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 
@@ -1370,11 +1150,7 @@ class case_expr : public SMVnode
 
  public:
   case_expr(std::vector<pono::SMVnode *> el) { ex_l = el; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 class case_body_ex : public SMVnode
@@ -1388,11 +1164,8 @@ class case_body_ex : public SMVnode
     ex1 = e1;
     ex2 = e2;
   }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * get_cond() { return ex1; }
+  SMVnode * get_value() { return ex2; }
 };
 class next_expr : public SMVnode
 {
@@ -1400,11 +1173,7 @@ class next_expr : public SMVnode
 
  public:
   next_expr(pono::SMVnode * e) { ex = e; }
-  void generate_ostream(std::string name,
-                        std::string prefix,
-                        std::unordered_map<string, module_node *> module_list,
-                        std::unordered_map<string, string> new_prefix,
-                        ostream & s);
+  SMVnode * build(SMVEncoder & enc, const module_scope & scope);
 };
 
 }  // namespace pono
@@ -6,8 +6,6 @@
     #include "frontends/smv_encoder.h"
     #include "frontends/smv_node.h"
     using namespace std;
-    int case_start = 0;
-    bool case_true = false;
 %}
 
 %code requires{
@@ -247,19 +245,7 @@ define_decl:
 
 define_body: complex_identifier ASSIGNSYM basic_expr semioption {
   if(enc.module_flat){
-              SMVnode *a = $3;
-              smt::Term define_var = a->getTerm();
-              enc.terms_[$1] = define_var;
-              if (a->getType() == SMVnode::Unsigned){
-                enc.unsignedbv_[$1] = define_var;
-              }else if (a->getType() == SMVnode::Signed){
-                enc.signedbv_[$1] = define_var;
-              }   else if(a->getType() == SMVnode::WordArray){
-               enc.arrayty_[$1] = a->getElementType();
-              }
-               else if(a->getType() == SMVnode::IntArray){
-               enc.arrayint_[$1] = a->getElementType();
-              }
+      enc.define($1, $3);
   }else{
       enc.define_list_.push_back(new define_node_c($1,$3));
   }
@@ -272,39 +258,24 @@ assign_list: assign_test semioption
 
 assign_test: complex_identifier ASSIGNSYM simple_expr {
   if(enc.module_flat){
-          SMVnode *a = $3;
-          smt::Term e = enc.terms_[$1];
-          smt::Term assign = enc.solver_->make_term(smt::Equal, e, a->getTerm());
-          enc.rts_.add_constraint(assign);
+      enc.assign($1, $3);
   }else{
       enc.assign_list_.push_back(new assign_node_c("",$1,$3));
   }
 }
         | TOK_INIT "(" complex_identifier ")" ASSIGNSYM simple_expr{
         if(enc.module_flat){
-          SMVnode *a = $6;
-          smt::Term init = enc.terms_[$3];
-          smt::Term e = enc.solver_->make_term(smt::Equal, init, a->getTerm());
-          enc.rts_.constrain_init(e);
+          enc.assign_init($3, $6);
         }else{
          enc.assign_list_.push_back(new assign_node_c("init",$3,$6));
         }
         }
         | TOK_NEXT "(" complex_identifier ")" ASSIGNSYM basic_expr {
         if(enc.module_flat){
-          SMVnode *a = $6;
-          smt::Term state = enc.terms_[$3];
-          //enc.rts_.assign_next(state,a->getTerm());
-          assert(enc.rts_.is_curr_var(state));
-          if (enc.rts_.only_curr(a->getTerm())){
-            enc.rts_.assign_next(state, a->getTerm());
-          }else
-          {
-            enc.rts_.constrain_trans(enc.rts_.make_term(smt::Equal, enc.rts_.next(state), a->getTerm()));
-          }
-          }else{
+          enc.assign_next($3, $6);
+        }else{
           enc.assign_list_.push_back(new assign_node_c("next",$3,$6));
-          }
+        }
         };
 
 ivar_test:
@@ -315,19 +286,7 @@ ivar_test:
 ivar_list:
     complex_identifier ":" type_identifier semioption {
         if(enc.module_flat){
-         type_node *a = $3;
-         smt::Term input = enc.rts_.make_inputvar($1, a->getSort());
-         if (a->getType() == SMVnode::Unsigned){
-           enc.unsignedbv_[$1] = input;
-         }else if (a->getType() == SMVnode::Signed){
-           enc.signedbv_[$1] = input;
-         } else if(a->getType() == SMVnode::WordArray){
-          enc.arrayty_[$1] = a->getElementType();
-        }
-        else if(a->getType() == SMVnode::IntArray){
-          enc.arrayint_[$1] = a->getElementType();
-        }
-         enc.terms_[$1] = input;
+          enc.declare_input($1, $3);
         }else{
           SMVnode *a = new ivar_node_c($1,$3);
           enc.ivar_list_.push_back(a);
@@ -341,20 +300,8 @@ var_test:
 var_list:
     complex_identifier ":" type_identifier semioption{
       if(enc.module_flat){
-         type_node *a = $3;
-         smt::Term state = enc.rts_.make_statevar($1, a->getSort());
-         enc.terms_[$1] = state;
-         if (a->getType() == SMVnode::Unsigned){
-            enc.unsignedbv_[$1] = state;
-         } else if(a->getType() == SMVnode::Signed){
-           enc.signedbv_[$1] = state;
-         } else if(a->getType() == SMVnode::WordArray){
-          enc.arrayty_[$1] = a->getElementType();
-         } else if(a->getType() == SMVnode::IntArray){
-          enc.arrayint_[$1] = a->getElementType();
-         } 
+          enc.declare_state($1, $3);
       }else{
-          SMVnode *a = new var_node_c($1,$3,SMVnode::BasicT);
           enc.var_list_.push_back(new var_node_c($1,$3,SMVnode::BasicT));
       }
     }
@@ -375,8 +322,7 @@ fun_decl:
   {
     if (enc.module_flat)
     {
-      smt::Term fun = enc.rts_.solver()->make_symbol($1, $3->getSort());
-      enc.ufs_[$1] = {fun, $3->getType()};
+      enc.declare_fun($1, $3);
     }
     else
     {
@@ -413,22 +359,8 @@ frozenvar_test:
 frozenvar_list:
   complex_identifier ":" type_identifier semioption {
     if(enc.module_flat){
-      type_node *a = $3;
-      smt::Term state = enc.rts_.make_statevar($1, a->getSort());
-      enc.terms_[$1] = state;
-      if (a->getType() == SMVnode::Unsigned){
-            enc.unsignedbv_[$1] = state;
-      } else if(a->getType() == SMVnode::Signed){
-           enc.signedbv_[$1] = state;
-      } else if(a->getType() == SMVnode::WordArray){
-          enc.arrayty_[$1] = a->getElementType();
-      } else if(a->getType() == SMVnode::IntArray){
-          enc.arrayint_[$1] = a->getElementType();
-      }
-      smt::Term n = enc.rts_.next(state);
-      smt::Term e = enc.solver_->make_term(smt::Equal, n, state);
-      enc.rts_.constrain_trans(e);
-      enc.transterm_.push_back(make_pair(enc.loc.end.line,e));
+      enc.declare_state($1, $3);
+      enc.freeze($1);
     }else{
       SMVnode *a = new frozenvar_node_c($1,$3);
       enc.frozenvar_list_.push_back(a);
@@ -439,8 +371,7 @@ init_constraint: INIT init_list;
 
 init_list: simple_expr semioption{
   if(enc.module_flat){
-        SMVnode *a = $1;
-        enc.rts_.constrain_init(a->getTerm());
+    enc.add_init($1);
   }else{
     SMVnode *a = new init_node_c($1);
     enc.init_list_.push_back(a);
@@ -451,9 +382,7 @@ trans_constraint: TRANS trans_list;
 
 trans_list: basic_expr semioption{
   if(enc.module_flat){
-            SMVnode *a = $1;
-            enc.rts_.constrain_trans(a->getTerm());
-            case_true = false;
+    enc.add_trans($1);
   }else{
     SMVnode *a = new trans_node_c($1);
     enc.trans_list_.push_back(a);
@@ -464,11 +393,7 @@ invar_constraint: INVAR invar_list;
 
 invar_list: basic_expr semioption{
   if(enc.module_flat){
-            SMVnode *a = $1;
-            enc.rts_.add_invar(a->getTerm());
-            // an invariant is added over current and next states
-            enc.transterm_.push_back(make_pair(enc.loc.end.line,a->getTerm()));
-            enc.transterm_.push_back(make_pair(enc.loc.end.line,enc.rts_.next(a->getTerm())));
+    enc.add_invar($1);
   }else{
      SMVnode *a = new invar_node_c($1);
     enc.invar_list_.push_back(a);
@@ -480,9 +405,7 @@ invarspec_test: INVARSPEC invarspec_list;
 
 invarspec_list: basic_expr semioption {
   if(enc.module_flat){
-                SMVnode *a = $1;
-                smt::Term prop = a->getTerm();
-                enc.propvec_.push_back(prop);
+    enc.add_invarspec($1);
   }else{
     SMVnode *a = new invarspec_node_c($1);
     enc.invarspec_list_.push_back(a);
@@ -490,104 +413,51 @@ invarspec_list: basic_expr semioption {
 };
 
 constant: boolean_constant {
+  SMVnode *c = enc.make_bool_constant($1);
   if(enc.module_flat){
-      smt::Term con = enc.solver_->make_term($1);
-      $$ = new SMVnode(con,SMVnode::Boolean);
+    $$ = c;
   }else{
-    if($1) $$ = new constant("TRUE");
-    else $$ = new constant("FALSE");
+    $$ = new constant($1 ? "TRUE" : "FALSE", c);
   }
 }
           | integer_constant {
+            SMVnode *c = enc.make_int_constant($1);
             if(enc.module_flat){
-            smt::Sort sort_ = enc.solver_->make_sort(smt::INT);
-            smt::Term con = enc.solver_->make_term($1,sort_);
-            $$ = new SMVnode(con,SMVnode::Integer);
+              $$ = c;
             }else{
-          $$ = new constant($1);
-          }
+              $$ = new constant($1, c);
+            }
 }
           | real_constant{
+            SMVnode *c = enc.make_real_constant($1);
             if(enc.module_flat){
-            smt::Sort sort_ = enc.solver_->make_sort(smt::REAL);
-            smt::Term con = enc.solver_->make_term($1,sort_);
-            $$ = new SMVnode(con,SMVnode::Real);
+              $$ = c;
             }else{
-            $$ = new constant($1);
+              $$ = new constant($1, c);
             }
           }
           | word_value {
-            if(enc.module_flat){
-              $$ = $1;
-            }else{
-              SMVnode *wv = $1;
-              string n = wv ->getName();
-              $$ = new type_node(n);
-            }
+            $$ = $1;
           }
           | range_constant{
             throw PonoException("Range constants are not yet supported");
           };
 
 word_value: word_index1 integer_val "_" integer_val {
-      if(enc.module_flat){
-          smt::Sort sort_ = enc.solver_->make_sort(smt::BV, stoi($2));
-          std::string temp = $1;
-          int base = 2;
-          switch (temp[1]){
-            case 'b':
-              base = 2;
-              break;
-            case 'd':
-              base = 10;
-              break;
-            case 'h':
-              base = 16;
-              break;
-            default:
-              base = 2;
+          SMVnode *c = enc.make_word_constant($1, $2, $4);
+          if(enc.module_flat){
+            $$ = c;
+          }else{
+            $$ = new constant($1 + $2 + "_" + $4, c);
           }
-          smt::Term num = enc.solver_->make_term($4, sort_, base);
-          $$ = new SMVnode(num, SMVnode::Unsigned); }
-          else{
-            string n = $1 + $2 + "_" + $4;
-            $$ = new type_node(n);
-        } }
+        }
         | word_index2 integer_val "_" integer_val {
-        if(enc.module_flat){
-          smt::Sort sort_ = enc.solver_->make_sort(smt::BV, stoi($2));
-          std::string temp = $1;
-          SMVnode::Type bvt;
-          int base = 2;
-          switch (temp[1]){
-            case 'u':
-              bvt = SMVnode::Unsigned;
-              break;
-            case 's':
-              bvt = SMVnode::Signed;
-              break;
-            default:
-              bvt = SMVnode::Unsigned;
-          }
-          switch (temp[2]){
-            case 'b':
-              base = 2;
-              break;
-            case 'd':
-              base = 10;
-              break;
-            case 'h':
-              base = 16;
-              break;
-            default:
-              base = 2;
+          SMVnode *c = enc.make_word_constant($1, $2, $4);
+          if(enc.module_flat){
+            $$ = c;
+          }else{
+            $$ = new constant($1 + $2 + "_" + $4, c);
           }
-          smt::Term num = enc.solver_->make_term($4, sort_, base);
-          $$ = new SMVnode(num,bvt);
-        }else{
-            string n = $1 + $2 + "_" + $4;
-            $$ = new type_node(n);
-        }
    };
 
 
@@ -627,24 +497,7 @@ simple_expr: constant {
           }
             | complex_identifier {
             if(enc.module_flat){
-              smt::Term tok = enc.terms_.at($1);
-              if (enc.unsignedbv_.find($1) != enc.unsignedbv_.end() ) {
-                $$ = new SMVnode(tok, SMVnode::Unsigned);
-              } else if(enc.signedbv_.find($1) != enc.signedbv_.end()){
-                $$ = new SMVnode(tok, SMVnode::Signed);
-              } else if(enc.arrayty_.find($1) != enc.arrayty_.end()){
-                $$ = new SMVnode(tok, SMVnode::WordArray,enc.arrayty_[$1]);
-              } else if(enc.arrayint_.find($1) != enc.arrayint_.end()){
-                $$ = new SMVnode(tok, SMVnode::IntArray,enc.arrayint_[$1]);
-              }
-              else{
-                smt::SortKind kind_ = tok->get_sort()->get_sort_kind();
-                assert(tok);
-                if (kind_ == smt::BV || kind_ == smt::BOOL) $$ = new SMVnode(tok,SMVnode::Boolean);
-                else if (kind_ == smt::INT) $$ = new SMVnode(tok,SMVnode::Integer);
-                else if (kind_ == smt::REAL) $$ = new SMVnode(tok,SMVnode::Real);
-                else throw PonoException("The type of the identifier is wrong");
-              }
+              $$ = enc.make_identifier($1);
             }else{
               $$ = new identifier($1);
               }
@@ -658,527 +511,154 @@ simple_expr: constant {
             }
             | OP_NOT basic_expr {
             if(enc.module_flat){
-              SMVnode *a = $2;
-              SMVnode::Type bvs_a = a->getType();
-              smt::SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
-              smt::Term e;
-              if(bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }else if(ask != smt::BOOL && ask != smt::BV){
-                throw PonoException("Expecting two booleans or two bit-vectors of the same width");
-              }else{
-               if(ask == smt::BOOL) e = enc.solver_->make_term(smt::Not, a->getTerm());
-               else  e = enc.solver_->make_term(smt::BVNot, a->getTerm());
-              }
-              assert(e);    //check e non-null
-              $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_not($2);
             }else{
               $$ = new not_expr($2);
               }
             }
             | basic_expr OP_AND basic_expr {
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if(bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }
-              if(bvs_b != SMVnode::Unsigned && bvs_b != SMVnode::Signed && bvs_b != SMVnode::Boolean){
-                  throw PonoException("Type system violation");
-              }
-              smt::SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
-              smt::SortKind bsk = b->getTerm()->get_sort()->get_sort_kind();
-              if(bvs_a != bvs_b  || (ask != smt::BOOL && ask != smt::BV)){
-                 throw PonoException("Expecting two booleans or two bit-vectors of the same width");
-              } else{
-                assert(ask ==  bsk);
-                assert(ask == smt::BOOL || ask == smt::BV);
-                if(ask == smt::BOOL)  e = enc.solver_->make_term(smt::And, a->getTerm(), b->getTerm());
-                else e = enc.solver_->make_term(smt::BVAnd, a->getTerm(), b->getTerm());
-              }
-                assert(e);    //check e in non-null
-                $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_logic(smt::And, smt::BVAnd, $1, $3);
             }else{
               $$ = new and_expr($1,$3);
               }
             }
             | basic_expr OP_OR basic_expr{
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if(bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }
-              if(bvs_b != SMVnode::Unsigned && bvs_b != SMVnode::Signed && bvs_b != SMVnode::Boolean){
-                  throw PonoException("Type system violation");
-              }
-              smt::SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
-              smt::SortKind bsk = b->getTerm()->get_sort()->get_sort_kind();
-              if(bvs_a != bvs_b  || (ask != smt::BOOL && ask != smt::BV)){
-                 throw PonoException("Expecting two booleans or two bit-vectors of the same width");
-              } else{
-                assert(ask ==  bsk);
-                assert(ask == smt::BOOL || ask == smt::BV);
-                if(ask == smt::BOOL)  e = enc.solver_->make_term(smt::Or, a->getTerm(), b->getTerm());
-                else e = enc.solver_->make_term(smt::BVOr, a->getTerm(), b->getTerm());
-              }
-                assert(e);    //check e in non-null
-                $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_logic(smt::Or, smt::BVOr, $1, $3);
               }else{
               $$ = new or_expr($1,$3);
               }
             }
             | basic_expr OP_XOR basic_expr {
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if(bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }
-              if(bvs_b != SMVnode::Unsigned && bvs_b != SMVnode::Signed && bvs_b != SMVnode::Boolean){
-                  throw PonoException("Type system violation");
-              }
-              smt::SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
-              smt::SortKind bsk = b->getTerm()->get_sort()->get_sort_kind();
-              if(bvs_a != bvs_b  || (ask != smt::BOOL && ask != smt::BV)){
-                 throw PonoException("Expecting two booleans or two bit-vectors of the same width");
-              } else{
-                assert(ask ==  bsk);
-                assert(ask == smt::BOOL || ask == smt::BV);
-                if(ask == smt::BOOL)  e = enc.solver_->make_term(smt::Xor, a->getTerm(), b->getTerm());
-                else e = enc.solver_->make_term(smt::BVXor, a->getTerm(), b->getTerm());
-              }
-                assert(e);    //check e in non-null
-                $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_logic(smt::Xor, smt::BVXor, $1, $3);
               }else{
               $$ = new xor_expr($1,$3);
               }
             }
             | basic_expr OP_XNOR basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if(bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }
-              if(bvs_b != SMVnode::Unsigned && bvs_b != SMVnode::Signed && bvs_b != SMVnode::Boolean){
-                  throw PonoException("Type system violation");
-              }
-              smt::SortKind ask = a->getTerm()->get_sort()->get_sort_kind();
-              smt::SortKind bsk = b->getTerm()->get_sort()->get_sort_kind();
-              if(bvs_a != bvs_b  || (ask != smt::BOOL && ask != smt::BV)){
-                 throw PonoException("Expecting two booleans or two bit-vectors of the same width");
-              } else{
-                assert(ask ==  bsk);
-                assert(ask == smt::BOOL || ask == smt::BV);
-                if(ask == smt::BOOL)  e = enc.solver_->make_term(smt::Not, enc.solver_->make_term(smt::Xor, a->getTerm(), b->getTerm()));
-                else e = enc.solver_->make_term(smt::BVXnor, a->getTerm(), b->getTerm());
-              }
-                assert(e);    //check e in non-null
-                $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_xnor($1, $3);
               }else{
-              $$ = new xor_expr($1,$3);
+              $$ = new xnor_expr($1,$3);
               }
             }
             | basic_expr OP_IMPLY basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if( bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }
-              if(bvs_b != SMVnode::Unsigned && bvs_b != SMVnode::Signed && bvs_b != SMVnode::Boolean){
-                  throw PonoException("Type system violation");
-              }
-              if((bvs_a == SMVnode::Real && bvs_b == SMVnode::Integer) || (bvs_a == SMVnode::Integer && bvs_b == SMVnode::Real) ){
-                e = enc.solver_->make_term(smt::Implies, a->getTerm(), b->getTerm());
-              }else if(bvs_a != bvs_b){
-                 throw PonoException(to_string(enc.loc.end.line) + " Unsigned/Signed mismatch");
-              } else{
-              e = enc.solver_->make_term(smt::Implies, a->getTerm(), b->getTerm());
-              }
-              assert(e);
-              $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_bool_op(smt::Implies, $1, $3);
               }else{
               $$ = new imp_expr($1,$3);
               }
             }
             | basic_expr OP_BI basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if(bvs_a != SMVnode::Unsigned && bvs_a != SMVnode::Signed && bvs_a != SMVnode::Boolean){
-                throw PonoException("Type system violation");
-              }
-              if(bvs_b != SMVnode::Unsigned && bvs_b != SMVnode::Signed && bvs_b != SMVnode::Boolean){
-                  throw PonoException("Type system violation");
-              }
-              if((bvs_a == SMVnode::Real && bvs_b == SMVnode::Integer) || (bvs_a == SMVnode::Integer && bvs_b == SMVnode::Real) ){
-                e = enc.solver_->make_term(smt::Equal, a->getTerm(), b->getTerm());
-              }else if(bvs_a != bvs_b){
-                 throw PonoException(to_string(enc.loc.end.line) +" Unsigned/Signed mismatch");
-              } else{
-              e = enc.solver_->make_term(smt::Equal, a->getTerm(), b->getTerm());
-              }
-              assert(e);
-              $$ = new SMVnode(e,bvs_a);
+              $$ = enc.make_bool_op(smt::Equal, $1, $3);
               }else{
               $$ = new iff_expr($1,$3);
               }
             }
             | basic_expr OP_EQ basic_expr {
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if((bvs_a == SMVnode::Real && bvs_b == SMVnode::Integer) || (bvs_a == SMVnode::Integer && bvs_b == SMVnode::Real) ){
-                e = enc.solver_->make_term(smt::Equal, a->getTerm(), b->getTerm());
-              }else if(bvs_a != bvs_b){
-                 throw PonoException(to_string(enc.loc.end.line) +" Unsigned/Signed mismatch");
-              } else{
-               e = enc.solver_->make_term(smt::Equal, a->getTerm(), b->getTerm());
-              }
-              assert(e);
-              $$ = new SMVnode(e,SMVnode::Boolean);
+              $$ = enc.make_equal(smt::Equal, $1, $3);
               }else{
               $$ = new eq_expr($1,$3);
               }
             }
             | basic_expr OP_NEQ basic_expr {
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term e;
-              if((bvs_a == SMVnode::Real && bvs_b == SMVnode::Integer) || (bvs_a == SMVnode::Integer && bvs_b == SMVnode::Real) ){
-                e = enc.solver_->make_term(smt::Distinct, a->getTerm(), b->getTerm());
-              }else if(bvs_a != bvs_b){
-                 throw PonoException(to_string(enc.loc.end.line) +" Unsigned/Signed mismatch");
-              } else{
-                e = enc.solver_->make_term(smt::Distinct, a->getTerm(), b->getTerm());
-              }
-                assert(e);
-                $$ = new SMVnode(e,SMVnode::Boolean);
+              $$ = enc.make_equal(smt::Distinct, $1, $3);
               }else{
               $$ = new neq_expr($1,$3);
               }
             }
             | basic_expr OP_LT basic_expr  {
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ( (bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Lt, a->getTerm(), b->getTerm());
-              }else{
-                  if (bvs_a == bvs_b == SMVnode::Unsigned){
-                    res = enc.solver_->make_term(smt::BVUlt, a->getTerm(), b->getTerm());
-                  } else if (bvs_a == bvs_b == SMVnode::Signed){
-                    res = enc.solver_->make_term(smt::BVSlt, a->getTerm(), b->getTerm());
-                  } else{
-                    throw PonoException (to_string(enc.loc.end.line) +" Unsigned/Signed mismatch");
-                  }
-              }
-                  assert(res);
-                  $$ = new SMVnode(res,SMVnode::Boolean);
+              $$ = enc.make_compare(smt::Lt, smt::BVUlt, smt::BVSlt, $1, $3);
               }else{
               $$ = new lt_expr($1,$3);
               }
             }
             | basic_expr OP_GT basic_expr {
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              smt::SortKind kind_a = a->getTerm()->get_sort()->get_sort_kind();
-              smt::SortKind kind_b = b->getTerm()->get_sort()->get_sort_kind();
-              smt::Term res;
-              if ( (kind_a == smt::INT) || (kind_a == smt::REAL) ||(kind_b == smt::INT) || (kind_b == smt::REAL) ){
-                  res = enc.solver_->make_term(smt::Gt, a->getTerm(), b->getTerm());
-              }else{
-                  SMVnode::Type bvs_a = a->getType();
-                  SMVnode::Type bvs_b = b->getType();
-                  if (bvs_a == bvs_b == SMVnode::Unsigned){
-                    res = enc.solver_->make_term(smt::BVUgt, a->getTerm(), b->getTerm());
-                  } else if (bvs_a == bvs_b == SMVnode::Signed){
-                    res = enc.solver_->make_term(smt::BVSgt, a->getTerm(), b->getTerm());
-                  } else{
-                    throw PonoException (to_string(enc.loc.end.line) +" Unsigned/Signed mismatch");
-                  }
-              }
-                  assert(res);
-                  $$ = new SMVnode(res,SMVnode::Boolean);
+              $$ = enc.make_compare(smt::Gt, smt::BVUgt, smt::BVSgt, $1, $3);
               }else{
               $$ = new gt_expr($1,$3);
               }
             }
             | basic_expr OP_LTE basic_expr{
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ( (bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Le, a->getTerm(), b->getTerm());
-              }else{
-                  if (bvs_a == bvs_b == SMVnode::Unsigned){
-                    res = enc.solver_->make_term(smt::BVUle, a->getTerm(), b->getTerm());
-                  } else if (bvs_a == bvs_b == SMVnode::Signed){
-                    res = enc.solver_->make_term(smt::BVSle, a->getTerm(), b->getTerm());
-                  } else{
-                    throw PonoException (to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-                  }
-              }
-                  assert(res);
-                  $$ = new SMVnode(res,SMVnode::Boolean);
+              $$ = enc.make_compare(smt::Le, smt::BVUle, smt::BVSle, $1, $3);
               }else{
               $$ = new lte_expr($1,$3);
               }
             }
             | basic_expr OP_GTE basic_expr{
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ( (bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Ge, a->getTerm(), b->getTerm());
-              }else{
-                  if (bvs_a == bvs_b == SMVnode::Unsigned){
-                    res = enc.solver_->make_term(smt::BVUge, a->getTerm(), b->getTerm());
-                  } else if (bvs_a == bvs_b == SMVnode::Signed){
-                    res = enc.solver_->make_term(smt::BVSge, a->getTerm(), b->getTerm());
-                  } else{
-                    throw PonoException (to_string(enc.loc.end.line) +" Unsigned/Signed mismatch");
-                  }
-              }
-                  assert(res);
-                  $$ = new SMVnode(res,SMVnode::Boolean);
+              $$ = enc.make_compare(smt::Ge, smt::BVUge, smt::BVSge, $1, $3);
               }else{
               $$ = new gte_expr($1,$3);
               }
             }
             | OP_MINUS basic_expr %prec UMINUS{
             if(enc.module_flat){
-                SMVnode *a = $2;
-                SMVnode::Type bvs_a = a->getType();
-                smt::Term res;
-                if ((bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real)){
-                  res = enc.solver_->make_term(smt::Negate, a->getTerm());
-                  assert(res); //check res non-null
-                  if(res->get_sort()->get_sort_kind()==smt::REAL) $$ = new SMVnode(res,SMVnode::Real);
-                  else $$ = new SMVnode(res,SMVnode::Integer);
-                }else {
-                  res = enc.solver_->make_term(smt::BVNeg, a->getTerm());
-                  assert(res); //check res non-null
-                  $$ = new SMVnode(res,bvs_a);
-                }
+              $$ = enc.make_uminus($2);
               }else{
               $$ = new uminus_expr($2);
               }
             }
             | basic_expr "+" basic_expr{
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ((bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Plus, a->getTerm(), b->getTerm());
-                  assert(res); //check res non-null
-                  if(res->get_sort()->get_sort_kind()==smt::REAL) $$ = new SMVnode(res,SMVnode::Real);
-                  else $$ = new SMVnode(res,SMVnode::Integer);
-              }else{
-                  if(bvs_a != bvs_b){
-                   throw PonoException(to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-                  } else{
-                  res = enc.solver_->make_term(smt::BVAdd, a->getTerm(), b->getTerm());
-                  assert(res); //check res non-null
-                  $$ = new SMVnode(res,bvs_a);
-                }
-              }
+              $$ = enc.make_arith(smt::Plus, smt::BVAdd, $1, $3);
               }else{
               $$ = new add_expr($1,$3);
               }
             }
             | basic_expr "-" basic_expr{
             if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ((bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Minus, a->getTerm(), b->getTerm());
-                  assert(res); //check res non-null
-                  if(res->get_sort()->get_sort_kind()==smt::REAL) $$ = new SMVnode(res,SMVnode::Real);
-                  else $$ = new SMVnode(res,SMVnode::Integer);
-              }else{
-                  if(bvs_a != bvs_b){
-                   throw PonoException(to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-                  } else{
-                  assert(res); //check res non-null
-                  res = enc.solver_->make_term(smt::BVSub, a->getTerm(), b->getTerm());
-                  $$ = new SMVnode(res,bvs_a);
-                  }
-              }
+              $$ = enc.make_arith(smt::Minus, smt::BVSub, $1, $3);
               }else{
               $$ = new sub_expr($1,$3);
               }
             }
             | basic_expr "*" basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ((bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Mult, a->getTerm(), b->getTerm());
-                  assert(res); //check res non-null
-                  if(res->get_sort()->get_sort_kind()==smt::REAL) $$ = new SMVnode(res,SMVnode::Real);
-                  else $$ = new SMVnode(res,SMVnode::Integer);
-              }else{
-                  if(bvs_a != bvs_b){
-                   throw PonoException(to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-                  } else{
-                  assert(res); //check res non-null
-                  res = enc.solver_->make_term(smt::BVMul, a->getTerm(), b->getTerm());
-                  $$ = new SMVnode(res,bvs_a);
-                  }
-              }
+              $$ = enc.make_arith(smt::Mult, smt::BVMul, $1, $3);
               }else{
               $$ = new mul_expr($1,$3);
               }
             }
             | basic_expr "/" basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ((bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Div, a->getTerm(), b->getTerm());
-                  assert(res); //check res non-null
-                  if(res->get_sort()->get_sort_kind()==smt::REAL) $$ = new SMVnode(res,SMVnode::Real);
-                  else $$ = new SMVnode(res,SMVnode::Integer);
-              }else{
-                  if (bvs_a == bvs_b == SMVnode::Unsigned){
-                    res = enc.solver_->make_term(smt::BVUdiv, a->getTerm(), b->getTerm());
-                    $$ = new SMVnode(res,SMVnode::Unsigned);
-                  } else if (bvs_a == bvs_b == SMVnode::Signed){
-                    assert(res); //check res non-null
-                    res = enc.solver_->make_term(smt::BVSdiv, a->getTerm(), b->getTerm());
-                    $$ = new SMVnode(res,SMVnode::Signed);
-                  } else{
-                    throw PonoException (to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-                  }
-              }
+              $$ = enc.make_div(smt::Div, smt::BVUdiv, smt::BVSdiv, $1, $3);
               }else{
               $$ = new div_expr($1,$3);
               }
             }
             | basic_expr OP_MOD basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res;
-              if ((bvs_a == SMVnode::Integer) || (bvs_a == SMVnode::Real) ||(bvs_b == SMVnode::Integer) || (bvs_b == SMVnode::Real) ){
-                  res = enc.solver_->make_term(smt::Mod, a->getTerm(), b->getTerm());
-                  assert(res); //check res non-null
-                  if(res->get_sort()->get_sort_kind()==smt::REAL) $$ = new SMVnode(res,SMVnode::Real);
-                  else $$ = new SMVnode(res,SMVnode::Integer);
-              }else{
-                  if (bvs_a == bvs_b == SMVnode::Unsigned){
-                    res = enc.solver_->make_term(smt::BVUrem, a->getTerm(), b->getTerm());
-                    assert(res); //check res non-null
-                    $$ = new SMVnode(res,SMVnode::Unsigned);
-                  } else if (bvs_a == bvs_b == SMVnode::Signed){
-                    res = enc.solver_->make_term(smt::BVSmod, a->getTerm(), b->getTerm());
-                    assert(res); //check res non-null
-                    $$ = new SMVnode(res,SMVnode::Signed);
-                  } else{
-                    throw PonoException (to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-                  }
-              }
+              $$ = enc.make_div(smt::Mod, smt::BVUrem, smt::BVSmod, $1, $3);
               }else{
               $$ = new mod_expr($1,$3);
               }
             }
             | basic_expr OP_SHIFTR basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res = enc.solver_->make_term(smt::BVLshr, a->getTerm(), b->getTerm());
-                if(bvs_b == SMVnode::Unsigned){
-                  assert(res); //check res non-null
-                  $$ = new SMVnode(res,a->getType());
-                }else{
-                  throw PonoException("Shift type mismatch");
-                }
-
+              $$ = enc.make_shift(smt::BVLshr, $1, $3);
               }else{
               $$ = new sr_expr($1,$3);
               }
             }
             | basic_expr OP_SHIFTL basic_expr{
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_b = b->getType();
-              smt::Term res = enc.solver_->make_term(smt::BVShl, a->getTerm(), b->getTerm());
-              if(bvs_b == SMVnode::Unsigned){
-                  assert(res); //check res non-null
-                  $$ = new SMVnode(res,a->getType());
-                }else{
-                  throw PonoException("Shift type mismatch");
-              }
+              $$ = enc.make_shift(smt::BVShl, $1, $3);
               }else{
               $$ = new sl_expr($1,$3);
               }
             }
             | basic_expr OP_CON basic_expr  {
               if(enc.module_flat){
-              SMVnode *a = $1;
-              SMVnode *b = $3;
-              SMVnode::Type bvs_a = a->getType();
-              SMVnode::Type bvs_b = b->getType();
-              if(bvs_a != bvs_b){
-                throw PonoException(to_string(enc.loc.end.line) +"Unsigned/Signed bitvector mismatch");
-              } else{
-                smt::Term res = enc.solver_->make_term(smt::Concat, a->getTerm(), b->getTerm());
-                assert(res); //check res non-null
-                $$ = new SMVnode(res,SMVnode::Unsigned);
-              }
+              $$ = enc.make_concat($1, $3);
               }else{
                 $$ = new con_expr($1,$3);
               }
@@ -1188,15 +668,7 @@ simple_expr: constant {
             }
             | basic_expr "[" integer_val ":" integer_val "]"{
               if(enc.module_flat){
-                SMVnode *a = $1;
-                SMVnode::Type bvs_a = a->getType();
-                if(bvs_a == SMVnode::Unsigned || bvs_a == SMVnode::Signed){
-                  smt::Term res = enc.solver_->make_term(smt::Op(smt::Extract, stoi($3),stoi($5)), a->getTerm());
-                  assert(res); //check res non-null
-                  $$ = new SMVnode(res,SMVnode::Unsigned);
-                }else{
-                  throw PonoException("Bit selection type is uncompatible");
-                }
+                $$ = enc.make_extract($1, $3, $5);
                 }else{
                 $$ = new sel_expr($1,$3,$5);
               }
@@ -1239,11 +711,7 @@ simple_expr: constant {
             | tok_floor "(" basic_expr ")"{
               if (enc.module_flat)
               {
-                smt::Term t = $3->getTerm();
-                smt::SortKind sk = t->get_sort()->get_sort_kind();
-                assert(sk == smt::REAL || sk == smt::INT);
-                smt::Term res = enc.solver_->make_term(smt::To_Int, t);
-                $$ = new SMVnode(res, SMVnode::Integer);
+                $$ = enc.make_floor($3);
               }
               else
               {
@@ -1273,35 +741,14 @@ simple_expr: constant {
             }
             | basic_expr IF_ELSE basic_expr ":" basic_expr  {
               if(enc.module_flat){
-                 SMVnode *a = $1;
-                 SMVnode *b = $3;
-                 SMVnode *c = $5;
-                 smt::Term e = enc.solver_->make_term(smt::Ite, a->getTerm(),b->getTerm(),c->getTerm());
-                 $$ = new SMVnode(e,b->getType());
+                $$ = enc.make_ite($1, $3, $5);
               }else{
                 $$ = new ite_expr($1,$3,$5);
               }
             }
           | WRITE "(" basic_expr "," basic_expr "," basic_expr ")"{
             if(enc.module_flat){
-            SMVnode *a = $3;
-            SMVnode *b = $5;
-            SMVnode *c = $7;
-            smt::Sort arrsort = a->getTerm()->get_sort();
-            smt::Sort idxsort = b->getTerm()->get_sort();
-            smt::Sort elemsort = c->getTerm()->get_sort();
-            if (arrsort->get_sort_kind() != smt::ARRAY ||
-                arrsort->get_indexsort() != idxsort ||
-                arrsort->get_elemsort() != elemsort)
-            {
-              // TODO: would be good to print the SMV text and line number
-              throw PonoException("Type checking error in array write");
-            }
-            smt::Term write_r = enc.solver_->make_term(smt::Store,
-                                                       a->getTerm(),
-                                                       b->getTerm(),
-                                                       c->getTerm());
-            $$ = new SMVnode(write_r, a->getType(), a->getElementType());
+              $$ = enc.make_write($3, $5, $7);
             }
             else{
               $$ = new write_expr($3,$5,$7);
@@ -1309,81 +756,42 @@ simple_expr: constant {
           }
           | READ "(" basic_expr "," basic_expr ")"{
             if(enc.module_flat){
-            SMVnode *a = $3;
-            SMVnode *b = $5;
-            smt::Term read_r =  enc.solver_->make_term(smt::Select, a->getTerm(),b->getTerm());
-            $$ = new SMVnode(read_r,a->getElementType());
+              $$ = enc.make_read($3, $5);
             }else{
               $$ = new read_expr($3,$5);
             }
           }
           | CONSTARRAY "(" tok_typeof "(" complex_identifier ")" "," basic_expr ")" {
              if(enc.module_flat){
-             SMVnode *a = $8;
-             smt::Term tok = enc.terms_.at($5);
-             assert(tok);
-              if(enc.arrayty_.find($5) != enc.arrayty_.end()){
-                 smt::Sort kind_ = tok->get_sort();
-                smt::Term const_arr = enc.solver_->make_term(a->getTerm(),kind_);
-                $$ = new SMVnode(const_arr,SMVnode::WordArray,a->getType());
-              } else if (enc.arrayint_.find($5) != enc.arrayint_.end()){
-                smt::Sort sort_ = tok->get_sort();
-                smt::Term const_arr = enc.solver_->make_term(a->getTerm(),sort_);
-                $$ = new SMVnode(const_arr,SMVnode::IntArray,SMVnode::Integer);
-              }
-              else{
-                throw PonoException("The type of the const array is wrong");
-              }
+               $$ = enc.make_const_array($5, $8);
              }else{
                $$ = new constarray_type_expr($5, $8);
              }
           }
           | CONSTARRAY "(" arrayword sizev of type_identifier "," basic_expr ")" {
             if(enc.module_flat){
-             SMVnode *a = $8;
-             type_node *b = $6;
-             smt::Sort arraysort = enc.solver_->make_sort(smt::BV,$4);
-             smt::Sort sort_ = enc.solver_->make_sort(smt::ARRAY, arraysort,b->getSort());
-             smt::Term const_arr = enc.solver_->make_term(a->getTerm(),sort_);
-             $$ = new SMVnode(const_arr,SMVnode::WordArray, a->getType());
+              smt::Sort index_sort = enc.solver_->make_sort(smt::BV, $4);
+              $$ = enc.make_const_array(index_sort, SMVnode::WordArray, $6, $8);
              }else{
                $$ = new constarray_word_expr($4, $6, $8);
              }
           }
           | CONSTARRAY "(" arrayinteger of type_identifier "," basic_expr ")" {
             if(enc.module_flat){
-             SMVnode *a = $7;
-             type_node *b = $5;
-             smt::Sort arraysort = enc.solver_->make_sort(smt::INT);
-             smt::Sort sort_ = enc.solver_->make_sort(smt::ARRAY, arraysort, b->getSort());
-             smt::Term const_arr = enc.solver_->make_term(a->getTerm(),sort_);
-             $$ = new SMVnode(const_arr,SMVnode::IntArray,a->getType());
+              smt::Sort index_sort = enc.solver_->make_sort(smt::INT);
+              $$ = enc.make_const_array(index_sort, SMVnode::IntArray, $5, $7);
              }else{
                $$ = new constarray_int_expr($5, $7);
              }
           }
           | case_expr {
-            SMVnode *a = $1;
             $$ = $1;
           }
           | complex_identifier "(" parameter_list ")"
           {
             if (enc.module_flat)
             {
-              if (enc.ufs_.find($1) == enc.ufs_.end())
-              {
-                throw PonoException("Function application with unknown function: " + $1);
-              }
-              auto fun_info = enc.ufs_.at($1);
-              smt::Term fun = fun_info.first;
-              SMVnode::Type return_type = fun_info.second;
-              smt::TermVec args({fun});
-              for (auto arg : $3)
-              {
-                args.push_back(arg->getTerm());
-              }
-              $$ = new SMVnode(enc.solver_->make_term(smt::Apply, args),
-                               return_type);
+              $$ = enc.make_apply($1, $3);
             }
             else
             {
@@ -1394,9 +802,7 @@ simple_expr: constant {
 
 next_expr: TOK_NEXT "(" basic_expr ")"{
   if(enc.module_flat){
-          SMVnode *a = $3;
-          smt::Term n = enc.rts_.next(a->getTerm());
-          $$ = new SMVnode(n,a->getType());
+    $$ = enc.make_next($3);
   }else{
     $$ = new next_expr($3);
   }
@@ -1404,51 +810,25 @@ next_expr: TOK_NEXT "(" basic_expr ")"{
 
 case_expr: TOK_CASE case_body TOK_ESAC {
   if(enc.module_flat){
-          std::pair<SMVnode*,SMVnode*> term_last = enc.caseterm_.back();
-          smt::Term cond = term_last.first->getTerm();
-          smt::Term final_term = term_last.second->getTerm();
-          enc.caseterm_.pop_back();
-          int total_num = enc.caseterm_.size();
-          SMVnode::Type t = SMVnode::Default;
-          for (int i = 0; i < total_num; i++){
-            std::pair<SMVnode*,SMVnode*> term_pair = enc.caseterm_.back();
-            enc.caseterm_.pop_back();
-            case_true = true;
-            t = term_pair.second->getType();
-            smt::Term e = enc.solver_->make_term(smt::Ite, term_pair.first->getTerm(), term_pair.second->getTerm(), final_term);
-            if(cond->get_sort()->get_sort_kind() == smt::BOOL) cond = enc.solver_->make_term(smt::Or,cond, term_pair.first->getTerm());
-            else cond = enc.solver_->make_term(smt::BVOr,cond, term_pair.first->getTerm());
-            final_term = e;
-          }
-          enc.casecheck_.push_back(cond);
-          $$ = new SMVnode(final_term,t);
+    std::vector<std::pair<SMVnode*,SMVnode*>> body;
+    for (auto e : $2) {
+      case_body_ex *c = static_cast<case_body_ex *>(e);
+      body.push_back(make_pair(c->get_cond(), c->get_value()));
+    }
+    $$ = enc.make_case(body);
   }else{
     $$ = new case_expr($2);
   }
 }
 
 case_body: basic_expr ":" basic_expr ";"{
-  if(enc.module_flat){
-      case_start = enc.loc.end.line;
-      SMVnode *a = $1;
-      SMVnode *b = $3;
-      enc.caseterm_.clear();
-      enc.caseterm_.push_back(make_pair(a,b));
-  }else{
     vector<SMVnode*> body;
     body.push_back(new case_body_ex($1,$3));
     $$ = body;
-  }
 } | case_body basic_expr ":" basic_expr ";" {
-  if(enc.module_flat){
-      SMVnode *a = $2;
-      SMVnode *b = $4;
-      enc.caseterm_.push_back(make_pair(a,b));
-  }else{
     vector<SMVnode*> body = $1;
     body.push_back(new case_body_ex($2,$4));
     $$ = body;
-  }
 };
 
 basic_expr_list: basic_expr
@@ -1468,28 +848,16 @@ complex_identifier: tok_name{
  };
 
 type_identifier: real_type{
-        if(enc.module_flat){
                 smt::Sort sort_ = enc.solver_->make_sort(smt::REAL);
-                $$ =  new type_node(sort_,SMVnode::Real);
-        }else{
-          $$ = new type_node("real");
-        }
+                $$ = new type_node("real", sort_, SMVnode::Real);
                 }
                 | integer_type{
-                  if(enc.module_flat){
                   smt::Sort sort_ = enc.solver_->make_sort(smt::INT);
-                  $$ =  new type_node (sort_,SMVnode::Integer);
-                  }else{
-                   $$ = new type_node("integer");
-                  }
+                  $$ = new type_node("integer", sort_, SMVnode::Integer);
                 }
                 | bool_type {
-                  if(enc.module_flat){
                   smt::Sort sort_ = enc.solver_->make_sort(smt::BOOL);
-                  $$ =  new type_node(sort_,SMVnode::Boolean);
-                  }else{
-                    $$ = new type_node("boolean");
-                  }
+                  $$ = new type_node("boolean", sort_, SMVnode::Boolean);
                 }
                 | array_type{
                   $$ = $1 ;
@@ -1502,56 +870,34 @@ type_identifier: real_type{
                 };
 
 word_type: signed_word sizev {
-  if(enc.module_flat){
         smt::Sort sort_ = enc.solver_->make_sort(smt::BV, $2);
-        $$ =  new type_node(sort_,SMVnode::Signed);
-  }else{
-    string n = "signed word [" + std::to_string($2) + "]";
-    $$ = new type_node(n);
-  }
+        string n = "signed word [" + std::to_string($2) + "]";
+        $$ = new type_node(n, sort_, SMVnode::Signed);
 }
           | unsigned_word sizev{
-            if(enc.module_flat){
-            smt::Sort sort_ = enc.solver_->make_sort(smt::BV, $2);
-            $$ =  new type_node (sort_,SMVnode::Unsigned);
-    }else{
+        smt::Sort sort_ = enc.solver_->make_sort(smt::BV, $2);
         string n = "unsigned word [" + std::to_string($2) + "]";
-         $$ = new type_node(n);
-    }
+        $$ = new type_node(n, sort_, SMVnode::Unsigned);
 }
           | tok_word sizev{
-    if(enc.module_flat){
         smt::Sort sort_ = enc.solver_->make_sort(smt::BV, $2);
-        $$ =  new type_node (sort_,SMVnode::Unsigned);
-    }else{
         string n = "word [" + std::to_string($2) + "]";
-        $$ = new type_node(n);
-    }
+        $$ = new type_node(n, sort_, SMVnode::Unsigned);
 };
 
 array_type: arrayword sizev of type_identifier{
-            if(enc.module_flat){
               smt::Sort arraysort = enc.solver_->make_sort(smt::BV,$2);
-              SMVnode *a = $4;
+              type_node *a = $4;
               smt::Sort sort_ = enc.solver_->make_sort(smt::ARRAY, arraysort,a->getSort());
-              $$ = new type_node(sort_,SMVnode::WordArray,a->getType());
-            }else{
-              SMVnode *temp = $4;
-              string n = "array word" + std::to_string($2) + "of " + temp->getName();
-              $$ = new type_node(n);
-            }
+              string n = "array word [" + std::to_string($2) + "] of " + a->getName();
+              $$ = new type_node(n, sort_, SMVnode::WordArray, a->getType());
           }
           | arrayinteger of type_identifier{
-           if(enc.module_flat){
             smt::Sort arraysort = enc.solver_->make_sort(smt::INT);
-            SMVnode *a = $3;
+            type_node *a = $3;
             smt::Sort sort_ = enc.solver_->make_sort(smt::ARRAY, arraysort,a->getSort());
-            $$ = new type_node(sort_,SMVnode::IntArray,a->getType());
-            }else{
-            SMVnode *temp = $3;
-            string n = "array integer of " + temp->getName();
-            $$ = new type_node(n);
-            }
+            string n = "array integer of " + a->getName();
+            $$ = new type_node(n, sort_, SMVnode::IntArray, a->getType());
           }
           | array_tok of type_identifier{
             throw PonoException("No other array now");
@@ -1560,33 +906,26 @@ array_type: arrayword sizev of type_identifier{
 fun_type:
    domain_list OP_IMPLY type_identifier
    {
-     if (enc.module_flat)
-     {
-       smt::SortVec sorts;
-       for (auto tn : $1)
-       {
-         sorts.push_back(tn->getSort());
-       }
-       sorts.push_back($3->getSort());
-       smt::Sort funsort = enc.solver_->make_sort(smt::FUNCTION, sorts);
-       // TODO: properly handle function sorts
-       //       for now just storing return type because that's all we
-       //       need to propagate signed / unsigned type checking
-       //       at the SMV level (no notion of signed / unsigned values
-       //       in SMT-LIB, instead only the operators)
-       $$ = new type_node(funsort, $3->getType());
-     }
-     else
+     assert($1.size());
+     smt::SortVec sorts;
+     std::string n = $1[0]->getName();
+     for (size_t i = 0; i < $1.size(); ++i)
      {
-       assert($1.size());
-       std::string n = $1[0]->getName();
-       for (size_t i = 1; i < $1.size(); ++i)
+       sorts.push_back($1[i]->getSort());
+       if (i > 0)
        {
          n += " * " + $1[i]->getName();
        }
-       n += " -> " + $3->getName();
-       $$ = new type_node(n);
      }
+     sorts.push_back($3->getSort());
+     n += " -> " + $3->getName();
+     smt::Sort funsort = enc.solver_->make_sort(smt::FUNCTION, sorts);
+     // TODO: properly handle function sorts
+     //       for now just storing return type because that's all we
+     //       need to propagate signed / unsigned type checking
+     //       at the SMV level (no notion of signed / unsigned values
+     //       in SMT-LIB, instead only the operators)
+     $$ = new type_node(n, funsort, $3->getType());
    }
 ;
 
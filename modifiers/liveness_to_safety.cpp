@@ -0,0 +1,95 @@
+/*********************                                                  */
+/*! \file liveness_to_safety.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Functions for reducing justice properties (with fairness
+**        constraints) to a single signal and to safety properties.
+**
+**/
+
+#include "modifiers/liveness_to_safety.h"
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+Term combine_justice(TransitionSystem & ts,
+                     const TermVec & justice,
+                     const TermVec & fairness)
+{
+  TermVec signals = justice;
+  signals.insert(signals.end(), fairness.begin(), fairness.end());
+  if (signals.empty()) {
+    throw PonoException("Expecting at least one justice signal");
+  }
+  if (signals.size() == 1) {
+    return signals[0];
+  }
+
+  logger.log(1, "Combining {} justice and fairness signals", signals.size());
+
+  Sort boolsort = ts.make_sort(BOOL);
+  TermVec seen;
+  TermVec seen_or_now;
+  Term combined = ts.make_term(true);
+  for (size_t i = 0; i < signals.size(); ++i) {
+    seen.push_back(ts.make_statevar("_justice_seen_" + std::to_string(i),
+                                    boolsort));
+    ts.constrain_init(ts.make_term(Not, seen.back()));
+    seen_or_now.push_back(ts.make_term(Or, seen.back(), signals[i]));
+    combined = ts.make_term(And, combined, seen_or_now.back());
+  }
+
+  // start over once all of them have been seen
+  Term not_combined = ts.make_term(Not, combined);
+  for (size_t i = 0; i < signals.size(); ++i) {
+    ts.assign_next(seen[i], ts.make_term(And, not_combined, seen_or_now[i]));
+  }
+
+  return combined;
+}
+
+Term liveness_to_safety(TransitionSystem & ts, const Term & signal)
+{
+  logger.log(1, "Adding a liveness-to-safety monitor");
+
+  // the original state is copied, not the monitor
+  UnorderedTermSet statevars = ts.statevars();
+
+  Sort boolsort = ts.make_sort(BOOL);
+  Term save = ts.make_inputvar("_l2s_save", boolsort);
+  Term saved = ts.make_statevar("_l2s_saved", boolsort);
+  Term live = ts.make_statevar("_l2s_live", boolsort);
+  ts.constrain_init(ts.make_term(Not, saved));
+  ts.constrain_init(ts.make_term(Not, live));
+
+  Term save_now = ts.make_term(And, save, ts.make_term(Not, saved));
+  Term in_loop = ts.make_term(Or, saved, save);
+  ts.assign_next(saved, in_loop);
+  // the signal was true since the state was saved
+  ts.assign_next(live,
+                 ts.make_term(And, in_loop, ts.make_term(Or, live, signal)));
+
+  Term looped = ts.make_term(And, saved, live);
+  for (const auto & sv : statevars) {
+    Term shadow =
+        ts.make_statevar("_l2s_shadow_" + sv->to_string(), sv->get_sort());
+    ts.assign_next(shadow, ts.make_term(Ite, save_now, sv, shadow));
+    looped = ts.make_term(And, looped, ts.make_term(Equal, sv, shadow));
+  }
+
+  return ts.make_term(Not, looped);
+}
+
+}  // namespace pono
@@ -0,0 +1,50 @@
+/*********************                                                  */
+/*! \file liveness_to_safety.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Functions for reducing justice properties (with fairness
+**        constraints) to a single signal and to safety properties.
+**
+**        A justice property is violated by an infinite path on which
+**        every justice and fairness signal is true infinitely often.
+**
+**/
+
+#pragma once
+
+#include "core/ts.h"
+
+namespace pono {
+
+/** Combines justice and fairness signals into a single signal which is
+ *  true infinitely often iff all of them are
+ *  adds a monitor state variable for each signal that remembers
+ *  if it has been seen since the combined signal was last true
+ *  @param ts the transition system to modify
+ *  @param justice the (boolean) justice signals
+ *  @param fairness the (boolean) fairness signals
+ *  @return the combined signal
+ */
+smt::Term combine_justice(TransitionSystem & ts,
+                          const smt::TermVec & justice,
+                          const smt::TermVec & fairness);
+
+/** Liveness-to-safety translation (Biere, Artho, Schuppan)
+ *  a non-deterministic input saves a copy of the state, then a bad
+ *  state is reached when the current state is equal to the saved
+ *  copy and the signal was true in between, i.e. on a lasso where
+ *  the signal is true infinitely often
+ *  @param ts the transition system to modify
+ *  @param signal the signal that should not be true infinitely often
+ *  @return the safety property (over current state variables)
+ */
+smt::Term liveness_to_safety(TransitionSystem & ts, const smt::Term & signal);
+
+}  // namespace pono
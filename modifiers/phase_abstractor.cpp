@@ -0,0 +1,198 @@
+/*********************                                                  */
+/*! \file phase_abstractor.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Phase abstraction: folds the low and high phase of a clock
+**        into a single transition per clock cycle.
+**
+**/
+
+#include "modifiers/phase_abstractor.h"
+
+#include "assert.h"
+#include "smt-switch/substitution_walker.h"
+#include "utils/logger.h"
+#include "utils/term_evaluator.h"
+#include "utils/ts_manipulation.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+PhaseAbstractor::PhaseAbstractor(const TransitionSystem & ts,
+                                 const Term & clock_symbol)
+    : orig_ts_(ts),
+      abs_ts_(create_fresh_ts(true, ts.solver())),
+      clock_(clock_symbol)
+{
+  const SmtSolver & solver = orig_ts_.solver();
+  if (!orig_ts_.is_functional()) {
+    throw PonoException(
+        "Phase abstraction requires a functional transition system");
+  }
+
+  Sort sort = clock_->get_sort();
+  SortKind sk = sort->get_sort_kind();
+  if (sk != BOOL && sort != solver->make_sort(BV, 1)) {
+    throw PonoException("Expecting a boolean or one-bit clock sort.");
+  }
+  if (orig_ts_.is_curr_var(clock_)) {
+    if (orig_ts_.state_updates().find(clock_)
+        != orig_ts_.state_updates().end()) {
+      throw PonoException("Clock " + clock_->to_string()
+                          + " already has a next-state function");
+    }
+  } else if (orig_ts_.inputvars().find(clock_)
+             == orig_ts_.inputvars().end()) {
+    throw PonoException("Clock " + clock_->to_string()
+                        + " is not an input or state variable");
+  }
+
+  Term low_val = (sk == BOOL) ? solver->make_term(false)
+                              : solver->make_term(0, sort);
+  Term high_val = (sk == BOOL) ? solver->make_term(true)
+                               : solver->make_term(1, sort);
+  low_[clock_] = low_val;
+  high_[clock_] = high_val;
+
+  // the clock stays in the system, unconstrained and unused,
+  // so that the witness printers still know about it
+  for (const auto & sv : orig_ts_.statevars()) {
+    abs_ts_.add_statevar(sv, orig_ts_.next(sv));
+  }
+  for (const auto & iv : orig_ts_.inputvars()) {
+    abs_ts_.add_inputvar(iv);
+    if (iv == clock_) {
+      continue;
+    }
+    Term iv_high =
+        solver->make_symbol(iv->to_string() + "__high__", iv->get_sort());
+    abs_ts_.add_inputvar(iv_high);
+    high_inputs_[iv] = iv_high;
+    high_[iv] = iv_high;
+  }
+
+  // the state after the low phase
+  SubstitutionWalker low_walker(solver, low_);
+  const UnorderedTermMap & state_updates = orig_ts_.state_updates();
+  for (const auto & sv : orig_ts_.statevars()) {
+    if (sv == clock_) {
+      continue;
+    }
+    auto it = state_updates.find(sv);
+    Term mid;
+    if (it != state_updates.end()) {
+      Term update = it->second;
+      mid = low_walker.visit(update);
+    } else {
+      // unconstrained in every step
+      mid = solver->make_symbol(sv->to_string() + "__mid__", sv->get_sort());
+      abs_ts_.add_inputvar(mid);
+    }
+    mid_states_[sv] = mid;
+    high_[sv] = mid;
+  }
+
+  // the high phase starts from the state after the low phase
+  SubstitutionWalker high_walker(solver, high_);
+  for (auto elem : state_updates) {
+    abs_ts_.assign_next(elem.first, high_walker.visit(elem.second));
+  }
+
+  Term init = orig_ts_.init();
+  abs_ts_.set_init(low_walker.visit(init));
+
+  // constraints have to hold in both phases
+  for (auto e : orig_ts_.constraints()) {
+    abs_ts_.add_constraint(low_walker.visit(e.first), e.second);
+    abs_ts_.add_constraint(high_walker.visit(e.first), false);
+  }
+
+  for (const auto & elem : orig_ts_.named_terms()) {
+    Term t = elem.second;
+    if (t == clock_ || !orig_ts_.no_next(t)) {
+      continue;
+    }
+    abs_ts_.name_term(elem.first, low_walker.visit(t));
+  }
+
+  logger.log(1,
+             "Phase abstraction: {} state variables, {} inputs including "
+             "the high phase copies",
+             abs_ts_.statevars().size(),
+             abs_ts_.inputvars().size());
+}
+
+Term PhaseAbstractor::abstract_prop(const Term & prop) const
+{
+  const SmtSolver & solver = orig_ts_.solver();
+  Term low_prop = solver->substitute(prop, low_);
+  Term high_prop = solver->substitute(prop, high_);
+  return solver->make_term(And, low_prop, high_prop);
+}
+
+vector<UnorderedTermMap> PhaseAbstractor::expand_witness(
+    const vector<UnorderedTermMap> & abs_cex) const
+{
+  const SmtSolver & solver = orig_ts_.solver();
+  Term low_val = low_.at(clock_);
+  Term high_val = high_.at(clock_);
+
+  vector<UnorderedTermMap> cex;
+  cex.reserve(2 * abs_cex.size());
+  TermEvaluator evaluator(solver);
+  for (const auto & abs_map : abs_cex) {
+    UnorderedTermMap low_map, high_map;
+    for (const auto & sv : orig_ts_.statevars()) {
+      auto it = abs_map.find(sv);
+      if (it != abs_map.end()) {
+        low_map[sv] = it->second;
+      }
+    }
+    for (const auto & iv : orig_ts_.inputvars()) {
+      auto it = abs_map.find(iv);
+      if (it != abs_map.end()) {
+        low_map[iv] = it->second;
+      }
+      auto hit = high_inputs_.find(iv);
+      if (hit == high_inputs_.end()) {
+        continue;
+      }
+      it = abs_map.find(hit->second);
+      if (it != abs_map.end()) {
+        high_map[iv] = it->second;
+      }
+    }
+    low_map[clock_] = low_val;
+    high_map[clock_] = high_val;
+
+    // the state after the low phase
+    evaluator.set_assignment(abs_map);
+    for (const auto & elem : mid_states_) {
+      Term val = evaluator.evaluate(elem.second);
+      if (val) {
+        high_map[elem.first] = val;
+      } else {
+        logger.log(3,
+                   "Could not evaluate {} after the low phase",
+                   elem.first);
+      }
+    }
+
+    cex.push_back(low_map);
+    cex.push_back(high_map);
+  }
+
+  evaluate_named_terms(orig_ts_, cex);
+  return cex;
+}
+
+}  // namespace pono
@@ -0,0 +1,74 @@
+/*********************                                                  */
+/*! \file phase_abstractor.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Phase abstraction: folds the low and high phase of a clock
+**        into a single transition per clock cycle.
+**
+**        Instead of toggling the clock every step (see toggle_clock),
+**        the next-state function of the abstract system applies the
+**        low phase (clock 0) and then the high phase (clock 1).
+**        Inputs get a second copy for the high phase. A state of the
+**        abstract system corresponds to the state at the start of a
+**        low phase, which halves the depth of BMC, k-induction and IC3.
+**
+**/
+
+#pragma once
+
+#include <vector>
+
+#include "core/ts.h"
+
+namespace pono {
+
+class PhaseAbstractor
+{
+ public:
+  /** Builds the abstract system
+   *  throws a PonoException if the system is not functional or the
+   *  clock is not a boolean or one-bit input or state variable without
+   *  a next-state function
+   *  @param ts the system with an explicit clock
+   *  @param clock_symbol the clock, posedge is when it becomes true/bv1
+   */
+  PhaseAbstractor(const TransitionSystem & ts, const smt::Term & clock_symbol);
+
+  /** @return the abstract system, one transition per clock cycle */
+  const TransitionSystem & abs_ts() const { return abs_ts_; }
+
+  /** @return a property of the abstract system that holds iff prop
+   *  holds in both phases of every cycle
+   *  (over current state and input variables)
+   */
+  smt::Term abstract_prop(const smt::Term & prop) const;
+
+  /** Expands a witness of the abstract system into one step per phase
+   *  over the variables and named terms of the original system
+   *  @param abs_cex the witness of the abstract system
+   *  @return the witness of the original system, twice as long
+   */
+  std::vector<smt::UnorderedTermMap> expand_witness(
+      const std::vector<smt::UnorderedTermMap> & abs_cex) const;
+
+ protected:
+  TransitionSystem orig_ts_;
+  TransitionSystem abs_ts_;
+  smt::Term clock_;
+
+  smt::UnorderedTermMap low_;   ///< clock to its low value
+  smt::UnorderedTermMap high_;  ///< original to high phase variables
+  ///< state variables to their value after the low phase
+  smt::UnorderedTermMap mid_states_;
+  ///< original inputs to their copies for the high phase
+  smt::UnorderedTermMap high_inputs_;
+};
+
+}  // namespace pono
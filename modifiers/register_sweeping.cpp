@@ -0,0 +1,190 @@
+/*********************                                                  */
+/*! \file register_sweeping.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Sequential sweeping of constant and equivalent state variables.
+**
+**/
+
+#include "modifiers/register_sweeping.h"
+
+#include "utils/invariant_miner.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+/** Union-find over the state variables with a polarity on every edge
+ *  the representative of a class is a state variable or a value, so the
+ *  replacements never chain or cycle
+ */
+class SweepClasses
+{
+ public:
+  SweepClasses(const SmtSolver & solver) : solver_(solver) {}
+
+  /** Records that state variable a is equal to b (or to its negation)
+   *  @param a a state variable
+   *  @param b a state variable or a value
+   *  @param negated true iff a is the negation of b
+   */
+  void merge(const Term & a, const Term & b, bool negated)
+  {
+    pair<Term, bool> ra = find(a);
+    pair<Term, bool> rb = find(b);
+    bool neg = (ra.second != rb.second) != negated;
+    if (ra.first == rb.first) {
+      return;
+    } else if (ra.first->is_value()) {
+      if (rb.first->is_value()) {
+        return;
+      }
+      swap(ra, rb);
+    }
+
+    if (rb.first->is_value()) {
+      parent_[ra.first] = with_polarity(rb.first, neg);
+    } else {
+      parent_[ra.first] = rb.first;
+      if (neg) {
+        negated_.insert(ra.first);
+      }
+    }
+  }
+
+  /** @return a map from every merged state variable that is not a
+   *          representative to its representative (with polarity)
+   */
+  UnorderedTermMap replacements() const
+  {
+    UnorderedTermMap res;
+    for (const auto & elem : parent_) {
+      pair<Term, bool> r = find(elem.first);
+      res[elem.first] = with_polarity(r.first, r.second);
+    }
+    return res;
+  }
+
+ private:
+  pair<Term, bool> find(Term t) const
+  {
+    bool neg = false;
+    auto it = parent_.find(t);
+    while (it != parent_.end()) {
+      neg = neg != (negated_.find(t) != negated_.end());
+      t = it->second;
+      it = parent_.find(t);
+    }
+    return { t, neg };
+  }
+
+  Term with_polarity(const Term & t, bool negated) const
+  {
+    if (!negated) {
+      return t;
+    } else if (t->is_value()) {
+      return solver_->make_term(t != solver_->make_term(true));
+    }
+    return solver_->make_term(Not, t);
+  }
+
+  SmtSolver solver_;
+  UnorderedTermMap parent_;
+  UnorderedTermSet negated_;  ///< state variables negated w.r.t. parent
+};
+
+/** Merges the classes related by an invariant candidate
+ *  @return true iff the candidate is a constant or an equivalence
+ */
+static bool add_replacement(const TransitionSystem & ts,
+                            const Term & inv,
+                            SweepClasses & classes)
+{
+  const SmtSolver & solver = ts.solver();
+  auto is_sv = [&ts](const Term & t) { return ts.is_curr_var(t); };
+
+  if (is_sv(inv)) {
+    classes.merge(inv, solver->make_term(true), false);
+    return true;
+  }
+
+  TermVec children(inv->begin(), inv->end());
+  Op op = inv->get_op();
+  if (op == Not && is_sv(children[0])) {
+    classes.merge(children[0], solver->make_term(true), true);
+    return true;
+  } else if (op != Equal) {
+    return false;
+  }
+
+  const Term & a = children[0];
+  const Term & b = children[1];
+  if (is_sv(a) && b->is_value()) {
+    classes.merge(a, b, false);
+    return true;
+  } else if (is_sv(a) && is_sv(b)) {
+    classes.merge(b, a, false);
+    return true;
+  } else if (is_sv(a) && b->get_op() == Not && is_sv(*b->begin())) {
+    classes.merge(*b->begin(), a, true);
+    return true;
+  }
+  return false;
+}
+
+UnorderedTermMap sweep_registers(TransitionSystem & ts,
+                                 size_t num_cycles,
+                                 unsigned int seed)
+{
+  if (!ts.is_functional()) {
+    throw PonoException(
+        "Register sweeping is only supported for functional transition "
+        "systems");
+  }
+
+  logger.log(
+      1, "Register sweeping: {} state variables", ts.statevars().size());
+
+  InvariantMiner miner(ts, seed);
+  miner.mine(num_cycles);
+
+  // only the constants and equivalences can remove state variables
+  const SmtSolver & solver = ts.solver();
+  TermVec candidates;
+  SweepClasses proposed(solver);
+  for (const auto & c : miner.candidates()) {
+    if (add_replacement(ts, c, proposed)) {
+      candidates.push_back(c);
+    }
+  }
+
+  SweepClasses proven(solver);
+  for (const auto & inv : inductive_subset(ts, candidates)) {
+    add_replacement(ts, inv, proven);
+  }
+
+  UnorderedTermMap subst = proven.replacements();
+  if (subst.empty()) {
+    logger.log(1, "Register sweeping: no constant or equivalent registers");
+    return subst;
+  }
+
+  ts.substitute_and_remove_statevars(subst);
+
+  logger.log(1,
+             "Register sweeping: removed {} state variables, {} remaining",
+             subst.size(),
+             ts.statevars().size());
+  return subst;
+}
+
+}  // namespace pono
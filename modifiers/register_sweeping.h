@@ -0,0 +1,42 @@
+/*********************                                                  */
+/*! \file register_sweeping.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Sequential sweeping: removes state variables that are constant
+**        or equal (or complementary) to another state variable in all
+**        reachable states.
+**
+**        Random simulation proposes the candidates, a Houdini-style
+**        fixpoint on the solver of the system proves them, then the
+**        proven state variables are replaced by their constant or
+**        representative.
+**
+**/
+
+#pragma once
+
+#include "core/ts.h"
+
+namespace pono {
+
+/** Sweeps the constant and equivalent state variables of a functional
+ *  transition system
+ *  @param ts the transition system to modify
+ *  @param num_cycles the number of simulated cycles proposing candidates
+ *  @param seed the seed for the random simulation
+ *  @return a map from each removed state variable to its replacement
+ *          (over the remaining state variables), to be applied to the
+ *          property with the solver's substitute
+ */
+smt::UnorderedTermMap sweep_registers(TransitionSystem & ts,
+                                      size_t num_cycles,
+                                      unsigned int seed = 0);
+
+}  // namespace pono
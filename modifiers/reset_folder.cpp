@@ -0,0 +1,260 @@
+/*********************                                                  */
+/*! \file reset_folder.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Folds the reset sequence into the initial states.
+**
+**/
+
+#include "modifiers/reset_folder.h"
+
+#include "assert.h"
+#include "smt-switch/substitution_walker.h"
+#include "smt-switch/utils.h"
+#include "utils/logger.h"
+#include "utils/term_evaluator.h"
+#include "utils/ts_manipulation.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+ResetFolder::ResetFolder(const TransitionSystem & ts,
+                         const Term & reset_symbol,
+                         size_t reset_bnd)
+    : orig_ts_(ts),
+      folded_ts_(create_fresh_ts(true, ts.solver())),
+      reset_bnd_(reset_bnd)
+{
+  const SmtSolver & solver = orig_ts_.solver();
+  if (!orig_ts_.is_functional()) {
+    throw PonoException(
+        "Reset folding requires a functional transition system");
+  }
+
+  Sort reset_sort = reset_symbol->get_sort();
+  Sort one_bit_sort = solver->make_sort(BV, 1);
+  if (reset_sort->get_sort_kind() != BOOL && reset_sort != one_bit_sort) {
+    throw PonoException("Unexpected reset symbol sort: "
+                        + reset_sort->to_string());
+  }
+  UnorderedTermSet reset_vars;
+  get_free_symbolic_consts(reset_symbol, reset_vars);
+  for (const auto & v : reset_vars) {
+    if (orig_ts_.inputvars().find(v) == orig_ts_.inputvars().end()) {
+      throw PonoException("Reset folding requires a reset over inputs");
+    }
+  }
+  Term active_reset = reset_symbol;
+  if (reset_sort == one_bit_sort) {
+    active_reset =
+        solver->make_term(Equal, reset_symbol, solver->make_term(1, reset_sort));
+  }
+
+  // symbolic simulation of the reset sequence
+  UnorderedTermMap cur;
+  for (const auto & sv : orig_ts_.statevars()) {
+    cur[sv] = solver->make_symbol(sv->to_string() + "__reset_0__",
+                                  sv->get_sort());
+  }
+  conditions_.push_back(solver->substitute(orig_ts_.init(), cur));
+  const UnorderedTermMap & state_updates = orig_ts_.state_updates();
+  for (size_t j = 0; j < reset_bnd_; ++j) {
+    UnorderedTermMap step = cur;
+    for (const auto & iv : orig_ts_.inputvars()) {
+      step[iv] = solver->make_symbol(
+          iv->to_string() + "__reset_" + to_string(j) + "__", iv->get_sort());
+    }
+    steps_.push_back(step);
+
+    SubstitutionWalker sw(solver, step);
+    conditions_.push_back(sw.visit(active_reset));
+    for (auto e : orig_ts_.constraints()) {
+      conditions_.push_back(sw.visit(e.first));
+    }
+    for (const auto & sv : orig_ts_.statevars()) {
+      auto it = state_updates.find(sv);
+      if (it != state_updates.end()) {
+        Term update = it->second;
+        cur[sv] = sw.visit(update);
+      } else {
+        cur[sv] = solver->make_symbol(
+            sv->to_string() + "__reset_" + to_string(j + 1) + "__",
+            sv->get_sort());
+      }
+    }
+  }
+  post_ = cur;
+
+  // find the state variables with the same value after every reset
+  // sequence, as long as a post-reset state differs from the first one
+  solver->push();
+  for (const auto & c : conditions_) {
+    solver->assert_formula(c);
+  }
+  Result r = solver->check_sat();
+  if (!r.is_sat()) {
+    solver->pop();
+    throw PonoException("There is no state after the reset sequence");
+  }
+  UnorderedTermMap vals;
+  UnorderedTermSet constants;
+  for (const auto & sv : orig_ts_.statevars()) {
+    vals[sv] = solver->get_value(post_.at(sv));
+    constants.insert(sv);
+  }
+  while (!constants.empty()) {
+    Term differ = solver->make_term(false);
+    for (const auto & sv : constants) {
+      differ = solver->make_term(
+          Or, differ, solver->make_term(Distinct, post_.at(sv), vals.at(sv)));
+    }
+    solver->push();
+    solver->assert_formula(differ);
+    r = solver->check_sat();
+    if (r.is_unsat()) {
+      solver->pop();
+      break;
+    }
+    for (auto it = constants.begin(); it != constants.end();) {
+      if (solver->get_value(post_.at(*it)) != vals.at(*it)) {
+        it = constants.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    solver->pop();
+  }
+  solver->pop();
+
+  // the other state variables keep the relation to the symbols of the
+  // reset sequence, with the conditions that constrain those symbols
+  UnorderedTermSet frozen;
+  TermVec init_conjuncts;
+  for (const auto & sv : orig_ts_.statevars()) {
+    if (constants.find(sv) != constants.end()) {
+      init_conjuncts.push_back(solver->make_term(Equal, sv, vals.at(sv)));
+    } else {
+      get_free_symbolic_consts(post_.at(sv), frozen);
+      init_conjuncts.push_back(solver->make_term(Equal, sv, post_.at(sv)));
+    }
+  }
+  TermVec cond_conjuncts;
+  for (const auto & c : conditions_) {
+    conjunctive_partition(c, cond_conjuncts, true);
+  }
+  vector<bool> used(cond_conjuncts.size(), false);
+  bool changed = !frozen.empty();
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < cond_conjuncts.size(); ++i) {
+      if (used[i]) {
+        continue;
+      }
+      UnorderedTermSet vars;
+      get_free_symbolic_consts(cond_conjuncts[i], vars);
+      bool related = false;
+      for (const auto & v : vars) {
+        related |= frozen.find(v) != frozen.end();
+      }
+      if (related) {
+        used[i] = changed = true;
+        frozen.insert(vars.begin(), vars.end());
+        init_conjuncts.push_back(cond_conjuncts[i]);
+      }
+    }
+  }
+
+  for (const auto & sv : orig_ts_.statevars()) {
+    folded_ts_.add_statevar(sv, orig_ts_.next(sv));
+  }
+  for (const auto & iv : orig_ts_.inputvars()) {
+    folded_ts_.add_inputvar(iv);
+  }
+  for (const auto & f : frozen) {
+    folded_ts_.add_statevar(
+        f, solver->make_symbol(f->to_string() + ".next", f->get_sort()));
+    folded_ts_.assign_next(f, f);
+  }
+  for (const auto & elem : state_updates) {
+    folded_ts_.assign_next(elem.first, elem.second);
+  }
+
+  Term init = solver->make_term(true);
+  for (const auto & c : init_conjuncts) {
+    init = solver->make_term(And, init, c);
+  }
+  folded_ts_.set_init(init);
+  for (const auto & e : orig_ts_.constraints()) {
+    folded_ts_.add_constraint(e.first, e.second);
+  }
+  folded_ts_.constrain_inputs(solver->make_term(Not, active_reset));
+
+  for (const auto & elem : orig_ts_.named_terms()) {
+    if (orig_ts_.no_next(elem.second)) {
+      folded_ts_.name_term(elem.first, elem.second);
+    }
+  }
+
+  logger.log(1,
+             "Reset folding: {} of {} state variables are constant after "
+             "reset, {} frozen variables",
+             constants.size(),
+             orig_ts_.statevars().size(),
+             frozen.size());
+}
+
+vector<UnorderedTermMap> ResetFolder::expand_witness(
+    const vector<UnorderedTermMap> & cex) const
+{
+  if (cex.empty()) {
+    return cex;
+  }
+
+  // find a reset sequence leading to the first state
+  const SmtSolver & solver = orig_ts_.solver();
+  solver->push();
+  for (const auto & c : conditions_) {
+    solver->assert_formula(c);
+  }
+  for (const auto & elem : cex[0]) {
+    const Term & v = elem.first;
+    auto it = post_.find(v);
+    if (it != post_.end()) {
+      solver->assert_formula(solver->make_term(Equal, it->second, elem.second));
+    } else if (folded_ts_.is_curr_var(v) && !orig_ts_.is_curr_var(v)) {
+      // frozen symbol of the reset sequence
+      solver->assert_formula(solver->make_term(Equal, v, elem.second));
+    }
+  }
+
+  Result r = solver->check_sat();
+  if (!r.is_sat()) {
+    solver->pop();
+    throw PonoException(
+        "Reset folding: could not reconstruct the reset sequence of the "
+        "witness");
+  }
+  vector<UnorderedTermMap> res;
+  for (const auto & step : steps_) {
+    res.push_back(UnorderedTermMap());
+    for (const auto & elem : step) {
+      res.back()[elem.first] = solver->get_value(elem.second);
+    }
+  }
+  solver->pop();
+
+  evaluate_named_terms(orig_ts_, res);
+  res.insert(res.end(), cex.begin(), cex.end());
+  return res;
+}
+
+}  // namespace pono
@@ -0,0 +1,74 @@
+/*********************                                                  */
+/*! \file reset_folder.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Folds the reset sequence into the initial states.
+**
+**        Instead of adding a reset counter (see add_reset_seq), the
+**        first reset_bnd steps with an active reset are simulated
+**        symbolically and the resulting states become the initial
+**        states. State variables with the same value after every reset
+**        sequence are initialized to that value. The others are related
+**        to the reset sequence through frozen state variables (with an
+**        identity next-state function) that only occur in init.
+**
+**/
+
+#pragma once
+
+#include <vector>
+
+#include "core/ts.h"
+
+namespace pono {
+
+class ResetFolder
+{
+ public:
+  /** Builds the folded system
+   *  throws a PonoException if the system is not functional, the reset
+   *  is not over inputs, or there is no state after the reset sequence
+   *  @param ts the system
+   *  @param reset_symbol the reset signal, a boolean or one-bit term over
+   *         inputs that is active when it evaluates to true/bv1
+   *  @param reset_bnd how many steps the reset is active
+   */
+  ResetFolder(const TransitionSystem & ts,
+              const smt::Term & reset_symbol,
+              size_t reset_bnd);
+
+  /** @return the system whose initial states are the states after the
+   *  reset sequence, the reset is inactive in every step
+   */
+  const TransitionSystem & folded_ts() const { return folded_ts_; }
+
+  /** Prepends a reset sequence leading to the first state of a witness
+   *  of the folded system. Uses push/pop on the solver.
+   *  Throws a PonoException if there is no such reset sequence
+   *  @param cex the witness of the folded system
+   *  @return the witness of the original system, reset_bnd steps longer
+   */
+  std::vector<smt::UnorderedTermMap> expand_witness(
+      const std::vector<smt::UnorderedTermMap> & cex) const;
+
+ protected:
+  TransitionSystem orig_ts_;
+  TransitionSystem folded_ts_;
+  size_t reset_bnd_;
+
+  ///< the variables of each reset step over the symbols of the sequence
+  std::vector<smt::UnorderedTermMap> steps_;
+  ///< the state after the reset sequence
+  smt::UnorderedTermMap post_;
+  ///< init, reset and constraints of the reset sequence
+  smt::TermVec conditions_;
+};
+
+}  // namespace pono
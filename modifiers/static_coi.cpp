@@ -40,6 +40,8 @@ StaticConeOfInfluence::StaticConeOfInfluence(TransitionSystem & ts,
   orig_num_inputvars_ = ts_.inputvars().size();
   coi_.compute_coi(to_keep);
 
+  reduce_init(to_keep);
+
   const UnorderedTermSet & statevars_in_coi = coi_.statevars_in_coi();
   const UnorderedTermSet & inputvars_in_coi = coi_.inputvars_in_coi();
   assert(statevars_in_coi.size() <= ts_.statevars().size());
@@ -47,11 +49,7 @@ StaticConeOfInfluence::StaticConeOfInfluence(TransitionSystem & ts,
 
   ts_.rebuild_trans_based_on_coi(statevars_in_coi, inputvars_in_coi);
 
-  // NOTE: Cannot expect ts_.statevars().size() == statevars_in_coi.size()
-  //       because, we cannot remove state variables from system that
-  //       occur in init. This is because COI ignores init, and removing
-  //       them would make the TS ill-formed. This should not affect
-  //       performance though, since they were removed from trans
+  assert(statevars_in_coi.size() == ts_.statevars().size());
   assert(inputvars_in_coi.size() == ts_.inputvars().size());
 
   logger.log(
@@ -64,9 +62,109 @@ StaticConeOfInfluence::StaticConeOfInfluence(TransitionSystem & ts,
       "COI analysis completed: {} remaining state variables, {} original",
       statevars_in_coi.size(),
       orig_num_statevars_);
-  logger.log(1,
-             "COI analysis note: state variables occurring in init will "
-             "not be removed from system");
+  logger.log(
+      1,
+      "COI analysis completed: {} remaining init conjuncts, {} original",
+      num_init_conjuncts_,
+      orig_num_init_conjuncts_);
+}
+
+void StaticConeOfInfluence::reduce_init(const TermVec & to_keep)
+{
+  TermVec conjuncts;
+  conjunctive_partition(ts_.init(), conjuncts, true);
+  orig_num_init_conjuncts_ = conjuncts.size();
+
+  // number of conjuncts each variable occurs in
+  vector<UnorderedTermSet> conjunct_vars(conjuncts.size());
+  unordered_map<Term, size_t> occurrences;
+  for (size_t i = 0; i < conjuncts.size(); ++i) {
+    get_free_symbolic_consts(conjuncts[i], conjunct_vars[i]);
+    for (const auto & v : conjunct_vars[i]) {
+      ++occurrences[v];
+    }
+  }
+
+  TermVec keep = to_keep;
+  TermVec reduced_init;
+  while (true) {
+    const UnorderedTermSet & statevars_in_coi = coi_.statevars_in_coi();
+    reduced_init.clear();
+    // variables outside of the cone that init relates to the cone
+    UnorderedTermSet pulled;
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+      const Term & c = conjuncts[i];
+      Term removed_var;
+      size_t num_removed = 0;
+      for (const auto & v : conjunct_vars[i]) {
+        if (statevars_in_coi.find(v) == statevars_in_coi.end()) {
+          removed_var = v;
+          ++num_removed;
+        }
+      }
+
+      if (!num_removed) {
+        reduced_init.push_back(c);
+      } else if (num_removed == conjunct_vars[i].size()) {
+        // not connected to the cone (yet), dropped unless a later
+        // iteration pulls one of its variables into the cone
+        continue;
+      } else if (num_removed > 1 || occurrences.at(removed_var) > 1
+                 || !projectable(c, removed_var)) {
+        for (const auto & v : conjunct_vars[i]) {
+          if (statevars_in_coi.find(v) == statevars_in_coi.end()) {
+            pulled.insert(v);
+          }
+        }
+      }
+      // otherwise exists removed_var. c is valid, drop it
+    }
+
+    if (pulled.empty()) {
+      break;
+    }
+
+    logger.log(2,
+               "COI: adding {} state variables constrained with the cone "
+               "in init",
+               pulled.size());
+    keep.insert(keep.end(), pulled.begin(), pulled.end());
+    coi_.compute_coi(keep);
+  }
+
+  Term init = ts_.make_term(true);
+  for (const auto & c : reduced_init) {
+    init = ts_.make_term(And, init, c);
+  }
+  ts_.set_init(init);
+  num_init_conjuncts_ = reduced_init.size();
+}
+
+bool StaticConeOfInfluence::projectable(const Term & c, const Term & var) const
+{
+  if (c == var) {
+    return true;
+  }
+
+  Op op = c->get_op();
+  if (op == Not) {
+    return *c->begin() == var;
+  } else if (op != Equal) {
+    return false;
+  }
+
+  // var = t where t does not contain var
+  TermVec children(c->begin(), c->end());
+  assert(children.size() == 2);
+  UnorderedTermSet free_vars;
+  if (children[0] == var) {
+    get_free_symbolic_consts(children[1], free_vars);
+  } else if (children[1] == var) {
+    get_free_symbolic_consts(children[0], free_vars);
+  } else {
+    return false;
+  }
+  return free_vars.find(var) == free_vars.end();
 }
 
 }  // namespace pono
@@ -34,6 +34,25 @@ class StaticConeOfInfluence
                         int verbosity = 1);
 
  protected:
+  /** Removes the init conjuncts over state variables outside of the
+   *  cone-of-influence. A conjunct that mentions both cone and
+   *  out-of-cone variables is dropped if it is an equality (or boolean
+   *  literal) over a single variable outside of the cone that occurs in
+   *  no other conjunct, i.e. projecting the variable out does not change
+   *  the reachable states of the cone. Otherwise its variables are
+   *  pulled into the cone, until a fixpoint is reached. Conjuncts that
+   *  are not transitively connected to the cone are dropped.
+   *  Afterwards, init only mentions variables of the cone, as required
+   *  by TransitionSystem::rebuild_trans_based_on_coi.
+   *  Sets the reduced init in ts_ and updates coi_.
+   *  @param to_keep the terms the cone-of-influence was computed for
+   */
+  void reduce_init(const smt::TermVec & to_keep);
+
+  /** @return true iff exists var. c is valid, assuming var occurs in
+   *  no other conjunct of init
+   */
+  bool projectable(const smt::Term & c, const smt::Term & var) const;
 
   TransitionSystem & ts_;
   int verbosity_;
@@ -43,5 +62,7 @@ class StaticConeOfInfluence
 
   unsigned int orig_num_statevars_;
   unsigned int orig_num_inputvars_;
+  unsigned int orig_num_init_conjuncts_;
+  unsigned int num_init_conjuncts_;
 };
 }  // namespace pono
@@ -41,21 +41,30 @@ enum optionIndex
   STATICCOI,
   SHOW_INVAR,
   CHECK_INVAR,
+  CHECK_WITNESS,
+  SNAPSHOT_DIR,
   RESET,
   RESET_BND,
   CLK,
+  PHASE_ABSTRACTION,
+  RESET_FOLDING,
+  PASSES,
   SMT_SOLVER,
   LOGGING_SMT_SOLVER,
+  SAT_BACKEND,
   NO_IC3_PREGEN,
   NO_IC3_INDGEN,
   IC3_GEN_MAX_ITER,
   IC3_FUNCTIONAL_PREIMAGE,
   NO_IC3_UNSATCORE_GEN,
+  NO_IC3_INIT_CACHE,
   NO_IC3IA_REDUCE_PREDS,
   NO_IC3IA_TRACK_IMPORTANT_VARS,
   NO_IC3SA_FUNC_REFINE,
   MBIC3_INDGEN_MODE,
   PROFILING_LOG_FILENAME,
+  SOLVER_PROFILE_FILENAME,
+  STATS_JSON_FILENAME,
   PSEUDO_INIT_PROP,
   ASSUME_PROP,
   CEGPROPHARR,
@@ -68,6 +77,8 @@ enum optionIndex
   CEGP_STRONG_ABSTRACTION,
   CEG_BV_ARITH,
   CEG_BV_ARITH_MIN_BW,
+  CEG_LOC,
+  CEG_LOC_PBA,
   PROMOTE_INPUTVARS,
   SYGUS_OP_LVL,
   SYGUS_TERM_MODE,
@@ -84,6 +95,8 @@ enum optionIndex
   BMC_MIN_CEX_LESS_INC_BIN_SEARCH,
   BMC_NEG_BAD_STEP_ALL,
   BMC_ALLOW_NON_MINIMAL_CEX,
+  BMC_ADAPTIVE_STEP,
+  BMC_ADAPTIVE_TARGET_TIME,
   KIND_NO_SIMPLE_PATH_CHECK,
   KIND_EAGER_SIMPLE_PATH_CHECK,
   KIND_NO_MULTI_CALL_SIMPLE_PATH_CHECK,
@@ -92,6 +105,13 @@ enum optionIndex
   KIND_NO_IND_CHECK_PROPERTY,
   KIND_ONE_TIME_BASE_CHECK,
   KIND_BOUND_STEP,
+  SIM_BMC_WINDOW,
+  SIM_BMC_SIM_STEPS,
+  SIM_CYCLES,
+  MINE_INVARIANTS,
+  SWEEP_REGISTERS,
+  JUSTICE,
+  KLIVE_ENGINE,
   MUS_ATOMIC_INIT,
   MUS_INCLUDE_YOSYS_INTERNAL_NETNAMES,
   MUS_COMBINE_SUFFIX,
@@ -159,7 +179,8 @@ const option::Descriptor usage[] = {
     "engine",
     Arg::NonEmpty,
     "  --engine, -e <engine> \tSelect engine from [bmc, bmc-sp, ind, "
-    "interp, mbic3, ic3bits, ic3ia, msat-ic3ia, ic3sa, sygus-pdr]." },
+    "interp, mbic3, ic3bits, ic3ia, msat-ic3ia, ic3sa, sygus-pdr, pdkind, "
+    "sim-bmc, klive, sat-bmc]." },
   { BOUND,
     0,
     "k",
@@ -205,6 +226,14 @@ const option::Descriptor usage[] = {
     "guarantees the exact term structure that was created. Good "
     "for avoiding term rewriting at the API level or sort aliasing. "
     "(default: false)" },
+  { SAT_BACKEND,
+    0,
+    "",
+    "sat-backend",
+    Arg::None,
+    "  --sat-backend \tRun bmc, ic3bool and ic3bits on the native SAT "
+    "solver over the bit-blasted system instead of the SMT solver. "
+    "(default: false)" },
   { WITNESS,
     0,
     "",
@@ -232,6 +261,22 @@ const option::Descriptor usage[] = {
     Arg::None,
     "  --check-invar \tFor engines that produce invariants, check that they "
     "hold." },
+  { CHECK_WITNESS,
+    0,
+    "",
+    "check-witness",
+    Arg::None,
+    "  --check-witness \tReplay counterexamples on the transition system "
+    "without a solver and check that they violate the property." },
+  { SNAPSHOT_DIR,
+    0,
+    "",
+    "snapshot-dir",
+    Arg::NonEmpty,
+    "  --snapshot-dir \tDirectory for binary snapshots of the preprocessed "
+    "transition system. A snapshot is written after preprocessing and "
+    "loaded instead of parsing and preprocessing on later runs with the "
+    "same file and preprocessing options." },
   { RESET,
     0,
     "r",
@@ -255,6 +300,34 @@ const option::Descriptor usage[] = {
     "  --clock, -c <clock name> \tSymbol to use for clock signal (only "
     "supports "
     "starting at 0 and toggling each step)" },
+  { PHASE_ABSTRACTION,
+    0,
+    "",
+    "phase-abstraction",
+    Arg::None,
+    "  --phase-abstraction \tFold the low and high phase of the clock "
+    "(--clock) into one transition per cycle, only for functional systems "
+    "where the clock is an input or a state variable without next-state "
+    "function" },
+  { RESET_FOLDING,
+    0,
+    "",
+    "reset-folding",
+    Arg::None,
+    "  --reset-folding \tUse the states after the reset sequence (--reset, "
+    "--resetsteps) as initial states instead of adding a reset counter, "
+    "only for functional systems where the reset is an input" },
+  { PASSES,
+    0,
+    "",
+    "passes",
+    Arg::NonEmpty,
+    "  --passes <list> \tComma-separated preprocessing pipeline that "
+    "replaces the passes enabled by the individual options: clock, reset, "
+    "reset-fold, phase-abs, sweep, coi, pseudo-init, promote-inputs, "
+    "prop-monitor, assume-prop (parameters still come from the options, "
+    "a listed pass that cannot be applied is an error, prop-monitor is "
+    "added if missing)" },
   { NO_IC3_PREGEN,
     0,
     "",
@@ -291,6 +364,14 @@ const option::Descriptor usage[] = {
     " variants but also runs the risk of myopic over-generalization. Some IC3"
     " variants have better inductive generalization and do better with this"
     " option." },
+  { NO_IC3_INIT_CACHE,
+    0,
+    "",
+    "no-ic3-init-cache",
+    Arg::None,
+    "  --no-ic3-init-cache \tDisable the cache that answers checks for"
+    " intersection with the initial states by subsumption with previously"
+    " checked cubes." },
   { NO_IC3IA_REDUCE_PREDS,
     0,
     "",
@@ -327,6 +408,20 @@ const option::Descriptor usage[] = {
     Arg::NonEmpty,
     "  --profiling-log \tName of logfile for profiling output"
     " (requires build with linked profiling library 'gperftools')." },
+  { SOLVER_PROFILE_FILENAME,
+    0,
+    "",
+    "solver-profile",
+    Arg::NonEmpty,
+    "  --solver-profile \tWrite the number and latency of solver calls per "
+    "engine phase as JSON to the given file at exit." },
+  { STATS_JSON_FILENAME,
+    0,
+    "",
+    "stats-json",
+    Arg::NonEmpty,
+    "  --stats-json \tWrite the statistics of the engine, e.g. frames, "
+    "lemmas and refinements, as JSON to the given file." },
   { PSEUDO_INIT_PROP,
     0,
     "",
@@ -413,6 +508,22 @@ const option::Descriptor usage[] = {
     Arg::Numeric,
     "  --ceg-bv-arith-min-bw \tminimum bitwidth of operators to abstract - "
     "must be positive (default: 16) " },
+  { CEG_LOC,
+    0,
+    "",
+    "ceg-loc",
+    Arg::None,
+    "  --ceg-loc \tlocalization abstraction-refinement: state variables "
+    "outside the abstraction are inputs (only for functional systems, "
+    "with bmc, ind, mbic3, ic3bits, ic3ia, ic3sa)" },
+  { CEG_LOC_PBA,
+    0,
+    "",
+    "ceg-loc-pba",
+    Arg::None,
+    "  --ceg-loc-pba \trefine the localization abstraction with the unsat "
+    "core of the BMC query instead of the spurious trace (proof-based "
+    "abstraction)" },
   { PROMOTE_INPUTVARS,
     0,
     "",
@@ -540,6 +651,24 @@ const option::Descriptor usage[] = {
     "  --bmc-allow-non-minimal-cex \tDo not search for minimal cex within an interval;"
     "instead, terminate immediately (reported bound of cex is an upper bound of actual cex)"
     },
+  { BMC_ADAPTIVE_STEP,
+    0,
+    "",
+    "bmc-adaptive-step",
+    Arg::None,
+    "  --bmc-adaptive-step \tAdapt the BMC bound step to the time spent in each "
+    "BMC step: the step is doubled if a step was fast and halved if it was slow "
+    "compared to '--bmc-adaptive-target-time'. Starts with '--bmc-bound-step' "
+    "(default: false)."
+    },
+  { BMC_ADAPTIVE_TARGET_TIME,
+    0,
+    "",
+    "bmc-adaptive-target-time",
+    Arg::Numeric,
+    "  --bmc-adaptive-target-time \tTargeted time in seconds per BMC step "
+    "when using '--bmc-adaptive-step' (default: 10)."
+    },
   { KIND_NO_SIMPLE_PATH_CHECK,
     0,
     "",
@@ -605,6 +734,69 @@ const option::Descriptor usage[] = {
     "  --kind-bound-step \tAmount by which bound (unrolling depth) "
     "is increased in k-induction (default: 1)"
     },
+  { SIM_BMC_WINDOW,
+    0,
+    "",
+    "sim-bmc-window",
+    Arg::Numeric,
+    "  --sim-bmc-window \tLength of the BMC windows started from simulated "
+    "states in engine sim-bmc (default: 10)"
+    },
+  { SIM_BMC_SIM_STEPS,
+    0,
+    "",
+    "sim-bmc-sim-steps",
+    Arg::Numeric,
+    "  --sim-bmc-sim-steps \tNumber of random simulation steps between BMC "
+    "windows in engine sim-bmc (default: 100)"
+    },
+  { SIM_CYCLES,
+    0,
+    "",
+    "sim-cycles",
+    Arg::Numeric,
+    "  --sim-cycles \tNumber of cycles of bit-parallel random simulation "
+    "run before the engine to falsify the property, only for functional "
+    "systems (default: 0, disabled)"
+    },
+  { MINE_INVARIANTS,
+    0,
+    "",
+    "mine-invariants",
+    Arg::Numeric,
+    "  --mine-invariants \tNumber of cycles of random simulation used to "
+    "mine candidate invariants, which are validated and used to strengthen "
+    "kind and the IC3 engines, only for functional systems "
+    "(default: 0, disabled)"
+    },
+  { SWEEP_REGISTERS,
+    0,
+    "",
+    "sweep-registers",
+    Arg::Numeric,
+    "  --sweep-registers \tNumber of cycles of random simulation used to "
+    "find constant and equivalent state variables, which are proven and "
+    "removed from the system, only for functional systems "
+    "(default: 0, disabled)"
+    },
+  { JUSTICE,
+    0,
+    "",
+    "justice",
+    Arg::None,
+    "  --justice \tCheck the justice property with index --prop (with the "
+    "fairness constraints) of a BTOR2 or AIGER file. Engine klive proves it "
+    "with k-liveness, the other engines check it after a liveness-to-safety "
+    "translation."
+    },
+  { KLIVE_ENGINE,
+    0,
+    "",
+    "klive-engine",
+    Arg::NonEmpty,
+    "  --klive-engine <engine> \tIC3 variant used by engine klive to check "
+    "the bounded counter (default: ic3bits)"
+    },
   { MUS_ATOMIC_INIT,
   0,
   "",
@@ -665,6 +857,9 @@ const std::unordered_set<Engine> ic3_variants_set({ IC3_BOOL,
 const std::unordered_set<Engine> & ic3_variants() { return ic3_variants_set; }
 
 const std::string PonoOptions::default_profiling_log_filename_ = "";
+const std::string PonoOptions::default_solver_profile_filename_ = "";
+const std::string PonoOptions::default_stats_json_filename_ = "";
+const std::string PonoOptions::default_passes_ = "";
 const std::string PonoOptions::default_mus_combine_suffix_ = "";
 
 Engine PonoOptions::to_engine(std::string s)
@@ -749,13 +944,19 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           break;
         }
         case LOGGING_SMT_SOLVER: logging_smt_solver_ = true; break;
+        case SAT_BACKEND: sat_backend_ = true; break;
         case WITNESS: witness_ = true; break;
         case STATICCOI: static_coi_ = true; break;
         case SHOW_INVAR: show_invar_ = true; break;
         case CHECK_INVAR: check_invar_ = true; break;
+        case CHECK_WITNESS: check_witness_ = true; break;
+        case SNAPSHOT_DIR: snapshot_dir_ = opt.arg; break;
         case RESET: reset_name_ = opt.arg; break;
         case RESET_BND: reset_bnd_ = atoi(opt.arg); break;
         case CLK: clock_name_ = opt.arg; break;
+        case PHASE_ABSTRACTION: phase_abstraction_ = true; break;
+        case RESET_FOLDING: reset_folding_ = true; break;
+        case PASSES: passes_ = opt.arg; break;
         case NO_IC3_PREGEN: ic3_pregen_ = false; break;
         case NO_IC3_INDGEN: ic3_indgen_ = false; break;
         case IC3_GEN_MAX_ITER: ic3_gen_max_iter_ = atoi(opt.arg); break;
@@ -767,6 +968,7 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           break;
         case IC3_FUNCTIONAL_PREIMAGE: ic3_functional_preimage_ = true; break;
         case NO_IC3_UNSATCORE_GEN: ic3_unsatcore_gen_ = false; break;
+        case NO_IC3_INIT_CACHE: ic3_init_cache_ = false; break;
         case NO_IC3IA_REDUCE_PREDS: ic3ia_reduce_preds_ = false;
         case NO_IC3IA_TRACK_IMPORTANT_VARS: ic3ia_track_important_vars_ = false;
         case NO_IC3SA_FUNC_REFINE: ic3sa_func_refine_ = false; break;
@@ -779,6 +981,8 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           profiling_log_filename_ = opt.arg;
 #endif
           break;
+        case SOLVER_PROFILE_FILENAME: solver_profile_filename_ = opt.arg; break;
+        case STATS_JSON_FILENAME: stats_json_filename_ = opt.arg; break;
         case PSEUDO_INIT_PROP: pseudo_init_prop_ = true; break;
         case ASSUME_PROP: assume_prop_ = true; break;
         case CEGPROPHARR: ceg_prophecy_arrays_ = true; break;
@@ -793,6 +997,8 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
         case CEGP_STRONG_ABSTRACTION: cegp_strong_abstraction_ = true; break;
         case CEG_BV_ARITH: ceg_bv_arith_ = true; break;
         case CEG_BV_ARITH_MIN_BW: ceg_bv_arith_min_bw_ = atoi(opt.arg); break;
+        case CEG_LOC: ceg_loc_ = true; break;
+        case CEG_LOC_PBA: ceg_loc_pba_ = true; break;
         case PROMOTE_INPUTVARS: promote_inputvars_ = true; break;
         case SYGUS_OP_LVL: sygus_use_operator_abstraction_ = atoi(opt.arg); break;
         case SYGUS_TERM_MODE: sygus_term_mode_ = SyGuSTermMode(atoi(opt.arg)); break;
@@ -829,6 +1035,11 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
 	  bmc_min_cex_less_inc_bin_search_ = true; break;
         case BMC_ALLOW_NON_MINIMAL_CEX:
 	  bmc_allow_non_minimal_cex_ = true; break;
+        case BMC_ADAPTIVE_STEP: bmc_adaptive_step_ = true; break;
+        case BMC_ADAPTIVE_TARGET_TIME: bmc_adaptive_target_time_ = atoi(opt.arg);
+	  if (bmc_adaptive_target_time_ == 0)
+	    throw PonoException("--bmc-adaptive-target-time must be greater than 0");
+	  break;
         case KIND_NO_SIMPLE_PATH_CHECK: kind_no_simple_path_check_ = true; break;
         case KIND_EAGER_SIMPLE_PATH_CHECK: kind_eager_simple_path_check_ = true; break;
         case KIND_NO_MULTI_CALL_SIMPLE_PATH_CHECK: kind_no_multi_call_simple_path_check_ = true; break;
@@ -841,6 +1052,21 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
 	  if (kind_bound_step_ == 0)
 	    throw PonoException("--kind-bound-step must be greater than 0");
 	  break;
+        case SIM_BMC_WINDOW: sim_bmc_window_ = atoi(opt.arg); break;
+        case SIM_BMC_SIM_STEPS: sim_bmc_sim_steps_ = atoi(opt.arg);
+	  if (sim_bmc_sim_steps_ == 0)
+	    throw PonoException("--sim-bmc-sim-steps must be greater than 0");
+	  break;
+        case SIM_CYCLES: sim_cycles_ = atoi(opt.arg); break;
+        case MINE_INVARIANTS: mine_invariants_ = atoi(opt.arg); break;
+        case SWEEP_REGISTERS: sweep_registers_ = atoi(opt.arg); break;
+        case JUSTICE: justice_ = true; break;
+        case KLIVE_ENGINE:
+          klive_engine_ = to_engine(opt.arg);
+          if (ic3_variants().find(klive_engine_) == ic3_variants().end()) {
+            throw PonoException("--klive-engine must be an IC3 variant");
+          }
+          break;
         case MUS_ATOMIC_INIT: mus_atomic_init_ = true; break;
         case MUS_INCLUDE_YOSYS_INTERNAL_NETNAMES: mus_include_yosys_internal_netnames_ = true; break;
         case MUS_COMBINE_SUFFIX: mus_combine_suffix_ = opt.arg;
@@ -858,6 +1084,51 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           "Interpolation engine can be only used with '--smt-solver msat'.");
     }
 
+    if (smt_solver_ != smt::MSAT && engine_ == Engine::PDKIND) {
+      throw PonoException(
+          "PD-KIND engine can be only used with '--smt-solver msat'.");
+    }
+
+    if (ceg_loc_
+        && (ceg_prophecy_arrays_ || cegp_abs_vals_ || ceg_bv_arith_)) {
+      throw PonoException(
+          "--ceg-loc cannot be combined with the other CEGAR options");
+    }
+
+    if (ceg_loc_pba_ && !ceg_loc_) {
+      throw PonoException("--ceg-loc-pba requires --ceg-loc");
+    }
+
+    if (phase_abstraction_ && clock_name_.empty()) {
+      throw PonoException("--phase-abstraction requires a clock (--clock)");
+    }
+
+    if (reset_folding_ && reset_name_.empty()) {
+      throw PonoException("--reset-folding requires a reset (--reset)");
+    }
+
+    if (reset_folding_ && phase_abstraction_) {
+      throw PonoException(
+          "--reset-folding cannot be combined with --phase-abstraction");
+    }
+
+    if (engine_ == Engine::KLIVE && !justice_) {
+      throw PonoException(
+          "Engine klive can only be used for justice properties "
+          "(--justice).");
+    }
+
+    if (justice_ && (pseudo_init_prop_ || assume_prop_)) {
+      throw PonoException(
+          "--justice cannot be combined with --pseudo-init-prop or "
+          "--assume-prop");
+    }
+
+    if (bmc_adaptive_step_ && bmc_exponential_step_) {
+      throw PonoException(
+          "--bmc-adaptive-step cannot be combined with --bmc-exponential-step");
+    }
+
     if (ceg_prophecy_arrays_ && smt_solver_ != smt::MSAT) {
       throw PonoException(
           "Counterexample-guided prophecy only supported with MathSAT so far");
@@ -937,6 +1208,22 @@ string to_string(Engine e)
       res = "sygus-pdr";
       break;
     }
+    case PDKIND: {
+      res = "pdkind";
+      break;
+    }
+    case SIM_BMC: {
+      res = "sim-bmc";
+      break;
+    }
+    case KLIVE: {
+      res = "klive";
+      break;
+    }
+    case SAT_BMC: {
+      res = "sat-bmc";
+      break;
+    }
     default: {
       throw PonoException("Unhandled engine: " + std::to_string(e));
     }
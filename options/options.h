@@ -40,7 +40,11 @@ enum Engine
   MSAT_IC3IA,
   IC3SA_ENGINE,
   SYGUS_PDR,
-  MUS_ENGINE
+  MUS_ENGINE,
+  PDKIND,
+  SIM_BMC,
+  KLIVE,
+  SAT_BMC
   // NOTE: if adding an IC3 variant,
   // make sure to update ic3_variants_set in options/options.cpp
   // used for setting solver options appropriately
@@ -67,7 +71,11 @@ const std::unordered_map<std::string, Engine> str2engine(
       { "msat-ic3ia", MSAT_IC3IA },
       { "ic3sa", IC3SA_ENGINE },
       { "sygus-pdr", SYGUS_PDR },
-      { "mus", MUS_ENGINE}});
+      { "mus", MUS_ENGINE},
+      { "pdkind", PDKIND },
+      { "sim-bmc", SIM_BMC },
+      { "klive", KLIVE },
+      { "sat-bmc", SAT_BMC } });
 
 // SyGuS mode option
 enum SyGuSTermMode{
@@ -98,19 +106,24 @@ class PonoOptions
         random_seed_(default_random_seed),
         smt_solver_(default_smt_solver_),
         logging_smt_solver_(default_logging_smt_solver_),
+        sat_backend_(default_sat_backend_),
         static_coi_(default_static_coi_),
         show_invar_(default_show_invar_),
         check_invar_(default_check_invar_),
+        check_witness_(default_check_witness_),
         ic3_pregen_(default_ic3_pregen_),
         ic3_indgen_(default_ic3_indgen_),
         ic3_gen_max_iter_(default_ic3_gen_max_iter_),
         mbic3_indgen_mode(default_mbic3_indgen_mode),
         ic3_functional_preimage_(default_ic3_functional_preimage_),
         ic3_unsatcore_gen_(default_ic3_unsatcore_gen_),
+        ic3_init_cache_(default_ic3_init_cache_),
         ic3ia_reduce_preds_(default_ic3ia_reduce_preds_),
         ic3ia_track_important_vars_(default_ic3ia_track_important_vars_),
         ic3sa_func_refine_(default_ic3sa_func_refine_),
         profiling_log_filename_(default_profiling_log_filename_),
+        solver_profile_filename_(default_solver_profile_filename_),
+        stats_json_filename_(default_stats_json_filename_),
         pseudo_init_prop_(default_pseudo_init_prop_),
         assume_prop_(default_assume_prop_),
         ceg_prophecy_arrays_(default_ceg_prophecy_arrays_),
@@ -123,6 +136,8 @@ class PonoOptions
         cegp_strong_abstraction_(default_cegp_strong_abstraction_),
         ceg_bv_arith_(default_ceg_bv_arith_),
         ceg_bv_arith_min_bw_(default_ceg_bv_arith_min_bw_),
+        ceg_loc_(default_ceg_loc_),
+        ceg_loc_pba_(default_ceg_loc_pba_),
         promote_inputvars_(default_promote_inputvars_),
         sygus_term_mode_(default_sygus_term_mode_),
         sygus_term_extract_depth_(default_sygus_term_extract_depth_),
@@ -144,6 +159,8 @@ class PonoOptions
         bmc_min_cex_linear_search_(default_bmc_min_cex_linear_search_),
         bmc_min_cex_less_inc_bin_search_(default_bmc_min_cex_less_inc_bin_search_),
         bmc_allow_non_minimal_cex_(default_bmc_allow_non_minimal_cex_),
+        bmc_adaptive_step_(default_bmc_adaptive_step_),
+        bmc_adaptive_target_time_(default_bmc_adaptive_target_time_),
         kind_no_simple_path_check_(default_kind_no_simple_path_check_),
         kind_eager_simple_path_check_(default_kind_eager_simple_path_check_),
         kind_no_multi_call_simple_path_check_(default_kind_no_multi_call_simple_path_check_),
@@ -152,6 +169,16 @@ class PonoOptions
         kind_no_ind_check_property_(default_kind_no_ind_check_property_),
         kind_one_time_base_check_(default_kind_one_time_base_check_),
         kind_bound_step_(default_kind_bound_step_),
+        sim_bmc_window_(default_sim_bmc_window_),
+        sim_bmc_sim_steps_(default_sim_bmc_sim_steps_),
+        sim_cycles_(default_sim_cycles_),
+        mine_invariants_(default_mine_invariants_),
+        sweep_registers_(default_sweep_registers_),
+        phase_abstraction_(default_phase_abstraction_),
+        reset_folding_(default_reset_folding_),
+        passes_(default_passes_),
+        justice_(default_justice_),
+        klive_engine_(default_klive_engine_),
         mus_atomic_init_(default_mus_atomic_init_),
         mus_include_yosys_internal_netnames_(default_mus_include_yosys_internal_netnames_),
         mus_combine_suffix_(default_mus_combine_suffix_),
@@ -194,9 +221,12 @@ class PonoOptions
   std::string filename_;
   smt::SolverEnum smt_solver_;  ///< underlying smt solver
   bool logging_smt_solver_;
+  bool sat_backend_;  ///< use the native SAT solver on the bit-blasted system
   bool static_coi_;
   bool show_invar_;   ///< display invariant when running from command line
   bool check_invar_;  ///< check invariants (if available) when run through CLI
+  bool check_witness_;  ///< replay counterexamples when run through CLI
+  std::string snapshot_dir_;  ///< directory for snapshots of preprocessed systems
   // ic3 options
   bool ic3_pregen_;  ///< generalize counterexamples in IC3
   bool ic3_indgen_;  ///< inductive generalization in IC3
@@ -206,11 +236,14 @@ class PonoOptions
   bool ic3_functional_preimage_; ///< functional preimage in IC3
   bool ic3_unsatcore_gen_;  ///< generalize a cube during relative inductiveness
                             ///< check with unsatcore
+  bool ic3_init_cache_;  ///< answer init intersection checks by subsumption
   bool ic3ia_reduce_preds_;  ///< reduce predicates with unsatcore in IC3IA
   bool ic3ia_track_important_vars_;  ///< prioritize predicates with marked
                                      ///< important variables
   bool ic3sa_func_refine_;  ///< try functional unrolling in refinement
   std::string profiling_log_filename_;
+  std::string solver_profile_filename_;  ///< JSON file for solver call stats
+  std::string stats_json_filename_;      ///< JSON file for engine statistics
   bool pseudo_init_prop_;  ///< replace init and prop with boolean state vars
   bool assume_prop_;       ///< assume property in pre-state
   // ceg-prophecy-arrays options
@@ -228,6 +261,8 @@ class PonoOptions
   bool ceg_bv_arith_;            ///< CEGAR -- Abstract BV arithmetic operators
   size_t ceg_bv_arith_min_bw_;   ///< Only abstract operators having bitwidth
                                  ///< strictly greater than this number
+  bool ceg_loc_;      ///< CEGAR -- localization abstraction of state vars
+  bool ceg_loc_pba_;  ///< refine localization with proof-based abstraction
   bool promote_inputvars_;
   // sygus-pdr options
   SyGuSTermMode sygus_term_mode_; ///< SyGuS term production mode
@@ -277,6 +312,13 @@ class PonoOptions
   // i.e., skip binary or linear search for shortest cex in that
   // interval
   bool bmc_allow_non_minimal_cex_;
+  // BMC: adapt the bound step after each BMC step based on the time spent
+  // in that step; the step is doubled if the step was fast and halved if
+  // it was slow compared to 'bmc_adaptive_target_time_'
+  bool bmc_adaptive_step_;
+  // BMC: targeted time (in seconds) per BMC step when using
+  // 'bmc_adaptive_step_'
+  unsigned bmc_adaptive_target_time_;
   // K-induction: omit simple path check (might cause incompleteness)
   bool kind_no_simple_path_check_;
   // K-induction: eager simple path check (default: lazy check)
@@ -297,6 +339,35 @@ class PonoOptions
   bool kind_one_time_base_check_;
   // K-induction: amount of steps by which transition relation is unrolled
   unsigned kind_bound_step_;
+  // Simulation-guided BMC: length of the BMC windows
+  unsigned sim_bmc_window_;
+  // Simulation-guided BMC: number of random simulation steps between windows
+  unsigned sim_bmc_sim_steps_;
+  // Random simulation: number of cycles simulated to falsify the property
+  // before running the engine (0 disables simulation)
+  unsigned sim_cycles_;
+  // Invariant mining: number of cycles simulated to propose candidate
+  // invariants that are validated and fed to k-induction and IC3
+  // (0 disables mining)
+  unsigned mine_invariants_;
+  // Register sweeping: number of cycles simulated to propose constant and
+  // equivalent state variables that are removed after a proof
+  // (0 disables sweeping)
+  unsigned sweep_registers_;
+  // Phase abstraction: fold both phases of the clock (--clock) into
+  // one transition instead of toggling it every step
+  bool phase_abstraction_;
+  // Reset folding: use the states after the reset sequence as initial
+  // states instead of adding a reset counter
+  bool reset_folding_;
+  // Preprocessing: comma-separated pipeline of passes that replaces the
+  // one enabled by the individual options (empty: use the options)
+  std::string passes_;
+  // Liveness: check the justice property with index prop_idx_
+  // (with the fairness constraints) instead of a bad-state property
+  bool justice_;
+  // K-liveness: the IC3 variant checking the bounded counter
+  Engine klive_engine_;
   // MUS Engine: treat the conjunction of all init constraints as a single MUS constraint
   bool mus_atomic_init_;
   // MUS Engine: During synthesis, Yosys introduces internal ('$'-prefixed) identifiers
@@ -325,21 +396,27 @@ private:
   static const bool default_static_coi_ = false;
   static const bool default_show_invar_ = false;
   static const bool default_check_invar_ = false;
+  static const bool default_check_witness_ = false;
   static const size_t default_reset_bnd_ = 1;
   // TODO distinguish when solver is not set and choose a
   //      good solver for the provided engine automatically
   static const smt::SolverEnum default_smt_solver_ = smt::BTOR;
   static const bool default_logging_smt_solver_ = false;
+  static const bool default_sat_backend_ = false;
   static const bool default_ic3_pregen_ = true;
   static const bool default_ic3_indgen_ = true;
   static const unsigned int default_ic3_gen_max_iter_ = 2;
   static const unsigned int default_mbic3_indgen_mode = 0;
   static const bool default_ic3_functional_preimage_ = false;
   static const bool default_ic3_unsatcore_gen_ = true;
+  static const bool default_ic3_init_cache_ = true;
   static const bool default_ic3ia_reduce_preds_ = true;
   static const bool default_ic3ia_track_important_vars_ = true;
   static const bool default_ic3sa_func_refine_ = true;
   static const std::string default_profiling_log_filename_;
+  static const std::string default_solver_profile_filename_;
+  static const std::string default_stats_json_filename_;
+  static const std::string default_passes_;
   static const bool default_pseudo_init_prop_ = false;
   static const bool default_assume_prop_ = false;
   static const bool default_ceg_prophecy_arrays_ = false;
@@ -352,6 +429,8 @@ private:
   static const bool default_cegp_strong_abstraction_ = false;
   static const bool default_ceg_bv_arith_ = false;
   static const size_t default_ceg_bv_arith_min_bw_ = 16;
+  static const bool default_ceg_loc_ = false;
+  static const bool default_ceg_loc_pba_ = false;
   static const bool default_promote_inputvars_ = false;
   static const SyGuSTermMode default_sygus_term_mode_ = TERM_MODE_AUTO;
   static const unsigned default_sygus_term_extract_depth_ = 0;
@@ -373,6 +452,8 @@ private:
   static const bool default_bmc_min_cex_linear_search_ = false;
   static const bool default_bmc_min_cex_less_inc_bin_search_ = false;
   static const bool default_bmc_allow_non_minimal_cex_ = false;
+  static const bool default_bmc_adaptive_step_ = false;
+  static const unsigned default_bmc_adaptive_target_time_ = 10;
   static const bool default_kind_no_simple_path_check_ = false;
   static const bool default_kind_eager_simple_path_check_ = false;
   static const bool default_kind_no_multi_call_simple_path_check_ = false;
@@ -381,6 +462,15 @@ private:
   static const bool default_kind_no_ind_check_property_ = false;
   static const bool default_kind_one_time_base_check_ = false;
   static const unsigned default_kind_bound_step_ = 1;
+  static const unsigned default_sim_bmc_window_ = 10;
+  static const unsigned default_sim_bmc_sim_steps_ = 100;
+  static const unsigned default_sim_cycles_ = 0;
+  static const unsigned default_mine_invariants_ = 0;
+  static const unsigned default_sweep_registers_ = 0;
+  static const bool default_phase_abstraction_ = false;
+  static const bool default_reset_folding_ = false;
+  static const bool default_justice_ = false;
+  static const Engine default_klive_engine_ = IC3_BITS;
   static const bool default_mus_atomic_init_ = false;
   static const bool default_mus_include_yosys_internal_netnames_ = false;
   static const std::string default_mus_combine_suffix_;
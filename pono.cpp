@@ -14,8 +14,13 @@
 **
 **/
 
+#include <algorithm>
 #include <csignal>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include "assert.h"
 
 #ifdef WITH_PROFILING
@@ -28,103 +33,513 @@
 #endif
 
 #include "core/fts.h"
+#include "frontends/aiger_encoder.h"
 #include "frontends/btor2_encoder.h"
 #include "frontends/smv_encoder.h"
 #include "frontends/vmt_encoder.h"
 #include "modifiers/control_signals.h"
+#include "modifiers/liveness_to_safety.h"
 #include "modifiers/mod_ts_prop.h"
+#include "modifiers/phase_abstractor.h"
+#include "modifiers/reset_folder.h"
 #include "modifiers/prop_monitor.h"
+#include "modifiers/register_sweeping.h"
 #include "modifiers/static_coi.h"
 #include "options/options.h"
+#include "printers/aiger_witness_printer.h"
 #include "printers/btor2_witness_printer.h"
 #include "printers/vcd_witness_printer.h"
 #include "smt-switch/logging_solver.h"
 #include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
 #include "utils/logger.h"
 #include "utils/timestamp.h"
 #include "utils/make_provers.h"
+#include "utils/pass_manager.h"
+#include "utils/simulator.h"
+#include "utils/str_util.h"
 #include "utils/ts_analysis.h"
+#include "utils/ts_snapshot.h"
 
 using namespace pono;
 using namespace smt;
 using namespace std;
 
-ProverResult check_prop(PonoOptions pono_options,
-                        Term & prop,
-                        TransitionSystem & ts,
-                        const SmtSolver & s,
-                        std::vector<UnorderedTermMap> & cex)
+/** Try to falsify the property with bit-parallel random simulation
+ *  @return true iff a bad state was reached, then cex is populated
+ *          if witnesses are requested
+ */
+bool simulate_prop(const PonoOptions & pono_options,
+                   const TransitionSystem & ts,
+                   const Term & prop,
+                   std::vector<UnorderedTermMap> & cex)
 {
-  // get property name before it is rewritten
-  const string prop_name = ts.get_name(prop);
-
-  logger.log(1, "Solving property: {}", prop_name);
-  logger.log(3, "INIT:\n{}", ts.init());
-  logger.log(3, "TRANS:\n{}", ts.trans());
+  if (!ts.is_functional()) {
+    logger.log(1, "Skipping simulation of relational transition system");
+    return false;
+  }
 
-  // modify the transition system and property based on options
-  if (!pono_options.clock_name_.empty()) {
-    Term clock_symbol = ts.lookup(pono_options.clock_name_);
-    toggle_clock(ts, clock_symbol);
-  }
-  if (!pono_options.reset_name_.empty()) {
-    std::string reset_name = pono_options.reset_name_;
-    bool negative_reset = false;
-    if (reset_name.at(0) == '~') {
-      reset_name = reset_name.substr(1, reset_name.length() - 1);
-      negative_reset = true;
-    }
-    Term reset_symbol = ts.lookup(reset_name);
-    if (negative_reset) {
-      SortKind sk = reset_symbol->get_sort()->get_sort_kind();
-      reset_symbol = (sk == BV) ? s->make_term(BVNot, reset_symbol)
-                                : s->make_term(Not, reset_symbol);
+  std::unique_ptr<Simulator> sim;
+  try {
+    sim.reset(new Simulator(ts, pono_options.random_seed_));
+    sim->set_bad(ts.solver()->make_term(Not, prop));
+  }
+  catch (PonoException & e) {
+    logger.log(1, "Skipping simulation: {}", e.what());
+    return false;
+  }
+  sim->set_record(pono_options.witness_);
+
+  // restart whenever all lanes violate the constraints
+  size_t remaining = pono_options.sim_cycles_;
+  while (remaining) {
+    sim->reset();
+    if (sim->run(remaining)) {
+      logger.log(1, "Simulation reached a bad state at cycle {}", sim->cycle());
+      if (pono_options.witness_) {
+        size_t lane = 0;
+        while (!((sim->bad_lanes() >> lane) & 1)) {
+          ++lane;
+        }
+        sim->witness(lane, cex);
+      }
+      return true;
     }
-    Term reset_done = add_reset_seq(ts, reset_symbol, pono_options.reset_bnd_);
-    // guard the property with reset_done
-    prop = ts.solver()->make_term(Implies, reset_done, prop);
+    remaining -= min<size_t>(remaining, max<size_t>(sim->cycle(), 1));
+  }
+
+  logger.log(1,
+             "Simulation of {} cycles did not reach a bad state",
+             pono_options.sim_cycles_);
+  return false;
+}
+
+/** Location and key of the snapshot of the preprocessed transition system
+ *  the path is empty if snapshots are disabled
+ */
+struct SnapshotId
+{
+  SnapshotId() : key(0) {}
+
+  string path;
+  uint64_t key;  ///< identifies the file and the options that influence
+                 ///< parsing and preprocessing
+};
+
+/** Compute the snapshot location and key
+ *  hashes the whole source file, so it should only be called once
+ */
+SnapshotId snapshot_id(const PonoOptions & pono_options)
+{
+  SnapshotId id;
+  if (pono_options.snapshot_dir_.empty()) {
+    return id;
   }
 
+  ostringstream config;
+  config << "solver " << pono_options.smt_solver_ << " prop "
+         << pono_options.prop_idx_ << " clock " << pono_options.clock_name_
+         << " reset " << pono_options.reset_name_ << " "
+         << pono_options.reset_bnd_ << " passes " << pono_options.passes_
+         << " reset-folding "
+         << pono_options.reset_folding_ << " phase-abstraction "
+         << pono_options.phase_abstraction_ << " static-coi "
+         << pono_options.static_coi_ << " pseudo-init-prop "
+         << pono_options.pseudo_init_prop_ << " promote-inputvars "
+         << pono_options.promote_inputvars_ << " sweep-registers "
+         << pono_options.sweep_registers_ << " seed "
+         << pono_options.random_seed_ << " assume-prop "
+         << pono_options.assume_prop_ << " justice " << pono_options.justice_
+         << " " << (pono_options.engine_ == KLIVE);
+  id.key = TSSnapshot::make_key(pono_options.filename_, config.str());
+
+  const string & filename = pono_options.filename_;
+  string basename = filename.substr(filename.find_last_of("/") + 1);
+  ostringstream path;
+  path << pono_options.snapshot_dir_ << "/" << basename << "-" << hex
+       << id.key << ".snap";
+  id.path = path.str();
+  return id;
+}
 
-  if (pono_options.static_coi_) {
-    /* Compute the set of state/input variables related to the
-       bad-state property. Based on that information, rebuild the
-       transition relation of the transition system. */
-    StaticConeOfInfluence coi(ts, { prop }, pono_options.verbosity_);
+/** Property for the justice property with index prop_idx_
+ *  k-liveness proves that the combined justice signal is eventually
+ *  false forever, the other engines check the liveness-to-safety
+ *  translation, both modify the transition system
+ */
+Term justice_prop(const PonoOptions & pono_options,
+                  TransitionSystem & ts,
+                  const vector<TermVec> & justicevec,
+                  const TermVec & fairvec)
+{
+  unsigned int num_justice = justicevec.size();
+  if (pono_options.prop_idx_ >= num_justice) {
+    throw PonoException(
+        "Justice property index " + to_string(pono_options.prop_idx_)
+        + " is greater than the number of justice properties in file "
+        + pono_options.filename_ + " (" + to_string(num_justice) + ")");
   }
 
-  if (pono_options.pseudo_init_prop_) {
-    ts = pseudo_init_and_prop(ts, prop);
+  Term signal =
+      combine_justice(ts, justicevec[pono_options.prop_idx_], fairvec);
+  if (pono_options.engine_ == KLIVE) {
+    return ts.make_term(Not, signal);
   }
+  return liveness_to_safety(ts, signal);
+}
 
-  if (pono_options.promote_inputvars_) {
+/** Load the preprocessed transition system and property from a snapshot
+ *  @return true iff there is a snapshot for the file and options
+ */
+bool load_snapshot(const SnapshotId & snapshot,
+                   TransitionSystem & ts,
+                   Term & prop)
+{
+  if (snapshot.path.empty()) {
+    return false;
+  }
+  TermVec props;
+  if (!TSSnapshot::read(snapshot.path, snapshot.key, ts, props)) {
+    return false;
+  }
+  if (props.size() != 1) {
+    throw PonoException("Expecting one property in snapshot "
+                        + snapshot.path);
+  }
+  prop = props[0];
+  return true;
+}
+
+/** Replay a counterexample natively and report the result
+ *  throws a PonoException if the counterexample is incorrect
+ */
+void check_cex(const TransitionSystem & ts,
+               const Term & prop,
+               const std::vector<UnorderedTermMap> & cex)
+{
+  bool cex_passes;
+  try {
+    cex_passes = check_witness(ts, prop, cex);
+  }
+  catch (PonoException & e) {
+    logger.log(1, "{}", e.what());
+    std::cout << "Witness Check SKIPPED" << std::endl;
+    return;
+  }
+  std::cout << "Witness Check " << (cex_passes ? "PASSED" : "FAILED")
+            << std::endl;
+  if (!cex_passes) {
+    // shouldn't return false if the counterexample is incorrect
+    throw PonoException("Witness Check FAILED");
+  }
+}
+
+/** @return the reset symbol of the options over ts, negated for a
+ *  reset name starting with ~
+ */
+Term reset_symbol(const PonoOptions & pono_options,
+                  const TransitionSystem & ts)
+{
+  std::string reset_name = pono_options.reset_name_;
+  bool negative_reset = false;
+  if (reset_name.at(0) == '~') {
+    reset_name = reset_name.substr(1, reset_name.length() - 1);
+    negative_reset = true;
+  }
+  Term reset_symbol = ts.lookup(reset_name);
+  if (negative_reset) {
+    const SmtSolver & s = ts.solver();
+    SortKind sk = reset_symbol->get_sort()->get_sort_kind();
+    reset_symbol = (sk == BV) ? s->make_term(BVNot, reset_symbol)
+                              : s->make_term(Not, reset_symbol);
+  }
+  return reset_symbol;
+}
+
+/** Adds a reset sequence and guards the property with reset_done */
+void reset_seq_prop(const PonoOptions & pono_options,
+                    TransitionSystem & ts,
+                    Term & prop)
+{
+  Term reset_done = add_reset_seq(
+      ts, reset_symbol(pono_options, ts), pono_options.reset_bnd_);
+  prop = ts.solver()->make_term(Implies, reset_done, prop);
+}
+
+/** Registers the preprocessing passes, parameterized by the options
+ *  @param reset_folder set by reset-fold, to expand witnesses
+ *  @param phase_abs set by phase-abs, to expand witnesses
+ */
+void add_preprocessing_passes(PassManager & pm,
+                              const PonoOptions & pono_options,
+                              shared_ptr<ResetFolder> & reset_folder,
+                              shared_ptr<PhaseAbstractor> & phase_abs)
+{
+  const PonoOptions & opts = pono_options;
+  auto needs_clock = [&opts](const TransitionSystem &, const Term &) {
+    return opts.clock_name_.empty() ? string("requires --clock") : "";
+  };
+  auto needs_reset = [&opts](const TransitionSystem &, const Term &) {
+    return opts.reset_name_.empty() ? string("requires --reset") : "";
+  };
+  // can't assume the non-delayed prop and also delay it
+  auto before_assume_prop = [&pm](const TransitionSystem &, const Term &) {
+    return pm.applied("assume-prop") ? string("cannot follow assume-prop")
+                                     : "";
+  };
+
+  pm.add_pass(
+      "clock",
+      [&opts](TransitionSystem & ts, Term & prop) {
+        toggle_clock(ts, ts.lookup(opts.clock_name_));
+      },
+      needs_clock);
+
+  pm.add_pass(
+      "reset",
+      [&opts](TransitionSystem & ts, Term & prop) {
+        reset_seq_prop(opts, ts, prop);
+      },
+      needs_reset);
+
+  pm.add_pass(
+      "reset-fold",
+      [&opts, &reset_folder](TransitionSystem & ts, Term & prop) {
+        try {
+          reset_folder = make_shared<ResetFolder>(
+              ts, reset_symbol(opts, ts), opts.reset_bnd_);
+          ts = reset_folder->folded_ts();
+        }
+        catch (PonoException & e) {
+          logger.log(0,
+                     "Warning: adding a reset sequence, reset folding is "
+                     "not possible: {}",
+                     e.what());
+          reset_folder.reset();
+          reset_seq_prop(opts, ts, prop);
+        }
+      },
+      [&opts, &phase_abs](const TransitionSystem &, const Term &) {
+        if (opts.reset_name_.empty()) {
+          return string("requires --reset");
+        }
+        return phase_abs ? string("cannot follow phase-abs") : "";
+      });
+
+  // after the reset sequence, which then constrains both phases
+  pm.add_pass(
+      "phase-abs",
+      [&opts, &phase_abs](TransitionSystem & ts, Term & prop) {
+        Term clock_symbol = ts.lookup(opts.clock_name_);
+        try {
+          phase_abs = make_shared<PhaseAbstractor>(ts, clock_symbol);
+          prop = phase_abs->abstract_prop(prop);
+          ts = phase_abs->abs_ts();
+        }
+        catch (PonoException & e) {
+          logger.log(0,
+                     "Warning: toggling the clock, phase abstraction is not "
+                     "possible: {}",
+                     e.what());
+          phase_abs.reset();
+          toggle_clock(ts, clock_symbol);
+        }
+      },
+      [&opts, &reset_folder](const TransitionSystem &, const Term &) {
+        if (opts.clock_name_.empty()) {
+          return string("requires --clock");
+        }
+        return reset_folder ? string("cannot follow reset-fold") : "";
+      });
+
+  pm.add_pass(
+      "sweep",
+      [&opts](TransitionSystem & ts, Term & prop) {
+        UnorderedTermMap subst =
+            sweep_registers(ts, opts.sweep_registers_, opts.random_seed_);
+        prop = ts.solver()->substitute(prop, subst);
+      },
+      [&opts](const TransitionSystem & ts, const Term &) {
+        if (!opts.sweep_registers_) {
+          return string("requires --sweep-registers <cycles>");
+        }
+        return ts.is_functional() ? "" : string("relational system");
+      });
+
+  /* Compute the set of state/input variables related to the
+     bad-state property. Based on that information, rebuild the
+     transition relation of the transition system. */
+  pm.add_pass("coi", [&opts](TransitionSystem & ts, Term & prop) {
+    StaticConeOfInfluence coi(ts, { prop }, opts.verbosity_);
+  });
+
+  pm.add_pass(
+      "pseudo-init",
+      [](TransitionSystem & ts, Term & prop) {
+        ts = pseudo_init_and_prop(ts, prop);
+      },
+      before_assume_prop);
+
+  pm.add_pass("promote-inputs", [](TransitionSystem & ts, Term & prop) {
     ts = promote_inputvars(ts);
     assert(!ts.inputvars().size());
+  });
+
+  pm.add_pass(
+      "prop-monitor",
+      [](TransitionSystem & ts, Term & prop) {
+        if (!ts.only_curr(prop)) {
+          logger.log(1,
+                     "Got next state or input variables in property. "
+                     "Generating a monitor state.");
+          prop = add_prop_monitor(ts, prop);
+        }
+      },
+      before_assume_prop);
+
+  // pseudo-init and prop-monitor must come before this pass
+  pm.add_pass(
+      "assume-prop",
+      [](TransitionSystem & ts, Term & prop) { prop_in_trans(ts, prop); },
+      [](const TransitionSystem & ts, const Term & prop) {
+        return ts.only_curr(prop) ? "" : string("requires prop-monitor");
+      });
+}
+
+/** @return the preprocessing pipeline, either --passes or the passes
+ *  enabled by the individual options in the default order
+ *  the property monitor is always added unless it is already there
+ */
+vector<string> preprocessing_pipeline(const PonoOptions & pono_options)
+{
+  vector<string> pipeline;
+  if (!pono_options.passes_.empty()) {
+    pipeline = syntax_analysis::Split(pono_options.passes_, ",");
+  } else {
+    if (!pono_options.clock_name_.empty()
+        && !pono_options.phase_abstraction_) {
+      pipeline.push_back("clock");
+    }
+    if (!pono_options.reset_name_.empty()) {
+      pipeline.push_back(pono_options.reset_folding_ ? "reset-fold" : "reset");
+    }
+    if (pono_options.phase_abstraction_) {
+      pipeline.push_back("phase-abs");
+    }
+    if (pono_options.sweep_registers_) {
+      pipeline.push_back("sweep");
+    }
+    if (pono_options.static_coi_) {
+      pipeline.push_back("coi");
+    }
+    if (pono_options.pseudo_init_prop_) {
+      pipeline.push_back("pseudo-init");
+    }
+    if (pono_options.promote_inputvars_) {
+      pipeline.push_back("promote-inputs");
+    }
+    if (pono_options.assume_prop_) {
+      pipeline.push_back("assume-prop");
+    }
   }
 
-  if (!ts.only_curr(prop)) {
-    logger.log(1,
-               "Got next state or input variables in property. "
-               "Generating a monitor state.");
-    prop = add_prop_monitor(ts, prop);
+  if (find(pipeline.begin(), pipeline.end(), "prop-monitor")
+      == pipeline.end()) {
+    auto it = find(pipeline.begin(), pipeline.end(), "assume-prop");
+    pipeline.insert(it, "prop-monitor");
   }
+  return pipeline;
+}
 
-  if (pono_options.assume_prop_) {
-    // NOTE: crucial that pseudo_init_prop and add_prop_monitor passes are
-    // before this pass. Can't assume the non-delayed prop and also
-    // delay it
-    prop_in_trans(ts, prop);
+/** Modify the transition system and property based on options
+ *  and write a snapshot of the result if requested
+ *  @param snapshot where to write the snapshot, empty path for none
+ *  @param reset_folder set if the reset sequence was folded into init,
+ *         to expand witnesses
+ *  @param phase_abs set if phase abstraction was applied, to expand
+ *         witnesses
+ */
+void preprocess_prop(const PonoOptions & pono_options,
+                     const SnapshotId & snapshot,
+                     Term & prop,
+                     TransitionSystem & ts,
+                     shared_ptr<ResetFolder> & reset_folder,
+                     shared_ptr<PhaseAbstractor> & phase_abs)
+{
+  PassManager pm;
+  add_preprocessing_passes(pm, pono_options, reset_folder, phase_abs);
+  // passes requested explicitly must apply
+  pm.run(preprocessing_pipeline(pono_options),
+         ts,
+         prop,
+         !pono_options.passes_.empty());
+  pm.log_statistics(1);
+
+  if (!snapshot.path.empty()) {
+    try {
+      TSSnapshot::write(snapshot.path, snapshot.key, ts, { prop });
+    }
+    catch (PonoException & e) {
+      logger.log(0, "Warning: could not write snapshot: {}", e.what());
+    }
+  }
+}
+
+ProverResult check_prop(PonoOptions pono_options,
+                        Term & prop,
+                        TransitionSystem & ts,
+                        const SmtSolver & s,
+                        std::vector<UnorderedTermMap> & cex,
+                        const SnapshotId & snapshot,
+                        bool preprocessed)
+{
+  // get property name before it is rewritten
+  const string prop_name = ts.get_name(prop);
+
+  // witnesses are needed for checking, but only returned if requested
+  const bool return_witness = pono_options.witness_;
+  pono_options.witness_ |= pono_options.check_witness_;
+
+  logger.log(1, "Solving property: {}", prop_name);
+  logger.log(3, "INIT:\n{}", ts.init());
+  logger.log(3, "TRANS:\n{}", ts.trans());
+
+  // modify the transition system and property based on options
+  // unless they were loaded from a snapshot
+  shared_ptr<ResetFolder> reset_folder;
+  shared_ptr<PhaseAbstractor> phase_abs;
+  if (preprocessed) {
+    logger.log(1, "Using preprocessed transition system from snapshot");
+  } else {
+    preprocess_prop(
+        pono_options, snapshot, prop, ts, reset_folder, phase_abs);
   }
 
   Property p(s, prop, prop_name);
 
   // end modification of the transition system and property
 
+  if (pono_options.sim_cycles_ && simulate_prop(pono_options, ts, prop, cex)) {
+    if (pono_options.check_witness_) {
+      check_cex(ts, prop, cex);
+    }
+    if (!return_witness) {
+      cex.clear();
+    } else if (phase_abs) {
+      cex = phase_abs->expand_witness(cex);
+    } else if (reset_folder) {
+      cex = reset_folder->expand_witness(cex);
+    }
+    return ProverResult::FALSE;
+  }
+
   Engine eng = pono_options.engine_;
 
   std::shared_ptr<Prover> prover;
   if (pono_options.cegp_abs_vals_) {
     prover = make_cegar_values_prover(eng, p, ts, s, pono_options);
+  } else if (pono_options.ceg_loc_) {
+    prover = make_cegar_loc_prover(eng, p, ts, s, pono_options);
   } else if (pono_options.ceg_bv_arith_) {
     prover = make_cegar_bv_arith_prover(eng, p, ts, s, pono_options);
   } else if (pono_options.ceg_prophecy_arrays_) {
@@ -138,6 +553,7 @@ ProverResult check_prop(PonoOptions pono_options,
   //       consider calling prover for CegProphecyArrays (so that underlying
   //       model checker runs prove unbounded) or possibly, have a command line
   //       flag to pick between the two
+  auto check_begin = timestamp();
   ProverResult r;
   if (pono_options.engine_ == MSAT_IC3IA)
   {
@@ -149,12 +565,35 @@ ProverResult check_prop(PonoOptions pono_options,
     r = prover->check_until(pono_options.bound_);
   }
 
+  if (!pono_options.stats_json_filename_.empty()) {
+    ProverStatistics stats = prover->statistics();
+    stats.timers["check_time"] =
+        time_duration_to_sec(timestamp_diff(check_begin, timestamp()));
+    ofstream out(pono_options.stats_json_filename_);
+    if (!out.is_open()) {
+      throw PonoException("Could not open statistics file: "
+                          + pono_options.stats_json_filename_);
+    }
+    stats.write_json(out);
+  }
+
   if (r == FALSE && pono_options.witness_) {
     bool success = prover->witness(cex);
     if (!success) {
       logger.log(
           0,
           "Only got a partial witness from engine. Not suitable for printing.");
+    } else if (pono_options.check_witness_) {
+      check_cex(ts, prop, cex);
+    }
+    if (!return_witness) {
+      cex.clear();
+    } else if (phase_abs) {
+      // one step per phase for the printers
+      cex = phase_abs->expand_witness(cex);
+    } else if (reset_folder) {
+      // prepend the reset sequence for the printers
+      cex = reset_folder->expand_witness(cex);
     }
   }
 
@@ -185,7 +624,86 @@ ProverResult check_prop(PonoOptions pono_options,
   return r;
 }
 
-// Note: signal handlers are registered only when profiling is enabled.
+/** Property with index prop_idx_ among the safety properties of a file */
+Term select_prop(const PonoOptions & pono_options, const TermVec & propvec)
+{
+  unsigned int num_props = propvec.size();
+  if (pono_options.prop_idx_ >= num_props) {
+    throw PonoException(
+        "Property index " + to_string(pono_options.prop_idx_)
+        + " is greater than the number of properties in file "
+        + pono_options.filename_ + " (" + to_string(num_props) + ")");
+  }
+  return propvec[pono_options.prop_idx_];
+}
+
+/** Parse a BTOR2 or AIGER file unless a snapshot can be used, check the
+ *  selected safety or justice property and print the result
+ *  @param format the name of the format for logging
+ *  @param print_witness prints a counterexample in the format of the file
+ */
+template <class Encoder>
+ProverResult check_functional_file(
+    const PonoOptions & pono_options,
+    const SnapshotId & snapshot,
+    const SmtSolver & s,
+    const string & format,
+    function<void(const Encoder &,
+                  const PonoOptions &,
+                  const vector<UnorderedTermMap> &,
+                  const TransitionSystem &)> print_witness)
+{
+  FunctionalTransitionSystem fts(s);
+  Term prop;
+  // the witness printer needs the encoder
+  // and the witness is expanded by the preprocessing passes,
+  // so always parse and preprocess then
+  bool preprocessed =
+      !pono_options.witness_ && load_snapshot(snapshot, fts, prop);
+  unique_ptr<Encoder> enc;
+  if (!preprocessed) {
+    logger.log(2, "Parsing {} file: {}", format, pono_options.filename_);
+    enc.reset(new Encoder(pono_options.filename_, fts));
+    if (pono_options.justice_) {
+      prop = justice_prop(pono_options, fts, enc->justicevec(), enc->fairvec());
+    } else {
+      prop = select_prop(pono_options, enc->propvec());
+    }
+  }
+  // justice properties are reported as j<idx>
+  const char * prop_kind = pono_options.justice_ ? "j" : "b";
+
+  vector<UnorderedTermMap> cex;
+  ProverResult res =
+      check_prop(pono_options, prop, fts, s, cex, snapshot, preprocessed);
+  // we assume that a prover never returns 'ERROR'
+  assert(res != ERROR);
+
+  if (res == FALSE) {
+    cout << "sat" << endl;
+    cout << prop_kind << pono_options.prop_idx_ << endl;
+    assert(pono_options.witness_ || !cex.size());
+    if (cex.size()) {
+      assert(enc);
+      print_witness(*enc, pono_options, cex, fts);
+      if (!pono_options.vcd_name_.empty()) {
+        VCDWitnessPrinter vcdprinter(fts, cex);
+        vcdprinter.dump_trace_to_file(pono_options.vcd_name_);
+      }
+    }
+  } else if (res == TRUE) {
+    cout << "unsat" << endl;
+    cout << prop_kind << pono_options.prop_idx_ << endl;
+  } else {
+    assert(res == pono::UNKNOWN);
+    cout << "unknown" << endl;
+    cout << prop_kind << pono_options.prop_idx_ << endl;
+  }
+  return res;
+}
+
+// Note: signal handlers are registered only when profiling or solver
+// profiling is enabled.
 void profiling_sig_handler(int sig)
 {
   std::string signame;
@@ -203,6 +721,7 @@ void profiling_sig_handler(int sig)
   ProfilerFlush();
   ProfilerStop();
 #endif
+  solver_profile().dump();
   // Switch back to default handling for signal 'sig' and raise it.
   signal(sig, SIG_DFL);
   raise(sig);
@@ -227,10 +746,20 @@ int main(int argc, char ** argv)
   // For profiling: set signal handlers for common signals to abort
   // program.  This is necessary to gracefully stop profiling when,
   // e.g., an external time limit is enforced to stop the program.
-  if (!pono_options.profiling_log_filename_.empty()) {
+  if (!pono_options.profiling_log_filename_.empty()
+      || !pono_options.solver_profile_filename_.empty()) {
     signal(SIGINT, profiling_sig_handler);
     signal(SIGTERM, profiling_sig_handler);
     signal(SIGALRM, profiling_sig_handler);
+  }
+  if (!pono_options.solver_profile_filename_.empty()) {
+    // solvers created from now on are wrapped in a ProfilingSolver
+    solver_profile().enable(pono_options.solver_profile_filename_);
+  } else if (!pono_options.stats_json_filename_.empty()) {
+    // only to count the solver calls for the statistics
+    solver_profile().enable("");
+  }
+  if (!pono_options.profiling_log_filename_.empty()) {
 #ifdef WITH_PROFILING
     logger.log(
         0, "Profiling log filename: {}", pono_options.profiling_log_filename_);
@@ -259,18 +788,6 @@ int main(int argc, char ** argv)
       //      to allow resetting assertions
     }
 
-    // limitations with COI
-    if (pono_options.static_coi_) {
-      if (pono_options.pseudo_init_prop_) {
-        // Issue explained here:
-        // https://github.com/upscale-project/pono/pull/160 will be resolved
-        // once state variables removed by COI are removed from init then should
-        // do static-coi BEFORE mod-init-prop
-        logger.log(0,
-                   "Warning: --mod-init-prop and --static-coi don't work "
-                   "well together currently.");
-      }
-    }
     // default options for IC3SA
     if (pono_options.engine_ == IC3SA_ENGINE) {
       // IC3SA expects all state variables
@@ -282,72 +799,59 @@ int main(int argc, char ** argv)
     //       and also only create the transition system once
     string file_ext = pono_options.filename_.substr(
         pono_options.filename_.find_last_of(".") + 1);
+    const SnapshotId snapshot = snapshot_id(pono_options);
     if (file_ext == "btor2" || file_ext == "btor") {
-      logger.log(2, "Parsing BTOR2 file: {}", pono_options.filename_);
-      FunctionalTransitionSystem fts(s);
-      BTOR2Encoder btor_enc(pono_options.filename_, fts);
-      const TermVec & propvec = btor_enc.propvec();
-      unsigned int num_props = propvec.size();
-      if (pono_options.prop_idx_ >= num_props) {
+      res = check_functional_file<BTOR2Encoder>(
+          pono_options,
+          snapshot,
+          s,
+          "BTOR2",
+          [](const BTOR2Encoder & enc,
+             const PonoOptions & opts,
+             const vector<UnorderedTermMap> & cex,
+             const TransitionSystem & ts) {
+            print_witness_btor(enc, cex, ts);
+          });
+    } else if (file_ext == "aag" || file_ext == "aig") {
+      res = check_functional_file<AIGEREncoder>(
+          pono_options,
+          snapshot,
+          s,
+          "AIGER",
+          [](const AIGEREncoder & enc,
+             const PonoOptions & opts,
+             const vector<UnorderedTermMap> & cex,
+             const TransitionSystem & ts) {
+            print_witness_aiger(enc, opts.prop_idx_, cex, opts.justice_);
+          });
+    } else if (file_ext == "smv" || file_ext == "vmt" || file_ext == "smt2") {
+      if (pono_options.justice_) {
         throw PonoException(
-            "Property index " + to_string(pono_options.prop_idx_)
-            + " is greater than the number of properties in file "
-            + pono_options.filename_ + " (" + to_string(num_props) + ")");
+            "Justice properties are only supported for BTOR2 and AIGER files");
       }
-
-      Term prop = propvec[pono_options.prop_idx_];
-
-      vector<UnorderedTermMap> cex;
-      res = check_prop(pono_options, prop, fts, s, cex);
-      // we assume that a prover never returns 'ERROR'
-      assert(res != ERROR);
-
-      // print btor output
-      if (res == FALSE) {
-        cout << "sat" << endl;
-        cout << "b" << pono_options.prop_idx_ << endl;
-        assert(pono_options.witness_ || !cex.size());
-        if (cex.size()) {
-          print_witness_btor(btor_enc, cex, fts);
-          if (!pono_options.vcd_name_.empty()) {
-            VCDWitnessPrinter vcdprinter(fts, cex);
-            vcdprinter.dump_trace_to_file(pono_options.vcd_name_);
-          }
-        }
-      } else if (res == TRUE) {
-        cout << "unsat" << endl;
-        cout << "b" << pono_options.prop_idx_ << endl;
-      } else {
-        assert(res == pono::UNKNOWN);
-        cout << "unknown" << endl;
-        cout << "b" << pono_options.prop_idx_ << endl;
-      }
-
-    } else if (file_ext == "smv" || file_ext == "vmt" || file_ext == "smt2") {
-      logger.log(2, "Parsing SMV/VMT file: {}", pono_options.filename_);
       RelationalTransitionSystem rts(s);
-      TermVec propvec;
-      if (file_ext == "smv") {
-        SMVEncoder smv_enc(pono_options.filename_, rts);
-        propvec = smv_enc.propvec();
-      } else {
-        assert(file_ext == "vmt" || file_ext == "smt2");
-        VMTEncoder vmt_enc(pono_options.filename_, rts);
-        propvec = vmt_enc.propvec();
-      }
-      unsigned int num_props = propvec.size();
-      if (pono_options.prop_idx_ >= num_props) {
-        throw PonoException(
-            "Property index " + to_string(pono_options.prop_idx_)
-            + " is greater than the number of properties in file "
-            + pono_options.filename_ + " (" + to_string(num_props) + ")");
+      Term prop;
+      // the witness is expanded by the preprocessing passes, so
+      // always preprocess then
+      bool preprocessed =
+          !pono_options.witness_ && load_snapshot(snapshot, rts, prop);
+      if (!preprocessed) {
+        logger.log(2, "Parsing SMV/VMT file: {}", pono_options.filename_);
+        TermVec propvec;
+        if (file_ext == "smv") {
+          SMVEncoder smv_enc(pono_options.filename_, rts);
+          propvec = smv_enc.propvec();
+        } else {
+          assert(file_ext == "vmt" || file_ext == "smt2");
+          VMTEncoder vmt_enc(pono_options.filename_, rts);
+          propvec = vmt_enc.propvec();
+        }
+        prop = select_prop(pono_options, propvec);
       }
 
-      Term prop = propvec[pono_options.prop_idx_];
-      // get property name before it is rewritten
-
       std::vector<UnorderedTermMap> cex;
-      res = check_prop(pono_options, prop, rts, s, cex);
+      res = check_prop(
+          pono_options, prop, rts, s, cex, snapshot, preprocessed);
       // we assume that a prover never returns 'ERROR'
       assert(res != ERROR);
 
@@ -407,6 +911,7 @@ int main(int argc, char ** argv)
     ProfilerStop();
 #endif
   }
+  solver_profile().dump();
 
   if (pono_options.print_wall_time_) {
     auto end_time_stamp = timestamp();
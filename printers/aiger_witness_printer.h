@@ -0,0 +1,70 @@
+/*********************                                                        */
+/*! \file aiger_witness_printer.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Prints counterexamples in the AIGER witness format
+**        (as used in the hardware model checking competition).
+**
+**
+**/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/ts.h"
+#include "frontends/aiger_encoder.h"
+#include "smt-switch/smt.h"
+#include "utils/logger.h"
+
+namespace pono {
+
+/** Values of boolean variables at one step as a string of 0/1
+ *  variables without a value (e.g. removed by COI) are printed as x
+ */
+std::string aiger_vals_at_time(const smt::TermVec & vec,
+                               const smt::UnorderedTermMap & valmap)
+{
+  std::string res(vec.size(), 'x');
+  for (size_t i = 0, size = vec.size(); i < size; ++i) {
+    auto it = valmap.find(vec[i]);
+    if (it == valmap.end()) {
+      continue;
+    }
+    if (!it->second->is_value()) {
+      throw PonoException("Expecting a value for " + vec[i]->to_string());
+    }
+    // solvers that alias booleans and bit-vectors of width one print #b1
+    std::string val = it->second->to_string();
+    res[i] = (val == "true" || val == "#b1") ? '1' : '0';
+  }
+  return res;
+}
+
+/** Prints the witness: the property, the initial latch values and the
+ *  inputs at each step, see http://fmv.jku.at/aiger/
+ *  @param justice true iff prop_idx is the index of a justice property
+ */
+void print_witness_aiger(const AIGEREncoder & aiger_enc,
+                         unsigned int prop_idx,
+                         const std::vector<smt::UnorderedTermMap> & cex,
+                         bool justice = false)
+{
+  logger.log(0, "1");
+  logger.log(0, "{}{}", justice ? "j" : "b", prop_idx);
+  logger.log(0, "{}", aiger_vals_at_time(aiger_enc.statesvec(), cex.at(0)));
+  for (const auto & valmap : cex) {
+    logger.log(0, "{}", aiger_vals_at_time(aiger_enc.inputsvec(), valmap));
+  }
+  logger.log(0, ".");
+}
+
+}  // namespace pono
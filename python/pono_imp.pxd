@@ -1,5 +1,6 @@
-from libc.stdint cimport uint64_t
+from libc.stdint cimport int64_t, uint64_t
 from libcpp cimport bool
+from libcpp.map cimport map
 from libcpp.pair cimport pair
 from libcpp.string cimport string
 from libcpp.unordered_map cimport unordered_map
@@ -101,6 +102,10 @@ cdef extern from "core/proverresult.h" namespace "pono":
 
 
 cdef extern from "engines/prover.h" namespace "pono":
+    cdef cppclass ProverStatistics:
+        map[string, int64_t] counters
+        map[string, double] timers
+
     cdef cppclass Prover:
         Prover(const Property & p, const TransitionSystem & ts,
                c_SmtSolver & s) except +
@@ -109,6 +114,7 @@ cdef extern from "engines/prover.h" namespace "pono":
         bint witness(vector[c_UnorderedTermMap] & out) except +
         c_Term invar() except +
         ProverResult prove() except +
+        ProverStatistics statistics() except +
 
 
 cdef extern from "engines/bmc.h" namespace "pono":
@@ -179,6 +185,12 @@ cdef extern from "frontends/btor2_encoder.h" namespace "pono":
         const c_TermVec & propvec() except +
 
 
+cdef extern from "frontends/aiger_encoder.h" namespace "pono":
+    cdef cppclass AIGEREncoder:
+        AIGEREncoder(string filename, FunctionalTransitionSystem & ts) except +
+        const c_TermVec & propvec() except +
+
+
 cdef extern from "frontends/smv_encoder.h" namespace "pono":
     cdef cppclass SMVEncoder:
         SMVEncoder(string filename, RelationalTransitionSystem & ts) except +
@@ -240,4 +252,7 @@ cdef extern from "utils/ts_analysis.h" namespace "pono":
     bint check_invar(const TransitionSystem & ts,
                      const c_Term & prop,
                      const c_Term & invar) except +
+    bint check_witness(const TransitionSystem & ts,
+                       const c_Term & prop,
+                       const vector[c_UnorderedTermMap] & witness) except +
 
@@ -17,6 +17,7 @@ from pono_imp cimport UNKNOWN as c_UNKNOWN
 from pono_imp cimport FALSE as c_FALSE
 from pono_imp cimport TRUE as c_TRUE
 from pono_imp cimport Prover as c_Prover
+from pono_imp cimport ProverStatistics as c_ProverStatistics
 from pono_imp cimport Bmc as c_Bmc
 from pono_imp cimport KInduction as c_KInduction
 from pono_imp cimport BmcSimplePath as c_BmcSimplePath
@@ -29,6 +30,7 @@ from pono_imp cimport ModelBasedIC3 as c_ModelBasedIC3
 IF WITH_MSAT_IC3IA == "ON":
     from pono_imp cimport MsatIC3IA as c_MsatIC3IA
 from pono_imp cimport BTOR2Encoder as c_BTOR2Encoder
+from pono_imp cimport AIGEREncoder as c_AIGEREncoder
 from pono_imp cimport SMVEncoder as c_SMVEncoder
 from pono_imp cimport VMTEncoder as c_VMTEncoder
 IF WITH_COREIR == "ON":
@@ -43,6 +45,7 @@ from pono_imp cimport pseudo_init_and_prop as c_pseudo_init_and_prop
 from pono_imp cimport prop_in_trans as c_prop_in_trans
 from pono_imp cimport set_global_logger_verbosity as c_set_global_logger_verbosity
 from pono_imp cimport check_invar as c_check_invar
+from pono_imp cimport check_witness as c_check_witness
 
 from smt_switch cimport SmtSolver, PrimOp, Op, c_SortKind, SortKind, \
     c_Sort, c_SortVec, Sort, Term, c_Term, c_TermVec, c_UnorderedTermMap
@@ -512,6 +515,19 @@ cdef class __AbstractProver:
         elif r == (<int> c_TRUE):
             return True
 
+    def statistics(self):
+        '''
+        Returns the statistics of the engine as a dictionary
+        counters are integers and timers are floats (seconds)
+        '''
+        cdef c_ProverStatistics cs = dref(self.cp).statistics()
+        stats = dict()
+        for elem in cs.counters:
+            stats[elem.first.decode()] = elem.second
+        for elem in cs.timers:
+            stats[elem.first.decode()] = elem.second
+        return stats
+
     @property
     def prop(self):
         return self._property
@@ -650,6 +666,27 @@ cdef class BTOR2Encoder:
         return res
 
 
+cdef class AIGEREncoder:
+    cdef c_AIGEREncoder * cbe
+    cdef FunctionalTransitionSystem _fts
+    def __cinit__(self, str filename, FunctionalTransitionSystem fts):
+        self.cbe = new c_AIGEREncoder(filename.encode(), \
+                                      dref(<c_FunctionalTransitionSystem * ?> fts.cts))
+        self._fts = fts
+
+    def __dealloc__(self):
+        del self.cbe
+
+    def propvec(self):
+        res = []
+        cdef vector[c_Term] props = dref(self.cbe).propvec()
+        for p in props:
+            term = Term(self._fts._solver)
+            term.ct = p
+            res.append(term)
+        return res
+
+
 cdef class SMVEncoder:
     cdef c_SMVEncoder * cbe
     cdef RelationalTransitionSystem _rts
@@ -786,6 +823,25 @@ def set_global_logger_verbosity(int v):
 def check_invar(__AbstractTransitionSystem ts, Term prop, Term invar):
     return c_check_invar(dref(ts.cts), prop.ct, invar.ct)
 
+def check_witness(__AbstractTransitionSystem ts, Term prop, witness):
+    '''
+
+    ts - a transition system
+    prop - the property
+    witness - a list of dictionaries from terms to values, e.g. from
+              a prover's witness method
+    Replay the witness on ts without a solver and return True iff it is
+    a counterexample, i.e. it starts in an initial state, follows the
+    transition relation and violates prop in the last step.
+
+    '''
+    cdef vector[c_UnorderedTermMap] c_witness
+    for i in range(len(witness)):
+        c_witness.push_back(c_UnorderedTermMap())
+        for k, v in witness[i].items():
+            c_witness[i][(<Term?> k).ct] = (<Term?> v).ct
+    return c_check_witness(dref(ts.cts), prop.ct, c_witness)
+
 def coi_reduction(__AbstractTransitionSystem ts, to_keep, verbosity=1):
     '''
 
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "assert.h"
+#include "smt/profiling_solver.h"
 
 // these two always included
 #include "smt-switch/boolector_factory.h"
@@ -105,6 +106,15 @@ SmtSolver create_solver(SolverEnum se,
   return s;
 }
 
+// wraps s in a ProfilingSolver if solver profiling is enabled
+SmtSolver profile_if_enabled(SmtSolver s)
+{
+  if (solver_profile().enabled()) {
+    s = make_shared<ProfilingSolver>(s);
+  }
+  return s;
+}
+
 SmtSolver create_solver_for(SolverEnum se,
                             Engine e,
                             bool logging,
@@ -143,7 +153,8 @@ SmtSolver create_solver_for(SolverEnum se,
     if (logging) {
       s = make_shared<LoggingSolver>(s);
     }
-    return s;
+    // MsatIC3IA needs the underlying MsatSolver
+    return e == MSAT_IC3IA ? s : profile_if_enabled(s);
   }
 #endif
   else {
@@ -154,7 +165,7 @@ SmtSolver create_solver_for(SolverEnum se,
   if (ic3_engine) {
     s->set_opt("produce-unsat-assumptions", "true");
   }
-  return s;
+  return profile_if_enabled(s);
 }
 
 SmtSolver create_reducer_for(SolverEnum se, Engine e, bool logging)
@@ -179,7 +190,7 @@ SmtSolver create_reducer_for(SolverEnum se, Engine e, bool logging)
 #endif
 
   assert(s);
-  return s;
+  return profile_if_enabled(s);
 }
 
 SmtSolver create_interpolating_solver(SolverEnum se)
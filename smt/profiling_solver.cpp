@@ -0,0 +1,402 @@
+/*********************                                                        */
+/*! \file profiling_solver.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A solver decorator that records the number and latency of
+**        solver calls, tagged with the phase of the engine.
+**
+**/
+
+#include "smt/profiling_solver.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+/** Records the time between construction and destruction as a call */
+class ProfiledCall
+{
+ public:
+  ProfiledCall(const ProfilingSolver * s, const char * call)
+      : solver_(s), call_(call), begin_(timestamp())
+  {
+  }
+  ~ProfiledCall()
+  {
+    solver_->record(call_, timestamp_diff(begin_, timestamp()));
+  }
+
+ protected:
+  const ProfilingSolver * solver_;
+  const char * call_;
+  pono_time_stamp begin_;
+};
+
+/* SolverProfile implementation */
+
+void SolverProfile::enable(const string & filename)
+{
+  enabled_ = true;
+  filename_ = filename;
+}
+
+void SolverProfile::record(const char * call, pono_time_duration d)
+{
+  SolverCallStats & st =
+      stats_[phases_.empty() ? "none" : phases_.back()][call];
+  double sec = time_duration_to_sec(d);
+  st.count++;
+  st.total += sec;
+  st.max = std::max(st.max, sec);
+
+  size_t bucket = 0;
+  for (long long us = d.count() / 1000; us > 0; us >>= 1) {
+    bucket++;
+  }
+  if (st.histogram.size() <= bucket) {
+    st.histogram.resize(bucket + 1, 0);
+  }
+  st.histogram[bucket]++;
+}
+
+void SolverProfile::dump_json(ostream & out) const
+{
+  out << "{" << endl;
+  out << "  \"histogram_buckets\": \"log2 microseconds\"," << endl;
+  out << "  \"phases\": {";
+  bool first_phase = true;
+  for (const auto & phase : stats_) {
+    out << (first_phase ? "" : ",") << endl;
+    first_phase = false;
+    out << "    \"" << phase.first << "\": {";
+    bool first_call = true;
+    for (const auto & call : phase.second) {
+      const SolverCallStats & st = call.second;
+      out << (first_call ? "" : ",") << endl;
+      first_call = false;
+      out << "      \"" << call.first << "\": { ";
+      out << "\"count\": " << st.count << ", ";
+      out << "\"total\": " << st.total << ", ";
+      out << "\"mean\": " << (st.count ? st.total / st.count : 0.0) << ", ";
+      out << "\"max\": " << st.max << ", ";
+      out << "\"histogram\": [";
+      for (size_t i = 0; i < st.histogram.size(); ++i) {
+        out << (i ? ", " : "") << st.histogram[i];
+      }
+      out << "] }";
+    }
+    out << endl << "    }";
+  }
+  out << endl << "  }" << endl;
+  out << "}" << endl;
+}
+
+void SolverProfile::dump() const
+{
+  if (!enabled_ || filename_.empty()) {
+    return;
+  }
+  ofstream out(filename_);
+  if (!out.is_open()) {
+    // also called from signal handlers, do not throw
+    logger.log(0, "Could not open solver profile file: {}", filename_);
+    return;
+  }
+  dump_json(out);
+  logger.log(1, "Wrote solver profile to {}", filename_);
+}
+
+SolverProfile & solver_profile()
+{
+  static SolverProfile profile;
+  return profile;
+}
+
+/* ProfilingSolver implementation */
+
+ProfilingSolver::ProfilingSolver(SmtSolver s)
+    : AbstractSmtSolver(s->get_solver_enum()),
+      wrapped_(s),
+      num_calls_(0),
+      time_(0)
+{
+}
+
+void ProfilingSolver::record(const char * call, pono_time_duration d) const
+{
+  num_calls_++;
+  time_ += time_duration_to_sec(d);
+  solver_profile().record(call, d);
+}
+
+void ProfilingSolver::set_opt(const string option, const string value)
+{
+  wrapped_->set_opt(option, value);
+}
+
+void ProfilingSolver::set_logic(const string logic)
+{
+  wrapped_->set_logic(logic);
+}
+
+void ProfilingSolver::assert_formula(const Term & t)
+{
+  wrapped_->assert_formula(t);
+}
+
+Result ProfilingSolver::check_sat()
+{
+  ProfiledCall pc(this, "check_sat");
+  return wrapped_->check_sat();
+}
+
+Result ProfilingSolver::check_sat_assuming(const TermVec & assumptions)
+{
+  ProfiledCall pc(this, "check_sat_assuming");
+  return wrapped_->check_sat_assuming(assumptions);
+}
+
+Result ProfilingSolver::check_sat_assuming_list(const TermList & assumptions)
+{
+  ProfiledCall pc(this, "check_sat_assuming");
+  return wrapped_->check_sat_assuming_list(assumptions);
+}
+
+Result ProfilingSolver::check_sat_assuming_set(
+    const UnorderedTermSet & assumptions)
+{
+  ProfiledCall pc(this, "check_sat_assuming");
+  return wrapped_->check_sat_assuming_set(assumptions);
+}
+
+void ProfilingSolver::push(uint64_t num)
+{
+  ProfiledCall pc(this, "push");
+  wrapped_->push(num);
+}
+
+void ProfilingSolver::pop(uint64_t num)
+{
+  ProfiledCall pc(this, "pop");
+  wrapped_->pop(num);
+}
+
+uint64_t ProfilingSolver::get_context_level() const
+{
+  return wrapped_->get_context_level();
+}
+
+Term ProfilingSolver::get_value(const Term & t) const
+{
+  ProfiledCall pc(this, "get_value");
+  return wrapped_->get_value(t);
+}
+
+UnorderedTermMap ProfilingSolver::get_array_values(
+    const Term & arr, Term & out_const_base) const
+{
+  ProfiledCall pc(this, "get_value");
+  return wrapped_->get_array_values(arr, out_const_base);
+}
+
+void ProfilingSolver::get_unsat_assumptions(UnorderedTermSet & out)
+{
+  ProfiledCall pc(this, "get_unsat_assumptions");
+  wrapped_->get_unsat_assumptions(out);
+}
+
+Sort ProfilingSolver::make_sort(const string name, uint64_t arity) const
+{
+  return wrapped_->make_sort(name, arity);
+}
+
+Sort ProfilingSolver::make_sort(const SortKind sk) const
+{
+  return wrapped_->make_sort(sk);
+}
+
+Sort ProfilingSolver::make_sort(const SortKind sk, uint64_t size) const
+{
+  return wrapped_->make_sort(sk, size);
+}
+
+Sort ProfilingSolver::make_sort(const SortKind sk, const Sort & sort1) const
+{
+  return wrapped_->make_sort(sk, sort1);
+}
+
+Sort ProfilingSolver::make_sort(const SortKind sk,
+                                const Sort & sort1,
+                                const Sort & sort2) const
+{
+  return wrapped_->make_sort(sk, sort1, sort2);
+}
+
+Sort ProfilingSolver::make_sort(const SortKind sk,
+                                const Sort & sort1,
+                                const Sort & sort2,
+                                const Sort & sort3) const
+{
+  return wrapped_->make_sort(sk, sort1, sort2, sort3);
+}
+
+Sort ProfilingSolver::make_sort(const SortKind sk, const SortVec & sorts) const
+{
+  return wrapped_->make_sort(sk, sorts);
+}
+
+Sort ProfilingSolver::make_sort(const Sort & sort_con,
+                                const SortVec & sorts) const
+{
+  return wrapped_->make_sort(sort_con, sorts);
+}
+
+Sort ProfilingSolver::make_sort(const DatatypeDecl & d) const
+{
+  return wrapped_->make_sort(d);
+}
+
+DatatypeDecl ProfilingSolver::make_datatype_decl(const string & s)
+{
+  return wrapped_->make_datatype_decl(s);
+}
+
+DatatypeConstructorDecl ProfilingSolver::make_datatype_constructor_decl(
+    const string s)
+{
+  return wrapped_->make_datatype_constructor_decl(s);
+}
+
+void ProfilingSolver::add_constructor(
+    DatatypeDecl & dt, const DatatypeConstructorDecl & con) const
+{
+  wrapped_->add_constructor(dt, con);
+}
+
+void ProfilingSolver::add_selector(DatatypeConstructorDecl & dt,
+                                   const string & name,
+                                   const Sort & s) const
+{
+  wrapped_->add_selector(dt, name, s);
+}
+
+void ProfilingSolver::add_selector_self(DatatypeConstructorDecl & dt,
+                                        const string & name) const
+{
+  wrapped_->add_selector_self(dt, name);
+}
+
+Term ProfilingSolver::get_constructor(const Sort & s, string name) const
+{
+  return wrapped_->get_constructor(s, name);
+}
+
+Term ProfilingSolver::get_tester(const Sort & s, string name) const
+{
+  return wrapped_->get_tester(s, name);
+}
+
+Term ProfilingSolver::get_selector(const Sort & s,
+                                   string con,
+                                   string name) const
+{
+  return wrapped_->get_selector(s, con, name);
+}
+
+Term ProfilingSolver::make_term(bool b) const
+{
+  return wrapped_->make_term(b);
+}
+
+Term ProfilingSolver::make_term(int64_t i, const Sort & sort) const
+{
+  return wrapped_->make_term(i, sort);
+}
+
+Term ProfilingSolver::make_term(const string val,
+                                const Sort & sort,
+                                uint64_t base) const
+{
+  return wrapped_->make_term(val, sort, base);
+}
+
+Term ProfilingSolver::make_term(const Term & val, const Sort & sort) const
+{
+  return wrapped_->make_term(val, sort);
+}
+
+Term ProfilingSolver::make_symbol(const string name, const Sort & sort)
+{
+  return wrapped_->make_symbol(name, sort);
+}
+
+Term ProfilingSolver::get_symbol(const string & name)
+{
+  return wrapped_->get_symbol(name);
+}
+
+Term ProfilingSolver::make_param(const string name, const Sort & sort)
+{
+  return wrapped_->make_param(name, sort);
+}
+
+Term ProfilingSolver::make_term(const Op op, const Term & t) const
+{
+  return wrapped_->make_term(op, t);
+}
+
+Term ProfilingSolver::make_term(const Op op,
+                                const Term & t0,
+                                const Term & t1) const
+{
+  return wrapped_->make_term(op, t0, t1);
+}
+
+Term ProfilingSolver::make_term(const Op op,
+                                const Term & t0,
+                                const Term & t1,
+                                const Term & t2) const
+{
+  return wrapped_->make_term(op, t0, t1, t2);
+}
+
+Term ProfilingSolver::make_term(const Op op, const TermVec & terms) const
+{
+  return wrapped_->make_term(op, terms);
+}
+
+void ProfilingSolver::reset() { wrapped_->reset(); }
+
+void ProfilingSolver::reset_assertions() { wrapped_->reset_assertions(); }
+
+Term ProfilingSolver::substitute(
+    const Term term, const UnorderedTermMap & substitution_map) const
+{
+  return wrapped_->substitute(term, substitution_map);
+}
+
+void ProfilingSolver::substitute_terms(
+    TermVec & terms, const UnorderedTermMap & substitution_map) const
+{
+  wrapped_->substitute_terms(terms, substitution_map);
+}
+
+void ProfilingSolver::dump_smt2(string filename) const
+{
+  wrapped_->dump_smt2(filename);
+}
+
+}  // namespace pono
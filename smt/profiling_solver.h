@@ -0,0 +1,203 @@
+/*********************                                                        */
+/*! \file profiling_solver.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A solver decorator that records the number and latency of
+**        solver calls, tagged with the phase of the engine.
+**
+**        Engines mark phases with a ProfilePhase in the scope of the
+**        phase, the innermost phase is used for a call. The calls of
+**        all ProfilingSolvers are accumulated in a global SolverProfile
+**        that is dumped as JSON at exit (--solver-profile).
+**
+**/
+
+#pragma once
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "smt-switch/smt.h"
+#include "utils/timestamp.h"
+
+namespace pono {
+
+struct SolverCallStats
+{
+  SolverCallStats() : count(0), total(0), max(0) {}
+
+  size_t count;
+  double total;  ///< seconds
+  double max;    ///< seconds
+  ///< bucket i counts the calls taking [2^(i-1), 2^i) microseconds
+  ///< bucket 0 the calls under a microsecond
+  std::vector<size_t> histogram;
+};
+
+class SolverProfile
+{
+ public:
+  SolverProfile() : enabled_(false) {}
+
+  /** Starts recording, the profile is written to filename by dump
+   *  unless it is empty
+   */
+  void enable(const std::string & filename);
+
+  bool enabled() const { return enabled_; }
+
+  void push_phase(const char * phase) { phases_.push_back(phase); }
+  void pop_phase() { phases_.pop_back(); }
+
+  /** Records a call in the current phase */
+  void record(const char * call, pono_time_duration d);
+
+  void dump_json(std::ostream & out) const;
+
+  /** Writes the profile to the file given to enable, if enabled */
+  void dump() const;
+
+ protected:
+  bool enabled_;
+  std::string filename_;
+  std::vector<const char *> phases_;
+  ///< phase -> call -> statistics
+  std::map<std::string, std::map<std::string, SolverCallStats>> stats_;
+};
+
+/** @return the global solver profile */
+SolverProfile & solver_profile();
+
+/** Tags the solver calls in its scope with a phase */
+class ProfilePhase
+{
+ public:
+  ProfilePhase(const char * phase) : active_(solver_profile().enabled())
+  {
+    if (active_) {
+      solver_profile().push_phase(phase);
+    }
+  }
+
+  ~ProfilePhase()
+  {
+    if (active_) {
+      solver_profile().pop_phase();
+    }
+  }
+
+ protected:
+  bool active_;
+};
+
+class ProfilingSolver : public smt::AbstractSmtSolver
+{
+ public:
+  ProfilingSolver(smt::SmtSolver s);
+
+  /** @return the number of timed calls to this solver */
+  size_t num_calls() const { return num_calls_; }
+
+  /** @return the time spent in timed calls to this solver, in seconds */
+  double time() const { return time_; }
+
+  /** Records a timed call, also in the global profile */
+  void record(const char * call, pono_time_duration d) const;
+
+  void set_opt(const std::string option, const std::string value) override;
+  void set_logic(const std::string logic) override;
+  void assert_formula(const smt::Term & t) override;
+  smt::Result check_sat() override;
+  smt::Result check_sat_assuming(const smt::TermVec & assumptions) override;
+  smt::Result check_sat_assuming_list(
+      const smt::TermList & assumptions) override;
+  smt::Result check_sat_assuming_set(
+      const smt::UnorderedTermSet & assumptions) override;
+  void push(uint64_t num = 1) override;
+  void pop(uint64_t num = 1) override;
+  uint64_t get_context_level() const override;
+  smt::Term get_value(const smt::Term & t) const override;
+  smt::UnorderedTermMap get_array_values(
+      const smt::Term & arr, smt::Term & out_const_base) const override;
+  void get_unsat_assumptions(smt::UnorderedTermSet & out) override;
+  smt::Sort make_sort(const std::string name, uint64_t arity) const override;
+  smt::Sort make_sort(const smt::SortKind sk) const override;
+  smt::Sort make_sort(const smt::SortKind sk, uint64_t size) const override;
+  smt::Sort make_sort(const smt::SortKind sk,
+                      const smt::Sort & sort1) const override;
+  smt::Sort make_sort(const smt::SortKind sk,
+                      const smt::Sort & sort1,
+                      const smt::Sort & sort2) const override;
+  smt::Sort make_sort(const smt::SortKind sk,
+                      const smt::Sort & sort1,
+                      const smt::Sort & sort2,
+                      const smt::Sort & sort3) const override;
+  smt::Sort make_sort(const smt::SortKind sk,
+                      const smt::SortVec & sorts) const override;
+  smt::Sort make_sort(const smt::Sort & sort_con,
+                      const smt::SortVec & sorts) const override;
+  smt::Sort make_sort(const smt::DatatypeDecl & d) const override;
+  smt::DatatypeDecl make_datatype_decl(const std::string & s) override;
+  smt::DatatypeConstructorDecl make_datatype_constructor_decl(
+      const std::string s) override;
+  void add_constructor(smt::DatatypeDecl & dt,
+                       const smt::DatatypeConstructorDecl & con) const override;
+  void add_selector(smt::DatatypeConstructorDecl & dt,
+                    const std::string & name,
+                    const smt::Sort & s) const override;
+  void add_selector_self(smt::DatatypeConstructorDecl & dt,
+                         const std::string & name) const override;
+  smt::Term get_constructor(const smt::Sort & s,
+                            std::string name) const override;
+  smt::Term get_tester(const smt::Sort & s, std::string name) const override;
+  smt::Term get_selector(const smt::Sort & s,
+                         std::string con,
+                         std::string name) const override;
+  smt::Term make_term(bool b) const override;
+  smt::Term make_term(int64_t i, const smt::Sort & sort) const override;
+  smt::Term make_term(const std::string val,
+                      const smt::Sort & sort,
+                      uint64_t base = 10) const override;
+  smt::Term make_term(const smt::Term & val,
+                      const smt::Sort & sort) const override;
+  smt::Term make_symbol(const std::string name,
+                        const smt::Sort & sort) override;
+  smt::Term get_symbol(const std::string & name) override;
+  smt::Term make_param(const std::string name,
+                       const smt::Sort & sort) override;
+  smt::Term make_term(const smt::Op op, const smt::Term & t) const override;
+  smt::Term make_term(const smt::Op op,
+                      const smt::Term & t0,
+                      const smt::Term & t1) const override;
+  smt::Term make_term(const smt::Op op,
+                      const smt::Term & t0,
+                      const smt::Term & t1,
+                      const smt::Term & t2) const override;
+  smt::Term make_term(const smt::Op op,
+                      const smt::TermVec & terms) const override;
+  void reset() override;
+  void reset_assertions() override;
+  smt::Term substitute(
+      const smt::Term term,
+      const smt::UnorderedTermMap & substitution_map) const override;
+  void substitute_terms(
+      smt::TermVec & terms,
+      const smt::UnorderedTermMap & substitution_map) const override;
+  void dump_smt2(std::string filename) const override;
+
+ protected:
+  smt::SmtSolver wrapped_;
+  mutable size_t num_calls_;
+  mutable double time_;
+};
+
+}  // namespace pono
@@ -0,0 +1,100 @@
+/*********************                                                        */
+/*! \file sat_solver.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A minimal incremental SAT solver interface for bit-level
+**        engines, backed by the MiniSat shipped with mustool.
+**
+**/
+
+#include "smt/sat_solver.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <unordered_set>
+
+#include "custom_minisat/Solver.h"
+
+using namespace std;
+
+namespace pono {
+
+class MinisatSolver : public SatSolver
+{
+ public:
+  MinisatSolver() : num_clauses_(0) {}
+
+  ~MinisatSolver() {}
+
+  int new_var() override { return solver_.newVar() + 1; }
+
+  void add_clause(const vector<int> & clause) override
+  {
+    CustomMinisat::vec<CustomMinisat::Lit> lits;
+    for (const auto & l : clause) {
+      lits.push(to_lit(l));
+    }
+    solver_.addClause(lits);
+    num_clauses_++;
+  }
+
+  bool solve(const vector<int> & assumptions) override
+  {
+    CustomMinisat::vec<CustomMinisat::Lit> lits;
+    for (const auto & l : assumptions) {
+      lits.push(to_lit(l));
+    }
+    bool res = solver_.solve(lits);
+
+    failed_.clear();
+    if (!res) {
+      // the final conflict is a clause over the negated assumptions
+      for (int i = 0; i < solver_.conflict.size(); ++i) {
+        failed_.insert(-from_lit(solver_.conflict[i]));
+      }
+    }
+    return res;
+  }
+
+  bool value(int lit) const override
+  {
+    return solver_.modelValue(to_lit(lit)) == l_True;
+  }
+
+  bool failed(int lit) const override
+  {
+    return failed_.find(lit) != failed_.end();
+  }
+
+  size_t num_vars() const override { return solver_.nVars(); }
+
+  size_t num_clauses() const override { return num_clauses_; }
+
+ protected:
+  static CustomMinisat::Lit to_lit(int l)
+  {
+    assert(l != 0);
+    return CustomMinisat::mkLit(abs(l) - 1, l < 0);
+  }
+
+  static int from_lit(CustomMinisat::Lit l)
+  {
+    int v = CustomMinisat::var(l) + 1;
+    return CustomMinisat::sign(l) ? -v : v;
+  }
+
+  CustomMinisat::Solver solver_;
+  size_t num_clauses_;
+  unordered_set<int> failed_;
+};
+
+SatSolverPtr create_sat_solver() { return make_shared<MinisatSolver>(); }
+
+}  // namespace pono
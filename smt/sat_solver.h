@@ -0,0 +1,63 @@
+/*********************                                                        */
+/*! \file sat_solver.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A minimal incremental SAT solver interface for bit-level
+**        engines, backed by the MiniSat shipped with mustool.
+**
+**        Literals are DIMACS-style: a positive or negative variable
+**        index, variables start at 1.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace pono {
+
+class SatSolver
+{
+ public:
+  virtual ~SatSolver() {}
+
+  /** @return the index of a fresh variable (greater than 0) */
+  virtual int new_var() = 0;
+
+  virtual void add_clause(const std::vector<int> & clause) = 0;
+
+  /** Check satisfiability under assumptions
+   *  @param assumptions literals that hold for this call only
+   *  @return true iff satisfiable
+   */
+  virtual bool solve(const std::vector<int> & assumptions) = 0;
+
+  /** @return the value of a literal in the model
+   *  @requires the last call to solve was satisfiable
+   */
+  virtual bool value(int lit) const = 0;
+
+  /** @return true iff the assumption is in the unsat core
+   *  @requires the last call to solve was unsatisfiable
+   */
+  virtual bool failed(int lit) const = 0;
+
+  virtual size_t num_vars() const = 0;
+
+  virtual size_t num_clauses() const = 0;
+};
+
+typedef std::shared_ptr<SatSolver> SatSolverPtr;
+
+/** @return a new MiniSat solver */
+SatSolverPtr create_sat_solver();
+
+}  // namespace pono
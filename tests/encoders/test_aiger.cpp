@@ -0,0 +1,96 @@
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/fts.h"
+#include "engines/bmc.h"
+#include "engines/kinduction.h"
+#include "frontends/aiger_encoder.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "test_encoder_inputs.h"
+#include "utils/exceptions.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class AigerFileUnitTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<tuple<SolverEnum, string>>
+{
+};
+
+class AigerUnitTests : public ::testing::Test,
+                       public ::testing::WithParamInterface<SolverEnum>
+{
+};
+
+TEST_P(AigerFileUnitTests, Encode)
+{
+  SmtSolver s = create_solver(get<0>(GetParam()));
+  FunctionalTransitionSystem fts(s);
+  // PONO_SRC_DIR is a macro set using CMake PROJECT_SRC_DIR
+  string filename = STRFY(PONO_SRC_DIR);
+  filename += "/tests/encoders/inputs/aiger/";
+  filename += get<1>(GetParam());
+  AIGEREncoder ae(filename, fts);
+
+  EXPECT_TRUE(fts.is_functional());
+  ASSERT_EQ(ae.inputsvec().size(), 1);
+  ASSERT_EQ(ae.statesvec().size(), 2);
+  EXPECT_EQ(ae.inputsvec()[0], fts.lookup("enable"));
+  EXPECT_EQ(ae.statesvec()[0], fts.lookup("a"));
+  EXPECT_EQ(ae.statesvec()[1], fts.lookup("b"));
+  for (const auto & sv : fts.statevars()) {
+    // no bit-vectors of width one
+    EXPECT_EQ(sv->get_sort(), s->make_sort(BOOL));
+  }
+  ASSERT_EQ(ae.propvec().size(), 2);
+  ASSERT_EQ(ae.justicevec().size(), 1);
+  EXPECT_EQ(ae.justicevec()[0].size(), 1);
+  EXPECT_EQ(ae.fairvec().size(), 1);
+
+  // the counter reaches 3 after 3 steps
+  Property p(s, ae.propvec()[0]);
+  Bmc bmc(p, fts, s);
+  EXPECT_EQ(bmc.check_until(2), ProverResult::UNKNOWN);
+  EXPECT_EQ(bmc.check_until(3), ProverResult::FALSE);
+
+  SmtSolver s2 = create_solver(get<0>(GetParam()));
+  Property never(s2, ae.propvec()[1]);
+  KInduction kind(never, fts, s2);
+  EXPECT_EQ(kind.check_until(1), ProverResult::TRUE);
+}
+
+TEST_P(AigerUnitTests, MissingFile)
+{
+  SmtSolver s = create_solver(GetParam());
+  FunctionalTransitionSystem fts(s);
+  EXPECT_THROW(AIGEREncoder ae("does-not-exist.aag", fts), PonoException);
+}
+
+TEST_P(AigerUnitTests, NotAiger)
+{
+  SmtSolver s = create_solver(GetParam());
+  FunctionalTransitionSystem fts(s);
+  // PONO_SRC_DIR is a macro set using CMake PROJECT_SRC_DIR
+  string filename = STRFY(PONO_SRC_DIR);
+  filename += "/tests/encoders/inputs/btor2/counter.btor";
+  EXPECT_THROW(AIGEREncoder ae(filename, fts), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParameterizedSolverAigerFileUnitTests,
+    AigerFileUnitTests,
+    testing::Combine(testing::ValuesIn(available_solver_enums()),
+                     // from test_encoder_inputs.h
+                     testing::ValuesIn(aiger_inputs)));
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSolverAigerUnitTests,
+                         AigerUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
@@ -72,6 +72,30 @@ TEST_P(Btor2UnitTests, InputConstraints)
   ASSERT_NE(r, ProverResult::FALSE);
 }
 
+TEST_P(Btor2UnitTests, UnnamedStates)
+{
+  SmtSolver s = create_solver(GetParam());
+  FunctionalTransitionSystem fts(s);
+  // PONO_SRC_DIR is a macro set using CMake PROJECT_SRC_DIR
+  string filename = STRFY(PONO_SRC_DIR);
+  filename += "/tests/encoders/inputs/btor2/unnamed-state.btor2";
+  BTOR2Encoder be(filename, fts);
+  ASSERT_EQ(be.statesvec().size(), 2);
+  // named by the output that refers to it
+  EXPECT_EQ(be.statesvec()[0], fts.lookup("count"));
+  // no named output, uses the default name
+  EXPECT_EQ(be.statesvec()[1], fts.lookup("state10"));
+  EXPECT_TRUE(be.no_next_statevars().empty());
+  EXPECT_EQ(be.propvec().size(), 1);
+}
+
+TEST_P(Btor2UnitTests, MissingFile)
+{
+  SmtSolver s = create_solver(GetParam());
+  FunctionalTransitionSystem fts(s);
+  EXPECT_THROW(BTOR2Encoder be("does-not-exist.btor2", fts), PonoException);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedSolverBtor2FileUnitTests,
     Btor2FileUnitTests,
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "core/rts.h"
+#include "engines/kinduction.h"
 #include "frontends/coreir_encoder.h"
 #include "gtest/gtest.h"
 #include "smt/available_solvers.h"
@@ -46,6 +47,138 @@ TEST_P(CoreIRUnitTests, EncodeForceAbstract)
   CoreIREncoder ce(filename, rts, true);
 }
 
+// exposes the module templates
+class CoreIRTemplateEncoder : public CoreIREncoder
+{
+ public:
+  CoreIRTemplateEncoder(std::string filename, RelationalTransitionSystem & ts)
+      : CoreIREncoder(filename, ts)
+  {
+  }
+
+  size_t num_templates() const { return templates_->size(); }
+
+  /** @return the number of instances of a module, 0 if there is no
+   *  template for it */
+  size_t num_instances(const string & module_name) const
+  {
+    for (const auto & elem : *templates_) {
+      if (elem.first->getName() == module_name) {
+        return elem.second->num_instances;
+      }
+    }
+    return 0;
+  }
+};
+
+class CoreIRHierarchyUnitTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    // PONO_SRC_DIR is a macro set using CMake PROJECT_SRC_DIR
+    filename = STRFY(PONO_SRC_DIR);
+    filename += "/tests/encoders/inputs/coreir/hierarchy.json";
+  }
+  string filename;
+};
+
+TEST_P(CoreIRHierarchyUnitTests, EncodeModulesOnce)
+{
+  SmtSolver s = create_solver(GetParam());
+  RelationalTransitionSystem rts(s);
+  CoreIRTemplateEncoder ce(filename, rts);
+
+  // pair, counter and counter8, the counters are only instantiated in
+  // the template of pair which is then instantiated twice
+  EXPECT_EQ(ce.num_templates(), 3);
+  EXPECT_EQ(ce.num_instances("pair"), 2);
+  EXPECT_EQ(ce.num_instances("counter"), 2);
+  EXPECT_EQ(ce.num_instances("counter8"), 1);
+
+  // the clock and one register per counter
+  EXPECT_EQ(rts.statevars().size(), 6);
+  for (auto name : { "p0$c0$r", "p0$c1$r", "p1$c0$r", "p1$c1$r", "q$r" }) {
+    EXPECT_TRUE(rts.is_curr_var(rts.lookup(name))) << name;
+  }
+}
+
+TEST_P(CoreIRHierarchyUnitTests, CountersAgree)
+{
+  SmtSolver s = create_solver(GetParam());
+  s->set_opt("incremental", "true");
+  s->set_opt("produce-models", "true");
+  RelationalTransitionSystem rts(s);
+  CoreIREncoder ce(filename, rts);
+
+  // all counters are incremented on the same clock
+  const auto & named_terms = rts.named_terms();
+  Term p0_out0 = named_terms.at("p0.out0");
+  Term agree = rts.make_term(Equal, p0_out0, named_terms.at("p0.out1"));
+  for (auto name : { "p1.out0", "p1.out1" }) {
+    agree = rts.make_term(
+        And, agree, rts.make_term(Equal, p0_out0, named_terms.at(name)));
+  }
+  Term q_low = rts.make_term(Op(Extract, 3, 0), named_terms.at("q.out"));
+  agree = rts.make_term(And, agree, rts.make_term(Equal, p0_out0, q_low));
+
+  Property prop(s, agree);
+  KInduction kind(prop, rts, s);
+  EXPECT_EQ(kind.check_until(5), ProverResult::TRUE);
+}
+
+// the encoding with module templates matches the one of the flattened
+// design
+TEST_P(CoreIRHierarchyUnitTests, MatchesFlattening)
+{
+  SmtSolver s1 = create_solver(GetParam());
+  RelationalTransitionSystem rts1(s1);
+  CoreIREncoder ce1(filename, rts1);
+
+  CoreIR::Context * c = CoreIR::newContext();
+  c->getLibraryManager()->loadLib("commonlib");
+  CoreIR::Module * m;
+  ASSERT_TRUE(CoreIR::loadFromFile(c, filename, &m));
+  c->runPasses({ "rungenerators", "flatten" }, { "global" });
+  SmtSolver s2 = create_solver(GetParam());
+  RelationalTransitionSystem rts2(s2);
+  CoreIREncoder ce2(m, rts2);
+
+  ASSERT_EQ(rts1.statevars().size(), rts2.statevars().size());
+  ASSERT_EQ(rts1.inputvars().size(), rts2.inputvars().size());
+
+  TermTranslator tt(s1);
+  UnorderedTermMap & cache = tt.get_cache();
+  for (const auto & v : rts2.statevars()) {
+    Term v1 = rts1.lookup(v->to_string());
+    ASSERT_TRUE(rts1.is_curr_var(v1));
+    cache[v] = v1;
+    cache[rts2.next(v)] = rts1.next(v1);
+  }
+  for (const auto & v : rts2.inputvars()) {
+    Term v1 = rts1.lookup(v->to_string());
+    ASSERT_TRUE(rts1.is_input_var(v1));
+    cache[v] = v1;
+  }
+
+  TermVec lhs({ rts1.init(), rts1.trans() });
+  TermVec rhs({ tt.transfer_term(rts2.init(), BOOL),
+                tt.transfer_term(rts2.trans(), BOOL) });
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    s1->push();
+    s1->assert_formula(s1->make_term(Distinct, lhs[i], rhs[i]));
+    EXPECT_TRUE(s1->check_sat().is_unsat());
+    s1->pop();
+  }
+  CoreIR::deleteContext(c);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSolverCoreIRHierarchyUnitTests,
+                         CoreIRHierarchyUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedSolverCoreIRUnitTests,
     CoreIRUnitTests,
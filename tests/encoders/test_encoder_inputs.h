@@ -20,17 +20,24 @@ const vector<string> btor2_inputs({ "counter.btor",
                                     "array_neq.btor2",
                                     "ridecore.btor",
                                     "state2input.btor",
+                                    "unnamed-state.btor2",
                                     "WRITE_COUNTER.btor2" });
 
+// the same system in the ASCII and the binary format
+const vector<string> aiger_inputs({ "counter.aag", "counter.aig" });
+
 const vector<string> coreir_inputs({ "counters.json",
                                      "WrappedPE_nofloats.json",
-                                     "SimpleALU.json" });
+                                     "SimpleALU.json",
+                                     "hierarchy.json" });
 
 const unordered_map<string, pono::ProverResult> smv_inputs(
     { { "simple_counter.smv", pono::ProverResult::TRUE },
       { "simple_counter_integer.smv", pono::ProverResult::TRUE },
       { "simple_counter_integer_uf.smv", pono::ProverResult::FALSE },
       { "combined-false.smv", pono::ProverResult::FALSE },
-      { "combined-true.smv", pono::ProverResult::TRUE } });
+      { "combined-true.smv", pono::ProverResult::TRUE },
+      { "modules.smv", pono::ProverResult::TRUE },
+      { "parameters.smv", pono::ProverResult::TRUE } });
 
 }  // namespace pono_tests
@@ -1,7 +1,7 @@
 import pytest
 import smt_switch as ss
 from smt_switch.sortkinds import BV
-from smt_switch.primops import And, BVAdd, BVSub, Equal, Ite
+from smt_switch.primops import And, BVAdd, BVSub, BVUle, Equal, Ite
 import pono
 import available_solvers
 
@@ -63,6 +63,29 @@ def test_bmc(create_solver):
 
     assert res is None, "BMC shouldn't be able to solve"
 
+@pytest.mark.parametrize("create_solver", ss.solvers.values())
+def test_bmc_check_witness(create_solver):
+    s = create_solver(False)
+    s.set_opt('produce-models', 'true')
+    s.set_opt('incremental', 'true')
+    bvsort8 = s.make_sort(BV, 8)
+    fts = pono.FunctionalTransitionSystem(s)
+    x = fts.make_statevar('x', bvsort8)
+    fts.constrain_init(s.make_term(Equal, x, s.make_term(0, bvsort8)))
+    fts.assign_next(x, s.make_term(BVAdd, x, s.make_term(1, bvsort8)))
+    prop_term = s.make_term(BVUle, x, s.make_term(4, bvsort8))
+    prop = pono.Property(s, prop_term)
+
+    bmc = pono.Bmc(prop, fts, s)
+    res = bmc.check_until(10)
+    assert res is False, "BMC should find a counterexample"
+
+    witness = bmc.witness()
+    assert len(witness) == 6
+    assert pono.check_witness(fts, prop_term, witness)
+    # the property holds in the last step of a prefix
+    assert not pono.check_witness(fts, prop_term, witness[:-1])
+
 @pytest.mark.parametrize("create_solver", ss.solvers.values())
 def test_kind(create_solver):
     s = create_solver(False)
@@ -124,3 +147,19 @@ def test_kind_inductive_prop(create_solver):
     res = kind.check_until(10)
 
     assert res is True, "KInduction should be able to solve this manually strengthened property"
+
+@pytest.mark.parametrize("create_solver", ss.solvers.values())
+def test_statistics(create_solver):
+    s = create_solver(False)
+    s.set_opt('produce-models', 'true')
+    s.set_opt('incremental', 'true')
+    prop, ts = build_simple_alu_fts(s)
+
+    bmc = pono.Bmc(prop, ts, s)
+    res = bmc.check_until(3)
+    assert res is None
+
+    stats = bmc.statistics()
+    assert stats['reached_k'] == 3
+    assert stats['statevars'] == 3
+    assert stats['inputvars'] == 2
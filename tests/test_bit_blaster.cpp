@@ -0,0 +1,166 @@
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "core/fts.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "utils/bit_blaster.h"
+#include "utils/exceptions.h"
+#include "utils/term_evaluator.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+// evaluate every node of the AIG given the values of the input nodes
+// children are always created before their parents
+static vector<bool> simulate(const Aig & aig,
+                             const unordered_map<uint32_t, bool> & inputs)
+{
+  vector<bool> vals(aig.num_nodes(), false);
+  for (uint32_t n = 1; n < aig.num_nodes(); ++n) {
+    if (!aig.is_and(n)) {
+      vals[n] = inputs.at(n);
+      continue;
+    }
+    AigLit c0 = aig.child0(n);
+    AigLit c1 = aig.child1(n);
+    vals[n] = (vals[Aig::node(c0)] != Aig::is_negated(c0))
+              && (vals[Aig::node(c1)] != Aig::is_negated(c1));
+  }
+  return vals;
+}
+
+static mpz_class bits_value(const vector<bool> & vals, const AigBits & bits)
+{
+  mpz_class res = 0;
+  for (size_t i = 0; i < bits.size(); ++i) {
+    if (vals[Aig::node(bits[i])] != Aig::is_negated(bits[i])) {
+      mpz_setbit(res.get_mpz_t(), i);
+    }
+  }
+  return res;
+}
+
+class BitBlasterUnitTests : public ::testing::Test,
+                            public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override { s = create_solver(GetParam()); }
+  SmtSolver s;
+};
+
+TEST_P(BitBlasterUnitTests, MatchesEvaluator)
+{
+  mt19937_64 rng(0);
+  for (uint64_t width : { 1, 7, 16 }) {
+    FunctionalTransitionSystem fts(s);
+    Sort bvsort = fts.make_sort(BV, width);
+    Term a = fts.make_inputvar("a", bvsort);
+    Term b = fts.make_inputvar("b", bvsort);
+    Term c = fts.make_inputvar("c", fts.make_sort(BOOL));
+    Term one = fts.make_term(1, bvsort);
+
+    TermVec terms;
+    for (auto po : { BVAdd,  BVSub,  BVMul, BVShl,  BVLshr, BVAshr,
+                     BVAnd,  BVOr,   BVXor, BVNand, BVNor,  BVXnor,
+                     BVComp, BVUlt,  BVUle, BVUgt,  BVUge,  BVSlt,
+                     BVSle,  BVSgt,  BVSge, Equal,  Distinct, Concat }) {
+      terms.push_back(fts.make_term(po, a, b));
+    }
+    // small shift amounts
+    terms.push_back(fts.make_term(BVShl, a, fts.make_term(BVAnd, b, one)));
+    terms.push_back(fts.make_term(BVAshr, a, fts.make_term(BVAnd, b, one)));
+    terms.push_back(fts.make_term(BVNeg, a));
+    terms.push_back(fts.make_term(Op(Extract, width - 1, width / 2), a));
+    terms.push_back(fts.make_term(Op(Zero_Extend, 3), a));
+    terms.push_back(fts.make_term(Op(Sign_Extend, 5), a));
+    terms.push_back(fts.make_term(Op(Repeat, 2), a));
+    terms.push_back(fts.make_term(Op(Rotate_Left, 3), a));
+    terms.push_back(fts.make_term(Op(Rotate_Right, 2), a));
+    terms.push_back(fts.make_term(Ite, c, a, b));
+    terms.push_back(fts.make_term(
+        Xor, c, fts.make_term(Not, fts.make_term(BVSgt, a, b))));
+    terms.push_back(fts.make_term(Implies, c, fts.make_term(Equal, a, b)));
+
+    Aig aig;
+    BitBlaster bb(aig);
+    const AigBits a_bits = bb.make_input(a);
+    const AigBits b_bits = bb.make_input(b);
+    const AigBits c_bits = bb.make_input(c);
+    vector<AigBits> term_bits;
+    for (const auto & t : terms) {
+      ASSERT_TRUE(BitBlaster::is_supported(t));
+      term_bits.push_back(bb.bit_blast(t));
+    }
+
+    TermEvaluator evaluator(s);
+    for (size_t round = 0; round < 50; ++round) {
+      mpz_class mask = (mpz_class(1) << width) - 1;
+      // make sure corner cases are covered
+      mpz_class a_val = round == 1 ? mpz_class(0) : mpz_class(rng()) & mask;
+      mpz_class b_val = round == 0 ? mpz_class(0) : mpz_class(rng()) & mask;
+      bool c_val = rng() & 1;
+
+      unordered_map<uint32_t, bool> inputs;
+      for (size_t i = 0; i < width; ++i) {
+        inputs[Aig::node(a_bits[i])] = mpz_tstbit(a_val.get_mpz_t(), i);
+        inputs[Aig::node(b_bits[i])] = mpz_tstbit(b_val.get_mpz_t(), i);
+      }
+      inputs[Aig::node(c_bits[0])] = c_val;
+      vector<bool> vals = simulate(aig, inputs);
+
+      evaluator.set_assignment(
+          { { a, fts.make_term(a_val.get_str(10), bvsort, 10) },
+            { b, fts.make_term(b_val.get_str(10), bvsort, 10) },
+            { c, fts.make_term(c_val) } });
+      for (size_t i = 0; i < terms.size(); ++i) {
+        mpz_class expected;
+        ASSERT_TRUE(evaluator.evaluate(terms[i], expected));
+        EXPECT_EQ(expected, bits_value(vals, term_bits[i]))
+            << terms[i] << " with a = " << a_val << ", b = " << b_val;
+      }
+    }
+  }
+}
+
+TEST_P(BitBlasterUnitTests, StructuralHashing)
+{
+  Aig aig;
+  AigLit x = aig.make_input();
+  AigLit y = aig.make_input();
+  EXPECT_EQ(aig.make_and(x, y), aig.make_and(y, x));
+  EXPECT_EQ(aig.make_and(x, Aig::negate(x)), Aig::FALSE_LIT);
+  EXPECT_EQ(aig.make_and(x, Aig::TRUE_LIT), x);
+  EXPECT_EQ(aig.make_or(x, Aig::TRUE_LIT), Aig::TRUE_LIT);
+  EXPECT_EQ(aig.num_ands(), 1);
+}
+
+TEST_P(BitBlasterUnitTests, Unsupported)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  Term a = fts.make_inputvar("a", bvsort8);
+  Term b = fts.make_inputvar("b", bvsort8);
+  Term div = fts.make_term(BVUdiv, a, b);
+  EXPECT_FALSE(BitBlaster::is_supported(div));
+
+  Aig aig;
+  BitBlaster bb(aig);
+  bb.make_input(a);
+  bb.make_input(b);
+  EXPECT_THROW(bb.bit_blast(div), PonoException);
+
+  // symbols need bits before they can be used
+  Term c = fts.make_inputvar("c", bvsort8);
+  EXPECT_THROW(bb.bit_blast(fts.make_term(BVAdd, a, c)), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedBitBlasterUnitTests,
+                         BitBlasterUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
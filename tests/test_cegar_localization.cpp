@@ -0,0 +1,98 @@
+#include <vector>
+
+#include "core/fts.h"
+#include "engines/bmc.h"
+#include "engines/cegar_localization.h"
+#include "engines/kinduction.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class CegarLocalizationUnitTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    bvsort = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort bvsort;
+};
+
+/** z delays the counter x, y is unrelated to the property */
+static void delayed_counter(FunctionalTransitionSystem & fts,
+                            const Sort & bvsort,
+                            bool frozen)
+{
+  Term x = fts.make_statevar("x", bvsort);
+  Term y = fts.make_statevar("y", bvsort);
+  Term z = fts.make_statevar("z", bvsort);
+  Term in = fts.make_inputvar("in", bvsort);
+  Term zero = fts.make_term(0, bvsort);
+  fts.constrain_init(fts.make_term(Equal, x, zero));
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  fts.constrain_init(fts.make_term(Equal, z, zero));
+  fts.assign_next(
+      x,
+      frozen ? x : fts.make_term(BVAdd, x, fts.make_term(1, bvsort)));
+  fts.assign_next(y, fts.make_term(BVAdd, y, in));
+  fts.assign_next(z, x);
+}
+
+TEST_P(CegarLocalizationUnitTests, Safe)
+{
+  FunctionalTransitionSystem fts(s);
+  delayed_counter(fts, bvsort, true);
+  Term z = fts.named_terms().at("z");
+  Property p(s, fts.make_term(Equal, z, fts.make_term(0, bvsort)));
+
+  CegarLocalization<KInduction> cegloc(p, fts, s);
+  ASSERT_EQ(cegloc.check_until(5), ProverResult::TRUE);
+
+  // y is never needed
+  const UnorderedTermSet & visible = cegloc.visible();
+  EXPECT_EQ(visible.size(), 2);
+  EXPECT_TRUE(visible.find(fts.named_terms().at("y")) == visible.end());
+}
+
+TEST_P(CegarLocalizationUnitTests, Unsafe)
+{
+  for (bool pba : { false, true }) {
+    FunctionalTransitionSystem fts(s);
+    delayed_counter(fts, bvsort, false);
+    Term z = fts.named_terms().at("z");
+    Property p(s, fts.make_term(BVUlt, z, fts.make_term(3, bvsort)));
+
+    PonoOptions opts;
+    opts.ceg_loc_ = true;
+    opts.ceg_loc_pba_ = pba;
+    CegarLocalization<Bmc> cegloc(p, fts, s, opts);
+    ASSERT_EQ(cegloc.check_until(5), ProverResult::FALSE);
+    EXPECT_EQ(cegloc.visible().size(), 2);
+
+    // z is 3 after four steps
+    vector<UnorderedTermMap> cex;
+    ASSERT_TRUE(cegloc.witness(cex));
+    ASSERT_EQ(cex.size(), 5);
+    for (size_t i = 0; i < cex.size(); ++i) {
+      EXPECT_EQ(cex[i].at(fts.named_terms().at("x"))->to_string(),
+                s->make_term(i, bvsort)->to_string());
+    }
+    EXPECT_EQ(cex[4].at(z)->to_string(),
+              s->make_term(3, bvsort)->to_string());
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedCegarLocalizationUnitTests,
+                         CegarLocalizationUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
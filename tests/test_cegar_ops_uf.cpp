@@ -1,5 +1,7 @@
+#include "core/fts.h"
 #include "engines/cegar_ops_uf.h"
 #include "engines/ic3ia.h"
+#include "engines/ic3sa.h"
 #include "gtest/gtest.h"
 #include "smt/available_solvers.h"
 #include "utils/logger.h"
@@ -114,6 +116,44 @@ TEST(CegOpsUf, IntSimpleUnsafe)
 
 }
 
+// a = 2 and b = 3 are a cube, c = a * b is not
+FunctionalTransitionSystem mul_ts(SmtSolver s)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort sort = fts.make_sort(BV, 8);
+  Term a = fts.make_statevar("a", sort);
+  Term b = fts.make_statevar("b", sort);
+  Term c = fts.make_statevar("c", sort);
+  fts.constrain_init(fts.make_term(Equal, a, fts.make_term(2, sort)));
+  fts.constrain_init(fts.make_term(Equal, b, fts.make_term(3, sort)));
+  fts.constrain_init(fts.make_term(Equal, c, fts.make_term(BVMul, a, b)));
+  fts.assign_next(a, a);
+  fts.assign_next(b, b);
+  fts.assign_next(c, c);
+  return fts;
+}
+
+// the refinements constrain the initial states of the running IC3SA
+TEST(CegOpsUf, IC3SARefinesInit)
+{
+  SmtSolver s = create_solver(MSAT);
+  s->set_opt("produce-unsat-assumptions", "true");
+
+  FunctionalTransitionSystem fts = mul_ts(s);
+  Term c = fts.named_terms().at("c");
+  Term six = fts.make_term(6, c->get_sort());
+
+  Property safe(s, fts.make_term(Equal, c, six));
+  CegarOpsUf<IC3SA> ceg_safe(safe, fts, s);
+  ceg_safe.set_ops_to_abstract({ BVMul });
+  ASSERT_EQ(ceg_safe.check_until(5), ProverResult::TRUE);
+
+  Property unsafe(s, fts.make_term(Distinct, c, six));
+  CegarOpsUf<IC3SA> ceg_unsafe(unsafe, fts, s);
+  ceg_unsafe.set_ops_to_abstract({ BVMul });
+  ASSERT_EQ(ceg_unsafe.check_until(5), ProverResult::FALSE);
+}
+
 }  // namespace pono_tests
 
 #endif
@@ -2,6 +2,8 @@
 #include "gtest/gtest.h"
 #include "modifiers/static_coi.h"
 #include "smt/available_solvers.h"
+#include "utils/dependency_graph.h"
+#include "utils/exceptions.h"
 
 using namespace pono;
 using namespace smt;
@@ -58,6 +60,123 @@ TEST_P(CoiUnitTests, SimpleCoiTest)
   EXPECT_TRUE(inputvars.find(d) != inputvars.end());
   EXPECT_TRUE(named_terms.find("a") != named_terms.end());
   EXPECT_TRUE(named_terms.find("c") == named_terms.end());
+  // counter only occurs in init, it is removed with its init constraint
+  EXPECT_EQ(statevars.size(), 1);
+  EXPECT_TRUE(statevars.find(counter) == statevars.end());
+  EXPECT_TRUE(fts.only_curr(fts.init()));
+}
+
+TEST_P(CoiUnitTests, InitCoiTest)
+{
+  FunctionalTransitionSystem fts(s);
+
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term z = fts.make_statevar("z", bvsort8);
+  Term w = fts.make_statevar("w", bvsort8);
+  Term one = fts.make_term(1, bvsort8);
+  fts.assign_next(x, fts.make_term(BVAdd, x, one));
+  fts.assign_next(y, fts.make_term(BVAdd, y, w));
+  fts.assign_next(z, z);
+  fts.assign_next(w, w);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort8)));
+  // can be projected: y only occurs in this conjunct
+  fts.constrain_init(fts.make_term(Equal, y, x));
+  // relates z to the cone, z has to be kept
+  fts.constrain_init(fts.make_term(BVUlt, x, z));
+
+  StaticConeOfInfluence coi(fts, { fts.make_term(BVUle, x, one) });
+
+  const UnorderedTermSet & statevars = fts.statevars();
+  EXPECT_EQ(statevars.size(), 2);
+  EXPECT_TRUE(statevars.find(x) != statevars.end());
+  EXPECT_TRUE(statevars.find(z) != statevars.end());
+  EXPECT_TRUE(fts.only_curr(fts.init()));
+  EXPECT_EQ(fts.state_updates().size(), 2);
+}
+
+TEST_P(CoiUnitTests, InitConnectivityTest)
+{
+  FunctionalTransitionSystem fts(s);
+
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term z = fts.make_statevar("z", bvsort8);
+  Term u = fts.make_statevar("u", bvsort8);
+  Term v = fts.make_statevar("v", bvsort8);
+  Term one = fts.make_term(1, bvsort8);
+  fts.assign_next(x, fts.make_term(BVAdd, x, one));
+  for (const auto & sv : { y, z, u, v }) {
+    fts.assign_next(sv, sv);
+  }
+  // y is related to the cone, and z to y
+  fts.constrain_init(fts.make_term(BVUlt, x, y));
+  fts.constrain_init(fts.make_term(BVUlt, y, z));
+  // not connected to the cone
+  fts.constrain_init(fts.make_term(BVUlt, u, v));
+
+  StaticConeOfInfluence coi(fts, { fts.make_term(BVUle, x, one) });
+
+  const UnorderedTermSet & statevars = fts.statevars();
+  EXPECT_EQ(statevars.size(), 3);
+  EXPECT_TRUE(statevars.find(y) != statevars.end());
+  EXPECT_TRUE(statevars.find(z) != statevars.end());
+  EXPECT_TRUE(statevars.find(u) == statevars.end());
+  EXPECT_TRUE(statevars.find(v) == statevars.end());
+  EXPECT_TRUE(fts.only_curr(fts.init()));
+}
+
+TEST_P(CoiUnitTests, RebuildRequiresReducedInit)
+{
+  FunctionalTransitionSystem fts(s);
+
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  fts.assign_next(x, x);
+  fts.assign_next(y, y);
+  fts.constrain_init(fts.make_term(Equal, x, y));
+
+  EXPECT_THROW(fts.rebuild_trans_based_on_coi({ x }, {}), PonoException);
+  // the system is left unchanged
+  EXPECT_EQ(fts.statevars().size(), 2);
+  EXPECT_EQ(fts.state_updates().size(), 2);
+}
+
+TEST_P(CoiUnitTests, DependencyGraphTest)
+{
+  FunctionalTransitionSystem fts(s);
+
+  Term in = fts.make_inputvar("in", bvsort8);
+  Term c = fts.make_inputvar("c", boolsort);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term z = fts.make_statevar("z", bvsort8);
+  fts.assign_next(x, fts.make_term(BVAdd, y, in));
+  fts.assign_next(y, y);
+  fts.assign_next(z, x);
+  fts.add_constraint(c);
+
+  DependencyGraph graph(fts);
+  EXPECT_EQ(graph.num_vars(), 5);
+  EXPECT_EQ(graph.dependencies(graph.id(x)).size(), 2);
+  EXPECT_EQ(graph.dependencies(graph.id(in)).size(), 0);
+  EXPECT_EQ(graph.constraint_vars().size(), 1);
+  EXPECT_THROW(graph.id(fts.next(x)), PonoException);
+
+  vector<size_t> cone = graph.cone({ graph.id(x) }, false);
+  EXPECT_EQ(cone.size(), 3);
+  EXPECT_EQ(cone[0], graph.id(x));
+
+  // queries are independent of each other
+  UnorderedTermSet statevars, inputvars;
+  graph.cone({ z }, statevars, inputvars);
+  EXPECT_EQ(statevars.size(), 3);
+  EXPECT_EQ(inputvars.size(), 2);
+  statevars.clear();
+  inputvars.clear();
+  graph.cone({ y }, statevars, inputvars);
+  EXPECT_EQ(statevars.size(), 1);
+  EXPECT_EQ(inputvars.size(), 1);
 }
 
 INSTANTIATE_TEST_SUITE_P(ParameterizedCoiUnitTests,
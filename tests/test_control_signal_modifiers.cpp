@@ -6,6 +6,8 @@
 #include "engines/bmc.h"
 #include "gtest/gtest.h"
 #include "modifiers/control_signals.h"
+#include "modifiers/phase_abstractor.h"
+#include "modifiers/reset_folder.h"
 #include "smt/available_solvers.h"
 #include "utils/exceptions.h"
 
@@ -114,6 +116,102 @@ TEST_P(ControlUnitTests, SimpleClock)
             ProverResult::UNKNOWN);  // bmc can't prove, will only say unknown
 }
 
+TEST_P(ControlUnitTests, PhaseAbstraction)
+{
+  FunctionalTransitionSystem fts(s);
+  Term clk = fts.make_inputvar("clk", boolsort);
+  Term in = fts.make_inputvar("in", bvsort8);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term zero = fts.make_term(0, bvsort8);
+  fts.constrain_init(fts.make_term(Equal, x, zero));
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  // x counts at the high phase, y latches the input in the low phase
+  fts.assign_next(
+      x,
+      fts.make_term(
+          Ite, clk, fts.make_term(BVAdd, x, fts.make_term(1, bvsort8)), x));
+  fts.assign_next(y, fts.make_term(Ite, clk, y, in));
+
+  // the clock has to be an input or a state variable without an update
+  EXPECT_THROW(PhaseAbstractor(fts, x), PonoException);
+
+  PhaseAbstractor pa(fts, clk);
+  const TransitionSystem & abs_ts = pa.abs_ts();
+  EXPECT_EQ(abs_ts.statevars().size(), 2);
+  // the clock, the input and its copy for the high phase
+  EXPECT_EQ(abs_ts.inputvars().size(), 3);
+
+  // x is 3 after three cycles, i.e. six steps with a toggled clock
+  Term prop = pa.abstract_prop(
+      fts.make_term(BVUlt, x, fts.make_term(3, bvsort8)));
+  Property p(s, prop);
+  Bmc bmc(p, abs_ts, s);
+  ASSERT_EQ(bmc.check_until(2), ProverResult::UNKNOWN);
+  ASSERT_EQ(bmc.check_until(3), ProverResult::FALSE);
+
+  vector<UnorderedTermMap> abs_cex;
+  ASSERT_TRUE(bmc.witness(abs_cex));
+  vector<UnorderedTermMap> cex = pa.expand_witness(abs_cex);
+  ASSERT_EQ(cex.size(), 2 * abs_cex.size());
+  for (size_t i = 0; i < cex.size(); ++i) {
+    EXPECT_EQ(cex[i].at(clk), s->make_term(i % 2 == 1));
+    EXPECT_TRUE(cex[i].find(in) != cex[i].end());
+  }
+  // x is unchanged by the low phase, y latches the input
+  EXPECT_EQ(cex[1].at(x)->to_string(), cex[0].at(x)->to_string());
+  EXPECT_EQ(cex[1].at(y)->to_string(), cex[0].at(in)->to_string());
+  EXPECT_EQ(cex[6].at(x)->to_string(),
+            s->make_term(3, bvsort8)->to_string());
+}
+
+TEST_P(ControlUnitTests, ResetFolding)
+{
+  FunctionalTransitionSystem fts(s);
+  Term rst = fts.make_inputvar("rst", boolsort);
+  Term in = fts.make_inputvar("in", bvsort8);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  // x counts from the reset, y latches the input during reset
+  fts.assign_next(
+      x,
+      fts.make_term(Ite,
+                    rst,
+                    fts.make_term(0, bvsort8),
+                    fts.make_term(BVAdd, x, fts.make_term(1, bvsort8))));
+  fts.assign_next(y, fts.make_term(Ite, rst, in, y));
+
+  // the reset has to be an input
+  EXPECT_THROW(ResetFolder(fts, fts.make_term(Equal, x, y), 2),
+               PonoException);
+
+  ResetFolder rf(fts, rst, 2);
+  const TransitionSystem & folded_ts = rf.folded_ts();
+  // x is constant after reset, y is related to a frozen copy of the
+  // input in the last reset step
+  EXPECT_EQ(folded_ts.statevars().size(), 3);
+
+  Term prop = fts.make_term(BVUlt, x, fts.make_term(3, bvsort8));
+  Property p(s, prop);
+  Bmc bmc(p, folded_ts, s);
+  ASSERT_EQ(bmc.check_until(2), ProverResult::UNKNOWN);
+  ASSERT_EQ(bmc.check_until(3), ProverResult::FALSE);
+
+  vector<UnorderedTermMap> folded_cex;
+  ASSERT_TRUE(bmc.witness(folded_cex));
+  vector<UnorderedTermMap> cex = rf.expand_witness(folded_cex);
+  ASSERT_EQ(cex.size(), folded_cex.size() + 2);
+  for (size_t i = 0; i < cex.size(); ++i) {
+    EXPECT_EQ(cex[i].at(rst), s->make_term(i < 2));
+  }
+  EXPECT_EQ(cex[2].at(x)->to_string(), s->make_term(0, bvsort8)->to_string());
+  EXPECT_EQ(cex[2].at(y)->to_string(), cex[1].at(in)->to_string());
+
+  // x is 0 after every reset sequence
+  folded_cex[0][x] = s->make_term(5, bvsort8);
+  EXPECT_THROW(rf.expand_witness(folded_cex), PonoException);
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedControlUnitTests,
                          ControlUnitTests,
                          testing::ValuesIn(available_solver_enums()));
@@ -8,6 +8,9 @@
 #include "engines/bmc_simplepath.h"
 #include "engines/interpolantmc.h"
 #include "engines/kinduction.h"
+#include "engines/sim_bmc.h"
+#include "engines/pdkind.h"
+#include "engines/sat_bmc.h"
 #include "gtest/gtest.h"
 #include "smt/available_solvers.h"
 #include "tests/common_ts.h"
@@ -80,6 +83,72 @@ TEST_P(EngineUnitTests, BmcFalse)
   ASSERT_EQ(r, ProverResult::FALSE);
 }
 
+TEST_P(EngineUnitTests, BmcAdaptiveStepFalse)
+{
+  SmtSolver s = create_solver(se);
+  PonoOptions opts;
+  opts.bmc_adaptive_step_ = true;
+  Bmc b(*false_p, *ts, s, opts);
+  ProverResult r = b.check_until(20);
+  ASSERT_EQ(r, ProverResult::FALSE);
+
+  // shortest counterexample is still found inside the interval
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(b.witness(witness));
+  ASSERT_EQ(witness.size(), 8);
+}
+
+TEST_P(EngineUnitTests, SimBmcFalse)
+{
+  SmtSolver s = create_solver(se);
+  PonoOptions opts;
+  // too short to find the bug from the initial states
+  opts.sim_bmc_window_ = 2;
+  opts.sim_bmc_sim_steps_ = 3;
+  SimBmc sb(*false_p, *ts, s, opts);
+  ProverResult r = sb.check_until(20);
+  ASSERT_EQ(r, ProverResult::FALSE);
+
+  // witness is stitched together from simulation and a window
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(sb.witness(witness));
+  ASSERT_EQ(witness.size(), 8);
+  Term x = ts->named_terms().at("x");
+  ASSERT_EQ(witness[0][x], ts->make_term(0, bvsort8));
+  ASSERT_EQ(witness[7][x], ts->make_term(7, bvsort8));
+}
+
+TEST_P(EngineUnitTests, SatBmcTrue)
+{
+  SmtSolver s = create_solver(se);
+  SatBmc sb(*true_p, *ts, s);
+  if (!ts->is_functional()) {
+    ASSERT_THROW(sb.check_until(20), PonoException);
+    return;
+  }
+  ProverResult r = sb.check_until(20);
+  ASSERT_EQ(r, ProverResult::UNKNOWN);
+}
+
+TEST_P(EngineUnitTests, SatBmcFalse)
+{
+  if (!ts->is_functional()) {
+    return;
+  }
+  SmtSolver s = create_solver(se);
+  SatBmc sb(*false_p, *ts, s);
+  ProverResult r = sb.check_until(20);
+  ASSERT_EQ(r, ProverResult::FALSE);
+
+  // witness is read back from the SAT model
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(sb.witness(witness));
+  ASSERT_EQ(witness.size(), 8);
+  Term x = ts->named_terms().at("x");
+  ASSERT_EQ(witness[0][x], ts->make_term(0, bvsort8));
+  ASSERT_EQ(witness[7][x], ts->make_term(7, bvsort8));
+}
+
 TEST_P(EngineUnitTests, BmcSimplePathTrue)
 {
   SmtSolver s = create_solver(se);
@@ -149,6 +218,57 @@ TEST_P(InterpUnitTest, InterpFalse)
   ASSERT_EQ(r, ProverResult::FALSE);
 }
 
+TEST_P(InterpUnitTest, PdKindTrue)
+{
+  PdKind pdkind(*true_p, *ts, s);
+  ProverResult r = pdkind.check_until(20);
+  ASSERT_EQ(r, ProverResult::TRUE);
+
+  Term invar = pdkind.invar();
+  ASSERT_TRUE(check_invar(*ts, true_p->prop(), invar));
+}
+
+TEST_P(InterpUnitTest, PdKindDeep)
+{
+  // shift register where a 1 can never enter
+  // the property !a is 3-inductive but not 1-inductive
+  FunctionalTransitionSystem fts(s);
+  Sort boolsort = fts.make_sort(BOOL);
+  Term a = fts.make_statevar("a", boolsort);
+  Term b = fts.make_statevar("b", boolsort);
+  Term c = fts.make_statevar("c", boolsort);
+  Term false_ = fts.make_term(false);
+  fts.constrain_init(fts.make_term(Not, a));
+  fts.constrain_init(fts.make_term(Not, b));
+  fts.constrain_init(fts.make_term(Not, c));
+  fts.assign_next(a, b);
+  fts.assign_next(b, c);
+  fts.assign_next(c, false_);
+  Property p(s, fts.make_term(Not, a));
+
+  PdKind pdkind(p, fts, s);
+  ProverResult r = pdkind.check_until(20);
+  ASSERT_EQ(r, ProverResult::TRUE);
+
+  // the lemmas blocking b and c are learned in the first push
+  // which makes the frame 1-inductive
+  Term invar = pdkind.invar();
+  ASSERT_TRUE(invar);
+  ASSERT_TRUE(check_invar(fts, p.prop(), invar));
+}
+
+TEST_P(InterpUnitTest, PdKindFalse)
+{
+  PdKind pdkind(*false_p, *ts, s);
+  ProverResult r = pdkind.check_until(20);
+  ASSERT_EQ(r, ProverResult::FALSE);
+
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(pdkind.witness(witness));
+  // counter reaches 7 after 7 steps
+  ASSERT_EQ(witness.size(), 8);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedInterpUnitTest,
     InterpUnitTest,
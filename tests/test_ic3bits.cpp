@@ -62,6 +62,81 @@ TEST_P(IC3BitsUnitTests, CounterSystemSafe)
   ASSERT_TRUE(check_invar(fts, prop_term, invar));
 }
 
+TEST_P(IC3BitsUnitTests, Statistics)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+  Property p(s, s->make_term(BVUle, x, max_val));
+
+  IC3Bits ic3bits(p, fts, s);
+  ASSERT_EQ(ic3bits.prove(), TRUE);
+
+  ProverStatistics stats = ic3bits.statistics();
+  const auto & counters = stats.counters;
+  ASSERT_GT(counters.at("frames"), 1);
+  int64_t num_lemmas = 0;
+  for (int64_t i = 0; i < counters.at("frames"); ++i) {
+    num_lemmas += counters.at("lemmas_frame_" + std::to_string(i));
+  }
+  EXPECT_EQ(counters.at("lemmas"), num_lemmas);
+  EXPECT_GT(counters.at("sat_checks"), 0);
+  EXPECT_GT(counters.at("proof_goals"), 0);
+  EXPECT_EQ(counters.at("refinements"), 0);
+  EXPECT_GE(counters.at("reached_k"), 0);
+  EXPECT_EQ(counters.at("statevars"), 1);
+  // init is x = 0, all checks against init are syntactic
+  EXPECT_GT(counters.at("init_syntactic_checks"), 0);
+  EXPECT_EQ(counters.at("init_cache_queries"), 0);
+}
+
+TEST_P(IC3BitsUnitTests, InitIntersectionCache)
+{
+  Term a = s->make_symbol("a", boolsort);
+  Term b = s->make_symbol("b", boolsort);
+  Term c = s->make_symbol("c", boolsort);
+
+  InitIntersectionCache cache;
+  bool intersects;
+  EXPECT_FALSE(cache.lookup({ a, b }, intersects));
+  cache.add({ a, b }, false);
+  cache.add({ c }, true);
+
+  // more literals than a non-intersecting cube
+  ASSERT_TRUE(cache.lookup({ c, b, a }, intersects));
+  EXPECT_FALSE(intersects);
+  // fewer literals than an intersecting cube
+  cache.add({ a, c }, true);
+  ASSERT_TRUE(cache.lookup({ a }, intersects));
+  EXPECT_TRUE(intersects);
+  // unrelated
+  EXPECT_FALSE(cache.lookup({ b, c }, intersects));
+  EXPECT_EQ(cache.num_queries(), 4);
+  EXPECT_EQ(cache.num_hits(), 2);
+
+  // same result with and without the cache
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+  Property p(s, s->make_term(BVUle, x, max_val));
+  for (bool use_cache : { true, false }) {
+    PonoOptions opts;
+    opts.ic3_init_cache_ = use_cache;
+    SmtSolver ic3_solver = create_solver_for(GetParam(), IC3_BITS, false);
+    IC3Bits ic3bits(p, fts, ic3_solver, opts);
+    ASSERT_EQ(ic3bits.prove(), TRUE);
+    ASSERT_TRUE(check_invar(fts, p.prop(), ic3bits.invar()));
+    ProverStatistics stats = ic3bits.statistics();
+    EXPECT_LE(stats.counters.at("init_cache_hits"),
+              stats.counters.at("init_cache_queries"));
+    if (!use_cache) {
+      EXPECT_EQ(stats.counters.at("init_cache_queries"), 0);
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedSolverIC3BitsUnitTests,
     IC3BitsUnitTests,
@@ -133,6 +133,59 @@ TEST_P(IC3SAUnitTests, SimpleCounterVar)
   ASSERT_EQ(r, ProverResult::FALSE);
 }
 
+// exposes the init cube of IC3Base
+class IC3SAInitCube : public IC3SA
+{
+ public:
+  IC3SAInitCube(const Property & p,
+                const TransitionSystem & ts,
+                const SmtSolver & s)
+      : IC3SA(p, ts, s)
+  {
+  }
+
+  using IC3SA::constrain_init;
+  using IC3SA::initialize;
+
+  bool init_is_cube() const { return init_is_cube_; }
+
+  /** @return false iff a literal conflicts with the init cube */
+  bool check_literals(const TermVec & cube)
+  {
+    TermVec rest;
+    return check_init_cube_literals(cube, rest);
+  }
+};
+
+TEST_P(IC3SAUnitTests, ConstrainInitUpdatesCube)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term zero = fts.make_term(0, bvsort8);
+  Term five = fts.make_term(5, bvsort8);
+  fts.set_init(fts.make_term(Equal, x, zero));
+  fts.assign_next(x, fts.make_term(BVAdd, x, y));
+  fts.assign_next(y, y);
+
+  Property p(s, fts.make_term(BVUle, x, five));
+  IC3SAInitCube ic3sa(p, fts, s);
+  ic3sa.initialize();
+  ASSERT_TRUE(ic3sa.init_is_cube());
+  // y is not initialized yet
+  Term y_eq_3 = fts.make_term(Equal, y, fts.make_term(3, bvsort8));
+  EXPECT_TRUE(ic3sa.check_literals({ y_eq_3 }));
+
+  // still a cube, with a value for y
+  ic3sa.constrain_init(fts.make_term(Equal, y, five));
+  ASSERT_TRUE(ic3sa.init_is_cube());
+  EXPECT_FALSE(ic3sa.check_literals({ y_eq_3 }));
+
+  ic3sa.constrain_init(fts.make_term(BVUle, x, y));
+  EXPECT_FALSE(ic3sa.init_is_cube());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedSolverIC3SAUnitTests,
     IC3SAUnitTests,
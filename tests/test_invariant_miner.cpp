@@ -0,0 +1,146 @@
+#include <vector>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "engines/kinduction.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+#include "utils/invariant_miner.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class InvariantMinerUnitTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    fts = new FunctionalTransitionSystem(s);
+    bvsort4 = fts->make_sort(BV, 4);
+    bvsort8 = fts->make_sort(BV, 8);
+
+    // two counters that always agree
+    a = fts->make_statevar("a", bvsort4);
+    b = fts->make_statevar("b", bvsort4);
+    // a register that is never set
+    c = fts->make_statevar("c", fts->make_sort(BOOL));
+    // a one-hot ring
+    h = fts->make_statevar("h", bvsort4);
+    // a counter saturating at 5
+    sat = fts->make_statevar("sat", bvsort8);
+    // a counter that is only bounded in short simulations
+    x = fts->make_statevar("x", bvsort8);
+
+    Term one4 = fts->make_term(1, bvsort4);
+    Term zero8 = fts->make_term(0, bvsort8);
+    Term one8 = fts->make_term(1, bvsort8);
+    Term five8 = fts->make_term(5, bvsort8);
+    fts->constrain_init(fts->make_term(Equal, a, fts->make_term(0, bvsort4)));
+    fts->constrain_init(fts->make_term(Equal, b, fts->make_term(0, bvsort4)));
+    fts->constrain_init(fts->make_term(Not, c));
+    fts->constrain_init(fts->make_term(Equal, h, one4));
+    fts->constrain_init(fts->make_term(Equal, sat, zero8));
+    fts->constrain_init(fts->make_term(Equal, x, zero8));
+    fts->assign_next(a, fts->make_term(BVAdd, a, one4));
+    fts->assign_next(b, fts->make_term(BVAdd, b, one4));
+    fts->assign_next(c, c);
+    fts->assign_next(h, fts->make_term(Op(Rotate_Left, 1), h));
+    fts->assign_next(sat,
+                     fts->make_term(Ite,
+                                    fts->make_term(BVUlt, sat, five8),
+                                    fts->make_term(BVAdd, sat, one8),
+                                    sat));
+    fts->assign_next(x, fts->make_term(BVAdd, x, one8));
+  }
+
+  void TearDown() override { delete fts; }
+
+  /** @return true iff the conjunction of invs implies t */
+  bool implies(const TermVec & invs, const Term & t)
+  {
+    s->push();
+    for (const auto & inv : invs) {
+      s->assert_formula(inv);
+    }
+    s->assert_formula(s->make_term(Not, t));
+    Result r = s->check_sat();
+    s->pop();
+    return r.is_unsat();
+  }
+
+  SmtSolver s;
+  FunctionalTransitionSystem * fts;
+  Sort bvsort4, bvsort8;
+  Term a, b, c, h, sat, x;
+};
+
+TEST_P(InvariantMinerUnitTests, Validate)
+{
+  InvariantMiner miner(*fts, 1);
+  // too short for x to wrap around
+  ASSERT_GT(miner.mine(10), 0);
+  Term x_bound = fts->make_term(BVUle, x, fts->make_term(9, bvsort8));
+  EXPECT_TRUE(implies(miner.candidates(), x_bound));
+
+  TermVec invs = miner.validate();
+  EXPECT_LT(invs.size(), miner.candidates().size());
+  EXPECT_TRUE(implies(invs, fts->make_term(Equal, a, b)));
+  EXPECT_TRUE(implies(invs, fts->make_term(Not, c)));
+  EXPECT_TRUE(
+      implies(invs, fts->make_term(BVUle, sat, fts->make_term(5, bvsort8))));
+  EXPECT_TRUE(
+      implies(invs, fts->make_term(Distinct, h, fts->make_term(3, bvsort4))));
+  EXPECT_FALSE(implies(invs, x_bound));
+
+  // the conjunction is inductive
+  Term inv = s->make_term(true);
+  for (const auto & i : invs) {
+    inv = s->make_term(And, inv, i);
+  }
+  s->push();
+  s->assert_formula(fts->init());
+  EXPECT_TRUE(implies({}, inv));
+  s->pop();
+  s->push();
+  s->assert_formula(fts->trans());
+  EXPECT_TRUE(implies({ inv }, fts->next(inv)));
+  s->pop();
+}
+
+TEST_P(InvariantMinerUnitTests, KInductionStrengthened)
+{
+  // not k-inductive for small k without the one-hot invariant
+  Property p(s, fts->make_term(Distinct, h, fts->make_term(3, bvsort4)));
+
+  SmtSolver s1 = create_solver(GetParam());
+  KInduction kind(p, *fts, s1);
+  ASSERT_EQ(kind.check_until(1), ProverResult::UNKNOWN);
+
+  PonoOptions opts;
+  opts.mine_invariants_ = 100;
+  SmtSolver s2 = create_solver(GetParam());
+  KInduction kind_mined(p, *fts, s2, opts);
+  ASSERT_EQ(kind_mined.check_until(1), ProverResult::TRUE);
+}
+
+TEST_P(InvariantMinerUnitTests, Relational)
+{
+  RelationalTransitionSystem rts(s);
+  Term y = rts.make_statevar("y", bvsort8);
+  rts.set_init(rts.make_term(Equal, y, rts.make_term(0, bvsort8)));
+  rts.set_trans(rts.make_term(BVUge, rts.next(y), y));
+  EXPECT_THROW(InvariantMiner miner(rts), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedInvariantMinerUnitTests,
+                         InvariantMinerUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
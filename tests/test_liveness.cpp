@@ -0,0 +1,141 @@
+#include <utility>
+#include <vector>
+
+#include "core/fts.h"
+#include "engines/bmc.h"
+#include "engines/kliveness.h"
+#include "gtest/gtest.h"
+#include "modifiers/liveness_to_safety.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class LivenessUnitTests : public ::testing::Test,
+                          public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver_for(GetParam(), IC3_BITS, false);
+    bvsort8 = s->make_sort(BV, 8);
+  }
+
+  // counter that stops at 10
+  Term saturating_counter(FunctionalTransitionSystem & fts)
+  {
+    Term x = fts.make_statevar("x", bvsort8);
+    Term max_val = fts.make_term(10, bvsort8);
+    fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort8)));
+    fts.assign_next(
+        x,
+        fts.make_term(Ite,
+                      fts.make_term(BVUlt, x, max_val),
+                      fts.make_term(BVAdd, x, fts.make_term(1, bvsort8)),
+                      x));
+    return x;
+  }
+
+  Term equals(const Term & x, int val)
+  {
+    return s->make_term(Equal, x, s->make_term(val, bvsort8));
+  }
+
+  SmtSolver s;
+  Sort bvsort8;
+};
+
+TEST_P(LivenessUnitTests, KLivenessSignalOnce)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = saturating_counter(fts);
+
+  // the signal is true once, the bound 0 fails and bound 1 holds
+  Property p(s, s->make_term(Not, equals(x, 5)));
+  KLiveness klive(p, fts, s);
+  ASSERT_EQ(klive.check_until(5), ProverResult::TRUE);
+}
+
+TEST_P(LivenessUnitTests, KLivenessSignalNever)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = saturating_counter(fts);
+
+  Property p(s, s->make_term(Not, equals(x, 20)));
+  KLiveness klive(p, fts, s);
+  ASSERT_EQ(klive.check_until(5), ProverResult::TRUE);
+}
+
+TEST_P(LivenessUnitTests, KLivenessSignalInfinitelyOften)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(10, bvsort8));
+  Term x = fts.named_terms().at("x");
+
+  // k-liveness cannot find counterexamples
+  Property p(s, s->make_term(Not, equals(x, 7)));
+  KLiveness klive(p, fts, s);
+  ASSERT_EQ(klive.check_until(2), ProverResult::UNKNOWN);
+}
+
+TEST_P(LivenessUnitTests, LivenessToSafety)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(10, bvsort8));
+  Term x = fts.named_terms().at("x");
+
+  Term prop = liveness_to_safety(fts, equals(x, 7));
+  EXPECT_TRUE(fts.only_curr(prop));
+  Property p(s, prop);
+  Bmc bmc(p, fts, s);
+  // the lasso has to go around the counter once
+  ASSERT_EQ(bmc.check_until(25), ProverResult::FALSE);
+}
+
+TEST_P(LivenessUnitTests, LivenessToSafetyNoLasso)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = saturating_counter(fts);
+
+  Term prop = liveness_to_safety(fts, equals(x, 5));
+  Property p(s, prop);
+  Bmc bmc(p, fts, s);
+  ASSERT_EQ(bmc.check_until(15), ProverResult::UNKNOWN);
+}
+
+TEST_P(LivenessUnitTests, CombineJustice)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(10, bvsort8));
+  Term x = fts.named_terms().at("x");
+
+  EXPECT_THROW(combine_justice(fts, {}, {}), PonoException);
+  Term single = equals(x, 3);
+  EXPECT_EQ(combine_justice(fts, { single }, {}), single);
+
+  // both signals are true infinitely often
+  Term signal = combine_justice(fts, { equals(x, 3) }, { equals(x, 7) });
+  Property p(s, liveness_to_safety(fts, signal));
+  Bmc bmc(p, fts, s);
+  ASSERT_EQ(bmc.check_until(25), ProverResult::FALSE);
+
+  // the second one never is
+  FunctionalTransitionSystem fts2(s);
+  counter_system(fts2, fts2.make_term(10, bvsort8));
+  Term x2 = fts2.named_terms().at("x");
+  Term signal2 = combine_justice(fts2, { equals(x2, 3), equals(x2, 20) }, {});
+  Property p2(s, s->make_term(Not, signal2));
+  KLiveness klive(p2, fts2, s);
+  ASSERT_EQ(klive.check_until(5), ProverResult::TRUE);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedLivenessUnitTests,
+                         LivenessUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
@@ -7,6 +7,7 @@
 #include "modifiers/history_modifier.h"
 #include "modifiers/implicit_predicate_abstractor.h"
 #include "modifiers/prophecy_modifier.h"
+#include "modifiers/register_sweeping.h"
 #include "smt-switch/utils.h"
 #include "smt/available_solvers.h"
 #include "tests/common_ts.h"
@@ -138,6 +139,94 @@ TEST_P(ModifierUnitTests, ImplicitPredicateAbstractor)
   EXPECT_TRUE(r.is_unsat());  // expecting it to be inductive now
 }
 
+TEST_P(ModifierUnitTests, RegisterSweeping)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+  Term zero = fts.make_term(0, bvsort);
+  Term one = fts.make_term(1, bvsort);
+
+  // same sequence of values as x
+  Term y = fts.make_statevar("y", bvsort);
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  fts.assign_next(
+      y,
+      fts.make_term(Ite,
+                    fts.make_term(BVUlt, y, max_val),
+                    fts.make_term(BVAdd, y, one),
+                    zero));
+  // stuck at its reset value
+  Term c = fts.make_statevar("c", bvsort);
+  fts.constrain_init(fts.make_term(Equal, c, one));
+  fts.assign_next(c, fts.make_term(BVMul, c, c));
+  // candidate from simulation that is not inductive
+  Term z = fts.make_statevar("z", bvsort);
+  fts.constrain_init(fts.make_term(Equal, z, zero));
+  fts.assign_next(
+      z, fts.make_term(Ite, fts.make_term(Equal, x, max_val), one, z));
+  Term in = fts.make_inputvar("in", bvsort);
+  fts.add_constraint(fts.make_term(BVUle, in, c));
+
+  Term c_next = fts.next(c);
+  UnorderedTermMap subst = sweep_registers(fts, 5);
+  EXPECT_EQ(subst.size(), 2);
+  EXPECT_EQ(subst.at(c), one);
+  EXPECT_TRUE(fts.is_curr_var(x) || fts.is_curr_var(y));
+  EXPECT_FALSE(fts.is_curr_var(x) && fts.is_curr_var(y));
+  EXPECT_FALSE(fts.is_curr_var(c));
+  EXPECT_TRUE(fts.is_curr_var(z));
+  EXPECT_EQ(fts.statevars().size(), 2);
+  EXPECT_EQ(fts.state_updates().size(), 2);
+
+  // the constraint is rewritten too
+  UnorderedTermSet free_vars;
+  get_free_symbolic_consts(fts.constraints()[0].first, free_vars);
+  EXPECT_TRUE(free_vars.find(c) == free_vars.end());
+  free_vars.clear();
+  get_free_symbolic_consts(fts.trans(), free_vars);
+  get_free_symbolic_consts(fts.init(), free_vars);
+  EXPECT_TRUE(free_vars.find(c) == free_vars.end());
+  EXPECT_TRUE(free_vars.find(c_next) == free_vars.end());
+}
+
+TEST_P(ModifierUnitTests, RegisterSweepingClasses)
+{
+  FunctionalTransitionSystem fts(s);
+  Term zero = fts.make_term(0, bvsort);
+  Term one = fts.make_term(1, bvsort);
+
+  // three registers with the same values and a toggling bit with its
+  // complement, every replacement is a single remaining representative
+  TermVec regs;
+  for (auto name : { "r0", "r1", "r2" }) {
+    Term r = fts.make_statevar(name, bvsort);
+    fts.constrain_init(fts.make_term(Equal, r, zero));
+    fts.assign_next(r, fts.make_term(BVAdd, r, one));
+    regs.push_back(r);
+  }
+  Term b = fts.make_statevar("b", boolsort);
+  Term nb = fts.make_statevar("nb", boolsort);
+  fts.constrain_init(b);
+  fts.constrain_init(fts.make_term(Not, nb));
+  fts.assign_next(b, fts.make_term(Not, b));
+  fts.assign_next(nb, fts.make_term(Not, nb));
+
+  UnorderedTermMap subst = sweep_registers(fts, 5);
+  EXPECT_EQ(subst.size(), 3);
+  EXPECT_EQ(fts.statevars().size(), 2);
+  for (const auto & elem : subst) {
+    EXPECT_FALSE(fts.is_curr_var(elem.first));
+    UnorderedTermSet free_vars;
+    get_free_symbolic_consts(elem.second, free_vars);
+    EXPECT_EQ(free_vars.size(), 1);
+    for (const auto & v : free_vars) {
+      EXPECT_TRUE(fts.is_curr_var(v));
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedModifierUnitTests,
                          ModifierUnitTests,
                          testing::ValuesIn(available_solver_enums()));
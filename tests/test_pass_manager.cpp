@@ -0,0 +1,121 @@
+#include <string>
+#include <vector>
+
+#include "core/fts.h"
+#include "gtest/gtest.h"
+#include "modifiers/mod_ts_prop.h"
+#include "modifiers/static_coi.h"
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+#include "utils/pass_manager.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class PassManagerUnitTests : public ::testing::Test,
+                             public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    bvsort = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort bvsort;
+};
+
+TEST_P(PassManagerUnitTests, Pipeline)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort);
+  Term y = fts.make_statevar("y", bvsort);
+  Term in = fts.make_inputvar("in", bvsort);
+  Term zero = fts.make_term(0, bvsort);
+  fts.constrain_init(fts.make_term(Equal, x, zero));
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  fts.assign_next(x, fts.make_term(BVAdd, x, fts.make_term(1, bvsort)));
+  fts.assign_next(y, fts.make_term(BVAdd, y, in));
+  Term prop = fts.make_term(BVUlt, x, fts.make_term(10, bvsort));
+
+  PassManager pm;
+  pm.add_pass("coi", [](TransitionSystem & ts, Term & prop) {
+    StaticConeOfInfluence coi(ts, { prop });
+  });
+  pm.add_pass("promote-inputs", [](TransitionSystem & ts, Term & prop) {
+    ts = promote_inputvars(ts);
+  });
+  pm.add_pass(
+      "never",
+      [](TransitionSystem & ts, Term & prop) { FAIL(); },
+      [](const TransitionSystem & ts, const Term & prop) {
+        return string("precondition does not hold");
+      });
+  EXPECT_TRUE(pm.has_pass("coi"));
+  EXPECT_THROW(pm.add_pass("coi", nullptr), PonoException);
+
+  // nothing runs if a pass is unknown
+  TransitionSystem ts = fts;
+  EXPECT_THROW(pm.run({ "coi", "unknown" }, ts, prop), PonoException);
+  EXPECT_TRUE(pm.statistics().empty());
+  EXPECT_EQ(ts.statevars().size(), 2);
+
+  pm.run({ "never", "coi", "promote-inputs" }, ts, prop);
+  const vector<PassStatistics> & stats = pm.statistics();
+  ASSERT_EQ(stats.size(), 3);
+
+  EXPECT_EQ(stats[0].name, "never");
+  EXPECT_FALSE(stats[0].applied);
+  EXPECT_EQ(stats[0].statevars_before, stats[0].statevars_after);
+
+  // y and in are not in the cone of influence of the property
+  EXPECT_EQ(stats[1].name, "coi");
+  EXPECT_TRUE(stats[1].applied);
+  EXPECT_EQ(stats[1].statevars_before, 2);
+  EXPECT_EQ(stats[1].statevars_after, 1);
+  EXPECT_EQ(stats[1].inputvars_before, 1);
+  EXPECT_EQ(stats[1].inputvars_after, 0);
+  EXPECT_LT(stats[1].trans_size_after, stats[1].trans_size_before);
+
+  EXPECT_EQ(stats[2].statevars_before, stats[1].statevars_after);
+  for (const auto & st : stats) {
+    EXPECT_GE(st.time, 0.0);
+  }
+}
+
+TEST_P(PassManagerUnitTests, Strict)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort);
+  fts.assign_next(x, x);
+  Term prop = fts.make_term(Equal, x, x);
+
+  PassManager pm;
+  pm.add_pass("first", [](TransitionSystem & ts, Term & prop) {});
+  // only allowed before "first"
+  pm.add_pass(
+      "second",
+      [](TransitionSystem & ts, Term & prop) {},
+      [&pm](const TransitionSystem & ts, const Term & prop) {
+        return pm.applied("first") ? string("cannot follow first") : "";
+      });
+
+  TransitionSystem ts = fts;
+  pm.run({ "second", "first" }, ts, prop, true);
+  EXPECT_TRUE(pm.applied("first"));
+  EXPECT_TRUE(pm.applied("second"));
+
+  // skipped with a warning unless strict
+  pm.run({ "second" }, ts, prop);
+  EXPECT_FALSE(pm.statistics().back().applied);
+  EXPECT_THROW(pm.run({ "second" }, ts, prop, true), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedPassManagerUnitTests,
+                         PassManagerUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
@@ -0,0 +1,81 @@
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "smt/profiling_solver.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class ProfilingSolverUnitTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = make_shared<ProfilingSolver>(create_solver(GetParam()));
+    s->set_opt("produce-unsat-assumptions", "true");
+    bvsort = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort bvsort;
+};
+
+TEST_P(ProfilingSolverUnitTests, PhaseTags)
+{
+  solver_profile().enable("solver_profile.json");
+
+  Term x = s->make_symbol("x", bvsort);
+  Term b = s->make_symbol("b", s->make_sort(BOOL));
+  Term zero = s->make_term(0, bvsort);
+  s->assert_formula(s->make_term(Implies, b, s->make_term(Equal, x, zero)));
+  {
+    ProfilePhase outer("outer");
+    s->push();
+    s->assert_formula(s->make_term(Distinct, x, zero));
+    {
+      ProfilePhase inner("inner");
+      ASSERT_TRUE(s->check_sat_assuming({ b }).is_unsat());
+      UnorderedTermSet core;
+      s->get_unsat_assumptions(core);
+    }
+    s->pop();
+  }
+  ASSERT_TRUE(s->check_sat().is_sat());
+  s->get_value(x);
+
+  ostringstream out;
+  solver_profile().dump_json(out);
+  string json = out.str();
+  // calls are tagged with the innermost phase
+  size_t outer = json.find("\"outer\"");
+  size_t inner = json.find("\"inner\"");
+  size_t none = json.find("\"none\"");
+  ASSERT_NE(outer, string::npos);
+  ASSERT_NE(inner, string::npos);
+  ASSERT_NE(none, string::npos);
+  // phases are ordered by name
+  EXPECT_LT(inner, none);
+  EXPECT_LT(none, outer);
+  string inner_stats = json.substr(inner, none - inner);
+  EXPECT_NE(inner_stats.find("\"check_sat_assuming\""), string::npos);
+  EXPECT_NE(inner_stats.find("\"get_unsat_assumptions\""), string::npos);
+  EXPECT_EQ(inner_stats.find("\"push\""), string::npos);
+  string none_stats = json.substr(none, outer - none);
+  EXPECT_NE(none_stats.find("\"check_sat\""), string::npos);
+  EXPECT_NE(none_stats.find("\"get_value\""), string::npos);
+  string outer_stats = json.substr(outer);
+  EXPECT_NE(outer_stats.find("\"push\""), string::npos);
+  EXPECT_NE(outer_stats.find("\"pop\""), string::npos);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedProfilingSolverUnitTests,
+                         ProfilingSolverUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
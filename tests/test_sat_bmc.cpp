@@ -0,0 +1,111 @@
+#include <vector>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "engines/sat_bmc.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class SatBmcUnitTests : public ::testing::Test,
+                        public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    boolsort = s->make_sort(BOOL);
+    bvsort8 = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort boolsort, bvsort8;
+};
+
+TEST_P(SatBmcUnitTests, CounterFalse)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort8)));
+  fts.assign_next(x, fts.make_term(BVAdd, x, fts.make_term(1, bvsort8)));
+
+  Property p(s, fts.make_term(BVUlt, x, fts.make_term(5, bvsort8)));
+  SatBmc sb(p, fts, s);
+  ASSERT_EQ(sb.check_until(10), ProverResult::FALSE);
+
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(sb.witness(witness));
+  ASSERT_EQ(witness.size(), 6);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(witness[i].at(x), fts.make_term(i, bvsort8));
+  }
+}
+
+TEST_P(SatBmcUnitTests, CounterUnknown)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term zero = fts.make_term(0, bvsort8);
+  Term one = fts.make_term(1, bvsort8);
+  Term max_val = fts.make_term(10, bvsort8);
+  fts.constrain_init(fts.make_term(Equal, x, zero));
+  fts.assign_next(x,
+                  fts.make_term(Ite,
+                                fts.make_term(BVUlt, x, max_val),
+                                fts.make_term(BVAdd, x, one),
+                                zero));
+
+  Property p(s, fts.make_term(BVUle, x, max_val));
+  SatBmc sb(p, fts, s);
+  ASSERT_EQ(sb.check_until(15), ProverResult::UNKNOWN);
+}
+
+TEST_P(SatBmcUnitTests, NoLongTraces)
+{
+  // the constraint rules out every trace longer than the initial state
+  FunctionalTransitionSystem fts(s);
+  Term b = fts.make_statevar("b", boolsort);
+  Term x = fts.make_statevar("x", bvsort8);
+  fts.constrain_init(fts.make_term(Not, b));
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort8)));
+  fts.assign_next(b, fts.make_term(true));
+  fts.assign_next(x, fts.make_term(BVAdd, x, fts.make_term(1, bvsort8)));
+  fts.add_constraint(fts.make_term(Not, b));
+
+  Property p(s, fts.make_term(Distinct, x, fts.make_term(200, bvsort8)));
+  SatBmc sb(p, fts, s);
+  ASSERT_EQ(sb.check_until(10), ProverResult::TRUE);
+}
+
+TEST_P(SatBmcUnitTests, Unsupported)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_inputvar("y", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(100, bvsort8)));
+  fts.assign_next(x, fts.make_term(BVUdiv, x, y));
+
+  Property p(s, fts.make_term(BVUle, x, fts.make_term(100, bvsort8)));
+  SatBmc sb(p, fts, s);
+  EXPECT_THROW(sb.check_until(1), PonoException);
+
+  // relational systems are not supported either
+  RelationalTransitionSystem rts(s);
+  Term z = rts.make_statevar("z", bvsort8);
+  rts.constrain_init(rts.make_term(Equal, z, rts.make_term(0, bvsort8)));
+  rts.assign_next(z, z);
+  Property rp(s, rts.make_term(Equal, z, rts.make_term(0, bvsort8)));
+  SatBmc rsb(rp, rts, s);
+  EXPECT_THROW(rsb.check_until(1), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSatBmcUnitTests,
+                         SatBmcUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
@@ -0,0 +1,104 @@
+#include <vector>
+
+#include "core/fts.h"
+#include "engines/sat_ic3.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+#include "utils/ts_analysis.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class SatIC3UnitTests : public ::testing::Test,
+                        public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    boolsort = s->make_sort(BOOL);
+    bvsort8 = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort boolsort, bvsort8;
+};
+
+TEST_P(SatIC3UnitTests, CounterSystemUnsafe)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+
+  // off-by-one in property -- unsafe
+  Property p(s, s->make_term(BVUlt, x, max_val));
+  SatIC3 sat_ic3(p, fts, s);
+  ASSERT_EQ(sat_ic3.check_until(12), ProverResult::FALSE);
+
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(sat_ic3.witness(witness));
+  ASSERT_EQ(witness.size(), 11);
+  for (int i = 0; i < 11; ++i) {
+    EXPECT_EQ(witness[i].at(x), fts.make_term(i, bvsort8));
+  }
+}
+
+TEST_P(SatIC3UnitTests, CounterSystemSafe)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+
+  Term prop_term = s->make_term(BVUle, x, max_val);
+  Property p(s, prop_term);
+  SatIC3 sat_ic3(p, fts, s);
+  ASSERT_EQ(sat_ic3.prove(), ProverResult::TRUE);
+  Term invar = sat_ic3.invar();
+  ASSERT_TRUE(check_invar(fts, prop_term, invar));
+
+  ProverStatistics stats = sat_ic3.statistics();
+  EXPECT_GT(stats.counters.at("sat_calls"), 0);
+  EXPECT_GT(stats.counters.at("frames"), 1);
+}
+
+TEST_P(SatIC3UnitTests, BadInitialState)
+{
+  FunctionalTransitionSystem fts(s);
+  Term b = fts.make_statevar("b", boolsort);
+  fts.assign_next(b, b);
+
+  Property p(s, b);
+  SatIC3 sat_ic3(p, fts, s);
+  ASSERT_EQ(sat_ic3.check_until(5), ProverResult::FALSE);
+
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(sat_ic3.witness(witness));
+  ASSERT_EQ(witness.size(), 1);
+  EXPECT_EQ(witness[0].at(b), fts.make_term(false));
+}
+
+TEST_P(SatIC3UnitTests, BoolOnly)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+  Property p(s, s->make_term(BVUle, x, max_val));
+
+  PonoOptions opts;
+  opts.engine_ = IC3_BOOL;
+  SatIC3 sat_ic3(p, fts, s, opts);
+  EXPECT_THROW(sat_ic3.check_until(1), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSatIC3UnitTests,
+                         SatIC3UnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
@@ -0,0 +1,189 @@
+#include <vector>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+#include "utils/simulator.h"
+#include "utils/term_evaluator.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class SimulatorUnitTests : public ::testing::Test,
+                           public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override { s = create_solver(GetParam()); }
+  SmtSolver s;
+};
+
+TEST_P(SimulatorUnitTests, Counter)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  counter_system(fts, fts.make_term(20, bvsort8));
+  Term x = fts.named_terms().at("x");
+  Term eight = fts.make_term(8, bvsort8);
+
+  Simulator sim(fts);
+  sim.set_bad(fts.make_term(Equal, x, eight));
+  sim.set_record(true);
+  sim.reset();
+  ASSERT_TRUE(sim.run(20));
+  EXPECT_EQ(sim.cycle(), 8);
+  // the counter is deterministic, all lanes reach the bad state
+  EXPECT_EQ(sim.bad_lanes(), ~((Simulator::LaneMask)0));
+
+  vector<UnorderedTermMap> witness;
+  sim.witness(5, witness);
+  ASSERT_EQ(witness.size(), 9);
+  for (size_t i = 0; i < witness.size(); ++i) {
+    EXPECT_EQ(witness[i].at(x), fts.make_term((int64_t)i, bvsort8));
+  }
+  // the simulator stays in the cycle of the bad state
+  EXPECT_EQ(sim.get_value(x, 5), eight);
+}
+
+TEST_P(SimulatorUnitTests, WideCounter)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort bvsort100 = fts.make_sort(BV, 100);
+  Term max_val = fts.make_term(
+      "1111111111111111111111111111111111111111111111111111111111111111111",
+      bvsort100,
+      2);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+
+  Simulator sim(fts);
+  sim.set_bad(fts.make_term(Equal, x, fts.make_term(5, bvsort100)));
+  sim.reset();
+  ASSERT_TRUE(sim.run(10));
+  EXPECT_EQ(sim.cycle(), 5);
+}
+
+TEST_P(SimulatorUnitTests, InputsAndConstraints)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort bvsort2 = fts.make_sort(BV, 2);
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term in = fts.make_inputvar("in", bvsort2);
+  Term three = fts.make_term(3, bvsort2);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort8)));
+  fts.assign_next(
+      x, fts.make_term(BVAdd, x, fts.make_term(Op(Zero_Extend, 6), in)));
+  fts.add_constraint(fts.make_term(Distinct, in, three));
+
+  Simulator sim(fts, 1);
+  sim.set_bad(fts.make_term(Equal, x, fts.make_term(6, bvsort8)));
+  sim.set_record(true);
+  sim.reset();
+  ASSERT_TRUE(sim.run(20));
+
+  size_t lane = 0;
+  while (!((sim.bad_lanes() >> lane) & 1)) {
+    ++lane;
+  }
+  ASSERT_TRUE((sim.valid_lanes() >> lane) & 1);
+
+  vector<UnorderedTermMap> witness;
+  sim.witness(lane, witness);
+  ASSERT_EQ(witness.size(), sim.cycle() + 1);
+  mpz_class x_val, in_val;
+  ASSERT_TRUE(TermEvaluator::value_to_mpz(witness[0].at(x), x_val));
+  EXPECT_EQ(x_val, 0);
+  for (size_t i = 0; i + 1 < witness.size(); ++i) {
+    EXPECT_NE(witness[i].at(in), three);
+    ASSERT_TRUE(TermEvaluator::value_to_mpz(witness[i].at(in), in_val));
+    x_val += in_val;
+    mpz_class next_x_val;
+    ASSERT_TRUE(TermEvaluator::value_to_mpz(witness[i + 1].at(x), next_x_val));
+    EXPECT_EQ(next_x_val, x_val);
+  }
+  EXPECT_EQ(x_val, 6);
+}
+
+TEST_P(SimulatorUnitTests, MatchesEvaluator)
+{
+  // compare the word-level and GMP implementations against TermEvaluator
+  for (uint64_t width : { 1, 7, 64, 100 }) {
+    FunctionalTransitionSystem fts(s);
+    Sort bvsort = fts.make_sort(BV, width);
+    Term a = fts.make_inputvar("a", bvsort);
+    Term b = fts.make_inputvar("b", bvsort);
+    Term c = fts.make_inputvar("c", fts.make_sort(BOOL));
+    Term one = fts.make_term(1, bvsort);
+
+    TermVec terms;
+    for (auto po : { BVAdd,  BVSub,  BVMul,  BVUdiv, BVUrem, BVSdiv, BVSrem,
+                     BVSmod, BVShl,  BVLshr, BVAshr, BVAnd,  BVOr,   BVXor,
+                     BVNand, BVNor,  BVXnor, BVComp, BVUlt,  BVSle,  Equal,
+                     Distinct, Concat }) {
+      terms.push_back(fts.make_term(po, a, b));
+    }
+    // small shift amounts
+    terms.push_back(fts.make_term(BVShl, a, fts.make_term(BVAnd, b, one)));
+    terms.push_back(fts.make_term(BVAshr, a, fts.make_term(BVAnd, b, one)));
+    terms.push_back(fts.make_term(BVNeg, a));
+    terms.push_back(fts.make_term(Op(Extract, width - 1, width / 2), a));
+    terms.push_back(fts.make_term(Op(Sign_Extend, 5), a));
+    terms.push_back(fts.make_term(Op(Repeat, 2), a));
+    terms.push_back(fts.make_term(Op(Rotate_Left, 3), a));
+    terms.push_back(fts.make_term(Ite, c, a, b));
+    terms.push_back(fts.make_term(
+        Xor, c, fts.make_term(Not, fts.make_term(BVSgt, a, b))));
+
+    Simulator sim(fts, width);
+    for (const auto & t : terms) {
+      sim.watch(t);
+    }
+    sim.reset();
+    sim.randomize_inputs();
+    // make sure corner cases are covered
+    sim.set_value(b, 0, fts.make_term(0, bvsort));
+    sim.set_value(a, 1, fts.make_term(0, bvsort));
+    sim.evaluate();
+
+    TermEvaluator evaluator(s);
+    for (size_t lane = 0; lane < Simulator::NUM_LANES; ++lane) {
+      evaluator.set_assignment({ { a, sim.get_value(a, lane) },
+                                 { b, sim.get_value(b, lane) },
+                                 { c, sim.get_value(c, lane) } });
+      for (const auto & t : terms) {
+        mpz_class expected, actual;
+        ASSERT_TRUE(evaluator.evaluate(t, expected));
+        ASSERT_TRUE(
+            TermEvaluator::value_to_mpz(sim.get_value(t, lane), actual));
+        EXPECT_EQ(expected, actual) << t << " at lane " << lane;
+      }
+    }
+  }
+}
+
+TEST_P(SimulatorUnitTests, Unsupported)
+{
+  RelationalTransitionSystem rts(s);
+  Sort bvsort8 = rts.make_sort(BV, 8);
+  Term x = rts.make_statevar("x", bvsort8);
+  rts.set_init(rts.make_term(Equal, x, rts.make_term(0, bvsort8)));
+  rts.set_trans(rts.make_term(BVUge, rts.next(x), x));
+  EXPECT_THROW(Simulator sim(rts), PonoException);
+
+  FunctionalTransitionSystem fts(s);
+  Sort arrsort = fts.make_sort(ARRAY, bvsort8, bvsort8);
+  fts.make_statevar("arr", arrsort);
+  EXPECT_THROW(Simulator sim(fts), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSimulatorUnitTests,
+                         SimulatorUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
@@ -120,6 +120,18 @@ TEST_P(TermAnalysisUnitTests, GetPredicatesIte)
   }
 }
 
+TEST_P(TermAnalysisUnitTests, DagSize)
+{
+  Term x = s->make_symbol("x", bvsort);
+  Term one = s->make_term(1, bvsort);
+  Term sum = s->make_term(BVAdd, x, one);
+  EXPECT_EQ(dag_size(x), 1);
+  EXPECT_EQ(dag_size(sum), 3);
+  // shared subterms are counted once
+  EXPECT_EQ(dag_size(s->make_term(BVMul, sum, sum)), 4);
+  EXPECT_EQ(dag_size(TermVec{ sum, x }), 3);
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedTermAnalysisUnitTests,
                          TermAnalysisUnitTests,
                          testing::ValuesIn(available_solver_enums()));
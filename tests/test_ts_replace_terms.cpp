@@ -48,6 +48,54 @@ TEST_P(TSReplaceTests, ReplaceTerms)
   EXPECT_TRUE(free_syms.find(v) == free_syms.end());
 }
 
+TEST_P(TSReplaceTests, ReplaceTermsKeepsStatevars)
+{
+  FunctionalTransitionSystem fts(s);
+
+  Term x = fts.make_statevar("x", bvsort);
+  Term y = fts.make_statevar("y", bvsort);
+  Term zero = fts.make_term(0, bvsort);
+  fts.assign_next(x, x);
+  fts.assign_next(y, fts.make_term(BVAdd, x, y));
+
+  // replace_terms only rewrites, COI reduction removes the variables
+  fts.replace_terms({ { x, zero } });
+  EXPECT_TRUE(fts.is_curr_var(x));
+  EXPECT_EQ(fts.statevars().size(), 2);
+  EXPECT_EQ(fts.state_updates().at(y), fts.make_term(BVAdd, zero, y));
+}
+
+TEST_P(TSReplaceTests, SubstituteAndRemoveStatevars)
+{
+  FunctionalTransitionSystem fts(s);
+
+  Term x = fts.make_statevar("x", bvsort);
+  Term y = fts.make_statevar("y", bvsort);
+  Term z = fts.make_statevar("z", bvsort);
+  Term one = fts.make_term(1, bvsort);
+  fts.constrain_init(fts.make_term(Equal, x, y));
+  fts.assign_next(x, fts.make_term(BVAdd, x, one));
+  fts.assign_next(y, fts.make_term(BVAdd, y, one));
+  fts.assign_next(z, fts.make_term(BVAdd, x, y));
+
+  // a replacement using a removed state variable is a chain
+  EXPECT_THROW(fts.substitute_and_remove_statevars({ { y, x }, { z, y } }),
+               PonoException);
+
+  Term y_next = fts.next(y);
+  fts.substitute_and_remove_statevars({ { y, x } });
+  EXPECT_FALSE(fts.is_curr_var(y));
+  EXPECT_EQ(fts.statevars().size(), 2);
+  EXPECT_EQ(fts.state_updates().size(), 2);
+  EXPECT_EQ(fts.state_updates().at(z), fts.make_term(BVAdd, x, x));
+
+  UnorderedTermSet free_syms;
+  get_free_symbolic_consts(fts.init(), free_syms);
+  get_free_symbolic_consts(fts.trans(), free_syms);
+  EXPECT_TRUE(free_syms.find(y) == free_syms.end());
+  EXPECT_TRUE(free_syms.find(y_next) == free_syms.end());
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedSolverTSReplaceTests,
                          TSReplaceTests,
                          testing::ValuesIn(available_solver_enums()));
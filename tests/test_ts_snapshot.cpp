@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "engines/bmc.h"
+#include "engines/kinduction.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+#include "utils/ts_snapshot.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class TSSnapshotUnitTests : public ::testing::Test,
+                            public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    bvsort = s->make_sort(BV, 8);
+    filename = string(P_tmpdir) + "/pono_test_ts_snapshot.snap";
+  }
+
+  void TearDown() override { remove(filename.c_str()); }
+
+  SmtSolver s;
+  Sort bvsort;
+  string filename;
+};
+
+TEST_P(TSSnapshotUnitTests, RoundTripFTS)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(10, bvsort));
+  Term x = fts.named_terms().at("x");
+  Term in = fts.make_inputvar("in", bvsort);
+  fts.add_constraint(fts.make_term(BVUlt, in, fts.make_term(4, bvsort)));
+  fts.name_term("x_plus_in", fts.make_term(BVAdd, x, in));
+  Term prop = fts.make_term(BVUle, x, fts.make_term(10, bvsort));
+  Term false_prop = fts.make_term(BVUlt, x, fts.make_term(5, bvsort));
+  TSSnapshot::write(filename, 42, fts, { prop, false_prop });
+
+  SmtSolver s2 = create_solver(GetParam());
+  FunctionalTransitionSystem loaded(s2);
+  TermVec props;
+  // wrong key
+  EXPECT_FALSE(TSSnapshot::read(filename, 43, loaded, props));
+  EXPECT_EQ(loaded.statevars().size(), 0);
+  ASSERT_TRUE(TSSnapshot::read(filename, 42, loaded, props));
+
+  EXPECT_TRUE(loaded.is_functional());
+  EXPECT_EQ(loaded.statevars().size(), fts.statevars().size());
+  EXPECT_EQ(loaded.inputvars().size(), fts.inputvars().size());
+  EXPECT_EQ(loaded.state_updates().size(), fts.state_updates().size());
+  EXPECT_EQ(loaded.constraints().size(), fts.constraints().size());
+  EXPECT_EQ(loaded.named_terms().size(), fts.named_terms().size());
+  EXPECT_NO_THROW(loaded.lookup("x_plus_in"));
+  ASSERT_EQ(props.size(), 2);
+
+  Property p(s2, props[0]);
+  KInduction kind(p, loaded, s2);
+  EXPECT_EQ(kind.check_until(12), ProverResult::TRUE);
+
+  Property false_p(s2, props[1]);
+  Bmc bmc(false_p, loaded, s2);
+  EXPECT_EQ(bmc.check_until(6), ProverResult::FALSE);
+}
+
+TEST_P(TSSnapshotUnitTests, RoundTripRTS)
+{
+  RelationalTransitionSystem rts(s);
+  Term y = rts.make_statevar("y", bvsort);
+  rts.set_init(rts.make_term(Equal, y, rts.make_term(0, bvsort)));
+  rts.set_trans(rts.make_term(BVUge, rts.next(y), y));
+  TSSnapshot::write(filename, 1, rts, { rts.make_term(BVUge, y, y) });
+
+  SmtSolver s2 = create_solver(GetParam());
+  RelationalTransitionSystem loaded(s2);
+  TermVec props;
+  ASSERT_TRUE(TSSnapshot::read(filename, 1, loaded, props));
+  EXPECT_FALSE(loaded.is_functional());
+  Term y2 = loaded.lookup("y");
+  EXPECT_EQ(loaded.next(y2)->to_string(), rts.next(y)->to_string());
+  EXPECT_EQ(loaded.trans()->to_string(), rts.trans()->to_string());
+}
+
+TEST_P(TSSnapshotUnitTests, MissingAndCorrupted)
+{
+  RelationalTransitionSystem rts(s);
+  TermVec props;
+  EXPECT_FALSE(TSSnapshot::read(filename, 0, rts, props));
+
+  {
+    ofstream f(filename);
+    f << "not a snapshot";
+  }
+  EXPECT_THROW(TSSnapshot::read(filename, 0, rts, props), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedTSSnapshotUnitTests,
+                         TSSnapshotUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
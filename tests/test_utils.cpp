@@ -4,6 +4,7 @@
 #include "core/fts.h"
 #include "core/rts.h"
 #include "core/unroller.h"
+#include "engines/bmc.h"
 #include "engines/kinduction.h"
 #include "gtest/gtest.h"
 #include "smt/available_solvers.h"
@@ -115,6 +116,48 @@ TEST_P(UtilsUnitTests, CheckInvarFalseNonState)
   EXPECT_FALSE(check_invar(rts, prop, invar));
 }
 
+TEST_P(UtilsUnitTests, CheckWitness)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort);
+  Term inp = fts.make_inputvar("inp", bvsort);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort)));
+  fts.assign_next(x, fts.make_term(BVAdd, x, inp));
+  fts.add_constraint(fts.make_term(BVUle, inp, fts.make_term(1, bvsort)));
+  Term prop = fts.make_term(BVUlt, x, fts.make_term(3, bvsort));
+
+  Property p(s, prop);
+  Bmc bmc(p, fts, create_solver(GetParam()));
+  ASSERT_EQ(bmc.check_until(5), ProverResult::FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_EQ(witness.size(), 4);
+  EXPECT_TRUE(check_witness(fts, prop, witness));
+
+  // the property holds in the last step of a prefix
+  vector<UnorderedTermMap> prefix(witness.begin(), witness.end() - 1);
+  EXPECT_FALSE(check_witness(fts, prop, prefix));
+
+  // violates the constraint on the input
+  vector<UnorderedTermMap> bad_input = witness;
+  bad_input[0][inp] = fts.make_term(3, bvsort);
+  bad_input[1][x] = fts.make_term(3, bvsort);
+  bad_input[1][inp] = fts.make_term(0, bvsort);
+  bad_input.resize(2);
+  EXPECT_FALSE(check_witness(fts, prop, bad_input));
+
+  // inconsistent with the state update
+  vector<UnorderedTermMap> bad_update = witness;
+  bad_update[1][x] = fts.make_term(2, bvsort);
+  EXPECT_FALSE(check_witness(fts, prop, bad_update));
+
+  // only values of variables are used
+  vector<UnorderedTermMap> missing = witness;
+  missing[2].erase(x);
+  missing[2][fts.make_term(BVAdd, x, inp)] = witness[3].at(x);
+  EXPECT_FALSE(check_witness(fts, prop, missing));
+}
+
 TEST_P(UtilsEngineUnitTests, MakeProver)
 {
   // use default solver
@@ -89,6 +89,45 @@ TEST_P(WitnessUnitTests, ArraysDefaultSolver)
   ASSERT_EQ(witness[6][x], fts.make_term(10, bvsort4));
 }
 
+TEST_P(WitnessUnitTests, NamedTermsEvaluated)
+{
+  FunctionalTransitionSystem fts;
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  counter_system(fts, fts.make_term(20, bvsort8));
+  Term x = fts.named_terms().at("x");
+
+  Term xp1 = fts.make_term(BVAdd, x, fts.make_term(1, bvsort8));
+  fts.name_term("xp1", xp1);
+  Term xm4 = fts.make_term(BVSub, x, fts.make_term(4, bvsort8));
+  Term sdiv = fts.make_term(BVSdiv, xm4, fts.make_term(3, bvsort8));
+  fts.name_term("sdiv", sdiv);
+
+  Term eight = fts.make_term(8, bvsort8);
+  Term prop_term = fts.make_term(BVUlt, x, eight);
+  Property prop(fts.solver(), prop_term);
+
+  SmtSolver s = create_solver(GetParam());
+  Bmc bmc(prop, fts, s);
+  ProverResult r = bmc.check_until(9);
+  ASSERT_EQ(r, FALSE);
+
+  vector<UnorderedTermMap> witness;
+  bool ok = bmc.witness(witness);
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(witness.size(), 9);
+
+  // named terms are evaluated from the values of the variables
+  for (int i = 0; i < 9; ++i) {
+    const UnorderedTermMap & step = witness[i];
+    ASSERT_NE(step.find(xp1), step.end());
+    ASSERT_NE(step.find(sdiv), step.end());
+    EXPECT_EQ(step.at(xp1), fts.make_term(i + 1, bvsort8));
+    // signed division rounds towards zero
+    int expected = (i - 4) / 3;
+    EXPECT_EQ(step.at(sdiv), fts.make_term((expected + 256) % 256, bvsort8));
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedWitnessUnitTests,
     WitnessUnitTests,
@@ -0,0 +1,651 @@
+/*********************                                                        */
+/*! \file bit_blaster.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief An and-inverter graph and a bit-blaster from boolean and
+**        bit-vector terms into it.
+**
+**/
+
+#include "utils/bit_blaster.h"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_set>
+
+#include "utils/exceptions.h"
+#include "utils/term_evaluator.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+/* Aig */
+
+Aig::Aig()
+{
+  // node 0 is the constant false node
+  nodes_.push_back({ FALSE_LIT, FALSE_LIT });
+}
+
+AigLit Aig::make_input()
+{
+  AigLit res = nodes_.size() << 1;
+  nodes_.push_back({ FALSE_LIT, FALSE_LIT });
+  return res;
+}
+
+AigLit Aig::make_and(AigLit a, AigLit b)
+{
+  if (a > b) {
+    swap(a, b);
+  }
+
+  if (a == FALSE_LIT || a == negate(b)) {
+    return FALSE_LIT;
+  } else if (a == TRUE_LIT || a == b) {
+    return b;
+  }
+
+  uint64_t key = (static_cast<uint64_t>(a) << 32) | b;
+  auto it = strash_.find(key);
+  if (it != strash_.end()) {
+    return it->second;
+  }
+
+  AigLit res = nodes_.size() << 1;
+  nodes_.push_back({ a, b });
+  strash_[key] = res;
+  return res;
+}
+
+AigLit Aig::make_or(AigLit a, AigLit b)
+{
+  return negate(make_and(negate(a), negate(b)));
+}
+
+AigLit Aig::make_xor(AigLit a, AigLit b)
+{
+  return make_or(make_and(a, negate(b)), make_and(negate(a), b));
+}
+
+AigLit Aig::make_ite(AigLit c, AigLit t, AigLit e)
+{
+  if (t == e) {
+    return t;
+  }
+  return make_or(make_and(c, t), make_and(negate(c), e));
+}
+
+/* BitBlaster */
+
+static size_t width_of(const Sort & sort)
+{
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    return 1;
+  } else if (sk == BV) {
+    return sort->get_width();
+  }
+  throw PonoException("BitBlaster: unsupported sort " + sort->to_string());
+}
+
+BitBlaster::BitBlaster(Aig & aig) : aig_(aig) {}
+
+const AigBits & BitBlaster::make_input(const Term & sym)
+{
+  size_t width = width_of(sym->get_sort());
+  AigBits & bits = cache_[sym];
+  bits.clear();
+  bits.reserve(width);
+  for (size_t i = 0; i < width; ++i) {
+    bits.push_back(aig_.make_input());
+  }
+  return bits;
+}
+
+void BitBlaster::set_bits(const Term & t, const AigBits & bits)
+{
+  assert(bits.size() == width_of(t->get_sort()));
+  cache_[t] = bits;
+}
+
+const AigBits & BitBlaster::bit_blast(const Term & t)
+{
+  TermVec to_visit({ t });
+  while (!to_visit.empty()) {
+    Term cur = to_visit.back();
+
+    if (cache_.find(cur) != cache_.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (cur->is_value()) {
+      size_t width = width_of(cur->get_sort());
+      mpz_class val;
+      if (!TermEvaluator::value_to_mpz(cur, val)) {
+        throw PonoException("BitBlaster: cannot interpret value "
+                            + cur->to_string());
+      }
+      AigBits & bits = cache_[cur];
+      for (size_t i = 0; i < width; ++i) {
+        bits.push_back(mpz_tstbit(val.get_mpz_t(), i) ? Aig::TRUE_LIT
+                                                      : Aig::FALSE_LIT);
+      }
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (cur->is_symbol() || cur->is_param()) {
+      throw PonoException("BitBlaster: no bits for symbol "
+                          + cur->to_string());
+    }
+
+    bool children_done = true;
+    for (const auto & c : cur) {
+      if (cache_.find(c) == cache_.end()) {
+        children_done = false;
+        to_visit.push_back(c);
+      }
+    }
+
+    if (children_done) {
+      to_visit.pop_back();
+      AigBits bits = apply(cur);
+      assert(bits.size() == width_of(cur->get_sort()));
+      cache_[cur] = std::move(bits);
+    }
+  }
+
+  return cache_.at(t);
+}
+
+AigLit BitBlaster::bit_blast_bool(const Term & t)
+{
+  const AigBits & bits = bit_blast(t);
+  assert(bits.size() == 1);
+  return bits[0];
+}
+
+bool BitBlaster::is_supported(const Term & t)
+{
+  // must be kept in sync with BitBlaster::apply
+  static const unordered_set<PrimOp> supported_ops(
+      { Not, And, Or, Xor, Implies, Ite, Equal, Distinct, Concat, Extract,
+        Zero_Extend, Sign_Extend, Repeat, Rotate_Left, Rotate_Right, BVNot,
+        BVNeg, BVAnd, BVOr, BVXor, BVNand, BVNor, BVXnor, BVComp, BVAdd,
+        BVSub, BVMul, BVShl, BVLshr, BVAshr, BVUlt, BVUle, BVUgt, BVUge,
+        BVSlt, BVSle, BVSgt, BVSge });
+
+  UnorderedTermSet visited;
+  TermVec to_visit({ t });
+  while (!to_visit.empty()) {
+    Term cur = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(cur).second) {
+      continue;
+    }
+
+    SortKind sk = cur->get_sort()->get_sort_kind();
+    if ((sk != BOOL && sk != BV) || cur->is_param()) {
+      return false;
+    }
+
+    Op op = cur->get_op();
+    if (!op.is_null()
+        && supported_ops.find(op.prim_op) == supported_ops.end()) {
+      return false;
+    }
+
+    for (const auto & c : cur) {
+      to_visit.push_back(c);
+    }
+  }
+  return true;
+}
+
+AigBits BitBlaster::apply(const Term & t)
+{
+  Op op = t->get_op();
+  vector<const AigBits *> args;
+  for (const auto & c : t) {
+    args.push_back(&cache_.at(c));
+  }
+  assert(args.size());
+  const AigBits & a = *args[0];
+  const size_t w = a.size();
+  AigLit carry;
+
+  AigBits res;
+  switch (op.prim_op) {
+    case Not:
+    case BVNot: {
+      for (const auto & l : a) {
+        res.push_back(Aig::negate(l));
+      }
+      break;
+    }
+    case And:
+    case BVAnd:
+    case BVNand: {
+      res = a;
+      for (size_t i = 1; i < args.size(); ++i) {
+        for (size_t j = 0; j < w; ++j) {
+          res[j] = aig_.make_and(res[j], (*args[i])[j]);
+        }
+      }
+      break;
+    }
+    case Or:
+    case BVOr:
+    case BVNor: {
+      res = a;
+      for (size_t i = 1; i < args.size(); ++i) {
+        for (size_t j = 0; j < w; ++j) {
+          res[j] = aig_.make_or(res[j], (*args[i])[j]);
+        }
+      }
+      break;
+    }
+    case Xor:
+    case BVXor:
+    case BVXnor: {
+      res = a;
+      for (size_t i = 1; i < args.size(); ++i) {
+        for (size_t j = 0; j < w; ++j) {
+          res[j] = aig_.make_xor(res[j], (*args[i])[j]);
+        }
+      }
+      break;
+    }
+    case Implies: {
+      res.push_back(aig_.make_or(Aig::negate(a[0]), (*args[1])[0]));
+      break;
+    }
+    case Ite: {
+      const AigBits & then_bits = *args[1];
+      const AigBits & else_bits = *args[2];
+      for (size_t j = 0; j < then_bits.size(); ++j) {
+        res.push_back(aig_.make_ite(a[0], then_bits[j], else_bits[j]));
+      }
+      break;
+    }
+    case Equal: {
+      AigLit eq = Aig::TRUE_LIT;
+      for (size_t i = 1; i < args.size(); ++i) {
+        eq = aig_.make_and(eq, equal(*args[i - 1], *args[i]));
+      }
+      res.push_back(eq);
+      break;
+    }
+    case Distinct: {
+      AigLit distinct = Aig::TRUE_LIT;
+      for (size_t i = 0; i < args.size(); ++i) {
+        for (size_t j = i + 1; j < args.size(); ++j) {
+          distinct = aig_.make_and(
+              distinct, Aig::negate(equal(*args[i], *args[j])));
+        }
+      }
+      res.push_back(distinct);
+      break;
+    }
+    case Concat: {
+      // the first argument holds the most significant bits
+      for (auto it = args.rbegin(); it != args.rend(); ++it) {
+        res.insert(res.end(), (*it)->begin(), (*it)->end());
+      }
+      break;
+    }
+    case Extract: {
+      res.assign(a.begin() + op.idx1, a.begin() + op.idx0 + 1);
+      break;
+    }
+    case Zero_Extend: {
+      res = a;
+      res.insert(res.end(), op.idx0, Aig::FALSE_LIT);
+      break;
+    }
+    case Sign_Extend: {
+      res = a;
+      res.insert(res.end(), op.idx0, a.back());
+      break;
+    }
+    case Repeat: {
+      for (size_t i = 0; i < op.idx0; ++i) {
+        res.insert(res.end(), a.begin(), a.end());
+      }
+      break;
+    }
+    case Rotate_Left: {
+      size_t n = op.idx0 % w;
+      for (size_t j = 0; j < w; ++j) {
+        res.push_back(a[(j + w - n) % w]);
+      }
+      break;
+    }
+    case Rotate_Right: {
+      size_t n = op.idx0 % w;
+      for (size_t j = 0; j < w; ++j) {
+        res.push_back(a[(j + n) % w]);
+      }
+      break;
+    }
+    case BVNeg: {
+      AigBits not_a;
+      for (const auto & l : a) {
+        not_a.push_back(Aig::negate(l));
+      }
+      res = add(not_a, AigBits(w, Aig::FALSE_LIT), Aig::TRUE_LIT, carry);
+      break;
+    }
+    case BVAdd: {
+      res = a;
+      for (size_t i = 1; i < args.size(); ++i) {
+        res = add(res, *args[i], Aig::FALSE_LIT, carry);
+      }
+      break;
+    }
+    case BVSub: {
+      AigBits not_b;
+      for (const auto & l : *args[1]) {
+        not_b.push_back(Aig::negate(l));
+      }
+      res = add(a, not_b, Aig::TRUE_LIT, carry);
+      break;
+    }
+    case BVMul: {
+      res = a;
+      for (size_t i = 1; i < args.size(); ++i) {
+        res = mul(res, *args[i]);
+      }
+      break;
+    }
+    case BVComp: res.push_back(equal(a, *args[1])); break;
+    case BVShl: res = shift(a, *args[1], true, Aig::FALSE_LIT); break;
+    case BVLshr: res = shift(a, *args[1], false, Aig::FALSE_LIT); break;
+    case BVAshr: res = shift(a, *args[1], false, a.back()); break;
+    case BVUlt: res.push_back(ult(a, *args[1])); break;
+    case BVUle: res.push_back(Aig::negate(ult(*args[1], a))); break;
+    case BVUgt: res.push_back(ult(*args[1], a)); break;
+    case BVUge: res.push_back(Aig::negate(ult(a, *args[1]))); break;
+    case BVSlt: res.push_back(slt(a, *args[1])); break;
+    case BVSle: res.push_back(Aig::negate(slt(*args[1], a))); break;
+    case BVSgt: res.push_back(slt(*args[1], a)); break;
+    case BVSge: res.push_back(Aig::negate(slt(a, *args[1]))); break;
+    default: {
+      throw PonoException("BitBlaster: unsupported operator "
+                          + op.to_string());
+    }
+  }
+
+  if (op.prim_op == BVNand || op.prim_op == BVNor || op.prim_op == BVXnor) {
+    for (auto & l : res) {
+      l = Aig::negate(l);
+    }
+  }
+
+  return res;
+}
+
+AigBits BitBlaster::add(const AigBits & a,
+                        const AigBits & b,
+                        AigLit carry_in,
+                        AigLit & carry_out)
+{
+  assert(a.size() == b.size());
+  AigBits res;
+  res.reserve(a.size());
+  AigLit carry = carry_in;
+  for (size_t i = 0; i < a.size(); ++i) {
+    AigLit a_xor_b = aig_.make_xor(a[i], b[i]);
+    res.push_back(aig_.make_xor(a_xor_b, carry));
+    carry = aig_.make_or(aig_.make_and(a[i], b[i]),
+                         aig_.make_and(carry, a_xor_b));
+  }
+  carry_out = carry;
+  return res;
+}
+
+AigBits BitBlaster::mul(const AigBits & a, const AigBits & b)
+{
+  // shift-and-add, the partial products are truncated to the width
+  const size_t w = a.size();
+  AigBits res(w, Aig::FALSE_LIT);
+  AigLit carry;
+  for (size_t i = 0; i < w; ++i) {
+    if (b[i] == Aig::FALSE_LIT) {
+      continue;
+    }
+    AigBits partial(w, Aig::FALSE_LIT);
+    for (size_t j = i; j < w; ++j) {
+      partial[j] = aig_.make_and(a[j - i], b[i]);
+    }
+    res = add(res, partial, Aig::FALSE_LIT, carry);
+  }
+  return res;
+}
+
+AigLit BitBlaster::equal(const AigBits & a, const AigBits & b)
+{
+  assert(a.size() == b.size());
+  AigLit res = Aig::TRUE_LIT;
+  for (size_t i = 0; i < a.size(); ++i) {
+    res = aig_.make_and(res, Aig::negate(aig_.make_xor(a[i], b[i])));
+  }
+  return res;
+}
+
+AigLit BitBlaster::ult(const AigBits & a, const AigBits & b)
+{
+  // a < b iff there is no carry out of a + ~b + 1 (i.e. a - b borrows)
+  AigBits not_b;
+  for (const auto & l : b) {
+    not_b.push_back(Aig::negate(l));
+  }
+  AigLit carry;
+  add(a, not_b, Aig::TRUE_LIT, carry);
+  return Aig::negate(carry);
+}
+
+AigLit BitBlaster::slt(const AigBits & a, const AigBits & b)
+{
+  // flipping the sign bits maps the signed order onto the unsigned one
+  AigBits flipped_a = a;
+  AigBits flipped_b = b;
+  flipped_a.back() = Aig::negate(flipped_a.back());
+  flipped_b.back() = Aig::negate(flipped_b.back());
+  return ult(flipped_a, flipped_b);
+}
+
+AigBits BitBlaster::shift(const AigBits & a,
+                          const AigBits & b,
+                          bool left,
+                          AigLit fill)
+{
+  const size_t w = a.size();
+  AigBits res = a;
+  // set if the shift amount is at least the width
+  AigLit overflow = Aig::FALSE_LIT;
+  for (size_t s = 0; s < b.size(); ++s) {
+    size_t dist = (s < 8 * sizeof(size_t) - 1) ? (size_t(1) << s) : w;
+    if (dist >= w) {
+      overflow = aig_.make_or(overflow, b[s]);
+      continue;
+    }
+
+    AigBits shifted(w, fill);
+    for (size_t j = 0; j < w; ++j) {
+      if (left && j >= dist) {
+        shifted[j] = res[j - dist];
+      } else if (!left && j + dist < w) {
+        shifted[j] = res[j + dist];
+      }
+    }
+    for (size_t j = 0; j < w; ++j) {
+      res[j] = aig_.make_ite(b[s], shifted[j], res[j]);
+    }
+  }
+
+  for (size_t j = 0; j < w; ++j) {
+    res[j] = aig_.make_ite(overflow, fill, res[j]);
+  }
+  return res;
+}
+
+/* BitBlastedTs */
+
+BitBlastedTs::BitBlastedTs(const TransitionSystem & ts, const Term & bad)
+    : num_statevars_(ts.statevars().size()),
+      init_(Aig::TRUE_LIT),
+      constraints_(Aig::TRUE_LIT),
+      bad_(Aig::FALSE_LIT)
+{
+  if (!ts.is_functional()) {
+    throw PonoException(
+        "Bit-blasting requires a functional transition system");
+  }
+
+  // check everything up front instead of failing half-way bit-blasting
+  TermVec to_blast({ ts.init(), bad });
+  for (const auto & elem : ts.state_updates()) {
+    to_blast.push_back(elem.second);
+  }
+  for (const auto & c : ts.constraints()) {
+    to_blast.push_back(c.first);
+  }
+  for (const auto & t : to_blast) {
+    if (!BitBlaster::is_supported(t)) {
+      throw PonoException("Can't bit-blast " + t->to_string());
+    }
+  }
+
+  BitBlaster bit_blaster(aig_);
+  for (const auto & v : ts.statevars()) {
+    vars_.push_back(v);
+    var_bits_.push_back(bit_blaster.make_input(v));
+    state_bits_.insert(
+        state_bits_.end(), var_bits_.back().begin(), var_bits_.back().end());
+  }
+  for (const auto & v : ts.inputvars()) {
+    vars_.push_back(v);
+    var_bits_.push_back(bit_blaster.make_input(v));
+    input_bits_.insert(
+        input_bits_.end(), var_bits_.back().begin(), var_bits_.back().end());
+  }
+
+  const UnorderedTermMap & updates = ts.state_updates();
+  for (size_t i = 0; i < num_statevars_; ++i) {
+    const Term & v = vars_[i];
+    const Term & nv = ts.next(v);
+    auto it = updates.find(v);
+    AigBits next = (it != updates.end()) ? bit_blaster.bit_blast(it->second)
+                                         : bit_blaster.make_input(nv);
+    bit_blaster.set_bits(nv, next);
+    assert(next.size() == var_bits_[i].size());
+    next_bits_.insert(next_bits_.end(), next.begin(), next.end());
+  }
+
+  init_ = bit_blaster.bit_blast_bool(ts.init());
+  for (const auto & c : ts.constraints()) {
+    constraints_ =
+        aig_.make_and(constraints_, bit_blaster.bit_blast_bool(c.first));
+  }
+  bad_ = bit_blaster.bit_blast_bool(bad);
+}
+
+Term BitBlastedTs::value(const SmtSolver & solver,
+                         size_t i,
+                         const vector<bool> & bit_values) const
+{
+  const Sort & sort = vars_[i]->get_sort();
+  assert(bit_values.size() == var_bits_[i].size());
+  if (sort->get_sort_kind() == BOOL) {
+    return solver->make_term(static_cast<bool>(bit_values[0]));
+  }
+  // most significant bit first
+  string val;
+  for (auto it = bit_values.rbegin(); it != bit_values.rend(); ++it) {
+    val += *it ? '1' : '0';
+  }
+  return solver->make_term(val, sort, 2);
+}
+
+Term BitBlastedTs::bit_term(const SmtSolver & solver,
+                            size_t i,
+                            size_t j,
+                            bool positive) const
+{
+  const Term & v = vars_[i];
+  if (v->get_sort()->get_sort_kind() == BOOL) {
+    assert(j == 0);
+    return positive ? v : solver->make_term(Not, v);
+  }
+  Term bit = solver->make_term(Op(Extract, j, j), v);
+  return solver->make_term(
+      Equal, bit, solver->make_term(positive ? 1 : 0, bit->get_sort()));
+}
+
+int encode_cnf(const Aig & aig,
+               SatSolver & sat,
+               unordered_map<uint32_t, int> & node_lits,
+               AigLit l)
+{
+  assert(node_lits.find(Aig::node(Aig::FALSE_LIT)) != node_lits.end());
+
+  // explicit stack, AIG cones can be very deep
+  vector<uint32_t> to_visit({ Aig::node(l) });
+  while (!to_visit.empty()) {
+    uint32_t cur = to_visit.back();
+
+    if (node_lits.find(cur) != node_lits.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (!aig.is_and(cur)) {
+      node_lits[cur] = sat.new_var();
+      to_visit.pop_back();
+      continue;
+    }
+
+    AigLit c0 = aig.child0(cur);
+    AigLit c1 = aig.child1(cur);
+    bool children_done = true;
+    if (node_lits.find(Aig::node(c0)) == node_lits.end()) {
+      children_done = false;
+      to_visit.push_back(Aig::node(c0));
+    }
+    if (node_lits.find(Aig::node(c1)) == node_lits.end()) {
+      children_done = false;
+      to_visit.push_back(Aig::node(c1));
+    }
+
+    if (children_done) {
+      to_visit.pop_back();
+      int a = node_lits.at(Aig::node(c0));
+      a = Aig::is_negated(c0) ? -a : a;
+      int b = node_lits.at(Aig::node(c1));
+      b = Aig::is_negated(c1) ? -b : b;
+
+      int v = sat.new_var();
+      sat.add_clause({ -v, a });
+      sat.add_clause({ -v, b });
+      sat.add_clause({ v, -a, -b });
+      node_lits[cur] = v;
+    }
+  }
+
+  int res = node_lits.at(Aig::node(l));
+  return Aig::is_negated(l) ? -res : res;
+}
+
+}  // namespace pono
@@ -0,0 +1,249 @@
+/*********************                                                        */
+/*! \file bit_blaster.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief An and-inverter graph and a bit-blaster from boolean and
+**        bit-vector terms into it.
+**
+**        The AIG is built once per transition system and can then be
+**        encoded into CNF for a native SAT solver as often as needed
+**        (e.g. once per BMC frame or IC3 transition query).
+**
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+#include "smt/sat_solver.h"
+
+namespace pono {
+
+/** A literal of an Aig: twice the node index plus the negation bit
+ *  node 0 is the constant false node
+ */
+typedef uint32_t AigLit;
+
+/** The bits of a term, least significant bit first */
+typedef std::vector<AigLit> AigBits;
+
+class Aig
+{
+ public:
+  static constexpr AigLit FALSE_LIT = 0;
+  static constexpr AigLit TRUE_LIT = 1;
+
+  Aig();
+
+  ~Aig() {}
+
+  /** @return a literal for a fresh input node */
+  AigLit make_input();
+
+  /** Create the conjunction of two literals
+   *  Simplifies constants and trivial cases, and reuses structurally
+   *  identical nodes
+   */
+  AigLit make_and(AigLit a, AigLit b);
+
+  AigLit make_or(AigLit a, AigLit b);
+
+  AigLit make_xor(AigLit a, AigLit b);
+
+  AigLit make_ite(AigLit c, AigLit t, AigLit e);
+
+  static AigLit negate(AigLit a) { return a ^ 1; }
+
+  static uint32_t node(AigLit a) { return a >> 1; }
+
+  static bool is_negated(AigLit a) { return a & 1; }
+
+  size_t num_nodes() const { return nodes_.size(); }
+
+  size_t num_ands() const { return strash_.size(); }
+
+  /** @return true iff the node is an and node (not an input or constant) */
+  bool is_and(uint32_t n) const { return nodes_[n].first != FALSE_LIT; }
+
+  AigLit child0(uint32_t n) const { return nodes_[n].first; }
+
+  AigLit child1(uint32_t n) const { return nodes_[n].second; }
+
+ protected:
+  /** the children of each node, inputs and the constant node have
+   *  FALSE_LIT children (and nodes never do after simplification)
+   */
+  std::vector<std::pair<AigLit, AigLit>> nodes_;
+
+  std::unordered_map<uint64_t, AigLit> strash_;  ///< structural hashing
+
+};  // class Aig
+
+class BitBlaster
+{
+ public:
+  BitBlaster(Aig & aig);
+
+  ~BitBlaster() {}
+
+  /** Create fresh input bits for a boolean or bit-vector symbol
+   *  @param sym the symbol
+   *  @return the bits of the symbol
+   */
+  const AigBits & make_input(const smt::Term & sym);
+
+  /** Use the given bits for a term, e.g. to substitute next state
+   *  variables by their update functions
+   */
+  void set_bits(const smt::Term & t, const AigBits & bits);
+
+  /** Bit-blast a term
+   *  @param t a boolean or bit-vector term over symbols that have bits
+   *  @return the bits of t, a single bit for booleans
+   *  throws a PonoException for unsupported sorts and operators
+   */
+  const AigBits & bit_blast(const smt::Term & t);
+
+  /** Bit-blast a boolean term
+   *  @return the literal of t
+   */
+  AigLit bit_blast_bool(const smt::Term & t);
+
+  /** @return true iff the term only contains supported sorts and operators
+   */
+  static bool is_supported(const smt::Term & t);
+
+ protected:
+  /** Bit-blast an operator application whose children are cached */
+  AigBits apply(const smt::Term & t);
+
+  /** Ripple-carry adder, the result has the width of a */
+  AigBits add(const AigBits & a,
+              const AigBits & b,
+              AigLit carry_in,
+              AigLit & carry_out);
+
+  AigBits mul(const AigBits & a, const AigBits & b);
+
+  AigLit equal(const AigBits & a, const AigBits & b);
+
+  AigLit ult(const AigBits & a, const AigBits & b);
+
+  AigLit slt(const AigBits & a, const AigBits & b);
+
+  /** Barrel shifter
+   *  @param left true for a left shift
+   *  @param fill the bit shifted in
+   */
+  AigBits shift(const AigBits & a,
+                const AigBits & b,
+                bool left,
+                AigLit fill);
+
+  Aig & aig_;
+
+  std::unordered_map<smt::Term, AigBits> cache_;
+
+};  // class BitBlaster
+
+/** A functional transition system and a bad state property bit-blasted
+ *  into an Aig once. The next state variables are replaced by the bits
+ *  of their update functions, state variables without an update get
+ *  fresh input bits for their next state.
+ */
+class BitBlastedTs
+{
+ public:
+  /** throws a PonoException if ts is not functional or if any term
+   *  can't be bit-blasted, before building anything
+   */
+  BitBlastedTs(const TransitionSystem & ts, const smt::Term & bad);
+
+  ~BitBlastedTs() {}
+
+  const Aig & aig() const { return aig_; }
+
+  /** @return the state variables followed by the inputs */
+  const smt::TermVec & vars() const { return vars_; }
+
+  size_t num_statevars() const { return num_statevars_; }
+
+  /** @return the bits of vars()[i] */
+  const AigBits & var_bits(size_t i) const { return var_bits_[i]; }
+
+  /** @return the bits of all state variables, in the order of vars() */
+  const AigBits & state_bits() const { return state_bits_; }
+
+  /** @return the next state function of every bit in state_bits() */
+  const AigBits & next_bits() const { return next_bits_; }
+
+  /** @return the bits of all inputs, in the order of vars() */
+  const AigBits & input_bits() const { return input_bits_; }
+
+  AigLit init() const { return init_; }
+
+  /** @return the conjunction of the constraints over the current state */
+  AigLit constraints() const { return constraints_; }
+
+  AigLit bad() const { return bad_; }
+
+  /** @return the value of vars()[i] given the values of its bits
+   *  @param solver the solver to build the value with
+   *  @param bit_values the value of every bit, least significant first
+   */
+  smt::Term value(const smt::SmtSolver & solver,
+                  size_t i,
+                  const std::vector<bool> & bit_values) const;
+
+  /** @return the literal of a bit of vars()[i] as a boolean term over
+   *  the state variable, (= ((_ extract j j) v) #b1) for bit-vectors
+   *  @param solver the solver to build the term with
+   *  @param i the index of the state variable
+   *  @param j the index of the bit
+   *  @param positive false for the negated bit
+   */
+  smt::Term bit_term(const smt::SmtSolver & solver,
+                     size_t i,
+                     size_t j,
+                     bool positive) const;
+
+ protected:
+  Aig aig_;
+  smt::TermVec vars_;
+  size_t num_statevars_;
+  std::vector<AigBits> var_bits_;
+  AigBits state_bits_;
+  AigBits next_bits_;
+  AigBits input_bits_;
+  AigLit init_;
+  AigLit constraints_;
+  AigLit bad_;
+
+};  // class BitBlastedTs
+
+/** Tseitin-encode the cone of an Aig literal into a SAT solver
+ *  @param aig the and-inverter graph
+ *  @param sat the solver to add the clauses to
+ *  @param node_lits the SAT literals of the nodes encoded so far, it must
+ *         contain the constant node. Inputs that are not in it get fresh
+ *         variables
+ *  @param l the literal to encode
+ *  @return the SAT literal of l
+ */
+int encode_cnf(const Aig & aig,
+               SatSolver & sat,
+               std::unordered_map<uint32_t, int> & node_lits,
+               AigLit l);
+
+}  // namespace pono
@@ -0,0 +1,160 @@
+/*********************                                                        */
+/*! \file dependency_graph.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Variable dependency graph of a functional transition system.
+**
+**/
+
+#include "utils/dependency_graph.h"
+
+#include <algorithm>
+
+#include "utils/exceptions.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+DependencyGraph::DependencyGraph(const TransitionSystem & ts)
+    : ts_(ts), epoch_(0)
+{
+  if (!ts_.is_functional()) {
+    throw PonoException(
+        "Dependency graphs are only supported for functional transition "
+        "systems");
+  }
+
+  for (const auto & sv : ts_.statevars()) {
+    ids_[sv] = vars_.size();
+    vars_.push_back(sv);
+    is_statevar_.push_back(true);
+  }
+  for (const auto & iv : ts_.inputvars()) {
+    ids_[iv] = vars_.size();
+    vars_.push_back(iv);
+    is_statevar_.push_back(false);
+  }
+  marks_.resize(vars_.size(), 0);
+
+  deps_.resize(vars_.size());
+  const UnorderedTermMap & state_updates = ts_.state_updates();
+  for (size_t i = 0; i < vars_.size(); ++i) {
+    if (!is_statevar_[i]) {
+      continue;
+    }
+    auto it = state_updates.find(vars_[i]);
+    if (it != state_updates.end()) {
+      deps_[i] = support(it->second);
+    }
+  }
+
+  for (const auto & e : ts_.constraints()) {
+    vector<size_t> s = support(e.first);
+    constraint_vars_.insert(constraint_vars_.end(), s.begin(), s.end());
+  }
+  sort(constraint_vars_.begin(), constraint_vars_.end());
+  constraint_vars_.erase(
+      unique(constraint_vars_.begin(), constraint_vars_.end()),
+      constraint_vars_.end());
+}
+
+size_t DependencyGraph::id(const Term & var) const
+{
+  auto it = ids_.find(var);
+  if (it == ids_.end()) {
+    throw PonoException("Not a state or input variable: " + var->to_string());
+  }
+  return it->second;
+}
+
+vector<size_t> DependencyGraph::support(const Term & term) const
+{
+  vector<size_t> res;
+  UnorderedTermSet visited;
+  TermVec to_visit{ term };
+  Term t;
+  while (to_visit.size()) {
+    t = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(t).second) {
+      continue;
+    }
+
+    if (t->is_symbolic_const()) {
+      auto it = ids_.find(t);
+      if (it != ids_.end()) {
+        res.push_back(it->second);
+      }
+    } else {
+      for (const auto & c : t) {
+        to_visit.push_back(c);
+      }
+    }
+  }
+  return res;
+}
+
+vector<size_t> DependencyGraph::cone(const vector<size_t> & seeds,
+                                     bool with_constraints) const
+{
+  ++epoch_;
+  if (epoch_ == 0) {
+    // wrapped around, reset the marks
+    fill(marks_.begin(), marks_.end(), 0);
+    epoch_ = 1;
+  }
+
+  vector<size_t> res;
+  auto visit = [&](size_t id) {
+    if (marks_[id] != epoch_) {
+      marks_[id] = epoch_;
+      res.push_back(id);
+    }
+  };
+  for (size_t id : seeds) {
+    visit(id);
+  }
+  if (with_constraints) {
+    for (size_t id : constraint_vars_) {
+      visit(id);
+    }
+  }
+
+  // res doubles as the queue
+  for (size_t i = 0; i < res.size(); ++i) {
+    for (size_t dep : deps_[res[i]]) {
+      visit(dep);
+    }
+  }
+  return res;
+}
+
+void DependencyGraph::cone(const TermVec & terms,
+                           UnorderedTermSet & statevars,
+                           UnorderedTermSet & inputvars) const
+{
+  vector<size_t> seeds;
+  for (const auto & t : terms) {
+    vector<size_t> s = support(t);
+    seeds.insert(seeds.end(), s.begin(), s.end());
+  }
+
+  for (size_t id : cone(seeds)) {
+    if (is_statevar_[id]) {
+      statevars.insert(vars_[id]);
+    } else {
+      inputvars.insert(vars_[id]);
+    }
+  }
+}
+
+}  // namespace pono
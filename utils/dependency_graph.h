@@ -0,0 +1,104 @@
+/*********************                                                        */
+/*! \file dependency_graph.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Variable dependency graph of a functional transition system.
+**
+**        Variables get dense ids and each state variable stores the
+**        support of its next-state function as an adjacency list.
+**        The graph is built once, then cone-of-influence queries are a
+**        breadth-first search that only touches the cone.
+**
+**/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+
+namespace pono {
+
+class DependencyGraph
+{
+ public:
+  /** Builds the graph, ts must not change while the graph is used
+   *  @param ts a functional transition system
+   */
+  DependencyGraph(const TransitionSystem & ts);
+
+  size_t num_vars() const { return vars_.size(); }
+
+  /** @return the id of a state or input variable
+   *  throws a PonoException for any other term
+   */
+  size_t id(const smt::Term & var) const;
+
+  const smt::Term & var(size_t id) const { return vars_[id]; }
+
+  bool is_statevar(size_t id) const { return is_statevar_[id]; }
+
+  /** @return the ids of the variables in the next-state function of
+   *  the variable, empty for input variables and state variables
+   *  without a next-state function
+   */
+  const std::vector<size_t> & dependencies(size_t id) const
+  {
+    return deps_[id];
+  }
+
+  /** @return the ids of the variables occurring in the constraints */
+  const std::vector<size_t> & constraint_vars() const
+  {
+    return constraint_vars_;
+  }
+
+  /** @return the ids of the (current) state and input variables in term
+   *  next-state variables are ignored
+   */
+  std::vector<size_t> support(const smt::Term & term) const;
+
+  /** Computes the cone-of-influence of a set of variables
+   *  linear in the size of the cone, not in the size of the system
+   *  NOTE: uses a marking shared by all queries, do not query the
+   *        same graph from several threads
+   *  @param seeds ids of the variables to start from
+   *  @param with_constraints also start from the constraint variables
+   *  @return the ids of the variables in the cone, seeds first
+   */
+  std::vector<size_t> cone(const std::vector<size_t> & seeds,
+                           bool with_constraints = true) const;
+
+  /** Computes the cone-of-influence of terms
+   *  @param terms the terms to start from
+   *  @param statevars populated with the state variables in the cone
+   *  @param inputvars populated with the input variables in the cone
+   */
+  void cone(const smt::TermVec & terms,
+            smt::UnorderedTermSet & statevars,
+            smt::UnorderedTermSet & inputvars) const;
+
+ protected:
+  const TransitionSystem & ts_;
+
+  smt::TermVec vars_;
+  std::vector<bool> is_statevar_;
+  std::unordered_map<smt::Term, size_t> ids_;
+
+  std::vector<std::vector<size_t>> deps_;
+  std::vector<size_t> constraint_vars_;
+
+  // a variable is marked in a query iff its mark equals epoch_
+  mutable std::vector<unsigned> marks_;
+  mutable unsigned epoch_;
+};
+
+}  // namespace pono
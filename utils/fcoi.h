@@ -18,23 +18,20 @@
 #pragma once
 
 #include "core/ts.h"
+#include "utils/dependency_graph.h"
 #include "utils/logger.h"
 
 namespace pono {
 class FunctionalConeOfInfluence
 {
  public:
-  /** This class computes the cone of influence on construction
-   *  @param ts the transition system to modify
-   *  @param to_keep terms in the transition system that need to be kept
-   *  The cone-of-influence will keep all the variables from terms in
-   *    to_keep and any variables that influence those variables.
+  /** Builds the dependency graph of the transition system once,
+   *  compute_coi can then be called any number of times
+   *  @param ts the transition system, must not change while this
+   *         object is used
    */
   FunctionalConeOfInfluence(const TransitionSystem & ts, int verbosity = 1);
 
-  // TODO if this is used incrementally, consider caching
-  //      some info. could be optional
-
   /** Compute the cone of influence for terms
    *  @param terms - a vector of important terms which
    *  after running, can access that statevars and input
@@ -58,6 +55,9 @@ class FunctionalConeOfInfluence
     return inputvars_in_coi_;
   }
 
+  /** the dependency graph used for the queries */
+  const DependencyGraph & graph() const { return graph_; }
+
  protected:
   /* Helper functions */
 
@@ -70,25 +70,18 @@ class FunctionalConeOfInfluence
   void print_coi_info(const smt::TermVec & terms);
   void print_term_dfs(const smt::Term & term);
 
-  /* Key functions. */
-  void compute_coi_trans_constraints();
-  void compute_term_coi(const smt::Term & term,
-                        smt::UnorderedTermSet & new_coi_state_vars,
-                        smt::UnorderedTermSet & new_coi_input_vars);
-  void compute_coi_next_state_funcs();
-
   const TransitionSystem & ts_;
   int verbosity_;
 
   Log local_logger_;  ///< local instance of a logger to respect this verbosity
 
+  DependencyGraph graph_;  ///< support sets of the next-state functions
+
   /* TermSets containing those state and input variables that appear
      in the term 'bad_' that represents the bad-state property. This
      information is used to rebuild the transition relation of the
      transition system 'ts_' of the property. */
   smt::UnorderedTermSet statevars_in_coi_;
   smt::UnorderedTermSet inputvars_in_coi_;
-  /* Set of terms already visited in COI analysis. */
-  smt::UnorderedTermSet coi_visited_terms_;
 };
 }  // namespace pono
@@ -0,0 +1,257 @@
+/*********************                                                        */
+/*! \file invariant_miner.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Simulation-based mining of candidate invariants.
+**
+**/
+
+#include "utils/invariant_miner.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+InvariantMiner::InvariantMiner(const TransitionSystem & ts, unsigned int seed)
+    : ts_(ts), sim_(new Simulator(ts, seed)), num_samples_(0)
+{
+  for (const auto & sv : ts_.statevars()) {
+    SortKind sk = sv->get_sort()->get_sort_kind();
+    if (sk == BOOL || sk == BV) {
+      statevars_.push_back(sv);
+    }
+  }
+  // deterministic order of the candidates
+  sort(statevars_.begin(), statevars_.end(), [](const Term & a, const Term & b) {
+    return a->to_string() < b->to_string();
+  });
+}
+
+size_t InvariantMiner::mine(size_t num_cycles)
+{
+  mpz_class val;
+  sim_->reset();
+  for (size_t c = 0; c < num_cycles; ++c) {
+    if (!sim_->valid_lanes()) {
+      // every lane violated a constraint
+      sim_->reset();
+    }
+    sim_->randomize_inputs();
+    sim_->evaluate();
+
+    Simulator::LaneMask valid = sim_->valid_lanes();
+    for (size_t lane = 0; lane < Simulator::NUM_LANES; ++lane) {
+      if (!((valid >> lane) & 1)) {
+        continue;
+      }
+      for (const auto & sv : statevars_) {
+        sim_->get_value(sv, lane, val);
+        const Sort & sort = sv->get_sort();
+        add_sample(summaries_[sv],
+                   val,
+                   sort->get_sort_kind() == BOOL || sort->get_width() == 1);
+      }
+      ++num_samples_;
+    }
+
+    sim_->advance();
+  }
+
+  make_candidates();
+  logger.log(1,
+             "InvariantMiner: {} candidates from {} samples",
+             candidates_.size(),
+             num_samples_);
+  return candidates_.size();
+}
+
+TermVec inductive_subset(const TransitionSystem & ts,
+                         const TermVec & candidates)
+{
+  const SmtSolver & solver = ts.solver();
+  const Term false_term = solver->make_term(false);
+  TermVec invs = candidates;
+
+  // Each iteration drops every candidate that is false in the model
+  // of a query asking for a violation of at least one candidate.
+  // Returns false if the query is unsat, i.e. none is violated
+  auto drop_violated = [&](const TermVec & checked) {
+    solver->push();
+    Term violated = false_term;
+    for (const auto & c : checked) {
+      violated = solver->make_term(Or, violated, solver->make_term(Not, c));
+    }
+    solver->assert_formula(violated);
+    Result r = solver->check_sat();
+    assert(r.is_sat() || r.is_unsat());
+    if (r.is_sat()) {
+      size_t k = 0;
+      for (size_t i = 0; i < invs.size(); ++i) {
+        if (solver->get_value(checked[i]) != false_term) {
+          invs[k++] = invs[i];
+        }
+      }
+      invs.resize(k);
+    }
+    solver->pop();
+    return r.is_sat();
+  };
+
+  // initiation
+  solver->push();
+  solver->assert_formula(ts.init());
+  while (!invs.empty() && drop_violated(invs)) {
+  }
+  solver->pop();
+  size_t num_init = invs.size();
+
+  // consecution relative to the remaining candidates
+  size_t num_iter = 0;
+  solver->push();
+  solver->assert_formula(ts.trans());
+  bool changed = true;
+  while (!invs.empty() && changed) {
+    ++num_iter;
+    solver->push();
+    TermVec next_invs;
+    next_invs.reserve(invs.size());
+    for (const auto & inv : invs) {
+      solver->assert_formula(inv);
+      next_invs.push_back(ts.next(inv));
+    }
+    changed = drop_violated(next_invs);
+    solver->pop();
+  }
+  solver->pop();
+
+  logger.log(1,
+             "Invariant validation: {} of {} candidates hold initially, {} "
+             "are inductive after {} iterations",
+             num_init,
+             candidates.size(),
+             invs.size(),
+             num_iter);
+  return invs;
+}
+
+TermVec InvariantMiner::validate()
+{
+  return inductive_subset(ts_, candidates_);
+}
+
+void InvariantMiner::add_sample(VarSummary & summary,
+                                const mpz_class & val,
+                                bool is_bool)
+{
+  const size_t popcount = mpz_popcount(val.get_mpz_t());
+  const size_t low = mpz_getlimbn(val.get_mpz_t(), 0);
+  if (!num_samples_) {
+    summary.first = val;
+    summary.max = val;
+    summary.constant = true;
+    summary.one_hot = popcount == 1;
+    summary.at_most_one_hot = popcount <= 1;
+    summary.signature = 0;
+    summary.neg_signature = 0;
+  } else {
+    summary.constant &= val == summary.first;
+    if (val > summary.max) {
+      summary.max = val;
+    }
+    summary.one_hot &= popcount == 1;
+    summary.at_most_one_hot &= popcount <= 1;
+  }
+
+  // equal signatures are a necessary condition for equal sequences
+  summary.signature = summary.signature * 1000003 + low;
+  if (is_bool) {
+    summary.neg_signature = summary.neg_signature * 1000003 + (1 - low);
+  }
+}
+
+void InvariantMiner::make_candidates()
+{
+  candidates_.clear();
+  if (!num_samples_) {
+    return;
+  }
+
+  const SmtSolver & solver = ts_.solver();
+  // representatives of the classes of equal sequences of values
+  unordered_map<string, Term> reps;
+  for (const auto & sv : statevars_) {
+    const VarSummary & summary = summaries_.at(sv);
+    const Sort & sort = sv->get_sort();
+    const bool is_bool = sort->get_sort_kind() == BOOL;
+
+    if (summary.constant) {
+      if (is_bool) {
+        candidates_.push_back(summary.first != 0
+                                  ? sv
+                                  : solver->make_term(Not, sv));
+      } else {
+        Term val = solver->make_term(summary.first.get_str(10), sort, 10);
+        candidates_.push_back(solver->make_term(Equal, sv, val));
+      }
+      continue;
+    }
+
+    const string key = sort->to_string() + "_" + to_string(summary.signature);
+    auto it = reps.find(key);
+    if (it != reps.end()) {
+      candidates_.push_back(solver->make_term(Equal, it->second, sv));
+      continue;
+    }
+    reps[key] = sv;
+
+    if (is_bool) {
+      it = reps.find(sort->to_string() + "_"
+                     + to_string(summary.neg_signature));
+      if (it != reps.end()) {
+        candidates_.push_back(
+            solver->make_term(Equal, it->second, solver->make_term(Not, sv)));
+      }
+      continue;
+    }
+
+    const uint64_t width = sort->get_width();
+    if (width < 2) {
+      continue;
+    }
+
+    Term zero = solver->make_term(0, sort);
+    Term one = solver->make_term(1, sort);
+    Term at_most_one_hot = solver->make_term(
+        Equal,
+        solver->make_term(BVAnd, sv, solver->make_term(BVSub, sv, one)),
+        zero);
+    if (summary.one_hot) {
+      candidates_.push_back(solver->make_term(
+          And, solver->make_term(Distinct, sv, zero), at_most_one_hot));
+    } else if (summary.at_most_one_hot) {
+      candidates_.push_back(at_most_one_hot);
+    }
+
+    mpz_class max_val;
+    mpz_ui_pow_ui(max_val.get_mpz_t(), 2, width);
+    if (summary.max < max_val - 1) {
+      Term bound = solver->make_term(summary.max.get_str(10), sort, 10);
+      candidates_.push_back(solver->make_term(BVUle, sv, bound));
+    }
+  }
+}
+
+}  // namespace pono
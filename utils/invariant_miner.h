@@ -0,0 +1,104 @@
+/*********************                                                        */
+/*! \file invariant_miner.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Simulation-based mining of candidate invariants.
+**
+**        Random simulation proposes simple candidates that held in every
+**        sampled state: constant registers, equal (or complementary)
+**        registers, one-hot vectors and upper bounds of counters.
+**        The candidates are then validated with a Houdini-style fixpoint:
+**        candidates that are violated by an initial state or are not
+**        inductive relative to the remaining candidates are dropped until
+**        the conjunction is inductive.
+**
+**/
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/ts.h"
+#include "gmpxx.h"
+#include "smt-switch/smt.h"
+#include "utils/simulator.h"
+
+namespace pono {
+
+/** Validate candidate invariants with a Houdini-style fixpoint
+ *  uses push/pop on the solver of the transition system and leaves
+ *  it at the same context level
+ *  @param ts the transition system
+ *  @param candidates the candidates (over current state variables)
+ *  @return the candidates whose conjunction is an inductive invariant
+ */
+smt::TermVec inductive_subset(const TransitionSystem & ts,
+                              const smt::TermVec & candidates);
+
+class InvariantMiner
+{
+ public:
+  /** Create a miner for a functional transition system
+   *  throws a PonoException if the system cannot be simulated
+   *  @param ts the transition system, the validation uses its solver
+   *  @param seed the seed for the random simulation
+   */
+  InvariantMiner(const TransitionSystem & ts, unsigned int seed = 0);
+
+  ~InvariantMiner() {}
+
+  /** Simulate the system and collect the candidates that held in every
+   *  sampled reachable state
+   *  @param num_cycles the number of simulated cycles
+   *  @return the number of candidates
+   */
+  size_t mine(size_t num_cycles);
+
+  /** @return the current candidates (over current state variables) */
+  const smt::TermVec & candidates() const { return candidates_; };
+
+  /** Validate the candidates with a Houdini-style fixpoint
+   *  uses push/pop on the solver of the transition system and leaves
+   *  it at the same context level
+   *  @return the candidates whose conjunction is an inductive invariant
+   */
+  smt::TermVec validate();
+
+ protected:
+  /** Summary of the values a state variable had in the samples */
+  struct VarSummary
+  {
+    mpz_class first;       ///< the first sampled value
+    mpz_class max;         ///< the maximum unsigned value
+    bool constant;         ///< whether all values are the same
+    bool one_hot;          ///< whether all values have exactly one bit set
+    bool at_most_one_hot;  ///< whether all values have at most one bit set
+    size_t signature;      ///< hash of the sequence of values
+    size_t neg_signature;  ///< hash of the sequence of negated values
+  };
+
+  void add_sample(VarSummary & summary, const mpz_class & val, bool is_bool);
+
+  void make_candidates();
+
+  TransitionSystem ts_;
+
+  std::unique_ptr<Simulator> sim_;
+
+  smt::TermVec statevars_;
+
+  std::unordered_map<smt::Term, VarSummary> summaries_;
+
+  size_t num_samples_;
+
+  smt::TermVec candidates_;
+};
+
+}  // namespace pono
@@ -19,6 +19,7 @@
 #include "engines/bmc.h"
 #include "engines/bmc_simplepath.h"
 #include "engines/ceg_prophecy_arrays.h"
+#include "engines/cegar_localization.h"
 #include "engines/cegar_ops_uf.h"
 #include "engines/cegar_values.h"
 #include "engines/ic3bits.h"
@@ -26,7 +27,12 @@
 #include "engines/ic3sa.h"
 #include "engines/interpolantmc.h"
 #include "engines/kinduction.h"
+#include "engines/kliveness.h"
 #include "engines/mbic3.h"
+#include "engines/pdkind.h"
+#include "engines/sat_bmc.h"
+#include "engines/sat_ic3.h"
+#include "engines/sim_bmc.h"
 #include "engines/syguspdr.h"
 #ifdef WITH_MSAT_IC3IA
 #include "engines/msat_ic3ia.h"
@@ -46,6 +52,7 @@ vector<Engine> all_engines()
            #ifdef WITH_MSAT
            INTERP,
            IC3IA_ENGINE,
+           PDKIND,
            #endif
            IC3SA_ENGINE,
            MUS_ENGINE
@@ -58,6 +65,17 @@ shared_ptr<Prover> make_prover(Engine e,
                                const SmtSolver & slv,
                                PonoOptions opts)
 {
+  if (opts.sat_backend_) {
+    if (e == BMC || e == SAT_BMC) {
+      return make_shared<SatBmc>(p, ts, slv, opts);
+    } else if (e == IC3_BOOL || e == IC3_BITS) {
+      return make_shared<SatIC3>(p, ts, slv, opts);
+    } else {
+      throw PonoException(
+          "The native SAT backend only supports bmc, ic3bool and ic3bits");
+    }
+  }
+
   if (e == BMC) {
     return make_shared<Bmc>(p, ts, slv, opts);
   } else if (e == BMC_SP) {
@@ -92,6 +110,18 @@ shared_ptr<Prover> make_prover(Engine e,
     return make_shared<SygusPdr>(p, ts, slv, opts);
   } else if (e == MUS_ENGINE) {
     return make_shared<Mus>(p, ts, slv, opts);
+  } else if (e == SIM_BMC) {
+    return make_shared<SimBmc>(p, ts, slv, opts);
+  } else if (e == SAT_BMC) {
+    return make_shared<SatBmc>(p, ts, slv, opts);
+  } else if (e == KLIVE) {
+    return make_shared<KLiveness>(p, ts, slv, opts);
+  } else if (e == PDKIND) {
+#ifdef WITH_MSAT
+    return make_shared<PdKind>(p, ts, slv, opts);
+#else
+    throw PonoException("PD-KIND requires an interpolator");
+#endif
   } else {
     throw PonoException("Unhandled engine");
   }
@@ -148,6 +178,36 @@ shared_ptr<Prover> make_cegar_values_prover(Engine e,
   return make_shared<CegarValues<CegProphecyArrays<IC3IA>>>(p, ts, slv, opts);
 }
 
+shared_ptr<Prover> make_cegar_loc_prover(Engine e,
+                                         const Property & p,
+                                         const TransitionSystem & ts,
+                                         const SmtSolver & slv,
+                                         PonoOptions opts)
+{
+  if (e == BMC) {
+    return make_shared<CegarLocalization<Bmc>>(p, ts, slv, opts);
+  } else if (e == KIND) {
+    return make_shared<CegarLocalization<KInduction>>(p, ts, slv, opts);
+  } else if (e == MBIC3) {
+    return make_shared<CegarLocalization<ModelBasedIC3>>(p, ts, slv, opts);
+  } else if (e == IC3_BITS) {
+    return make_shared<CegarLocalization<IC3Bits>>(p, ts, slv, opts);
+  } else if (e == IC3IA_ENGINE) {
+#ifdef WITH_MSAT
+    return make_shared<CegarLocalization<IC3IA>>(p, ts, slv, opts);
+#else
+    throw PonoException(
+        "IC3IA uses MathSAT for interpolants, but not built with MathSAT");
+#endif
+  } else if (e == IC3SA_ENGINE) {
+    return make_shared<CegarLocalization<IC3SA>>(p, ts, slv, opts);
+  } else {
+    throw PonoException(
+        "CegarLocalization currently only supports bmc, ind, mbic3, ic3bits, "
+        "ic3ia and ic3sa");
+  }
+}
+
 shared_ptr<Prover> make_cegar_bv_arith_prover(Engine e,
                                               const Property & p,
                                               const TransitionSystem & ts,
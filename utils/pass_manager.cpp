@@ -0,0 +1,116 @@
+/*********************                                                        */
+/*! \file pass_manager.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Runs a pipeline of named preprocessing passes on a transition
+**        system and a property.
+**
+**/
+
+#include "utils/pass_manager.h"
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/term_analysis.h"
+#include "utils/timestamp.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+void PassManager::add_pass(const string & name,
+                           Pass pass,
+                           Precondition precondition)
+{
+  if (has_pass(name)) {
+    throw PonoException("Preprocessing pass " + name + " already exists");
+  }
+  passes_[name] = { pass, precondition };
+}
+
+void PassManager::run(const vector<string> & pipeline,
+                      TransitionSystem & ts,
+                      Term & prop,
+                      bool strict)
+{
+  for (const auto & name : pipeline) {
+    if (!has_pass(name)) {
+      throw PonoException("Unknown preprocessing pass: " + name);
+    }
+  }
+
+  for (const auto & name : pipeline) {
+    const RegisteredPass & rp = passes_.at(name);
+    PassStatistics st;
+    st.name = name;
+    st.statevars_before = ts.statevars().size();
+    st.inputvars_before = ts.inputvars().size();
+    st.trans_size_before = dag_size(ts.trans());
+
+    pono_time_stamp start = timestamp();
+    string reason = rp.precondition ? rp.precondition(ts, prop) : "";
+    st.applied = reason.empty();
+    if (!st.applied && strict) {
+      throw PonoException("Cannot run preprocessing pass " + name + ": "
+                          + reason);
+    }
+    if (st.applied) {
+      logger.log(1, "Running preprocessing pass {}", name);
+      rp.pass(ts, prop);
+    } else {
+      logger.log(
+          0, "Warning: skipping preprocessing pass {}: {}", name, reason);
+    }
+    st.time = time_duration_to_sec(timestamp_diff(start, timestamp()));
+
+    st.statevars_after = ts.statevars().size();
+    st.inputvars_after = ts.inputvars().size();
+    st.trans_size_after = dag_size(ts.trans());
+    stats_.push_back(st);
+  }
+}
+
+bool PassManager::applied(const string & name) const
+{
+  for (const auto & st : stats_) {
+    if (st.name == name && st.applied) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PassManager::log_statistics(size_t verbosity) const
+{
+  logger.log(verbosity,
+             "{:<16} {:>9} {:>15} {:>15} {:>19}",
+             "pass",
+             "time (s)",
+             "state vars",
+             "inputs",
+             "trans nodes");
+  for (const auto & st : stats_) {
+    logger.log(verbosity,
+               "{:<16} {:>9.3f} {:>7} -> {:<5} {:>7} -> {:<5} "
+               "{:>9} -> {:<7}{}",
+               st.name,
+               st.time,
+               st.statevars_before,
+               st.statevars_after,
+               st.inputvars_before,
+               st.inputvars_after,
+               st.trans_size_before,
+               st.trans_size_after,
+               st.applied ? "" : " (skipped)");
+  }
+}
+
+}  // namespace pono
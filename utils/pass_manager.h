@@ -0,0 +1,111 @@
+/*********************                                                        */
+/*! \file pass_manager.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Runs a pipeline of named preprocessing passes on a transition
+**        system and a property.
+**
+**        Passes are registered once with a precondition, then a pipeline
+**        selects them by name. A pass whose precondition does not hold
+**        is skipped with a warning, or rejected if the pipeline is strict.
+**        Every pass records its wall time and the number of state
+**        variables, inputs and nodes in trans before and after.
+**
+**/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+
+namespace pono {
+
+struct PassStatistics
+{
+  std::string name;
+  bool applied;  ///< false if the precondition did not hold
+  double time;   ///< wall time in seconds
+  size_t statevars_before;
+  size_t statevars_after;
+  size_t inputvars_before;
+  size_t inputvars_after;
+  size_t trans_size_before;  ///< number of distinct nodes in trans
+  size_t trans_size_after;
+};
+
+class PassManager
+{
+ public:
+  /** A pass modifies the system and the property in place */
+  typedef std::function<void(TransitionSystem &, smt::Term &)> Pass;
+  /** A precondition returns an empty string if the pass can be applied
+   *  and the reason why not otherwise
+   */
+  typedef std::function<std::string(const TransitionSystem &,
+                                    const smt::Term &)>
+      Precondition;
+
+  PassManager() {}
+
+  /** Registers a pass, throws a PonoException if the name is taken
+   *  @param name the name used in pipelines
+   *  @param pass the modification
+   *  @param precondition checked right before running the pass
+   */
+  void add_pass(const std::string & name,
+                Pass pass,
+                Precondition precondition = nullptr);
+
+  bool has_pass(const std::string & name) const
+  {
+    return passes_.find(name) != passes_.end();
+  }
+
+  /** Runs the passes in order and records their statistics
+   *  throws a PonoException if a pass is not registered, before running
+   *  any of them
+   *  @param pipeline the names of the passes
+   *  @param ts the system to modify
+   *  @param prop the property to modify, over ts
+   *  @param strict throw a PonoException when reaching a pass whose
+   *         precondition does not hold instead of skipping it
+   */
+  void run(const std::vector<std::string> & pipeline,
+           TransitionSystem & ts,
+           smt::Term & prop,
+           bool strict = false);
+
+  /** @return true iff a pass with this name was applied so far
+   *  e.g. for preconditions on the order of passes
+   */
+  bool applied(const std::string & name) const;
+
+  /** @return the statistics of every pass run so far, in order */
+  const std::vector<PassStatistics> & statistics() const { return stats_; }
+
+  /** Logs the statistics as a table at the given verbosity */
+  void log_statistics(size_t verbosity = 1) const;
+
+ protected:
+  struct RegisteredPass
+  {
+    Pass pass;
+    Precondition precondition;
+  };
+
+  std::unordered_map<std::string, RegisteredPass> passes_;
+  std::vector<PassStatistics> stats_;
+};
+
+}  // namespace pono
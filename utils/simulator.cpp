@@ -0,0 +1,910 @@
+/*********************                                                        */
+/*! \file simulator.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Compiled random simulator for functional transition systems.
+**
+**/
+
+#include "utils/simulator.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "smt-switch/utils.h"
+#include "utils/exceptions.h"
+#include "utils/term_evaluator.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+// helpers for word-level bit-vector arithmetic
+// values are always kept masked to their width
+
+static inline uint64_t word_mask(uint64_t w)
+{
+  return w >= 64 ? ~((uint64_t)0) : (((uint64_t)1) << w) - 1;
+}
+
+static inline bool word_msb(uint64_t v, uint64_t w)
+{
+  return (v >> (w - 1)) & 1;
+}
+
+static inline int64_t word_signed(uint64_t v, uint64_t w)
+{
+  if (w >= 64) {
+    return (int64_t)v;
+  }
+  uint64_t m = ((uint64_t)1) << (w - 1);
+  return (int64_t)((v ^ m) - m);
+}
+
+static inline uint64_t word_udiv(uint64_t a, uint64_t b, uint64_t w)
+{
+  // SMT-LIB semantics: division by zero results in all ones
+  return b ? a / b : word_mask(w);
+}
+
+static inline uint64_t word_urem(uint64_t a, uint64_t b)
+{
+  // SMT-LIB semantics: remainder by zero is the dividend
+  return b ? a % b : a;
+}
+
+static inline uint64_t word_sdiv(uint64_t a, uint64_t b, uint64_t w)
+{
+  const uint64_t m = word_mask(w);
+  bool msb_a = word_msb(a, w);
+  bool msb_b = word_msb(b, w);
+  uint64_t q = word_udiv(msb_a ? (-a & m) : a, msb_b ? (-b & m) : b, w);
+  return (msb_a != msb_b) ? (-q & m) : q;
+}
+
+static inline uint64_t word_srem(uint64_t a, uint64_t b, uint64_t w)
+{
+  const uint64_t m = word_mask(w);
+  bool msb_a = word_msb(a, w);
+  bool msb_b = word_msb(b, w);
+  uint64_t r = word_urem(msb_a ? (-a & m) : a, msb_b ? (-b & m) : b);
+  return msb_a ? (-r & m) : r;
+}
+
+static inline uint64_t word_smod(uint64_t a, uint64_t b, uint64_t w)
+{
+  const uint64_t m = word_mask(w);
+  bool msb_a = word_msb(a, w);
+  bool msb_b = word_msb(b, w);
+  uint64_t r = word_urem(msb_a ? (-a & m) : a, msb_b ? (-b & m) : b);
+  if (r == 0 || (!msb_a && !msb_b)) {
+    return r;
+  } else if (msb_a && !msb_b) {
+    return (b - r) & m;
+  } else if (!msb_a && msb_b) {
+    return (r + b) & m;
+  }
+  return -r & m;
+}
+
+Simulator::Simulator(const TransitionSystem & ts, unsigned int seed)
+    : ts_(ts),
+      rng_(seed),
+      valid_(0),
+      bad_lanes_(0),
+      cycle_(0),
+      record_(false)
+{
+  if (!ts_.is_functional()) {
+    throw PonoException("Simulator requires a functional transition system");
+  }
+
+  // sort the variables so that the stimuli only depend on the seed
+  auto by_name = [](const Term & a, const Term & b) {
+    return a->to_string() < b->to_string();
+  };
+  statevars_.assign(ts_.statevars().begin(), ts_.statevars().end());
+  std::sort(statevars_.begin(), statevars_.end(), by_name);
+  TermVec inputs(ts_.inputvars().begin(), ts_.inputvars().end());
+  std::sort(inputs.begin(), inputs.end(), by_name);
+
+  for (const auto & sv : statevars_) {
+    Slot slot = new_slot(sv->get_sort());
+    leaves_[sv] = slot;
+    state_slots_.push_back(slot);
+  }
+  for (const auto & iv : inputs) {
+    Slot slot = new_slot(iv->get_sort());
+    leaves_[iv] = slot;
+    free_vars_.push_back(iv);
+    free_slots_.push_back(slot);
+  }
+
+  const UnorderedTermMap & state_updates = ts_.state_updates();
+  for (size_t i = 0; i < statevars_.size(); ++i) {
+    const Term & sv = statevars_[i];
+    auto it = state_updates.find(sv);
+    if (it == state_updates.end()) {
+      free_vars_.push_back(sv);
+      free_slots_.push_back(state_slots_[i]);
+      continue;
+    }
+
+    Slot next = compile(it->second, step_tape_, step_cache_);
+    if (it->second->is_symbol()) {
+      // the update is another variable, which is overwritten in advance
+      Slot tmp = new_slot(sv->get_sort());
+      step_tape_.push_back({ Op(), tmp, { next }, false });
+      next = tmp;
+    }
+    updates_.push_back({ state_slots_[i], next });
+  }
+
+  for (const auto & c : ts_.constraints()) {
+    constraints_.push_back(compile(c.first, step_tape_, step_cache_));
+  }
+
+  compile_init();
+}
+
+void Simulator::set_bad(const Term & bad)
+{
+  if (bad->get_sort()->get_sort_kind() != BOOL) {
+    throw PonoException("Expecting a boolean bad state condition");
+  }
+  bad_ = bad;
+  bad_slot_ = compile(bad_, step_tape_, step_cache_);
+}
+
+void Simulator::watch(const Term & t) { compile(t, step_tape_, step_cache_); }
+
+void Simulator::reset()
+{
+  for (const auto & slot : state_slots_) {
+    randomize(slot);
+  }
+  execute(init_tape_);
+
+  valid_ = ~((LaneMask)0);
+  for (const auto & slot : init_checks_) {
+    valid_ &= lanes(slot);
+  }
+  bad_lanes_ = 0;
+  cycle_ = 0;
+
+  init_record_ = Snapshot();
+  input_record_.clear();
+}
+
+void Simulator::randomize_inputs()
+{
+  for (const auto & slot : free_slots_) {
+    randomize(slot);
+  }
+}
+
+void Simulator::evaluate()
+{
+  if (record_) {
+    if (cycle_ == 0) {
+      init_record_ = save(state_slots_);
+    }
+    input_record_.resize(cycle_);
+    input_record_.push_back(save(free_slots_));
+  }
+
+  execute(step_tape_);
+
+  for (const auto & slot : constraints_) {
+    valid_ &= lanes(slot);
+  }
+  bad_lanes_ = bad_ ? (lanes(bad_slot_) & valid_) : 0;
+}
+
+void Simulator::advance()
+{
+  for (const auto & u : updates_) {
+    copy(u.first, u.second);
+  }
+  ++cycle_;
+}
+
+bool Simulator::run(size_t num_cycles)
+{
+  for (size_t i = 0; i < num_cycles && valid_; ++i) {
+    randomize_inputs();
+    evaluate();
+    if (bad_lanes_) {
+      return true;
+    }
+    advance();
+  }
+  return false;
+}
+
+void Simulator::set_value(const Term & var, size_t lane, const Term & val)
+{
+  assert(lane < NUM_LANES);
+  auto it = leaves_.find(var);
+  if (it == leaves_.end() || !var->is_symbol()) {
+    throw PonoException("Simulator can only set the value of variables");
+  }
+  mpz_class v;
+  if (!TermEvaluator::value_to_mpz(val, v)) {
+    throw PonoException("Could not interpret value " + val->to_string());
+  }
+  write(it->second, lane, v);
+}
+
+Term Simulator::get_value(const Term & t, size_t lane) const
+{
+  mpz_class v;
+  get_value(t, lane, v);
+  return to_term(v, t->get_sort());
+}
+
+void Simulator::get_value(const Term & t, size_t lane, mpz_class & out) const
+{
+  assert(lane < NUM_LANES);
+  auto it = leaves_.find(t);
+  if (it == leaves_.end()) {
+    it = step_cache_.find(t);
+    if (it == step_cache_.end()) {
+      throw PonoException("Simulator does not track term " + t->to_string());
+    }
+  }
+  read(it->second, lane, out);
+}
+
+void Simulator::witness(size_t lane, vector<UnorderedTermMap> & out)
+{
+  if (!record_ || input_record_.empty() || input_record_.size() < cycle_) {
+    throw PonoException(
+        "Simulator can only produce witnesses when recording is enabled");
+  }
+
+  // replay the recorded stimuli and restore the current state afterwards
+  vector<uint64_t> saved_words = words_;
+  vector<mpz_class> saved_wide = wide_;
+
+  load(state_slots_, init_record_);
+  for (size_t c = 0; c < input_record_.size(); ++c) {
+    load(free_slots_, input_record_[c]);
+    execute(step_tape_);
+
+    out.push_back(UnorderedTermMap());
+    UnorderedTermMap & map = out.back();
+    for (const auto & sv : statevars_) {
+      map[sv] = get_value(sv, lane);
+    }
+    for (const auto & v : free_vars_) {
+      map[v] = get_value(v, lane);
+    }
+
+    for (const auto & u : updates_) {
+      copy(u.first, u.second);
+    }
+  }
+
+  words_ = saved_words;
+  wide_ = saved_wide;
+
+  evaluate_named_terms(ts_, out);
+}
+
+Simulator::Slot Simulator::new_slot(const Sort & sort)
+{
+  Slot slot;
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    slot = { BOOL_SLOT, words_.size(), 1 };
+    words_.push_back(0);
+  } else if (sk == BV && sort->get_width() <= 64) {
+    slot = { WORD_SLOT, words_.size(), sort->get_width() };
+    words_.resize(words_.size() + NUM_LANES, 0);
+  } else if (sk == BV || sk == INT) {
+    slot = { WIDE_SLOT, wide_.size(), sk == BV ? sort->get_width() : 0 };
+    wide_.resize(wide_.size() + NUM_LANES, 0);
+  } else {
+    throw PonoException("Simulator does not support sort "
+                        + sort->to_string());
+  }
+  return slot;
+}
+
+Simulator::Slot Simulator::compile(const Term & t,
+                                   Tape & tape,
+                                   unordered_map<Term, Slot> & cache)
+{
+  TermVec to_visit({ t });
+  while (!to_visit.empty()) {
+    Term cur = to_visit.back();
+
+    if (leaves_.find(cur) != leaves_.end()
+        || cache.find(cur) != cache.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (cur->is_value()) {
+      mpz_class v;
+      if (!TermEvaluator::value_to_mpz(cur, v)) {
+        throw PonoException("Simulator does not support value "
+                            + cur->to_string());
+      }
+      Slot slot = new_slot(cur->get_sort());
+      for (size_t lane = 0; lane < NUM_LANES; ++lane) {
+        write(slot, lane, v);
+      }
+      leaves_[cur] = slot;
+      to_visit.pop_back();
+      continue;
+    }
+
+    Op op = cur->get_op();
+    if (cur->is_symbol() || cur->is_param() || op.is_null()
+        || !TermEvaluator::is_supported(op.prim_op)) {
+      // next state variables, uninterpreted functions, arrays, etc.
+      throw PonoException("Simulator does not support term "
+                          + cur->to_string());
+    }
+
+    bool children_done = true;
+    for (const auto & c : cur) {
+      if (leaves_.find(c) == leaves_.end() && cache.find(c) == cache.end()) {
+        children_done = false;
+        to_visit.push_back(c);
+      }
+    }
+
+    if (children_done) {
+      to_visit.pop_back();
+
+      Instr instr;
+      instr.op = op;
+      for (const auto & c : cur) {
+        auto it = leaves_.find(c);
+        instr.args.push_back(it != leaves_.end() ? it->second : cache.at(c));
+      }
+      instr.dst = new_slot(cur->get_sort());
+
+      // word-level implementations exist for all supported operators
+      // except integer arithmetic and n-ary (dis)equalities
+      instr.native = instr.dst.kind != WIDE_SLOT;
+      for (const auto & a : instr.args) {
+        instr.native &= a.kind != WIDE_SLOT;
+      }
+      if ((op.prim_op == Equal || op.prim_op == Distinct)
+          && instr.args.size() != 2) {
+        instr.native = false;
+      }
+
+      tape.push_back(instr);
+      cache[cur] = instr.dst;
+    }
+  }
+
+  auto it = leaves_.find(t);
+  return it != leaves_.end() ? it->second : cache.at(t);
+}
+
+void Simulator::compile_init()
+{
+  // collect the conjuncts of init
+  TermVec conjuncts;
+  TermVec to_visit({ ts_.init() });
+  UnorderedTermSet visited;
+  while (!to_visit.empty()) {
+    Term cur = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(cur).second) {
+      continue;
+    }
+    if (cur->get_op() == And) {
+      for (const auto & c : cur) {
+        to_visit.push_back(c);
+      }
+    } else if (cur != ts_.solver()->make_term(true)) {
+      conjuncts.push_back(cur);
+    }
+  }
+
+  // turn equalities into assignments of state variables
+  // an assignment can only be used once all state variables it depends on
+  // are assigned. If there is no such assignment, relax that requirement,
+  // the free state variables then keep their random values
+  UnorderedTermSet assigned;
+  vector<bool> used(conjuncts.size(), false);
+  bool strict = true;
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+      const Term & conj = conjuncts[i];
+      if (used[i] || conj->get_op() != Equal) {
+        continue;
+      }
+      TermVec children(conj->begin(), conj->end());
+      if (children.size() != 2) {
+        continue;
+      }
+
+      for (size_t j = 0; j < 2; ++j) {
+        const Term & lhs = children[j];
+        const Term & rhs = children[1 - j];
+        if (!ts_.is_curr_var(lhs) || assigned.find(lhs) != assigned.end()) {
+          continue;
+        }
+
+        UnorderedTermSet free_vars;
+        get_free_symbolic_consts(rhs, free_vars);
+        if (free_vars.find(lhs) != free_vars.end()) {
+          continue;
+        }
+        bool ready = true;
+        for (const auto & v : free_vars) {
+          ready &= assigned.find(v) != assigned.end();
+        }
+        if (!ready && strict) {
+          continue;
+        }
+
+        Slot val = compile(rhs, init_tape_, init_cache_);
+        init_tape_.push_back({ Op(), leaves_.at(lhs), { val }, false });
+        assigned.insert(lhs);
+        assigned.insert(free_vars.begin(), free_vars.end());
+        used[i] = true;
+        progress = true;
+        break;
+      }
+
+      if (!strict && progress) {
+        // go back to strict assignments
+        break;
+      }
+    }
+
+    if (!progress && strict) {
+      strict = false;
+      progress = true;
+    } else if (progress) {
+      strict = true;
+    }
+  }
+
+  // everything else is checked after the assignments
+  for (size_t i = 0; i < conjuncts.size(); ++i) {
+    if (!used[i]) {
+      init_checks_.push_back(compile(conjuncts[i], init_tape_, init_cache_));
+    }
+  }
+}
+
+void Simulator::execute(const Tape & tape)
+{
+  for (const auto & instr : tape) {
+    if (instr.op.is_null()) {
+      copy(instr.dst, instr.args[0]);
+    } else if (instr.native) {
+      execute_native(instr);
+    } else {
+      execute_generic(instr);
+    }
+  }
+}
+
+void Simulator::execute_native(const Instr & instr)
+{
+  const Op & op = instr.op;
+  const vector<Slot> & args = instr.args;
+  const size_t n = args.size();
+  uint64_t * d = &words_[instr.dst.offset];
+  const uint64_t w = instr.dst.width;
+  const uint64_t m = word_mask(w);
+  // width of the first argument (e.g. for predicates)
+  const uint64_t cw = args[0].width;
+  const uint64_t * a = &words_[args[0].offset];
+  const uint64_t * b = n > 1 ? &words_[args[1].offset] : nullptr;
+
+  // boolean results are computed for all lanes at once
+  // other results are computed lane by lane
+  auto pred = [d](const auto & f) {
+    uint64_t res = 0;
+    for (size_t l = 0; l < NUM_LANES; ++l) {
+      res |= ((uint64_t)f(l)) << l;
+    }
+    *d = res;
+  };
+
+  switch (op.prim_op) {
+    case Not: *d = ~*a; break;
+    case And: {
+      uint64_t res = *a;
+      for (size_t i = 1; i < n; ++i) {
+        res &= words_[args[i].offset];
+      }
+      *d = res;
+      break;
+    }
+    case Or: {
+      uint64_t res = *a;
+      for (size_t i = 1; i < n; ++i) {
+        res |= words_[args[i].offset];
+      }
+      *d = res;
+      break;
+    }
+    case Xor: {
+      uint64_t res = *a;
+      for (size_t i = 1; i < n; ++i) {
+        res ^= words_[args[i].offset];
+      }
+      *d = res;
+      break;
+    }
+    case Implies: *d = ~*a | *b; break;
+    case Ite: {
+      const uint64_t c = *a;
+      const uint64_t * t = b;
+      const uint64_t * e = &words_[args[2].offset];
+      if (instr.dst.kind == BOOL_SLOT) {
+        *d = (c & *t) | (~c & *e);
+      } else {
+        for (size_t l = 0; l < NUM_LANES; ++l) {
+          d[l] = ((c >> l) & 1) ? t[l] : e[l];
+        }
+      }
+      break;
+    }
+    case Equal:
+    case Distinct: {
+      if (args[0].kind == BOOL_SLOT) {
+        *d = *a ^ *b;
+      } else {
+        pred([a, b](size_t l) { return a[l] != b[l]; });
+      }
+      if (op.prim_op == Equal) {
+        *d = ~*d;
+      }
+      break;
+    }
+    case Concat: {
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        uint64_t res = 0;
+        for (const auto & s : args) {
+          uint64_t v = words_[s.offset + l];
+          res = s.width >= 64 ? v : ((res << s.width) | v);
+        }
+        d[l] = res;
+      }
+      break;
+    }
+    case Extract: {
+      const uint64_t em = word_mask(op.idx0 - op.idx1 + 1);
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        d[l] = (a[l] >> op.idx1) & em;
+      }
+      break;
+    }
+    case Zero_Extend: copy(instr.dst, args[0]); break;
+    case Sign_Extend: {
+      const uint64_t ext = m & ~word_mask(cw);
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        d[l] = word_msb(a[l], cw) ? (a[l] | ext) : a[l];
+      }
+      break;
+    }
+    case Repeat: {
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        uint64_t res = 0;
+        for (size_t i = 0; i < op.idx0; ++i) {
+          res = cw >= 64 ? a[l] : ((res << cw) | a[l]);
+        }
+        d[l] = res;
+      }
+      break;
+    }
+    case Rotate_Left:
+    case Rotate_Right: {
+      uint64_t k = op.idx0 % w;
+      if (op.prim_op == Rotate_Right && k) {
+        k = w - k;
+      }
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        d[l] = k ? (((a[l] << k) | (a[l] >> (w - k))) & m) : a[l];
+      }
+      break;
+    }
+    case BVNot:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = ~a[l] & m;
+      break;
+    case BVNeg:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = -a[l] & m;
+      break;
+    case BVAnd:
+    case BVOr:
+    case BVXor:
+    case BVAdd:
+    case BVMul: {
+      std::copy(a, a + NUM_LANES, d);
+      for (size_t i = 1; i < n; ++i) {
+        const uint64_t * c = &words_[args[i].offset];
+        switch (op.prim_op) {
+          case BVAnd:
+            for (size_t l = 0; l < NUM_LANES; ++l) d[l] &= c[l];
+            break;
+          case BVOr:
+            for (size_t l = 0; l < NUM_LANES; ++l) d[l] |= c[l];
+            break;
+          case BVXor:
+            for (size_t l = 0; l < NUM_LANES; ++l) d[l] ^= c[l];
+            break;
+          case BVAdd:
+            for (size_t l = 0; l < NUM_LANES; ++l) d[l] = (d[l] + c[l]) & m;
+            break;
+          default:
+            assert(op.prim_op == BVMul);
+            for (size_t l = 0; l < NUM_LANES; ++l) d[l] = (d[l] * c[l]) & m;
+            break;
+        }
+      }
+      break;
+    }
+    case BVNand:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = ~(a[l] & b[l]) & m;
+      break;
+    case BVNor:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = ~(a[l] | b[l]) & m;
+      break;
+    case BVXnor:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = ~(a[l] ^ b[l]) & m;
+      break;
+    case BVComp:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = a[l] == b[l];
+      break;
+    case BVSub:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = (a[l] - b[l]) & m;
+      break;
+    case BVUdiv:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = word_udiv(a[l], b[l], w);
+      break;
+    case BVUrem:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = word_urem(a[l], b[l]);
+      break;
+    case BVSdiv:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = word_sdiv(a[l], b[l], w);
+      break;
+    case BVSrem:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = word_srem(a[l], b[l], w);
+      break;
+    case BVSmod:
+      for (size_t l = 0; l < NUM_LANES; ++l) d[l] = word_smod(a[l], b[l], w);
+      break;
+    case BVShl:
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        d[l] = b[l] >= w ? 0 : ((a[l] << b[l]) & m);
+      }
+      break;
+    case BVLshr:
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        d[l] = b[l] >= w ? 0 : (a[l] >> b[l]);
+      }
+      break;
+    case BVAshr:
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        int64_t s = word_signed(a[l], w);
+        d[l] = ((uint64_t)(s >> (b[l] >= w ? w - 1 : b[l]))) & m;
+      }
+      break;
+    case BVUlt: pred([a, b](size_t l) { return a[l] < b[l]; }); break;
+    case BVUle: pred([a, b](size_t l) { return a[l] <= b[l]; }); break;
+    case BVUgt: pred([a, b](size_t l) { return a[l] > b[l]; }); break;
+    case BVUge: pred([a, b](size_t l) { return a[l] >= b[l]; }); break;
+    case BVSlt:
+      pred([a, b, cw](size_t l) {
+        return word_signed(a[l], cw) < word_signed(b[l], cw);
+      });
+      break;
+    case BVSle:
+      pred([a, b, cw](size_t l) {
+        return word_signed(a[l], cw) <= word_signed(b[l], cw);
+      });
+      break;
+    case BVSgt:
+      pred([a, b, cw](size_t l) {
+        return word_signed(a[l], cw) > word_signed(b[l], cw);
+      });
+      break;
+    case BVSge:
+      pred([a, b, cw](size_t l) {
+        return word_signed(a[l], cw) >= word_signed(b[l], cw);
+      });
+      break;
+    default:
+      // e.g. integer operators over booleans
+      execute_generic(instr);
+      break;
+  }
+}
+
+void Simulator::execute_generic(const Instr & instr)
+{
+  const size_t n = instr.args.size();
+  vector<mpz_class> vals(n);
+  vector<const mpz_class *> ptrs(n);
+  vector<uint64_t> widths(n);
+  for (size_t i = 0; i < n; ++i) {
+    ptrs[i] = &vals[i];
+    widths[i] = max<uint64_t>(instr.args[i].width, 1);
+  }
+  const uint64_t w = max<uint64_t>(instr.dst.width, 1);
+
+  mpz_class res;
+  for (size_t l = 0; l < NUM_LANES; ++l) {
+    for (size_t i = 0; i < n; ++i) {
+      read(instr.args[i], l, vals[i]);
+    }
+    if (!TermEvaluator::apply_op(instr.op, ptrs, widths, w, res)) {
+      throw PonoException("Simulator does not support operator "
+                          + instr.op.to_string());
+    }
+    write(instr.dst, l, res);
+  }
+}
+
+void Simulator::read(const Slot & slot, size_t lane, mpz_class & out) const
+{
+  switch (slot.kind) {
+    case BOOL_SLOT: out = (words_[slot.offset] >> lane) & 1; break;
+    case WORD_SLOT: out = words_[slot.offset + lane]; break;
+    default:
+      assert(slot.kind == WIDE_SLOT);
+      out = wide_[slot.offset + lane];
+      break;
+  }
+}
+
+void Simulator::write(const Slot & slot, size_t lane, const mpz_class & val)
+{
+  switch (slot.kind) {
+    case BOOL_SLOT: {
+      const uint64_t bit = ((uint64_t)1) << lane;
+      if (val != 0) {
+        words_[slot.offset] |= bit;
+      } else {
+        words_[slot.offset] &= ~bit;
+      }
+      break;
+    }
+    case WORD_SLOT: {
+      // values are masked, so they fit in an unsigned long
+      words_[slot.offset + lane] = val.get_ui();
+      break;
+    }
+    default:
+      assert(slot.kind == WIDE_SLOT);
+      wide_[slot.offset + lane] = val;
+      break;
+  }
+}
+
+void Simulator::randomize(const Slot & slot)
+{
+  switch (slot.kind) {
+    case BOOL_SLOT: words_[slot.offset] = rng_(); break;
+    case WORD_SLOT: {
+      const uint64_t m = word_mask(slot.width);
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        words_[slot.offset + l] = rng_() & m;
+      }
+      break;
+    }
+    default: {
+      assert(slot.kind == WIDE_SLOT);
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        mpz_class & v = wide_[slot.offset + l];
+        if (!slot.width) {
+          // integers
+          v = (long)rng_();
+          continue;
+        }
+        v = 0;
+        for (uint64_t i = 0; i < slot.width; i += 64) {
+          v <<= 64;
+          v += (unsigned long)rng_();
+        }
+        mpz_fdiv_r_2exp(v.get_mpz_t(), v.get_mpz_t(), slot.width);
+      }
+      break;
+    }
+  }
+}
+
+void Simulator::copy(const Slot & dst, const Slot & src)
+{
+  assert(dst.kind == src.kind);
+  switch (dst.kind) {
+    case BOOL_SLOT: words_[dst.offset] = words_[src.offset]; break;
+    case WORD_SLOT:
+      std::copy(&words_[src.offset],
+                &words_[src.offset] + NUM_LANES,
+                &words_[dst.offset]);
+      break;
+    default:
+      assert(dst.kind == WIDE_SLOT);
+      for (size_t l = 0; l < NUM_LANES; ++l) {
+        wide_[dst.offset + l] = wide_[src.offset + l];
+      }
+      break;
+  }
+}
+
+Term Simulator::to_term(const mpz_class & val, const Sort & sort) const
+{
+  const SmtSolver & solver = ts_.solver();
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    return solver->make_term(val != 0);
+  } else if (sk == BV) {
+    return solver->make_term(val.get_str(10), sort, 10);
+  } else {
+    assert(sk == INT);
+    return solver->make_term(val.get_str(10), sort);
+  }
+}
+
+Simulator::Snapshot Simulator::save(const vector<Slot> & slots) const
+{
+  Snapshot snapshot;
+  for (const auto & slot : slots) {
+    switch (slot.kind) {
+      case BOOL_SLOT: snapshot.words.push_back(words_[slot.offset]); break;
+      case WORD_SLOT:
+        snapshot.words.insert(snapshot.words.end(),
+                              words_.begin() + slot.offset,
+                              words_.begin() + slot.offset + NUM_LANES);
+        break;
+      default:
+        assert(slot.kind == WIDE_SLOT);
+        snapshot.wide.insert(snapshot.wide.end(),
+                             wide_.begin() + slot.offset,
+                             wide_.begin() + slot.offset + NUM_LANES);
+        break;
+    }
+  }
+  return snapshot;
+}
+
+void Simulator::load(const vector<Slot> & slots, const Snapshot & snapshot)
+{
+  size_t w = 0;
+  size_t g = 0;
+  for (const auto & slot : slots) {
+    switch (slot.kind) {
+      case BOOL_SLOT: words_[slot.offset] = snapshot.words[w++]; break;
+      case WORD_SLOT:
+        std::copy(snapshot.words.begin() + w,
+                  snapshot.words.begin() + w + NUM_LANES,
+                  words_.begin() + slot.offset);
+        w += NUM_LANES;
+        break;
+      default:
+        assert(slot.kind == WIDE_SLOT);
+        std::copy(snapshot.wide.begin() + g,
+                  snapshot.wide.begin() + g + NUM_LANES,
+                  wide_.begin() + slot.offset);
+        g += NUM_LANES;
+        break;
+    }
+  }
+}
+
+}  // namespace pono
@@ -0,0 +1,253 @@
+/*********************                                                        */
+/*! \file simulator.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Compiled random simulator for functional transition systems.
+**
+**        The initial state constraints, the constraints and the state
+**        updates are compiled into flat instruction tapes. Every
+**        instruction is executed for NUM_LANES independent stimuli at
+**        once: booleans are bit-parallel (one bit per lane of a machine
+**        word), bit-vectors up to 64 bits use one machine word per lane
+**        and wider bit-vectors and integers fall back to GMP.
+**
+**/
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "core/ts.h"
+#include "gmpxx.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class Simulator
+{
+ public:
+  /** The number of stimuli that are simulated in parallel */
+  static const size_t NUM_LANES = 64;
+
+  /** A set of lanes, one bit per lane */
+  typedef uint64_t LaneMask;
+
+  /** Compile a simulator for a functional transition system
+   *  state variables without an update function are treated like inputs
+   *  throws a PonoException if the system is not functional or
+   *  contains unsupported terms (e.g. arrays or uninterpreted functions)
+   *  @param ts the functional transition system
+   *  @param seed the seed for the random stimuli
+   */
+  Simulator(const TransitionSystem & ts, unsigned int seed = 0);
+
+  ~Simulator() {}
+
+  /** Set the bad state condition checked by evaluate
+   *  @param bad a boolean term over state variables and inputs
+   */
+  void set_bad(const smt::Term & bad);
+
+  /** Makes the value of a term available through get_value after evaluate
+   *  @param t a term over state variables and inputs
+   */
+  void watch(const smt::Term & t);
+
+  /** Enable recording of the stimuli, which is required to
+   *  reconstruct witnesses. Should be set before reset.
+   */
+  void set_record(bool record) { record_ = record; };
+
+  /** Start a new simulation run from random initial states
+   *  lanes whose initial state violates init are marked invalid
+   */
+  void reset();
+
+  /** Assign random values to the inputs (and state variables without
+   *  update functions) of all lanes
+   */
+  void randomize_inputs();
+
+  /** Evaluate the constraints, the bad state condition, the watched
+   *  terms and the next state functions of the current cycle
+   *  lanes violating a constraint are marked invalid
+   */
+  void evaluate();
+
+  /** Move all lanes to their next states and to the next cycle
+   *  @requires evaluate was called in this cycle
+   */
+  void advance();
+
+  /** Simulate a full cycle with random inputs */
+  void step()
+  {
+    randomize_inputs();
+    evaluate();
+    advance();
+  }
+
+  /** Simulate until a valid lane reaches a bad state
+   *  continues from the current state, it does not reset
+   *  @param num_cycles the maximum number of cycles to simulate
+   *  @return true iff a bad state was reached, in which case the
+   *          simulator stops in the cycle of the bad state
+   */
+  bool run(size_t num_cycles);
+
+  /** @return the lanes that satisfied init and all constraints so far */
+  LaneMask valid_lanes() const { return valid_; };
+
+  /** @return the valid lanes in a bad state in the last evaluated cycle */
+  LaneMask bad_lanes() const { return bad_lanes_; };
+
+  /** @return the number of cycles since the last reset */
+  size_t cycle() const { return cycle_; };
+
+  /** Set the value of a state or input variable in one lane
+   *  @param var the variable
+   *  @param lane the lane
+   *  @param val a value term
+   */
+  void set_value(const smt::Term & var, size_t lane, const smt::Term & val);
+
+  /** Get the value of a variable or watched term in one lane
+   *  @param t a state variable, input, bad or watched term
+   *  @param lane the lane
+   *  @return a value term of the transition system's solver
+   */
+  smt::Term get_value(const smt::Term & t, size_t lane) const;
+
+  /** Get the value of a variable or watched term in one lane as an integer
+   *  booleans are represented as 0 and 1 and bit-vectors as unsigned
+   *  @param t a state variable, input, bad or watched term
+   *  @param lane the lane
+   *  @param out set to the value
+   */
+  void get_value(const smt::Term & t, size_t lane, mpz_class & out) const;
+
+  /** Reconstruct the trace of a lane up to the current cycle by
+   *  replaying the recorded stimuli. Contains the state variables,
+   *  inputs and named terms of every cycle.
+   *  @requires recording was enabled at the last reset
+   *  @param lane the lane
+   *  @param out the trace
+   */
+  void witness(size_t lane, std::vector<smt::UnorderedTermMap> & out);
+
+ protected:
+  enum SlotKind
+  {
+    BOOL_SLOT = 0,  // one word, one bit per lane
+    WORD_SLOT,      // one word per lane
+    WIDE_SLOT       // one GMP integer per lane
+  };
+
+  struct Slot
+  {
+    SlotKind kind;
+    size_t offset;   // into words_ for BOOL/WORD, into wide_ for WIDE
+    uint64_t width;  // bit-width of bit-vectors, 1 for booleans, 0 for ints
+  };
+
+  struct Instr
+  {
+    smt::Op op;  // the null operator copies the first argument
+    Slot dst;
+    std::vector<Slot> args;
+    bool native;  // whether it has a word-level implementation
+  };
+
+  typedef std::vector<Instr> Tape;
+
+  /** Values of a list of slots in all lanes */
+  struct Snapshot
+  {
+    std::vector<uint64_t> words;
+    std::vector<mpz_class> wide;
+  };
+
+  Slot new_slot(const smt::Sort & sort);
+
+  /** Compile a term into a tape
+   *  @param t the term
+   *  @param tape the tape to append instructions to
+   *  @param cache the results computed by the tape so far
+   *  @return the slot of the result
+   */
+  Slot compile(const smt::Term & t,
+               Tape & tape,
+               std::unordered_map<smt::Term, Slot> & cache);
+
+  /** Compile the initial state constraints: conjuncts assigning a
+   *  state variable are turned into assignments, the rest into checks
+   */
+  void compile_init();
+
+  void execute(const Tape & tape);
+
+  void execute_native(const Instr & instr);
+
+  void execute_generic(const Instr & instr);
+
+  void read(const Slot & slot, size_t lane, mpz_class & out) const;
+
+  void write(const Slot & slot, size_t lane, const mpz_class & val);
+
+  void randomize(const Slot & slot);
+
+  void copy(const Slot & dst, const Slot & src);
+
+  smt::Term to_term(const mpz_class & val, const smt::Sort & sort) const;
+
+  /** @return the lanes in which a boolean slot is true */
+  LaneMask lanes(const Slot & slot) const { return words_[slot.offset]; };
+
+  Snapshot save(const std::vector<Slot> & slots) const;
+
+  void load(const std::vector<Slot> & slots, const Snapshot & snapshot);
+
+  TransitionSystem ts_;
+
+  std::mt19937_64 rng_;
+
+  std::vector<uint64_t> words_;
+  std::vector<mpz_class> wide_;
+
+  std::unordered_map<smt::Term, Slot> leaves_;  ///< variables and constants
+  std::unordered_map<smt::Term, Slot> init_cache_;
+  std::unordered_map<smt::Term, Slot> step_cache_;
+
+  Tape init_tape_;
+  Tape step_tape_;
+
+  smt::TermVec statevars_;
+  std::vector<Slot> state_slots_;
+  /** pairs of the slot of a state variable and the slot of its update */
+  std::vector<std::pair<Slot, Slot>> updates_;
+  smt::TermVec free_vars_;        ///< inputs and state vars without update
+  std::vector<Slot> free_slots_;  ///< their slots
+
+  std::vector<Slot> init_checks_;  ///< init conjuncts that are not assignments
+  std::vector<Slot> constraints_;
+
+  smt::Term bad_;
+  Slot bad_slot_;
+
+  LaneMask valid_;
+  LaneMask bad_lanes_;
+  size_t cycle_;
+
+  bool record_;
+  Snapshot init_record_;
+  std::vector<Snapshot> input_record_;
+};
+
+}  // namespace pono
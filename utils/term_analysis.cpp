@@ -355,4 +355,20 @@ TermVec remove_ites_under_model(const SmtSolver & solver, const TermVec & terms)
   return res;
 }
 
+size_t dag_size(const Term & term) { return dag_size(TermVec{ term }); }
+
+size_t dag_size(const TermVec & roots)
+{
+  UnorderedTermSet visited;
+  TermVec to_visit = roots;
+  while (!to_visit.empty()) {
+    Term t = to_visit.back();
+    to_visit.pop_back();
+    if (visited.insert(t).second) {
+      to_visit.insert(to_visit.end(), t->begin(), t->end());
+    }
+  }
+  return visited.size();
+}
+
 }  // namespace pono
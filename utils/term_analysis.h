@@ -83,4 +83,12 @@ void get_predicates(const smt::SmtSolver & solver,
 smt::TermVec remove_ites_under_model(const smt::SmtSolver & solver,
                                      const smt::TermVec & terms);
 
+/** @return the number of distinct nodes in the DAG of term */
+size_t dag_size(const smt::Term & term);
+
+/** @return the number of distinct nodes in the DAGs of the terms
+ *          shared subterms are counted once
+ */
+size_t dag_size(const smt::TermVec & roots);
+
 }  // namespace pono
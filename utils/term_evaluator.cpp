@@ -0,0 +1,518 @@
+/*********************                                                        */
+/*! \file term_evaluator.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Native evaluation of terms under a concrete assignment of their
+**        free symbols. Supports boolean, bit-vector and integer
+**        arithmetic operators, without calling an SMT solver.
+**
+**/
+
+#include "utils/term_evaluator.h"
+
+#include <cassert>
+#include <sstream>
+#include <unordered_set>
+
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+// helpers for modular bit-vector arithmetic
+
+static mpz_class pow2(uint64_t w)
+{
+  mpz_class res;
+  mpz_ui_pow_ui(res.get_mpz_t(), 2, w);
+  return res;
+}
+
+static mpz_class mask(const mpz_class & v, uint64_t w)
+{
+  mpz_class res;
+  mpz_fdiv_r_2exp(res.get_mpz_t(), v.get_mpz_t(), w);
+  return res;
+}
+
+static bool msb(const mpz_class & v, uint64_t w)
+{
+  return w && mpz_tstbit(v.get_mpz_t(), w - 1);
+}
+
+static mpz_class to_signed(const mpz_class & v, uint64_t w)
+{
+  return msb(v, w) ? mpz_class(v - pow2(w)) : v;
+}
+
+static mpz_class bv_udiv(const mpz_class & a, const mpz_class & b, uint64_t w)
+{
+  // SMT-LIB semantics: division by zero results in all ones
+  if (b == 0) {
+    return pow2(w) - 1;
+  }
+  mpz_class res;
+  mpz_fdiv_q(res.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+  return res;
+}
+
+static mpz_class bv_urem(const mpz_class & a, const mpz_class & b)
+{
+  // SMT-LIB semantics: remainder by zero is the dividend
+  if (b == 0) {
+    return a;
+  }
+  mpz_class res;
+  mpz_fdiv_r(res.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+  return res;
+}
+
+static uint64_t width_of(const Term & t)
+{
+  Sort sort = t->get_sort();
+  return sort->get_sort_kind() == BV ? sort->get_width() : 1;
+}
+
+TermEvaluator::TermEvaluator(const SmtSolver & solver) : solver_(solver) {}
+
+void TermEvaluator::set_assignment(const UnorderedTermMap & assignment)
+{
+  assignment_ = assignment;
+  cache_.clear();
+}
+
+Term TermEvaluator::evaluate(const Term & t)
+{
+  mpz_class val;
+  if (!evaluate(t, val)) {
+    return nullptr;
+  }
+
+  Sort sort = t->get_sort();
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    return solver_->make_term(val != 0);
+  } else if (sk == BV) {
+    return solver_->make_term(val.get_str(10), sort, 10);
+  } else {
+    assert(sk == INT);
+    return solver_->make_term(val.get_str(10), sort);
+  }
+}
+
+bool TermEvaluator::evaluate(const Term & t, mpz_class & out)
+{
+  TermVec to_visit({ t });
+  while (!to_visit.empty()) {
+    Term cur = to_visit.back();
+
+    if (cache_.find(cur) != cache_.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    SortKind sk = cur->get_sort()->get_sort_kind();
+    if (sk != BOOL && sk != BV && sk != INT) {
+      return false;
+    }
+
+    auto it = assignment_.find(cur);
+    if (it != assignment_.end() || cur->is_value()) {
+      const Term & val = (it != assignment_.end()) ? it->second : cur;
+      if (!value_to_mpz(val, cache_[cur])) {
+        cache_.erase(cur);
+        return false;
+      }
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (cur->is_symbol() || cur->is_param()) {
+      // unassigned symbol or uninterpreted function
+      return false;
+    }
+
+    bool children_done = true;
+    for (const auto & c : cur) {
+      if (cache_.find(c) == cache_.end()) {
+        children_done = false;
+        to_visit.push_back(c);
+      }
+    }
+
+    if (children_done) {
+      to_visit.pop_back();
+      mpz_class res;
+      if (!apply(cur, res)) {
+        return false;
+      }
+      cache_[cur] = res;
+    }
+  }
+
+  out = cache_.at(t);
+  return true;
+}
+
+bool TermEvaluator::is_supported(PrimOp po)
+{
+  // must be kept in sync with TermEvaluator::apply_op
+  static const unordered_set<PrimOp> supported_ops(
+      { Not, And, Or, Xor, Implies, Ite, Equal, Distinct, Plus, Minus, Negate,
+        Mult, Abs, Lt, Le, Gt, Ge, Concat, Extract, Zero_Extend, Sign_Extend,
+        Repeat, Rotate_Left, Rotate_Right, BVNot, BVNeg, BVAnd, BVOr, BVXor,
+        BVNand, BVNor, BVXnor, BVComp, BVAdd, BVSub, BVMul, BVUdiv, BVUrem,
+        BVSdiv, BVSrem, BVSmod, BVShl, BVLshr, BVAshr, BVUlt, BVUle, BVUgt,
+        BVUge, BVSlt, BVSle, BVSgt, BVSge });
+
+  return supported_ops.find(po) != supported_ops.end();
+}
+
+bool TermEvaluator::is_supported(const Term & t)
+{
+  UnorderedTermSet visited;
+  TermVec to_visit({ t });
+  while (!to_visit.empty()) {
+    Term cur = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(cur).second) {
+      continue;
+    }
+
+    SortKind sk = cur->get_sort()->get_sort_kind();
+    if (sk != BOOL && sk != BV && sk != INT) {
+      return false;
+    }
+
+    if (cur->is_param()) {
+      return false;
+    }
+
+    Op op = cur->get_op();
+    if (!op.is_null() && !is_supported(op.prim_op)) {
+      return false;
+    }
+
+    for (const auto & c : cur) {
+      to_visit.push_back(c);
+    }
+  }
+  return true;
+}
+
+bool TermEvaluator::value_to_mpz(const Term & val, mpz_class & out)
+{
+  string repr = val->to_string();
+  if (repr == "true") {
+    out = 1;
+  } else if (repr == "false") {
+    out = 0;
+  } else if (repr.substr(0, 2) == "#b") {
+    out.set_str(repr.substr(2), 2);
+  } else if (repr.substr(0, 2) == "#x") {
+    out.set_str(repr.substr(2), 16);
+  } else if (repr.substr(0, 5) == "(_ bv") {
+    // (_ bvN W)
+    istringstream iss(repr.substr(5));
+    string digits;
+    iss >> digits;
+    out.set_str(digits, 10);
+  } else if (repr.substr(0, 3) == "(- ") {
+    // negative integer: (- N)
+    out.set_str(repr.substr(3, repr.length() - 4), 10);
+    out = -out;
+  } else {
+    return out.set_str(repr, 10) == 0;
+  }
+  return true;
+}
+
+bool TermEvaluator::apply(const Term & t, mpz_class & out) const
+{
+  vector<const mpz_class *> vals;
+  vector<uint64_t> widths;
+  for (const auto & c : t) {
+    vals.push_back(&cache_.at(c));
+    widths.push_back(width_of(c));
+  }
+  return apply_op(t->get_op(), vals, widths, width_of(t), out);
+}
+
+bool TermEvaluator::apply_op(const Op & op,
+                             const vector<const mpz_class *> & vals,
+                             const vector<uint64_t> & widths,
+                             uint64_t w,
+                             mpz_class & out)
+{
+  // width of the first argument (e.g. for predicates)
+  const uint64_t cw = widths.size() ? widths[0] : 0;
+
+  switch (op.prim_op) {
+    // boolean operators
+    case Not: out = (*vals[0] == 0); break;
+    case And: {
+      out = 1;
+      for (auto v : vals) {
+        out = (out != 0 && *v != 0);
+      }
+      break;
+    }
+    case Or: {
+      out = 0;
+      for (auto v : vals) {
+        out = (out != 0 || *v != 0);
+      }
+      break;
+    }
+    case Xor: {
+      out = 0;
+      for (auto v : vals) {
+        out = ((out != 0) != (*v != 0));
+      }
+      break;
+    }
+    case Implies: out = (*vals[0] == 0 || *vals[1] != 0); break;
+    case Ite: out = (*vals[0] != 0) ? *vals[1] : *vals[2]; break;
+    case Equal: {
+      out = 1;
+      for (size_t i = 1; i < vals.size(); ++i) {
+        if (*vals[i] != *vals[0]) {
+          out = 0;
+        }
+      }
+      break;
+    }
+    case Distinct: {
+      out = 1;
+      for (size_t i = 0; i < vals.size(); ++i) {
+        for (size_t j = i + 1; j < vals.size(); ++j) {
+          if (*vals[i] == *vals[j]) {
+            out = 0;
+          }
+        }
+      }
+      break;
+    }
+    // integer arithmetic
+    case Plus: {
+      out = 0;
+      for (auto v : vals) {
+        out += *v;
+      }
+      break;
+    }
+    case Minus: {
+      out = *vals[0];
+      for (size_t i = 1; i < vals.size(); ++i) {
+        out -= *vals[i];
+      }
+      break;
+    }
+    case Negate: out = -*vals[0]; break;
+    case Mult: {
+      out = 1;
+      for (auto v : vals) {
+        out *= *v;
+      }
+      break;
+    }
+    case Abs: out = abs(*vals[0]); break;
+    case Lt: out = (*vals[0] < *vals[1]); break;
+    case Le: out = (*vals[0] <= *vals[1]); break;
+    case Gt: out = (*vals[0] > *vals[1]); break;
+    case Ge: out = (*vals[0] >= *vals[1]); break;
+    // bit-vector operators
+    case Concat: {
+      out = 0;
+      for (size_t i = 0; i < vals.size(); ++i) {
+        out = (out << widths[i]) | *vals[i];
+      }
+      break;
+    }
+    case Extract: out = mask(*vals[0] >> op.idx1, op.idx0 - op.idx1 + 1); break;
+    case Zero_Extend: out = *vals[0]; break;
+    case Sign_Extend: {
+      out = *vals[0];
+      if (msb(out, cw)) {
+        out += (pow2(op.idx0) - 1) << cw;
+      }
+      break;
+    }
+    case Repeat: {
+      out = 0;
+      for (size_t i = 0; i < op.idx0; ++i) {
+        out = (out << cw) | *vals[0];
+      }
+      break;
+    }
+    case Rotate_Left: {
+      uint64_t n = op.idx0 % w;
+      out = mask((*vals[0] << n) | (*vals[0] >> (w - n)), w);
+      break;
+    }
+    case Rotate_Right: {
+      uint64_t n = op.idx0 % w;
+      out = mask((*vals[0] >> n) | (*vals[0] << (w - n)), w);
+      break;
+    }
+    case BVNot: out = pow2(w) - 1 - *vals[0]; break;
+    case BVNeg: out = mask(-*vals[0], w); break;
+    case BVAnd: {
+      out = *vals[0];
+      for (size_t i = 1; i < vals.size(); ++i) {
+        out &= *vals[i];
+      }
+      break;
+    }
+    case BVOr: {
+      out = *vals[0];
+      for (size_t i = 1; i < vals.size(); ++i) {
+        out |= *vals[i];
+      }
+      break;
+    }
+    case BVXor: {
+      out = *vals[0];
+      for (size_t i = 1; i < vals.size(); ++i) {
+        out ^= *vals[i];
+      }
+      break;
+    }
+    case BVNand: out = pow2(w) - 1 - (*vals[0] & *vals[1]); break;
+    case BVNor: out = pow2(w) - 1 - (*vals[0] | *vals[1]); break;
+    case BVXnor: out = pow2(w) - 1 - (*vals[0] ^ *vals[1]); break;
+    case BVComp: out = (*vals[0] == *vals[1]); break;
+    case BVAdd: {
+      out = 0;
+      for (auto v : vals) {
+        out += *v;
+      }
+      out = mask(out, w);
+      break;
+    }
+    case BVSub: out = mask(*vals[0] - *vals[1], w); break;
+    case BVMul: {
+      out = 1;
+      for (auto v : vals) {
+        out *= *v;
+      }
+      out = mask(out, w);
+      break;
+    }
+    case BVUdiv: out = bv_udiv(*vals[0], *vals[1], w); break;
+    case BVUrem: out = bv_urem(*vals[0], *vals[1]); break;
+    case BVSdiv:
+    case BVSrem:
+    case BVSmod: {
+      const mpz_class & s = *vals[0];
+      const mpz_class & u = *vals[1];
+      bool msb_s = msb(s, w);
+      bool msb_u = msb(u, w);
+      mpz_class abs_s = msb_s ? mask(-s, w) : s;
+      mpz_class abs_u = msb_u ? mask(-u, w) : u;
+      if (op.prim_op == BVSdiv) {
+        mpz_class q = bv_udiv(abs_s, abs_u, w);
+        out = (msb_s != msb_u) ? mask(-q, w) : q;
+      } else if (op.prim_op == BVSrem) {
+        mpz_class r = bv_urem(abs_s, abs_u);
+        out = msb_s ? mask(-r, w) : r;
+      } else {
+        mpz_class r = bv_urem(abs_s, abs_u);
+        if (r == 0 || (!msb_s && !msb_u)) {
+          out = r;
+        } else if (msb_s && !msb_u) {
+          out = mask(u - r, w);
+        } else if (!msb_s && msb_u) {
+          out = mask(r + u, w);
+        } else {
+          out = mask(-r, w);
+        }
+      }
+      break;
+    }
+    case BVShl: {
+      out = (*vals[1] >= w) ? mpz_class(0)
+                            : mask(*vals[0] << vals[1]->get_ui(), w);
+      break;
+    }
+    case BVLshr: {
+      out = (*vals[1] >= w) ? mpz_class(0) : mpz_class(*vals[0] >> vals[1]->get_ui());
+      break;
+    }
+    case BVAshr: {
+      mpz_class s = to_signed(*vals[0], w);
+      uint64_t n = (*vals[1] >= w) ? w : vals[1]->get_ui();
+      // right shift of mpz_class rounds towards negative infinity
+      out = mask(s >> n, w);
+      break;
+    }
+    case BVUlt: out = (*vals[0] < *vals[1]); break;
+    case BVUle: out = (*vals[0] <= *vals[1]); break;
+    case BVUgt: out = (*vals[0] > *vals[1]); break;
+    case BVUge: out = (*vals[0] >= *vals[1]); break;
+    case BVSlt: out = (to_signed(*vals[0], cw) < to_signed(*vals[1], cw)); break;
+    case BVSle: out = (to_signed(*vals[0], cw) <= to_signed(*vals[1], cw)); break;
+    case BVSgt: out = (to_signed(*vals[0], cw) > to_signed(*vals[1], cw)); break;
+    case BVSge: out = (to_signed(*vals[0], cw) >= to_signed(*vals[1], cw)); break;
+    default: return false;
+  }
+
+  return true;
+}
+
+void evaluate_named_terms(const TransitionSystem & ts,
+                          vector<UnorderedTermMap> & trace)
+{
+  TermEvaluator evaluator(ts.solver());
+  for (size_t i = 0; i < trace.size(); ++i) {
+    UnorderedTermMap & map = trace[i];
+
+    bool complete = true;
+    for (const auto & elem : ts.named_terms()) {
+      if (map.find(elem.second) == map.end()) {
+        complete = false;
+        break;
+      }
+    }
+    if (complete) {
+      continue;
+    }
+
+    UnorderedTermMap assignment = map;
+    if (i + 1 < trace.size()) {
+      const UnorderedTermMap & next_map = trace[i + 1];
+      for (const auto & sv : ts.statevars()) {
+        auto it = next_map.find(sv);
+        if (it != next_map.end()) {
+          assignment[ts.next(sv)] = it->second;
+        }
+      }
+    }
+    evaluator.set_assignment(assignment);
+
+    for (const auto & elem : ts.named_terms()) {
+      const Term & t = elem.second;
+      if (map.find(t) != map.end()) {
+        continue;
+      }
+      Term val = evaluator.evaluate(t);
+      if (val) {
+        map[t] = val;
+      } else {
+        logger.log(
+            3, "Could not evaluate named term {} at step {}", elem.first, i);
+      }
+    }
+  }
+}
+
+}  // namespace pono
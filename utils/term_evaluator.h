@@ -0,0 +1,116 @@
+/*********************                                                        */
+/*! \file term_evaluator.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Native evaluation of terms under a concrete assignment of their
+**        free symbols. Supports boolean, bit-vector and integer
+**        arithmetic operators, without calling an SMT solver.
+**
+**/
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+#include "gmpxx.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class TermEvaluator
+{
+ public:
+  /** Create an evaluator for terms of the given solver
+   *  @param solver the solver used to create the resulting value terms
+   */
+  TermEvaluator(const smt::SmtSolver & solver);
+
+  ~TermEvaluator() {}
+
+  /** Set the concrete values for symbols (or any other terms)
+   *  Clears all previously cached results
+   *  @param assignment map from terms to values
+   */
+  void set_assignment(const smt::UnorderedTermMap & assignment);
+
+  /** Evaluate a term under the current assignment
+   *  @param t the term to evaluate
+   *  @return a value term or nullptr if the term contains an unsupported
+   *          operator or sort, or a symbol without a value
+   */
+  smt::Term evaluate(const smt::Term & t);
+
+  /** Evaluate a term under the current assignment as an integer
+   *  booleans are represented as 0 and 1 and bit-vectors as unsigned
+   *  @param t the term to evaluate
+   *  @param out set to the value of t on success
+   *  @return false if t could not be evaluated
+   */
+  bool evaluate(const smt::Term & t, mpz_class & out);
+
+  /** Interpret a value term as an integer (see above)
+   *  @param val the value term
+   *  @param out set to the integer value on success
+   *  @return false if the value could not be interpreted
+   */
+  static bool value_to_mpz(const smt::Term & val, mpz_class & out);
+
+  /** Syntactic check whether a term can be evaluated, i.e. it only
+   *  contains supported sorts and operators. It can still fail to
+   *  evaluate if some of its symbols are not assigned.
+   *  @param t the term to check
+   *  @return true iff all subterms are supported
+   */
+  static bool is_supported(const smt::Term & t);
+
+  /** @return true iff apply_op supports the operator */
+  static bool is_supported(smt::PrimOp po);
+
+  /** Compute the value of an operator application
+   *  booleans are represented as 0 and 1 and bit-vectors as unsigned
+   *  @param op the operator
+   *  @param vals the values of the arguments
+   *  @param widths the bit-widths of the arguments (1 for non-bit-vectors)
+   *  @param width the bit-width of the result (1 for non-bit-vectors)
+   *  @param out set to the result on success
+   *  @return false if the operator is unsupported
+   */
+  static bool apply_op(const smt::Op & op,
+                       const std::vector<const mpz_class *> & vals,
+                       const std::vector<uint64_t> & widths,
+                       uint64_t width,
+                       mpz_class & out);
+
+ protected:
+  /** Compute the value of an operator application from the cached
+   *  values of its children
+   *  @return false if the operator or sort is unsupported
+   */
+  bool apply(const smt::Term & t, mpz_class & out) const;
+
+  smt::SmtSolver solver_;
+
+  smt::UnorderedTermMap assignment_;
+
+  std::unordered_map<smt::Term, mpz_class> cache_;
+};
+
+/** Adds the values of the named terms of a transition system that are
+ *  missing in a trace, by evaluating them over the values of the variables
+ *  of each step. Next state variables take the values of the next step.
+ *  Named terms that cannot be evaluated are left out.
+ *  @param ts the transition system
+ *  @param trace the trace, using terms of ts
+ */
+void evaluate_named_terms(const TransitionSystem & ts,
+                          std::vector<smt::UnorderedTermMap> & trace);
+
+}  // namespace pono
@@ -16,8 +16,10 @@
 
 #pragma once
 
-#include <iostream>
 #include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
 
 /*************************************** time stamp functions
  * ************************************************/
@@ -46,10 +48,15 @@ static pono_time_duration timestamp_diff (
 }
 
 // convert duration in nanoseconds computed by 'timestamp_diff' to a string
-static string time_duration_to_sec_string (pono_time_duration d) {
-  ostringstream out;
+static std::string time_duration_to_sec_string (pono_time_duration d) {
+  std::ostringstream out;
   out << d.count() * 1e-9;
   return out.str();
 }
 
+// convert duration in nanoseconds computed by 'timestamp_diff' to seconds
+static double time_duration_to_sec (pono_time_duration d) {
+  return d.count() * 1e-9;
+}
+
 }  // namespace pono
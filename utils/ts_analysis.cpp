@@ -17,10 +17,13 @@
 #include "smt-switch/term_translator.h"
 
 #include "smt/available_solvers.h"
+#include "utils/exceptions.h"
 #include "utils/logger.h"
+#include "utils/term_evaluator.h"
 #include "utils/ts_analysis.h"
 
 using namespace smt;
+using namespace std;
 
 namespace pono {
 
@@ -75,4 +78,99 @@ bool check_invar(const TransitionSystem & ts,
   return pass;
 }
 
+bool check_witness(const TransitionSystem & ts,
+                   const Term & prop,
+                   const vector<UnorderedTermMap> & witness)
+{
+  if (witness.empty()) {
+    logger.log(1, "WITNESSCHECK: Fail, empty witness");
+    return false;
+  }
+
+  vector<pair<string, Term>> checks = { { "init", ts.init() },
+                                        { "trans", ts.trans() },
+                                        { "prop", prop } };
+  for (const auto & c : ts.constraints()) {
+    checks.push_back({ "constraint", c.first });
+  }
+  for (const auto & c : checks) {
+    if (!TermEvaluator::is_supported(c.second)) {
+      throw PonoException("Cannot check witness natively, unsupported "
+                          + c.first + ": " + c.second->to_string());
+    }
+  }
+
+  const size_t n = witness.size();
+  TermEvaluator evaluator(ts.solver());
+  UnorderedTermMap assignment;
+  mpz_class val;
+
+  // evaluates t under the current assignment and logs failures
+  auto holds = [&](const Term & t, const string & what, size_t i) {
+    if (!evaluator.evaluate(t, val)) {
+      logger.log(1,
+                 "WITNESSCHECK: Fail, missing variable values for {} at step {}",
+                 what,
+                 i);
+      return false;
+    }
+    if (val == 0) {
+      logger.log(1, "WITNESSCHECK: Fail, {} violated at step {}", what, i);
+      return false;
+    }
+    return true;
+  };
+
+  for (size_t i = 0; i < n; ++i) {
+    // only variables are taken from the trace, other entries such as named
+    // terms could hide inconsistencies
+    assignment.clear();
+    for (const auto & v : ts.statevars()) {
+      auto it = witness[i].find(v);
+      if (it != witness[i].end()) {
+        assignment[v] = it->second;
+      }
+      if (i + 1 < n) {
+        it = witness[i + 1].find(v);
+        if (it != witness[i + 1].end()) {
+          assignment[ts.next(v)] = it->second;
+        }
+      }
+    }
+    for (const auto & v : ts.inputvars()) {
+      auto it = witness[i].find(v);
+      if (it != witness[i].end()) {
+        assignment[v] = it->second;
+      }
+    }
+    evaluator.set_assignment(assignment);
+
+    if (!i && !holds(ts.init(), "init", i)) {
+      return false;
+    }
+    for (const auto & c : ts.constraints()) {
+      if (ts.no_next(c.first)) {
+        if (!holds(c.first, "constraint", i)) {
+          return false;
+        }
+      }
+    }
+    if (i + 1 < n && !holds(ts.trans(), "trans", i)) {
+      return false;
+    }
+  }
+
+  // still evaluating the last step
+  if (!evaluator.evaluate(prop, val)) {
+    logger.log(1, "WITNESSCHECK: Fail, missing variable values for prop");
+    return false;
+  }
+  if (val != 0) {
+    logger.log(1, "WITNESSCHECK: Fail, prop holds at step {}", n - 1);
+    return false;
+  }
+  logger.log(1, "WITNESSCHECK: OK, prop violated at step {}", n - 1);
+  return true;
+}
+
 }  // namespace pono
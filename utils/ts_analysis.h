@@ -15,6 +15,8 @@
 **/
 #pragma once
 
+#include <vector>
+
 #include "smt-switch/smt.h"
 
 #include "core/ts.h"
@@ -34,4 +36,21 @@ bool check_invar(const TransitionSystem & ts,
                  const smt::Term & prop,
                  const smt::Term & invar);
 
+/** Check if a trace is a counterexample for the given system and
+ *  property by replaying it with a TermEvaluator (no solver involved)
+ *  Checks that the first step satisfies init, that each pair of
+ *  consecutive steps satisfies trans, that the constraints hold in
+ *  every step and that the property is violated in the last step.
+ *  Only the values of state and input variables in the trace are used.
+ *  throws a PonoException if the system or property cannot be evaluated
+ *  natively, e.g. because it contains arrays
+ *  @param ts the transition system
+ *  @param prop the term representing the property
+ *  @param witness the trace, using terms of ts (e.g. from Prover::witness)
+ *  @return true iff the trace is a valid counterexample
+ */
+bool check_witness(const TransitionSystem & ts,
+                   const smt::Term & prop,
+                   const std::vector<smt::UnorderedTermMap> & witness);
+
 }  // namespace pono
@@ -0,0 +1,543 @@
+/*********************                                                        */
+/*! \file ts_snapshot.cpp
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Binary snapshots of transition systems.
+**
+**/
+
+#include "utils/ts_snapshot.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/term_evaluator.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+const char MAGIC[8] = { 'P', 'O', 'N', 'O', 'S', 'N', 'A', 'P' };
+// bump whenever the format changes
+const uint64_t VERSION = 1;
+
+enum TermTag
+{
+  SYMBOL = 0,
+  VALUE,
+  CONST_ARRAY,
+  APPLY
+};
+
+class Writer
+{
+ public:
+  Writer(ostream & out) : out_(out) {}
+
+  void write_uint(uint64_t v)
+  {
+    while (v >= 0x80) {
+      out_.put((char)((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+    out_.put((char)v);
+  }
+
+  void write_string(const string & s)
+  {
+    write_uint(s.size());
+    out_.write(s.data(), s.size());
+  }
+
+ private:
+  ostream & out_;
+};
+
+/** Assigns indices to sorts and terms and serializes them on first use */
+class Tables
+{
+ public:
+  Tables() : sorts_(sorts_buf_), terms_(terms_buf_) {}
+
+  uint64_t sort_index(const Sort & sort)
+  {
+    auto it = sort_ids_.find(sort);
+    if (it != sort_ids_.end()) {
+      return it->second;
+    }
+
+    // children first
+    SortKind sk = sort->get_sort_kind();
+    vector<uint64_t> children;
+    if (sk == ARRAY) {
+      children.push_back(sort_index(sort->get_indexsort()));
+      children.push_back(sort_index(sort->get_elemsort()));
+    } else if (sk == FUNCTION) {
+      for (const auto & d : sort->get_domain_sorts()) {
+        children.push_back(sort_index(d));
+      }
+      children.push_back(sort_index(sort->get_codomain_sort()));
+    }
+
+    sorts_.write_uint(sk);
+    switch (sk) {
+      case BOOL:
+      case INT:
+      case REAL: break;
+      case BV: sorts_.write_uint(sort->get_width()); break;
+      case ARRAY:
+      case FUNCTION:
+        sorts_.write_uint(children.size());
+        for (auto c : children) {
+          sorts_.write_uint(c);
+        }
+        break;
+      case UNINTERPRETED:
+        sorts_.write_string(sort->get_uninterpreted_name());
+        sorts_.write_uint(sort->get_arity());
+        break;
+      default:
+        throw PonoException("Snapshot: unsupported sort " + sort->to_string());
+    }
+
+    uint64_t id = sort_ids_.size();
+    sort_ids_[sort] = id;
+    return id;
+  }
+
+  uint64_t term_index(const Term & term)
+  {
+    // iterative post-order traversal, terms can be very deep
+    vector<pair<Term, bool>> to_visit = { { term, false } };
+    while (to_visit.size()) {
+      Term t = to_visit.back().first;
+      bool children_done = to_visit.back().second;
+      to_visit.pop_back();
+      if (term_ids_.find(t) != term_ids_.end()) {
+        continue;
+      }
+
+      bool is_const_array =
+          t->is_value() && t->get_sort()->get_sort_kind() == ARRAY;
+      bool has_children = !t->is_symbol() && (!t->is_value() || is_const_array);
+      if (!children_done && has_children) {
+        to_visit.push_back({ t, true });
+        for (const auto & c : t) {
+          to_visit.push_back({ c, false });
+        }
+        continue;
+      }
+
+      uint64_t sort = sort_index(t->get_sort());
+      if (t->is_param()) {
+        throw PonoException("Snapshot: unsupported bound variable "
+                            + t->to_string());
+      } else if (t->is_symbol()) {
+        terms_.write_uint(SYMBOL);
+        terms_.write_string(t->to_string());
+        terms_.write_uint(sort);
+      } else if (is_const_array) {
+        TermVec children(t->begin(), t->end());
+        assert(children.size() == 1);
+        terms_.write_uint(CONST_ARRAY);
+        terms_.write_uint(sort);
+        terms_.write_uint(term_ids_.at(children[0]));
+      } else if (t->is_value()) {
+        terms_.write_uint(VALUE);
+        terms_.write_uint(sort);
+        SortKind sk = t->get_sort()->get_sort_kind();
+        mpz_class val;
+        if ((sk == BOOL || sk == BV || sk == INT)
+            && TermEvaluator::value_to_mpz(t, val)) {
+          terms_.write_string(val.get_str(10));
+        } else {
+          // e.g. reals, relies on the solver's printing
+          terms_.write_string(t->to_string());
+        }
+      } else {
+        Op op = t->get_op();
+        assert(!op.is_null());
+        terms_.write_uint(APPLY);
+        terms_.write_uint(op.prim_op);
+        terms_.write_uint(op.num_idx);
+        if (op.num_idx > 0) {
+          terms_.write_uint(op.idx0);
+        }
+        if (op.num_idx > 1) {
+          terms_.write_uint(op.idx1);
+        }
+        TermVec children(t->begin(), t->end());
+        terms_.write_uint(children.size());
+        for (const auto & c : children) {
+          terms_.write_uint(term_ids_.at(c));
+        }
+      }
+
+      uint64_t id = term_ids_.size();
+      term_ids_[t] = id;
+    }
+    return term_ids_.at(term);
+  }
+
+  /** Writes the sort table followed by the term table */
+  void write_to(Writer & w, ostream & out) const
+  {
+    w.write_uint(sort_ids_.size());
+    const string sorts = sorts_buf_.str();
+    out.write(sorts.data(), sorts.size());
+    w.write_uint(term_ids_.size());
+    const string terms = terms_buf_.str();
+    out.write(terms.data(), terms.size());
+  }
+
+ private:
+  ostringstream sorts_buf_;
+  ostringstream terms_buf_;
+  Writer sorts_;
+  Writer terms_;
+
+  unordered_map<Sort, uint64_t> sort_ids_;
+  unordered_map<Term, uint64_t> term_ids_;
+};
+
+class Reader
+{
+ public:
+  Reader(istream & in, const SmtSolver & solver) : in_(in), solver_(solver)
+  {
+  }
+
+  uint64_t read_uint()
+  {
+    uint64_t v = 0;
+    unsigned shift = 0;
+    while (true) {
+      int c = in_.get();
+      if (c == EOF || shift > 63) {
+        throw PonoException("Snapshot: unexpected end of file");
+      }
+      v |= (uint64_t)(c & 0x7f) << shift;
+      if (!(c & 0x80)) {
+        return v;
+      }
+      shift += 7;
+    }
+  }
+
+  bool read_bool() { return read_uint(); }
+
+  string read_string()
+  {
+    uint64_t size = read_uint();
+    string s(size, '\0');
+    if (!in_.read(&s[0], size)) {
+      throw PonoException("Snapshot: unexpected end of file");
+    }
+    return s;
+  }
+
+  void read_sorts()
+  {
+    uint64_t n = read_uint();
+    sorts_.reserve(n);
+    for (uint64_t i = 0; i < n; ++i) {
+      SortKind sk = (SortKind)read_uint();
+      switch (sk) {
+        case BOOL:
+        case INT:
+        case REAL: sorts_.push_back(solver_->make_sort(sk)); break;
+        case BV: sorts_.push_back(solver_->make_sort(BV, read_uint())); break;
+        case ARRAY:
+        case FUNCTION: {
+          SortVec children;
+          uint64_t num_children = read_uint();
+          for (uint64_t j = 0; j < num_children; ++j) {
+            children.push_back(sort(read_uint()));
+          }
+          sorts_.push_back(solver_->make_sort(sk, children));
+          break;
+        }
+        case UNINTERPRETED: {
+          string name = read_string();
+          sorts_.push_back(solver_->make_sort(name, read_uint()));
+          break;
+        }
+        default: throw PonoException("Snapshot: unexpected sort kind");
+      }
+    }
+  }
+
+  void read_terms()
+  {
+    uint64_t n = read_uint();
+    terms_.reserve(n);
+    TermVec children;
+    for (uint64_t i = 0; i < n; ++i) {
+      uint64_t tag = read_uint();
+      if (tag == SYMBOL) {
+        string name = read_string();
+        terms_.push_back(solver_->make_symbol(name, sort(read_uint())));
+      } else if (tag == VALUE) {
+        Sort s = sort(read_uint());
+        string val = read_string();
+        if (s->get_sort_kind() == BOOL) {
+          terms_.push_back(solver_->make_term(val != "0" && val != "false"));
+        } else {
+          terms_.push_back(solver_->make_term(val, s));
+        }
+      } else if (tag == CONST_ARRAY) {
+        Sort s = sort(read_uint());
+        terms_.push_back(solver_->make_term(term(read_uint()), s));
+      } else if (tag == APPLY) {
+        PrimOp po = (PrimOp)read_uint();
+        uint64_t num_idx = read_uint();
+        Op op(po);
+        if (num_idx == 1) {
+          op = Op(po, read_uint());
+        } else if (num_idx == 2) {
+          uint64_t idx0 = read_uint();
+          op = Op(po, idx0, read_uint());
+        }
+        children.clear();
+        uint64_t num_children = read_uint();
+        for (uint64_t j = 0; j < num_children; ++j) {
+          children.push_back(term(read_uint()));
+        }
+        terms_.push_back(solver_->make_term(op, children));
+      } else {
+        throw PonoException("Snapshot: unexpected term tag");
+      }
+    }
+  }
+
+  const Sort & sort(uint64_t id) const
+  {
+    if (id >= sorts_.size()) {
+      throw PonoException("Snapshot: bad sort index");
+    }
+    return sorts_[id];
+  }
+
+  const Term & term(uint64_t id) const
+  {
+    if (id >= terms_.size()) {
+      throw PonoException("Snapshot: bad term index");
+    }
+    return terms_[id];
+  }
+
+  const Term & read_term() { return term(read_uint()); }
+
+ private:
+  istream & in_;
+  const SmtSolver & solver_;
+  SortVec sorts_;
+  TermVec terms_;
+};
+
+}  // namespace
+
+void TSSnapshot::write(const string & filename,
+                       uint64_t key,
+                       const TransitionSystem & ts,
+                       const TermVec & props)
+{
+  // write to a temporary file first so that readers never see
+  // partially written snapshots
+  const string tmp_filename = filename + ".tmp";
+  ofstream out(tmp_filename, ios::binary);
+  if (!out) {
+    throw PonoException("Could not open " + tmp_filename);
+  }
+
+  out.write(MAGIC, sizeof(MAGIC));
+  Writer w(out);
+  w.write_uint(VERSION);
+  w.write_uint(key);
+
+  // the body references terms by index, it is written after the tables
+  Tables tables;
+  ostringstream body_buf;
+  Writer body(body_buf);
+  auto write_term = [&](const Term & t) {
+    body.write_uint(tables.term_index(t));
+  };
+  auto write_set = [&](const UnorderedTermSet & set) {
+    body.write_uint(set.size());
+    for (const auto & t : set) {
+      write_term(t);
+    }
+  };
+  auto write_map = [&](const UnorderedTermMap & map) {
+    body.write_uint(map.size());
+    for (const auto & elem : map) {
+      write_term(elem.first);
+      write_term(elem.second);
+    }
+  };
+
+  body.write_uint(ts.functional_);
+  body.write_uint(ts.deterministic_);
+  write_term(ts.init_);
+  write_term(ts.trans_);
+  write_set(ts.statevars_);
+  write_set(ts.next_statevars_);
+  write_set(ts.inputvars_);
+  write_map(ts.state_updates_);
+  write_map(ts.next_map_);
+  write_map(ts.curr_map_);
+  body.write_uint(ts.named_terms_.size());
+  for (const auto & elem : ts.named_terms_) {
+    body.write_string(elem.first);
+    write_term(elem.second);
+  }
+  body.write_uint(ts.term_to_name_.size());
+  for (const auto & elem : ts.term_to_name_) {
+    write_term(elem.first);
+    body.write_string(elem.second);
+  }
+  body.write_uint(ts.constraints_.size());
+  for (const auto & elem : ts.constraints_) {
+    write_term(elem.first);
+    body.write_uint(elem.second);
+  }
+  body.write_uint(props.size());
+  for (const auto & p : props) {
+    write_term(p);
+  }
+
+  tables.write_to(w, out);
+  const string body_str = body_buf.str();
+  out.write(body_str.data(), body_str.size());
+  out.close();
+  if (!out || rename(tmp_filename.c_str(), filename.c_str())) {
+    remove(tmp_filename.c_str());
+    throw PonoException("Could not write " + filename);
+  }
+  logger.log(1, "Wrote snapshot {}", filename);
+}
+
+bool TSSnapshot::read(const string & filename,
+                      uint64_t key,
+                      TransitionSystem & ts,
+                      TermVec & props)
+{
+  ifstream in(filename, ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  char magic[sizeof(MAGIC)];
+  if (!in.read(magic, sizeof(MAGIC)) || memcmp(magic, MAGIC, sizeof(MAGIC))) {
+    throw PonoException(filename + " is not a pono snapshot");
+  }
+
+  Reader r(in, ts.solver());
+  uint64_t version = r.read_uint();
+  uint64_t stored_key = r.read_uint();
+  if (version != VERSION || stored_key != key) {
+    logger.log(1, "Ignoring stale snapshot {}", filename);
+    return false;
+  }
+
+  r.read_sorts();
+  r.read_terms();
+
+  auto read_set = [&](UnorderedTermSet & set) {
+    set.clear();
+    uint64_t n = r.read_uint();
+    for (uint64_t i = 0; i < n; ++i) {
+      set.insert(r.read_term());
+    }
+  };
+  auto read_map = [&](UnorderedTermMap & map) {
+    map.clear();
+    uint64_t n = r.read_uint();
+    for (uint64_t i = 0; i < n; ++i) {
+      const Term & k = r.read_term();
+      map[k] = r.read_term();
+    }
+  };
+
+  // populate a fresh system so that ts is unchanged on errors
+  TransitionSystem res(ts.solver());
+  res.functional_ = r.read_bool();
+  res.deterministic_ = r.read_bool();
+  res.init_ = r.read_term();
+  res.trans_ = r.read_term();
+  read_set(res.statevars_);
+  read_set(res.next_statevars_);
+  read_set(res.inputvars_);
+  read_map(res.state_updates_);
+  read_map(res.next_map_);
+  read_map(res.curr_map_);
+  uint64_t n = r.read_uint();
+  for (uint64_t i = 0; i < n; ++i) {
+    string name = r.read_string();
+    res.named_terms_[name] = r.read_term();
+  }
+  n = r.read_uint();
+  for (uint64_t i = 0; i < n; ++i) {
+    const Term & t = r.read_term();
+    res.term_to_name_[t] = r.read_string();
+  }
+  n = r.read_uint();
+  for (uint64_t i = 0; i < n; ++i) {
+    const Term & t = r.read_term();
+    res.constraints_.push_back({ t, r.read_bool() });
+  }
+  TermVec res_props;
+  n = r.read_uint();
+  for (uint64_t i = 0; i < n; ++i) {
+    res_props.push_back(r.read_term());
+  }
+
+  swap(ts, res);
+  props = res_props;
+  logger.log(1, "Loaded snapshot {}", filename);
+  return true;
+}
+
+uint64_t TSSnapshot::make_key(const string & source_file, const string & config)
+{
+  const uint64_t prime = 1099511628211ull;
+  uint64_t hash = 14695981039346656037ull;
+  auto update = [&](const char * data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= (unsigned char)data[i];
+      hash *= prime;
+    }
+  };
+
+  ifstream in(source_file, ios::binary);
+  if (!in) {
+    throw PonoException("Could not open " + source_file);
+  }
+  char buf[1 << 16];
+  while (in.read(buf, sizeof(buf)) || in.gcount()) {
+    update(buf, in.gcount());
+  }
+  // separate the contents from the configuration
+  update("\0", 1);
+  update(config.data(), config.size());
+  return hash;
+}
+
+}  // namespace pono
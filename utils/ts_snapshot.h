@@ -0,0 +1,78 @@
+/*********************                                                        */
+/*! \file ts_snapshot.h
+** \verbatim
+** Top contributors (to current version):
+**   Makai Mann
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Binary snapshots of transition systems.
+**
+**        A snapshot stores the term DAG of a transition system (every
+**        member of TransitionSystem) and a list of properties, so that
+**        a preprocessed system can be loaded without re-parsing and
+**        re-running the modifiers. Terms are written once in topological
+**        order and referenced by index, integers are LEB128 varints.
+**
+**        Snapshots are tagged with a key, e.g. a hash of the source file
+**        and the preprocessing options, and are only loaded if the key
+**        matches. Note that solvers that alias booleans and bit-vectors
+**        of width one (e.g. boolector) write terms with that aliasing,
+**        such snapshots should be loaded into the same kind of solver.
+**
+**/
+#pragma once
+
+#include <string>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class TSSnapshot
+{
+ public:
+  /** Write a snapshot of a transition system
+   *  throws a PonoException if the file cannot be written or the system
+   *  contains unsupported terms (e.g. quantifiers)
+   *  @param filename the file to write
+   *  @param key the key identifying the source of the system
+   *  @param ts the transition system
+   *  @param props properties over ts to store along with it
+   */
+  static void write(const std::string & filename,
+                    uint64_t key,
+                    const TransitionSystem & ts,
+                    const smt::TermVec & props);
+
+  /** Load a snapshot into a transition system
+   *  all members of ts are replaced, the terms are created with the
+   *  solver of ts which should not contain any of the symbols yet
+   *  throws a PonoException if the file is corrupted
+   *  @param filename the file to read
+   *  @param key the expected key
+   *  @param ts the transition system to populate
+   *  @param props populated with the stored properties
+   *  @return false if the file does not exist or has a different
+   *          key or format version, then ts is unchanged
+   */
+  static bool read(const std::string & filename,
+                   uint64_t key,
+                   TransitionSystem & ts,
+                   smt::TermVec & props);
+
+  /** Compute a key from the contents of a source file and a string
+   *  describing how it was processed (e.g. the relevant options)
+   *  @param source_file the file the system was built from
+   *  @param config the description of the processing
+   *  @return a 64-bit FNV-1a hash
+   */
+  static uint64_t make_key(const std::string & source_file,
+                           const std::string & config);
+};
+
+}  // namespace pono